@@ -178,6 +178,7 @@ def define_modules(target, variant):
             "CONFIG_IPA_UT": {
                 True: [
                     "drivers/platform/msm/ipa/test/ipa_ut_framework.c",
+                    "drivers/platform/msm/ipa/test/ipa_test_fltrt_gen.h",
                     "drivers/platform/msm/ipa/test/ipa_ut_framework.h",
                     "drivers/platform/msm/ipa/test/ipa_ut_i.h",
                     "drivers/platform/msm/ipa/test/ipa_ut_suite_list.h",
@@ -188,6 +189,9 @@ def define_modules(target, variant):
                     "drivers/platform/msm/ipa/test/ipa_pm_ut.c",
                     "drivers/platform/msm/ipa/test/ipa_test_wdi3.c",
                     "drivers/platform/msm/ipa/test/ipa_test_ntn.c",
+                    "drivers/platform/msm/ipa/test/ipa_test_fltrt.c",
+                    "drivers/platform/msm/ipa/test/ipa_test_fltrt_gen.c",
+                    "drivers/platform/msm/ipa/test/ipa_test_hdr.c",
                 ],
             },
         },
@@ -2612,9 +2612,17 @@ struct ipa_ioc_nat_dma_one {
 
 };
 
+/*
+ * Maximum number of dma commands a single IPA_IOC_TABLE_DMA_CMD may carry.
+ * The kernel chains them, plus a NOP and a coalescing close, in a single
+ * transfer, which is bounded by the smallest command pipe TLV FIFO (18).
+ */
+#define IPA_TABLE_DMA_CMD_MAX_ENTRIES 16
+
 /**
  * struct ipa_ioc_nat_dma_cmd - To hold multiple nat/ipv6ct dma commands
- * @entries: number of dma commands in use
+ * @entries: number of dma commands in use, up to
+ *  IPA_TABLE_DMA_CMD_MAX_ENTRIES
  * @dma: data pointer to the dma commands
  * @mem_type: input parameter, type of memory the table resides in
  */
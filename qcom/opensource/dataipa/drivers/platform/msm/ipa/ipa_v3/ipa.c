@@ -8057,6 +8057,7 @@ static int ipa3_post_init(const struct ipa3_plat_drv_res *resource_p,
 			flt_tbl->force_sys[IPA_RULE_NON_HASHABLE] = false;
 
 			flt_tbl->rule_ids = &ipa3_ctx->flt_rule_ids[ip];
+			flt_tbl->dirty = true;
 		}
 	}
 
@@ -12427,10 +12428,7 @@ static void __exit ipa_module_exit(void)
 	if (running_emulation)
 		pci_unregister_driver(&ipa_pci_driver);
 	platform_driver_unregister(&ipa_plat_drv);
-	if(ipa3_ctx->hw_stats) {
-		kfree(ipa3_ctx->hw_stats);
-		ipa3_ctx->hw_stats = NULL;
-	}
+	ipa_hw_stats_destroy();
 	unregister_pm_notifier(&ipa_pm_notifier);
 	kfree(ipa3_ctx);
 	ipa3_ctx = NULL;
@@ -811,6 +811,73 @@ static ssize_t ipa3_read_hdr(struct file *file, char __user *ubuf, size_t count,
 	return 0;
 }
 
+static int ipa3_print_hdr_mem_stats(int nbytes, const char *name,
+	struct ipa3_hdr_mem_stats *stats, int num_bins, bool proc_ctx)
+{
+	int i;
+
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"%s: size=%u end=%u used=%u free=%u largest_free=%u frag=%u%%\n",
+		name, stats->size, stats->end, stats->used, stats->free,
+		stats->largest_free,
+		stats->free ? 100 - stats->largest_free * 100 / stats->free : 0);
+
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"  free slots:");
+	for (i = 0; i < num_bins; i++)
+		nbytes += scnprintf(dbg_buff + nbytes,
+			IPA_MAX_MSG_LEN - nbytes, " %u*%uB",
+			stats->free_slots[i], proc_ctx ?
+			ipa3_get_hdr_proc_ctx_bin_size(i) :
+			ipa3_get_hdr_bin_size(i));
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"\n");
+
+	return nbytes;
+}
+
+static ssize_t ipa3_read_hdr_mem(struct file *file, char __user *ubuf,
+	size_t count, loff_t *ppos)
+{
+	struct ipa3_hdr_mem_stats stats;
+	struct ipa3_hdr_compact_stats cstats;
+	int nbytes = 0;
+
+	ipa3_get_hdr_mem_stats(HDR_TBL_LCL, &stats);
+	nbytes = ipa3_print_hdr_mem_stats(nbytes, "SRAM", &stats,
+		IPA_HDR_BIN_MAX, false);
+	ipa3_get_hdr_mem_stats(HDR_TBL_SYS, &stats);
+	nbytes = ipa3_print_hdr_mem_stats(nbytes, "DDR", &stats,
+		IPA_HDR_BIN_MAX, false);
+	ipa3_get_hdr_proc_ctx_mem_stats(&stats);
+	nbytes = ipa3_print_hdr_mem_stats(nbytes, "PROC_CTX", &stats,
+		IPA_HDR_PROC_CTX_BIN_MAX, true);
+
+	mutex_lock(&ipa3_ctx->lock);
+	cstats = ipa3_ctx->hdr_compact;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"compaction: runs=%llu moved=%llu promoted=%llu failed=%llu\n",
+		cstats.runs, cstats.moved, cstats.promoted, cstats.failed);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
+static ssize_t ipa3_write_hdr_mem(struct file *file, const char __user *buf,
+	size_t count, loff_t *ppos)
+{
+	int ret;
+
+	IPA_ACTIVE_CLIENTS_INC_SIMPLE();
+	ret = ipa3_compact_hdr();
+	IPA_ACTIVE_CLIENTS_DEC_SIMPLE();
+	if (ret)
+		return ret;
+
+	return count;
+}
+
 static int ipa3_attrib_dump(struct ipa_rule_attrib *attrib,
 		enum ipa_ip_type ip)
 {
@@ -1633,6 +1700,12 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 {
 	int nbytes;
 	int cnt = 0, i = 0, k = 0;
+	u32 coal_ring, coal_pool, def_ring, def_pool;
+
+	ipa3_get_rx_page_pool_occupancy(IPA_CLIENT_APPS_WAN_COAL_CONS,
+		&coal_ring, &coal_pool);
+	ipa3_get_rx_page_pool_occupancy(IPA_CLIENT_APPS_WAN_CONS,
+		&def_ring, &def_pool);
 
 	nbytes = scnprintf(
 		dbg_buff, IPA_MAX_MSG_LEN,
@@ -1640,11 +1713,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		"COAL   : Number of page recycled packets  =%llu\n"
 		"COAL   : Number of tmp alloc packets  =%llu\n"
 		"COAL   : Number of times tasklet scheduled  =%llu\n"
+		"COAL   : Number of tmp pages adopted into pool  =%llu\n"
+		"COAL   : Ring buffers posted / pool size  =%u/%u\n"
 
 		"DEF    : Total number of packets replenished =%llu\n"
 		"DEF    : Number of page recycled packets =%llu\n"
 		"DEF    : Number of tmp alloc packets  =%llu\n"
 		"DEF    : Number of times tasklet scheduled  =%llu\n"
+		"DEF    : Number of tmp pages adopted into pool  =%llu\n"
+		"DEF    : Ring buffers posted / pool size  =%u/%u\n"
 
 		"COMMON : Number of page recycled in tasklet  =%llu\n"
 		"COMMON : Number of times free pages not found in tasklet =%llu\n",
@@ -1653,11 +1730,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[0],
+		ipa3_ctx->stats.page_recycle_stats[0].page_adopted,
+		coal_ring, coal_pool,
 
 		ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
 		ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[1],
+		ipa3_ctx->stats.page_recycle_stats[1].page_adopted,
+		def_ring, def_pool,
 
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
 		ipa3_ctx->stats.num_of_times_wq_reschd);
@@ -1677,6 +1758,45 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static ssize_t ipa3_read_tx_batch_stats(struct file *file,
+		char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_tx_batch_stats *stats;
+	struct ipa3_ep_context *ep;
+	int nbytes;
+	int cnt = 0, i, j;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		ep = &ipa3_ctx->ep[i];
+		if (!ep->valid || !ep->sys || !IPA_CLIENT_IS_PROD(ep->client))
+			continue;
+
+		stats = &ep->sys->tx_batch;
+		nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%s: doorbell=%llu deferred=%llu timer_flush=%llu\n",
+			ipa_clients_strings[ep->client],
+			stats->doorbell, stats->deferred, stats->timer_flush);
+		cnt += nbytes;
+
+		for (j = 0; j < IPA_TX_BATCH_HIST_MAX; j++) {
+			if (j == IPA_TX_BATCH_HIST_MAX - 1)
+				nbytes = scnprintf(dbg_buff + cnt,
+					IPA_MAX_MSG_LEN - cnt,
+					"  batch[%u+]=%llu\n",
+					1U << j, stats->hist[j]);
+			else
+				nbytes = scnprintf(dbg_buff + cnt,
+					IPA_MAX_MSG_LEN - cnt,
+					"  batch[%u-%u]=%llu\n",
+					1U << j, (2U << j) - 1,
+					stats->hist[j]);
+			cnt += nbytes;
+		}
+	}
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
 static ssize_t ipa3_read_lan_coal_stats(
 	struct file *file,
 	char __user *ubuf,
@@ -3602,6 +3722,11 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"hdr", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_hdr,
 		}
+	}, {
+		"hdr_mem", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_read_hdr_mem,
+			.write = ipa3_write_hdr_mem,
+		}
 	}, {
 		"proc_ctx", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_proc_ctx,
@@ -3662,6 +3787,10 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"page_recycle_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_page_recycle_stats,
 		}
+	}, {
+		"tx_batch_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_tx_batch_stats,
+		}
 	}, {
 		"lan_coal_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_lan_coal_stats,
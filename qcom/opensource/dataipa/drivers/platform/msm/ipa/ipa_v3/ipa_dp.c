@@ -21,6 +21,8 @@
 #include <net/ipv6.h>
 #include <asm/page.h>
 #include <linux/mutex.h>
+#include <linux/prefetch.h>
+#include <linux/kthread.h>
 #include "gsi.h"
 #include "ipa_i.h"
 #include "ipa_trace.h"
@@ -34,6 +36,8 @@
 #define IPA_WAN_PAGE_ORDER 3
 #define IPA_LAN_AGGR_PKT_CNT 1
 #define IPA_LAN_NAPI_MAX_FRAMES (NAPI_WEIGHT / IPA_LAN_AGGR_PKT_CNT)
+/* completions to look ahead when warming rx wrappers in NAPI poll */
+#define IPA_RX_PREFETCH_DIST 4
 #define IPA_LAST_DESC_CNT 0xFFFF
 #define POLLING_INACTIVITY_RX 40
 #define POLLING_MIN_SLEEP_RX 1010
@@ -97,10 +101,12 @@
 
 #define IPA_APPS_BW_FOR_PM 700
 
-#define IPA_SEND_MAX_DESC (20)
-
 #define IPA_EOT_THRESH 32
 
+/* Packets and time a TX doorbell may be held back while xmit_more is set */
+#define IPA_TX_DB_BATCH_MAX 32
+#define IPA_TX_DB_DEFER_DELAY_NS (100 * 1000)
+
 #define IPA_QMAP_ID_BYTE 0
 
 #define IPA_MEM_ALLOC_RETRY 5
@@ -156,6 +162,8 @@ static void ipa3_tasklet_rx_notify(unsigned long data);
 static void ipa3_tasklet_find_freepage(unsigned long data);
 static u32 ipa_adjust_ra_buff_base_sz(u32 aggr_byte_limit);
 static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget);
+static void ipa3_rmnet_ll_busy_poll_attach(struct ipa3_sys_context *sys);
+static void ipa3_rmnet_ll_busy_poll_detach(struct ipa3_sys_context *sys);
 
 struct gsi_chan_xfer_notify g_lan_rx_notify[IPA_LAN_NAPI_MAX_FRAMES];
 
@@ -593,43 +601,15 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 }
 
 
-/**
- * ipa3_send() - Send multiple descriptors in one HW transaction
- * @sys: system pipe context
- * @num_desc: number of packets
- * @desc: packets to send (may be immediate command or data)
- * @in_atomic:  whether caller is in atomic context
- *
- * This function is used for GPI connection.
- * - ipa3_tx_pkt_wrapper will be used for each ipa
- *   descriptor (allocated from wrappers cache)
- * - The wrapper struct will be configured for each ipa-desc payload and will
- *   contain information which will be later used by the user callbacks
- * - Each packet (command or data) that will be sent will also be saved in
- *   ipa3_sys_context for later check that all data was sent
- *
- * Return codes: 0: success, -EFAULT: failure
+/*
+ * ipa3_send_check() - Validate the descriptor count of one packet
+ * against the TLV FIFO of the pipe
  */
-int ipa3_send(struct ipa3_sys_context *sys,
-		u32 num_desc,
-		struct ipa3_desc *desc,
-		bool in_atomic)
+static int ipa3_send_check(struct ipa3_sys_context *sys, u32 num_desc)
 {
-	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
-	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
-	struct ipa3_tx_pkt_wrapper *next_pkt;
-	struct gsi_xfer_elem gsi_xfer[IPA_SEND_MAX_DESC];
-	int i = 0;
-	int j;
-	int result;
-	u32 mem_flag = GFP_ATOMIC;
 	const struct ipa_gsi_ep_config *gsi_ep_cfg;
-	bool send_nop = false;
 	unsigned int max_desc;
 
-	if (unlikely(!in_atomic))
-		mem_flag = GFP_KERNEL;
-
 	gsi_ep_cfg = ipa_get_gsi_ep_info(sys->ep->client);
 	if (unlikely(!gsi_ep_cfg)) {
 		IPAERR("failed to get gsi EP config for client=%d\n",
@@ -655,16 +635,64 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		return -EPERM;
 	}
 
-	/* initialize only the xfers we use */
-	memset(gsi_xfer, 0, sizeof(gsi_xfer[0]) * num_desc);
+	return 0;
+}
 
-	spin_lock_bh(&sys->spinlock);
+/*
+ * ipa3_send_unwind() - Drop the last num_desc wrappers of head_desc_list
+ *
+ * Must be called with sys->spinlock held.
+ */
+static void ipa3_send_unwind(struct ipa3_sys_context *sys, u32 num_desc)
+{
+	struct ipa3_tx_pkt_wrapper *tx_pkt;
 
-	if (unlikely(atomic_read(&sys->ep->disconnect_in_progress))) {
-		IPAERR("Pipe disconnect in progress dropping the packet\n");
-		spin_unlock_bh(&sys->spinlock);
-		return -EFAULT;
+	while (num_desc--) {
+		tx_pkt = list_last_entry(&sys->head_desc_list,
+			struct ipa3_tx_pkt_wrapper, link);
+		list_del(&tx_pkt->link);
+		sys->len--;
+
+		if (!tx_pkt->no_unmap_dma) {
+			if (tx_pkt->type != IPA_DATA_DESC_SKB_PAGED) {
+				dma_unmap_single(ipa3_ctx->pdev,
+					tx_pkt->mem.phys_base,
+					tx_pkt->mem.size, DMA_TO_DEVICE);
+			} else {
+				dma_unmap_page(ipa3_ctx->pdev,
+					tx_pkt->mem.phys_base,
+					tx_pkt->mem.size,
+					DMA_TO_DEVICE);
+			}
+		}
+		if (tx_pkt->callback == ipa3_tag_destroy_imm)
+			ipahal_destroy_imm_cmd(tx_pkt->user1);
+		kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache, tx_pkt);
 	}
+}
+
+/*
+ * ipa3_send_prep() - Build the wrappers and GSI elements of one packet
+ * @sys: system pipe context
+ * @num_desc: number of descriptors of the packet
+ * @desc: descriptors of the packet
+ * @gsi_xfer: GSI elements to fill, one per descriptor
+ * @send_nop: set when the packet goes out without EOT
+ *
+ * Must be called with sys->spinlock held. On failure nothing of the packet
+ * is left on head_desc_list.
+ */
+static int ipa3_send_prep(struct ipa3_sys_context *sys, u32 num_desc,
+		struct ipa3_desc *desc, struct gsi_xfer_elem *gsi_xfer,
+		bool *send_nop)
+{
+	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
+	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
+	int i;
+	int result;
+
+	/* initialize only the xfers we use */
+	memset(gsi_xfer, 0, sizeof(gsi_xfer[0]) * num_desc);
 
 	for (i = 0; i < num_desc; i++) {
 		if (!list_empty(&sys->avail_tx_wrapper_list)) {
@@ -692,6 +720,7 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		}
 
 		/* populate tag field */
+		tag_pyld_ret = NULL;
 		if (desc[i].is_tag_status) {
 			if (ipa_populate_tag_field(&desc[i], tx_pkt,
 				&tag_pyld_ret)) {
@@ -774,8 +803,9 @@ int ipa3_send(struct ipa3_sys_context *sys,
 					GSI_XFER_FLAG_BEI;
 				hrtimer_try_to_cancel(&sys->db_timer);
 				sys->nop_pending = false;
+				*send_nop = false;
 			} else {
-				send_nop = true;
+				*send_nop = true;
 			}
 			gsi_xfer[i].xfer_user_data =
 				tx_pkt_first;
@@ -785,21 +815,83 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		}
 	}
 
+	sys->pkt_sent++;
+	return 0;
+
+failure_dma_map:
+	ipahal_destroy_imm_cmd(tag_pyld_ret);
+	kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache, tx_pkt);
+
+failure:
+	ipa3_send_unwind(sys, i);
+	return result;
+}
+
+static void ipa3_tx_batch_account(struct ipa3_sys_context *sys, u32 pkts)
+{
+	u32 bkt = min_t(u32, ilog2(pkts), IPA_TX_BATCH_HIST_MAX - 1);
+
+	IPA_STATS_INC_CNT(sys->tx_batch.doorbell);
+	IPA_STATS_INC_CNT(sys->tx_batch.hist[bkt]);
+}
+
+/*
+ * ipa3_send_queue() - Queue prepared GSI elements and ring the doorbell
+ * @sys: system pipe context
+ * @num_pkts: number of packets the elements belong to
+ * @num_xfers: number of GSI elements
+ * @gsi_xfer: GSI elements
+ * @xmit_more: more packets follow, the doorbell may be deferred
+ *
+ * While the caller reports more packets the doorbell is held back until
+ * IPA_TX_DB_BATCH_MAX packets are pending. If the burst ends without a
+ * final packet, db_defer_timer has it rung from the sys workqueue.
+ *
+ * Must be called with sys->spinlock held.
+ */
+static int ipa3_send_queue(struct ipa3_sys_context *sys, u32 num_pkts,
+		u32 num_xfers, struct gsi_xfer_elem *gsi_xfer, bool xmit_more)
+{
+	bool ring_db;
+	int pending;
+
+	ring_db = !xmit_more ||
+		atomic_read(&sys->db_pending) + num_pkts >= IPA_TX_DB_BATCH_MAX;
+
 	IPADBG_LOW("ch:%lu queue xfer\n", sys->ep->gsi_chan_hdl);
-	result = gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_desc,
-			gsi_xfer, true);
-	if (result != GSI_STATUS_SUCCESS) {
-		IPAERR_RL("GSI xfer failed.\n");
-		result = -EFAULT;
-		goto failure;
+	if (gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_xfers, gsi_xfer,
+		ring_db) != GSI_STATUS_SUCCESS)
+		return -EFAULT;
+
+	if (ring_db) {
+		pending = atomic_xchg(&sys->db_pending, 0);
+		if (pending)
+			hrtimer_try_to_cancel(&sys->db_defer_timer);
+		ipa3_tx_batch_account(sys, pending + num_pkts);
+		return 0;
 	}
 
+	sys->tx_batch.deferred += num_pkts;
+	/* first deferred packet arms the bound */
+	if (atomic_add_return(num_pkts, &sys->db_pending) == num_pkts)
+		hrtimer_start(&sys->db_defer_timer,
+			ktime_set(0, IPA_TX_DB_DEFER_DELAY_NS),
+			HRTIMER_MODE_REL);
+
+	return 0;
+}
+
+/*
+ * ipa3_send_unlock() - Drop sys->spinlock after a successful send and
+ * schedule the NOP descriptor if the last packet went out without EOT
+ */
+static void ipa3_send_unlock(struct ipa3_sys_context *sys, bool send_nop)
+{
 	if (send_nop && !sys->nop_pending)
 		sys->nop_pending = true;
 	else
 		send_nop = false;
 
-	sys->pkt_sent++;
 	spin_unlock_bh(&sys->spinlock);
 
 	/* set the timer for sending the NOP descriptor */
@@ -813,40 +905,72 @@ int ipa3_send(struct ipa3_sys_context *sys,
 
 	/* make sure TAG process is sent before clocks are gated */
 	ipa3_ctx->tag_process_before_gating = true;
+}
 
-	return 0;
+static int __ipa3_send(struct ipa3_sys_context *sys, u32 num_desc,
+		struct ipa3_desc *desc, bool xmit_more)
+{
+	struct gsi_xfer_elem gsi_xfer[IPA_SEND_MAX_DESC];
+	bool send_nop = false;
+	int result;
 
-failure_dma_map:
-	kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache, tx_pkt);
+	result = ipa3_send_check(sys, num_desc);
+	if (result)
+		return result;
 
-failure:
-	ipahal_destroy_imm_cmd(tag_pyld_ret);
-	tx_pkt = tx_pkt_first;
-	for (j = 0; j < i; j++) {
-		next_pkt = list_next_entry(tx_pkt, link);
-		list_del(&tx_pkt->link);
-		sys->len--;
+	spin_lock_bh(&sys->spinlock);
 
-		if (!tx_pkt->no_unmap_dma) {
-			if (desc[j].type != IPA_DATA_DESC_SKB_PAGED) {
-				dma_unmap_single(ipa3_ctx->pdev,
-					tx_pkt->mem.phys_base,
-					tx_pkt->mem.size, DMA_TO_DEVICE);
-			} else {
-				dma_unmap_page(ipa3_ctx->pdev,
-					tx_pkt->mem.phys_base,
-					tx_pkt->mem.size,
-					DMA_TO_DEVICE);
-			}
-		}
-		kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache, tx_pkt);
-		tx_pkt = next_pkt;
+	if (unlikely(atomic_read(&sys->ep->disconnect_in_progress))) {
+		IPAERR("Pipe disconnect in progress dropping the packet\n");
+		spin_unlock_bh(&sys->spinlock);
+		return -EFAULT;
 	}
 
+	result = ipa3_send_prep(sys, num_desc, desc, gsi_xfer, &send_nop);
+	if (result)
+		goto failure;
+
+	result = ipa3_send_queue(sys, 1, num_desc, gsi_xfer, xmit_more);
+	if (result) {
+		IPAERR_RL("GSI xfer failed.\n");
+		ipa3_send_unwind(sys, num_desc);
+		sys->pkt_sent--;
+		goto failure;
+	}
+
+	ipa3_send_unlock(sys, send_nop);
+	return 0;
+
+failure:
 	spin_unlock_bh(&sys->spinlock);
 	return result;
 }
 
+/**
+ * ipa3_send() - Send multiple descriptors in one HW transaction
+ * @sys: system pipe context
+ * @num_desc: number of packets
+ * @desc: packets to send (may be immediate command or data)
+ * @in_atomic:  whether caller is in atomic context
+ *
+ * This function is used for GPI connection.
+ * - ipa3_tx_pkt_wrapper will be used for each ipa
+ *   descriptor (allocated from wrappers cache)
+ * - The wrapper struct will be configured for each ipa-desc payload and will
+ *   contain information which will be later used by the user callbacks
+ * - Each packet (command or data) that will be sent will also be saved in
+ *   ipa3_sys_context for later check that all data was sent
+ *
+ * Return codes: 0: success, -EFAULT: failure
+ */
+int ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool in_atomic)
+{
+	return __ipa3_send(sys, num_desc, desc, false);
+}
+
 /**
  * ipa3_send_one() - Send a single descriptor
  * @sys:	system pipe context
@@ -1260,6 +1384,45 @@ enum hrtimer_restart ipa3_ring_doorbell_timer_fn(struct hrtimer *param)
 	return HRTIMER_NORESTART;
 }
 
+/*
+ * ring the doorbell for TREs queued with xmit_more, if any
+ *
+ * Must be called with sys->spinlock held.
+ */
+static bool ipa3_tx_db_flush(struct ipa3_sys_context *sys)
+{
+	int pending;
+
+	pending = atomic_xchg(&sys->db_pending, 0);
+	if (!pending)
+		return false;
+
+	gsi_queue_xfer(sys->ep->gsi_chan_hdl, 0, NULL, true);
+	ipa3_tx_batch_account(sys, pending);
+	return true;
+}
+
+static void ipa3_tx_db_defer_work_fn(struct work_struct *work)
+{
+	struct ipa3_sys_context *sys = container_of(work,
+		struct ipa3_sys_context, db_defer_work);
+
+	/* the burst ended with xmit_more set, flush what is queued */
+	spin_lock_bh(&sys->spinlock);
+	if (ipa3_tx_db_flush(sys))
+		IPA_STATS_INC_CNT(sys->tx_batch.timer_flush);
+	spin_unlock_bh(&sys->spinlock);
+}
+
+static enum hrtimer_restart ipa3_tx_db_defer_timer_fn(struct hrtimer *param)
+{
+	struct ipa3_sys_context *sys = container_of(param,
+		struct ipa3_sys_context, db_defer_timer);
+
+	queue_work(sys->wq, &sys->db_defer_work);
+	return HRTIMER_NORESTART;
+}
+
 static void ipa_pm_sys_pipe_cb(void *p, enum ipa_pm_cb_event event)
 {
 	struct ipa3_sys_context *sys = (struct ipa3_sys_context *)p;
@@ -1534,6 +1697,11 @@ int ipa_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 		hrtimer_init(&ep->sys->db_timer, CLOCK_MONOTONIC,
 			HRTIMER_MODE_REL);
 		ep->sys->db_timer.function = ipa3_ring_doorbell_timer_fn;
+		hrtimer_init(&ep->sys->db_defer_timer, CLOCK_MONOTONIC,
+			HRTIMER_MODE_REL);
+		ep->sys->db_defer_timer.function = ipa3_tx_db_defer_timer_fn;
+		INIT_WORK(&ep->sys->db_defer_work, ipa3_tx_db_defer_work_fn);
+		atomic_set(&ep->sys->db_pending, 0);
 
 		/* create IPA PM resources for handling polling mode */
 		if (sys_in->client == IPA_CLIENT_APPS_WAN_CONS &&
@@ -1650,6 +1818,7 @@ int ipa_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 			&ep->sys->napi_rx, ipa3_rmnet_ll_rx_poll, NAPI_WEIGHT);
 #endif
 		napi_enable(&ep->sys->napi_rx);
+		ipa3_rmnet_ll_busy_poll_attach(ep->sys);
 	}
 
 	ep->client = sys_in->client;
@@ -1762,6 +1931,9 @@ int ipa_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 							IPA_GENERIC_RX_PAGE_POOL_SZ_FACTOR;
 				IPADBG("Page repl capacity for client:%d, value:%d\n",
 						   sys_in->client, ep->sys->page_recycle_repl->capacity);
+				/* Room for one more ring of adopted temp pages */
+				ep->sys->page_recycle_repl->adopt_max =
+					ep->sys->rx_pool_sz + 1;
 				INIT_LIST_HEAD(&ep->sys->page_recycle_repl->page_repl_head);
 				INIT_DELAYED_WORK(&ep->sys->freepage_work, ipa3_schd_freepage_work);
 				tasklet_init(&ep->sys->tasklet_find_freepage,
@@ -1917,6 +2089,7 @@ fail_page_recycle_repl:
 	}
 fail_napi:
 	if (sys_in->client == IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS) {
+		ipa3_rmnet_ll_busy_poll_detach(ep->sys);
 		napi_disable(&ep->sys->napi_rx);
 		netif_napi_del(&ep->sys->napi_rx);
 	}
@@ -1988,9 +2161,23 @@ int ipa_teardown_sys_pipe(u32 clnt_hdl)
 	ipa3_disable_data_path(clnt_hdl);
 
 	if (IPA_CLIENT_IS_PROD(ep->client)) {
+		spin_lock_bh(&ep->sys->spinlock);
+		atomic_set(&ep->disconnect_in_progress, 1);
+		spin_unlock_bh(&ep->sys->spinlock);
+
+		/*
+		 * No send can arm the deferred doorbell any more. Stop it and
+		 * ring for whatever it still held, so the drain below can
+		 * complete and nothing rings the channel once it is stopped.
+		 */
+		hrtimer_cancel(&ep->sys->db_defer_timer);
+		cancel_work_sync(&ep->sys->db_defer_work);
+		spin_lock_bh(&ep->sys->spinlock);
+		ipa3_tx_db_flush(ep->sys);
+		spin_unlock_bh(&ep->sys->spinlock);
+
 		do {
 			spin_lock_bh(&ep->sys->spinlock);
-			atomic_set(&ep->disconnect_in_progress, 1);
 			empty = list_empty(&ep->sys->head_desc_list);
 			spin_unlock_bh(&ep->sys->spinlock);
 			if (!empty)
@@ -2009,6 +2196,7 @@ int ipa_teardown_sys_pipe(u32 clnt_hdl)
 	}
 
 	if(ep->client == IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS) {
+		ipa3_rmnet_ll_busy_poll_detach(ep->sys);
 		napi_disable(&ep->sys->napi_rx);
 		netif_napi_del(&ep->sys->napi_rx);
 	}
@@ -2314,6 +2502,7 @@ int ipa_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 	const struct ipa_gsi_ep_config *gsi_ep;
 	int data_idx;
 	unsigned int max_desc;
+	bool xmit_more = meta && meta->xmit_more;
 
 	if (unlikely(!ipa3_ctx)) {
 		IPAERR("IPA3 driver was not initialized\n");
@@ -2477,7 +2666,7 @@ int ipa_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[skb_idx].callback = NULL;
 		}
 
-		if (ipa3_send(sys, num_frags + data_idx, desc, true)) {
+		if (__ipa3_send(sys, num_frags + data_idx, desc, xmit_more)) {
 			IPAERR_RL("fail to send skb %pK num_frags %u SWP\n",
 				skb, num_frags);
 			goto fail_send;
@@ -2508,7 +2697,7 @@ int ipa_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx].dma_address = meta->dma_address;
 		}
 		if (num_frags == 0) {
-			if (ipa3_send(sys, data_idx + 1, desc, true)) {
+			if (__ipa3_send(sys, data_idx + 1, desc, xmit_more)) {
 				IPAERR_RL("fail to send skb %pK HWP\n", skb);
 				goto fail_mem;
 			}
@@ -2527,8 +2716,8 @@ int ipa_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx+f].user2 = desc[data_idx].user2;
 			desc[data_idx].callback = NULL;
 
-			if (ipa3_send(sys, num_frags + data_idx + 1,
-				desc, true)) {
+			if (__ipa3_send(sys, num_frags + data_idx + 1,
+				desc, xmit_more)) {
 				IPAERR_RL("fail to send skb %pK num_frags %u\n",
 					skb, num_frags);
 				goto fail_mem;
@@ -2951,6 +3140,21 @@ int ipa_unregister_notifier(void *fn_ptr)
 }
 EXPORT_SYMBOL(ipa_unregister_notifier);
 
+static u32 ipa3_rx_page_stats_idx(struct ipa3_sys_context *sys)
+{
+	switch (sys->ep->client) {
+		case IPA_CLIENT_APPS_WAN_COAL_CONS:
+			return 0;
+		case IPA_CLIENT_APPS_WAN_CONS:
+			return 1;
+		case IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS:
+			return 2;
+		default:
+			IPAERR_RL("Unexpected client%d\n", sys->ep->client);
+	}
+	return 0;
+}
+
  static void ipa3_replenish_rx_page_recycle(struct ipa3_sys_context *sys)
 {
 	struct ipa3_rx_pkt_wrapper *rx_pkt;
@@ -2964,19 +3168,7 @@ EXPORT_SYMBOL(ipa_unregister_notifier);
 	/* start replenish only when buffers go lower than the threshold */
 	if (sys->rx_pool_sz - sys->len < IPA_REPL_XFER_THRESH)
 		return;
-	switch (sys->ep->client) {
-		case IPA_CLIENT_APPS_WAN_COAL_CONS:
-			stats_i = 0;
-			break;
-		case IPA_CLIENT_APPS_WAN_CONS:
-			stats_i = 1;
-			break;
-		case IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS:
-			stats_i = 2;
-			break;
-		default:
-			IPAERR_RL("Unexpected client%d\n", sys->ep->client);
-	}
+	stats_i = ipa3_rx_page_stats_idx(sys);
 
 	rx_len_cached = sys->len;
 	curr_wq = atomic_read(&sys->repl->head_idx);
@@ -5250,6 +5442,77 @@ static void ipa3_recycle_rx_page_wrapper(struct ipa3_rx_pkt_wrapper *rx_pkt)
 		kmem_cache_free(ipa3_ctx->rx_pkt_wrapper_cache, rx_pkt);
 }
 
+/**
+ * ipa3_rx_page_adopt() - Keep a temporary page in the recycle pool
+ * @rx_pkt: completed wrapper of a temporary page about to go up the stack
+ *
+ * The page keeps its wrapper and DMA mapping. The pool takes its own page
+ * reference, so the page turns free for ipa3_get_free_page() as soon as the
+ * stack releases it and is reused with a dma sync only.
+ *
+ * Only pages nobody else holds are adopted. rmnet_mem keeps a reference on
+ * the pages of its own pools, which would never read as free here.
+ *
+ * Returns true if the page was adopted and must not be unmapped.
+ */
+static bool ipa3_rx_page_adopt(struct ipa3_rx_pkt_wrapper *rx_pkt)
+{
+	struct ipa3_sys_context *sys = rx_pkt->sys;
+	struct ipa3_page_repl_ctx *pool = sys->page_recycle_repl;
+	bool adopted = false;
+
+	if (!pool || !sys->common_sys ||
+		rx_pkt->page_data.page_order != sys->page_order ||
+		page_ref_count(rx_pkt->page_data.page) != 1)
+		return false;
+
+	spin_lock_bh(&sys->common_sys->spinlock);
+	if (pool->adopted < pool->adopt_max) {
+		pool->adopted++;
+		rx_pkt->page_data.is_tmp_alloc = false;
+		page_ref_inc(rx_pkt->page_data.page);
+		/* Add the element back to tail. */
+		list_add_tail(&rx_pkt->link, &pool->page_repl_head);
+		adopted = true;
+	}
+	spin_unlock_bh(&sys->common_sys->spinlock);
+
+	if (adopted)
+		ipa3_ctx->stats.page_recycle_stats[
+			ipa3_rx_page_stats_idx(sys)].page_adopted++;
+
+	return adopted;
+}
+
+/**
+ * ipa3_get_rx_page_pool_occupancy() - Snapshot of a page recycling pipe
+ * @client: RX client
+ * @ring: buffers currently posted to the GSI ring
+ * @pool: pages owned by the recycle pool, allocated and adopted
+ */
+void ipa3_get_rx_page_pool_occupancy(enum ipa_client_type client,
+		u32 *ring, u32 *pool)
+{
+	struct ipa3_sys_context *sys;
+	int ep_idx;
+
+	*ring = 0;
+	*pool = 0;
+
+	ep_idx = ipa_get_ep_mapping(client);
+	if (ep_idx == -1 || !ipa3_ctx->ep[ep_idx].valid)
+		return;
+
+	sys = ipa3_ctx->ep[ep_idx].sys;
+	if (!sys)
+		return;
+
+	*ring = READ_ONCE(sys->len);
+	if (sys->page_recycle_repl)
+		*pool = sys->page_recycle_repl->capacity +
+			READ_ONCE(sys->page_recycle_repl->adopted);
+}
+
 /**
  * handle_skb_completion()- Handle event completion EOB or EOT and prep the skb
  *
@@ -5387,7 +5650,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 	if (notify->veid >= GSI_VEID_MAX) {
 		IPAERR("notify->veid > GSI_VEID_MAX\n");
 		if (!rx_page.is_tmp_alloc) {
-			init_page_count(rx_page.page);
+			page_ref_dec(rx_page.page);
 			spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
 			/* Add the element to head. */
 			list_add(&rx_pkt->link,
@@ -5419,7 +5682,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				size = rx_pkt->data_len;
 				list_del_init(&rx_pkt->link);
 				if (!rx_page.is_tmp_alloc) {
-					init_page_count(rx_page.page);
+					page_ref_dec(rx_page.page);
 					spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
 					/* Add the element to head. */
 					list_add(&rx_pkt->link,
@@ -5441,8 +5704,14 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 
 			list_del_init(&rx_pkt->link);
 			if (rx_page.is_tmp_alloc) {
-				dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
-					rx_pkt->len, DMA_FROM_DEVICE);
+				if (ipa3_rx_page_adopt(rx_pkt))
+					dma_sync_single_for_cpu(ipa3_ctx->pdev,
+						rx_page.dma_addr,
+						rx_pkt->len, DMA_FROM_DEVICE);
+				else
+					dma_unmap_page(ipa3_ctx->pdev,
+						rx_page.dma_addr,
+						rx_pkt->len, DMA_FROM_DEVICE);
 			} else {
 				spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
 				/* Add the element back to tail. */
@@ -5491,6 +5760,41 @@ static void ipa3_wq_rx_common(
 	}
 }
 
+/**
+ * ipa3_rx_prefetch() - warm the rx wrappers of upcoming completions
+ * @notify: the polled completions
+ * @i: index of the completion about to be handled
+ * @num: number of polled completions
+ *
+ * The wrapper IPA_RX_PREFETCH_DIST entries ahead is prefetched so its miss
+ * overlaps with the handling of the current packet. In page mode the page
+ * of the wrapper half way there, prefetched a few packets ago, is warmed
+ * as well since the completion takes a ref on it and adds it as a frag.
+ */
+static inline void ipa3_rx_prefetch(struct gsi_chan_xfer_notify *notify,
+	u32 i, u32 num)
+{
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+
+	if (i + IPA_RX_PREFETCH_DIST < num)
+		prefetch(notify[i + IPA_RX_PREFETCH_DIST].xfer_user_data);
+
+	if (ipa3_ctx->ipa_wan_skb_page &&
+		i + IPA_RX_PREFETCH_DIST / 2 < num) {
+		rx_pkt = notify[i + IPA_RX_PREFETCH_DIST / 2].xfer_user_data;
+		prefetchw(rx_pkt->page_data.page);
+	}
+}
+
+static void ipa3_rx_prefetch_start(struct gsi_chan_xfer_notify *notify,
+	u32 num)
+{
+	u32 i;
+
+	for (i = 0; i < num && i < IPA_RX_PREFETCH_DIST; i++)
+		prefetch(notify[i].xfer_user_data);
+}
+
 static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 		struct gsi_chan_xfer_notify *notify, uint32_t num)
 {
@@ -5499,12 +5803,15 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 	struct sk_buff *rx_skb, *first_skb = NULL, *prev_skb = NULL,
 		*second_skb = NULL;
 
+	ipa3_rx_prefetch_start(notify, num);
+
 	/* non-coalescing case (SKB chaining enabled) */
 	/* Chain is created as follows: first_skb->frag_list = second_skb
 	 * After that the next skb's are added to second_skb->next .i.e
 	 * first_skb->frag_list->next->next->next etc..*/
 	if (sys->ep->client != IPA_CLIENT_APPS_WAN_COAL_CONS) {
 		for (i = 0; i < num; i++) {
+			ipa3_rx_prefetch(notify, i, num);
 			if (!ipa3_ctx->ipa_wan_skb_page)
 				rx_skb = handle_skb_completion(
 					&notify[i], false, NULL);
@@ -5537,6 +5844,7 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 		if (!ipa3_ctx->ipa_wan_skb_page) {
 			/* TODO: add chaining for coal case */
 			for (i = 0; i < num; i++) {
+				ipa3_rx_prefetch(notify, i, num);
 				rx_skb = handle_skb_completion(
 					&notify[i], false, NULL);
 				if (rx_skb) {
@@ -5560,6 +5868,7 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 			}
 		} else {
 			for (i = 0; i < num; i++) {
+				ipa3_rx_prefetch(notify, i, num);
 				rx_skb = handle_page_completion(
 					&notify[i], false);
 
@@ -6426,6 +6735,9 @@ void __ipa_gsi_irq_rx_scedule_poll(struct ipa3_sys_context *sys)
 	bool clk_off = true;
 	enum ipa_client_type client_type;
 
+	if (sys->ep->client == IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS)
+		ipa3_ctx->ll_rx_poll.irq_ts = ktime_get();
+
 	atomic_set(&sys->curr_polling_state, 1);
 	__ipa3_update_curr_poll_state(sys->ep->client, 1);
 
@@ -7428,6 +7740,308 @@ start_poll:
 	IPA_ACTIVE_CLIENTS_DEC_EP_NO_BLOCK(sys->ep->client);
 }
 
+/*
+ * Busy poll of the low lat data pipe.
+ *
+ * The interrupt driven path pays for an IRQ, a softirq and a NAPI schedule
+ * before the first completion is looked at. With busy poll configured, a
+ * NAPI poll that found completions does not re-arm the channel interrupt:
+ * it completes NAPI with the channel left in polling mode and hands it to a
+ * thread bound to a dedicated CPU, which keeps scheduling NAPI there. Once
+ * no completion was seen for idle_us the next poll goes back to interrupts.
+ *
+ * The thread schedules NAPI with BHs disabled and the poll that leaves busy
+ * poll runs in the softirq of that same CPU, so the thread never schedules
+ * NAPI again after the channel was handed back to interrupts.
+ */
+static int ipa3_rmnet_ll_busy_poll_fn(void *data)
+{
+	struct ipa3_ll_rx_poll *ll = data;
+
+	for (;;) {
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (kthread_should_stop())
+			break;
+
+		if (kthread_should_park()) {
+			__set_current_state(TASK_RUNNING);
+			kthread_parkme();
+			continue;
+		}
+
+		if (!READ_ONCE(ll->spinning)) {
+			schedule();
+			continue;
+		}
+		__set_current_state(TASK_RUNNING);
+
+		local_bh_disable();
+		if (READ_ONCE(ll->spinning)) {
+			napi_schedule(&ll->sys->napi_rx);
+			ll->busy_polls++;
+		}
+		local_bh_enable();
+
+		cond_resched();
+	}
+	__set_current_state(TASK_RUNNING);
+
+	return 0;
+}
+
+/**
+ * ipa3_rmnet_ll_busy_poll_hold() - decide whether the channel stays polled
+ * @sys: low lat data consumer sys context
+ * @cnt: completions handled by this NAPI poll
+ *
+ * Called from the NAPI poll once NAPI is completed. Returns true when the
+ * channel is to be left in polling mode for the busy poll thread, false
+ * when it has to go back to interrupt mode.
+ */
+static bool ipa3_rmnet_ll_busy_poll_hold(struct ipa3_sys_context *sys,
+	int cnt)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	bool hold = false;
+	ktime_t now;
+
+	if (!READ_ONCE(ll->idle_us) && !READ_ONCE(ll->spinning))
+		return false;
+
+	now = ktime_get();
+	spin_lock(&ll->state_lock);
+	if (cnt > 0)
+		ll->last_active = now;
+
+	if (ll->thread && ll->sys == sys && ll->idle_us &&
+		ktime_us_delta(now, ll->last_active) < ll->idle_us) {
+		hold = true;
+		if (!ll->spinning) {
+			ll->spinning = true;
+			ll->busy_enter++;
+			wake_up_process(ll->thread);
+		}
+	} else if (ll->spinning) {
+		ll->spinning = false;
+		ll->busy_exit++;
+	}
+	spin_unlock(&ll->state_lock);
+
+	return hold;
+}
+
+/*
+ * Give a channel the busy poll thread was holding back to interrupts. The
+ * thread must no longer be able to schedule NAPI when this is called.
+ */
+static void ipa3_rmnet_ll_busy_poll_release(struct ipa3_sys_context *sys)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	bool was_spinning;
+
+	spin_lock_bh(&ll->state_lock);
+	was_spinning = ll->spinning;
+	if (was_spinning) {
+		ll->spinning = false;
+		ll->busy_exit++;
+	}
+	spin_unlock_bh(&ll->state_lock);
+
+	/* the next poll finds busy poll off and switches to intr mode */
+	if (was_spinning && sys) {
+		local_bh_disable();
+		napi_schedule(&sys->napi_rx);
+		local_bh_enable();
+	}
+}
+
+static void ipa3_rmnet_ll_busy_poll_attach(struct ipa3_sys_context *sys)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+
+	mutex_lock(&ll->lock);
+	ll->sys = sys;
+	if (ll->thread)
+		kthread_unpark(ll->thread);
+	mutex_unlock(&ll->lock);
+}
+
+static void ipa3_rmnet_ll_busy_poll_detach(struct ipa3_sys_context *sys)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+
+	mutex_lock(&ll->lock);
+	if (ll->sys != sys)
+		goto unlock;
+
+	if (ll->thread)
+		kthread_park(ll->thread);
+	spin_lock_bh(&ll->state_lock);
+	ll->sys = NULL;
+	spin_unlock_bh(&ll->state_lock);
+	ipa3_rmnet_ll_busy_poll_release(sys);
+unlock:
+	mutex_unlock(&ll->lock);
+}
+
+void ipa3_rmnet_ll_rx_poll_init(void)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+
+	mutex_init(&ll->lock);
+	spin_lock_init(&ll->state_lock);
+	ll->cpu = -1;
+}
+
+/**
+ * ipa3_rmnet_ll_set_busy_poll() - configure busy poll of the low lat pipe
+ * @cpu: CPU to busy poll on
+ * @idle_us: idle time after which interrupts are re-armed, 0 turns busy
+ * poll off
+ *
+ * Returns:	0 on success, negative on failure
+ */
+int ipa3_rmnet_ll_set_busy_poll(int cpu, u32 idle_us)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	struct task_struct *thread = NULL;
+	struct task_struct *old;
+	int ret = 0;
+
+	if (idle_us && (cpu < 0 || cpu >= nr_cpu_ids || !cpu_online(cpu))) {
+		IPAERR("invalid busy poll cpu %d\n", cpu);
+		return -EINVAL;
+	}
+
+	mutex_lock(&ll->lock);
+	if (ll->thread && idle_us && ll->cpu == cpu) {
+		WRITE_ONCE(ll->idle_us, idle_us);
+		goto unlock;
+	}
+
+	if (idle_us) {
+		thread = kthread_create(ipa3_rmnet_ll_busy_poll_fn, ll,
+			"ipa_ll_bpoll/%d", cpu);
+		if (IS_ERR(thread)) {
+			IPAERR("fail to create busy poll thread %ld\n",
+				PTR_ERR(thread));
+			ret = PTR_ERR(thread);
+			goto unlock;
+		}
+		kthread_bind(thread, cpu);
+		sched_set_fifo_low(thread);
+	}
+
+	/* stop the old thread before the channel is handed back */
+	spin_lock_bh(&ll->state_lock);
+	old = ll->thread;
+	ll->thread = NULL;
+	WRITE_ONCE(ll->idle_us, 0);
+	spin_unlock_bh(&ll->state_lock);
+	if (old) {
+		kthread_stop(old);
+		ipa3_rmnet_ll_busy_poll_release(ll->sys);
+	}
+
+	spin_lock_bh(&ll->state_lock);
+	ll->thread = thread;
+	ll->cpu = cpu;
+	WRITE_ONCE(ll->idle_us, idle_us);
+	spin_unlock_bh(&ll->state_lock);
+
+	if (thread) {
+		if (ll->sys)
+			wake_up_process(thread);
+		else
+			kthread_park(thread);
+	}
+
+	IPADBG("busy poll cpu=%d idle_us=%u\n", cpu, idle_us);
+unlock:
+	mutex_unlock(&ll->lock);
+	return ret;
+}
+
+/*
+ * GSI completions carry no timestamp on this channel, so the latency of a
+ * completion is taken from the host clock: from the interrupt that started
+ * polling, or from the previous look at the ring while polling, whichever
+ * is later, up to the point the completion was handed to the network stack.
+ */
+static u32 ipa3_rmnet_ll_lat_bucket(u64 ns)
+{
+	u32 msb;
+
+	if (ns < IPA_LL_LAT_SUB)
+		return ns;
+	if (ns > U32_MAX)
+		return IPA_LL_LAT_HIST_MAX - 1;
+
+	msb = fls64(ns) - 1;
+	return (msb - IPA_LL_LAT_SUB_BITS + 1) * IPA_LL_LAT_SUB +
+		((ns >> (msb - IPA_LL_LAT_SUB_BITS)) & (IPA_LL_LAT_SUB - 1));
+}
+
+/* smallest latency in ns that falls in a bucket */
+static u64 ipa3_rmnet_ll_lat_bucket_base(u32 bucket)
+{
+	u32 grp = bucket / IPA_LL_LAT_SUB;
+
+	if (!grp)
+		return bucket;
+
+	return (u64)(IPA_LL_LAT_SUB + bucket % IPA_LL_LAT_SUB) << (grp - 1);
+}
+
+static void ipa3_rmnet_ll_rx_lat_record(struct ipa3_ll_rx_poll *ll, int num)
+{
+	ktime_t now = ktime_get();
+	ktime_t ref = ktime_after(ll->irq_ts, ll->last_poll) ?
+		ll->irq_ts : ll->last_poll;
+	u64 ns = ktime_to_ns(ktime_sub(now, ref));
+
+	ll->lat_hist[ipa3_rmnet_ll_lat_bucket(ns)] += num;
+	ll->lat_samples += num;
+	if (ns > ll->lat_max)
+		ll->lat_max = ns;
+	ll->last_poll = now;
+}
+
+/**
+ * ipa3_rmnet_ll_rx_lat_quantile() - RX latency quantile of the low lat pipe
+ * @per_10k: quantile in units of 0.01%, e.g. 9990 for p99.9
+ *
+ * Returns:	upper bound in ns of the bucket holding the quantile, 0 when
+ * no completion was recorded
+ */
+u64 ipa3_rmnet_ll_rx_lat_quantile(u32 per_10k)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	u64 target, sum = 0;
+	u32 i;
+
+	if (!ll->lat_samples)
+		return 0;
+
+	target = DIV_ROUND_UP_ULL(ll->lat_samples * per_10k, 10000);
+	for (i = 0; i < IPA_LL_LAT_HIST_MAX - 1; i++) {
+		sum += ll->lat_hist[i];
+		if (sum >= target)
+			return ipa3_rmnet_ll_lat_bucket_base(i + 1) - 1;
+	}
+
+	return ll->lat_max;
+}
+
+void ipa3_rmnet_ll_rx_lat_reset(void)
+{
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+
+	ll->lat_samples = 0;
+	ll->lat_max = 0;
+	memset(ll->lat_hist, 0, sizeof(ll->lat_hist));
+}
+
 static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget)
 {
 	struct ipa3_sys_context *sys = container_of(napi_rx,
@@ -7463,11 +8077,14 @@ start_poll:
 		atomic_set(&ipa3_ctx->transport_pm.eot_activity, 1);
 		ret = ipa_poll_gsi_n_pkt(sys, notify,
 			remain_aggr_weight, &num);
-		if (ret)
+		if (ret) {
+			ipa3_ctx->ll_rx_poll.last_poll = ktime_get();
 			break;
+		}
 
 		trace_ipa3_napi_rx_poll_num(sys->ep->client, num);
 		ipa3_rx_napi_chain(sys, notify, num);
+		ipa3_rmnet_ll_rx_lat_record(&ipa3_ctx->ll_rx_poll, num);
 		remain_aggr_weight -= num;
 
 		trace_ipa3_napi_rx_poll_cnt(sys->ep->client, sys->len);
@@ -7488,6 +8105,9 @@ start_poll:
 	 */
 	if (cnt < budget && (sys->len > IPA_DEFAULT_SYS_YELLOW_WM)) {
 		napi_complete(napi_rx);
+		/* busy poll thread schedules the next poll, no intr re-arm */
+		if (ipa3_rmnet_ll_busy_poll_hold(sys, cnt))
+			return cnt;
 		ret = ipa3_rx_switch_to_intr_mode(sys);
 		if (ret == -GSI_STATUS_PENDING_IRQ &&
 				napi_reschedule(napi_rx))
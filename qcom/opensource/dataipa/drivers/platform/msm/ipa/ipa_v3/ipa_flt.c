@@ -109,10 +109,28 @@ static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
 					i);
 				ipahal_free_dma_mem(&tbl->curr_mem[rlt]);
 			}
+			tbl->sys_valid[rlt] = false;
 		}
 	}
 }
 
+/**
+ * ipa_flt_tbl_save_lcl_bdy() - keep a copy of a freshly generated local body
+ * @tbl: the flt tbl the body belongs to
+ * @rlt: the rule type of the body
+ * @bdy: the generated body inside the sram image
+ * @len: body length
+ *
+ * Same as for rt tables: the copy is only an optimization, losing it to an
+ * allocation failure costs a regeneration on the next commit.
+ */
+static void ipa_flt_tbl_save_lcl_bdy(struct ipa3_flt_tbl *tbl,
+	enum ipa_rule_type rlt, const u8 *bdy, u32 len)
+{
+	kfree(tbl->lcl_bdy[rlt]);
+	tbl->lcl_bdy[rlt] = len ? kmemdup(bdy, len, GFP_ATOMIC) : NULL;
+}
+
 /**
  * ipa_prep_flt_tbl_for_cmt() - preparing the flt table for commit
  *  assign priorities to the rules, calculate their sizes and calculate
@@ -194,6 +212,9 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram
  *
+ * Tables which did not change since the last commit reuse their sys body
+ * or the cached copy of their local body instead of being regenerated.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -211,6 +232,8 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	struct ipa3_flt_tbl *tbl;
 	int i;
 	int hdr_idx = 0;
+	u8 *tbl_bdy;
+	u32 bdy_len;
 
 	body_i = base;
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
@@ -221,7 +244,17 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			hdr_idx++;
 			continue;
 		}
-		if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+		bdy_len = tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width();
+		if ((tbl->in_sys[rlt] || tbl->force_sys[rlt]) &&
+			!tbl->dirty && tbl->sys_valid[rlt]) {
+			/* body is unchanged, only point the hdr at it */
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base, hdr, hdr_idx,
+				true)) {
+				IPAERR("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+		} else if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -261,6 +294,8 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
+			tbl->sys_valid[rlt] = true;
+			ipa_flt_tbl_save_lcl_bdy(tbl, rlt, NULL, 0);
 		} else {
 			offset = body_i - base + body_ofst;
 
@@ -271,18 +306,30 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_flt_rule_list,
-				link) {
-				if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa3_generate_flt_hw_rule(
-					ip, entry, body_i);
-				if (res) {
-					IPAERR("failed to gen HW FLT rule\n");
-					goto err;
+			tbl->sys_valid[rlt] = false;
+			if (!tbl->dirty && tbl->lcl_bdy[rlt]) {
+				memcpy(body_i, tbl->lcl_bdy[rlt], bdy_len);
+				body_i += bdy_len;
+			} else {
+				tbl_bdy = body_i;
+
+				/* generate the rule-set */
+				list_for_each_entry(entry,
+					&tbl->head_flt_rule_list, link) {
+					if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa3_generate_flt_hw_rule(
+						ip, entry, body_i);
+					if (res) {
+						IPAERR(
+						"failed to gen HW FLT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+
+				ipa_flt_tbl_save_lcl_bdy(tbl, rlt, tbl_bdy,
+					body_i - tbl_bdy);
 			}
 
 			/**
@@ -539,7 +586,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
-		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+		/* clean tables keep the sizes of the last commit */
+		if (tbl->dirty && ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
 			rc = -EPERM;
 			goto prep_failed;
 		}
@@ -849,6 +897,11 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			alloc_params.nhash_bdy.size);
 	}
 
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (ipa_is_ep_support_flt(i))
+			ipa3_ctx->flt_tbl[i][ip].dirty = false;
+	}
+
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
 
@@ -1011,6 +1064,7 @@ static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
 		tbl->rule_cnt++;
 	else
 		return -EINVAL;
+	tbl->dirty = true;
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt++;
 	id = ipa3_id_alloc(entry);
@@ -1138,6 +1192,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
@@ -1181,6 +1236,7 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 
 	entry->rule = frule->rule;
 	entry->rt_tbl = rt_tbl;
+	entry->tbl->dirty = true;
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt++;
 	entry->hw_len = 0;
@@ -1917,6 +1973,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					entry->ipacm_installed) {
 				list_del(&entry->link);
 				entry->tbl->rule_cnt--;
+				entry->tbl->dirty = true;
 				if (entry->rt_tbl &&
 					(!ipa3_check_idr_if_freed(
 						entry->rt_tbl)))
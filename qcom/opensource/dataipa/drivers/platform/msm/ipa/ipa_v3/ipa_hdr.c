@@ -4,6 +4,7 @@
  * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/sort.h>
 #include "ipa_i.h"
 #include "ipahal.h"
 
@@ -16,6 +17,9 @@ static const u32 ipa_hdr_proc_ctx_bin_sz[IPA_HDR_PROC_CTX_BIN_MAX] = { 32, 64};
 #define HDR_PROC_TYPE_IS_VALID(type) \
 	((type) >= 0 && (type) < IPA_HDR_PROC_MAX)
 
+/* free bytes in the SRAM header table worth a compaction pass */
+#define IPA_HDR_COMPACT_MIN_FREE 256
+
 /**
  * ipa3_generate_hdr_hw_tbl() - generates the headers table
  * @loc:	[in] storage type of the header table buffer (local or system)
@@ -55,6 +59,24 @@ alloc:
 				entry->hdr, entry->hdr_len);
 	}
 
+	if (!ipa3_ctx->hdr_tbl[loc].moving)
+		return 0;
+
+	/*
+	 * Relocated headers all sit in the SRAM list. Their old copy is kept
+	 * until the routing rules stop pointing at it.
+	 */
+	list_for_each_entry(entry,
+		&ipa3_ctx->hdr_tbl[HDR_TBL_LCL].head_hdr_entry_list, link) {
+		if (!entry->moved_from ||
+			entry->moved_from_lcl != (loc == HDR_TBL_LCL))
+			continue;
+		IPADBG_LOW("old copy of hdr of len %d ofst=%d\n",
+				entry->hdr_len, entry->moved_from->offset);
+		ipahal_cp_hdr_to_hw_buff(mem->base, entry->moved_from->offset,
+				entry->hdr, entry->hdr_len);
+	}
+
 	return 0;
 }
 
@@ -424,6 +446,345 @@ end:
 	return rc;
 }
 
+/* Starting from IPA4.5, HW supports larger headers. */
+static int ipa3_hdr_max_bin(void)
+{
+	return ipa3_ctx->ipa_hw_type >= IPA_HW_v4_5 ?
+		IPA_HDR_BIN5 : IPA_HDR_BIN4;
+}
+
+static int ipa3_hdr_len_to_bin(u32 hdr_len)
+{
+	int bin;
+
+	for (bin = IPA_HDR_BIN0; bin < IPA_HDR_BIN_MAX; bin++)
+		if (hdr_len <= ipa_hdr_bin_sz[bin])
+			break;
+
+	if (bin > ipa3_hdr_max_bin())
+		return -EINVAL;
+
+	return bin;
+}
+
+/*
+ * Only the 36 bytes bin is not a multiple of 8, so a range can be cut in
+ * bins exactly when its length is a multiple of 8, or when it is at least
+ * 36 bytes long.
+ */
+static bool ipa3_hdr_range_fits_bins(u32 len)
+{
+	return !(len % 8) || len >= ipa_hdr_bin_sz[IPA_HDR_BIN3];
+}
+
+/**
+ * ipa3_hdr_fill_free() - cover a range of a header table with free slots
+ * @htbl:	[in] header table
+ * @offset:	[in] start of the range
+ * @len:	[in] length of the range, see ipa3_hdr_range_fits_bins()
+ *
+ * Returns:	0 on success, negative on failure
+ */
+static int ipa3_hdr_fill_free(struct ipa3_hdr_tbl *htbl, u32 offset, u32 len)
+{
+	struct ipa_hdr_offset_entry *slot;
+	int max_bin = ipa3_hdr_max_bin();
+	int bin;
+
+	while (len) {
+		if (len % 8) {
+			bin = IPA_HDR_BIN3;
+		} else {
+			for (bin = max_bin; bin > IPA_HDR_BIN0; bin--)
+				if (ipa_hdr_bin_sz[bin] <= len &&
+					!(ipa_hdr_bin_sz[bin] % 8))
+					break;
+		}
+
+		slot = kmem_cache_zalloc(ipa3_ctx->hdr_offset_cache,
+					 GFP_KERNEL);
+		if (!slot) {
+			IPAERR("failed to alloc hdr offset object\n");
+			return -ENOMEM;
+		}
+		INIT_LIST_HEAD(&slot->link);
+		slot->offset = offset;
+		slot->bin = bin;
+		list_add_tail(&slot->link, &htbl->head_free_offset_list[bin]);
+
+		offset += ipa_hdr_bin_sz[bin];
+		len -= ipa_hdr_bin_sz[bin];
+	}
+
+	return 0;
+}
+
+/* give the free slots at the end of a header table back to the table */
+static void ipa3_hdr_trim_tail(struct ipa3_hdr_tbl *htbl)
+{
+	struct ipa_hdr_offset_entry *slot;
+	bool trimmed;
+	int bin;
+
+	do {
+		trimmed = false;
+		for (bin = IPA_HDR_BIN0; bin < IPA_HDR_BIN_MAX && !trimmed;
+			bin++) {
+			list_for_each_entry(slot,
+				&htbl->head_free_offset_list[bin], link) {
+				if (slot->offset + ipa_hdr_bin_sz[bin] !=
+					htbl->end)
+					continue;
+				htbl->end = slot->offset;
+				list_del(&slot->link);
+				kmem_cache_free(ipa3_ctx->hdr_offset_cache, slot);
+				trimmed = true;
+				break;
+			}
+		}
+	} while (trimmed);
+}
+
+static void ipa3_hdr_free_slot(struct ipa3_hdr_tbl *htbl,
+	struct ipa_hdr_offset_entry *slot)
+{
+	slot->ipacm_installed = false;
+	list_move(&slot->link, &htbl->head_free_offset_list[slot->bin]);
+	ipa3_hdr_trim_tail(htbl);
+}
+
+/**
+ * ipa3_hdr_take_free() - take the lowest free slot large enough for a bin
+ * @htbl:	[in] header table
+ * @bin:	[in] bin of the header to place
+ * @below:	[in] the slot has to start below this offset
+ *
+ * A larger slot is cut down to the bin when the rest of it can be binned
+ * exactly, otherwise it is used whole.
+ *
+ * Returns:	the slot, moved to the used list, or NULL
+ */
+static struct ipa_hdr_offset_entry *ipa3_hdr_take_free(
+	struct ipa3_hdr_tbl *htbl, int bin, u32 below)
+{
+	struct ipa_hdr_offset_entry *slot, *best = NULL;
+	u32 rest;
+	int b;
+
+	for (b = bin; b < IPA_HDR_BIN_MAX; b++)
+		list_for_each_entry(slot, &htbl->head_free_offset_list[b], link)
+			if (slot->offset < below &&
+				(!best || slot->offset < best->offset))
+				best = slot;
+
+	if (!best)
+		return NULL;
+
+	rest = ipa_hdr_bin_sz[best->bin] - ipa_hdr_bin_sz[bin];
+	if (rest && ipa3_hdr_range_fits_bins(rest) &&
+		!ipa3_hdr_fill_free(htbl, best->offset + ipa_hdr_bin_sz[bin],
+			rest))
+		best->bin = bin;
+
+	list_move(&best->link, &htbl->head_offset_list[best->bin]);
+	return best;
+}
+
+/**
+ * ipa3_hdr_alloc_slot() - allocate a slot in a header table
+ * @htbl:	[in] header table
+ * @bin:	[in] bin of the header to place
+ * @mem_size:	[in] size of the memory partition of the table
+ *
+ * A free slot of the bin is used first, then the table is grown, and when
+ * the partition is full a larger free slot is borrowed.
+ *
+ * Returns:	the slot, on the used list, or NULL when the table is full
+ */
+static struct ipa_hdr_offset_entry *ipa3_hdr_alloc_slot(
+	struct ipa3_hdr_tbl *htbl, int bin, u32 mem_size)
+{
+	struct ipa_hdr_offset_entry *slot;
+
+	if (!list_empty(&htbl->head_free_offset_list[bin])) {
+		/* get the first free slot */
+		slot = list_first_entry(&htbl->head_free_offset_list[bin],
+			struct ipa_hdr_offset_entry, link);
+		list_move(&slot->link, &htbl->head_offset_list[bin]);
+		return slot;
+	}
+
+	if (htbl->end + ipa_hdr_bin_sz[bin] > mem_size)
+		return ipa3_hdr_take_free(htbl, bin, U32_MAX);
+
+	slot = kmem_cache_zalloc(ipa3_ctx->hdr_offset_cache, GFP_KERNEL);
+	if (!slot) {
+		IPAERR("failed to alloc hdr offset object\n");
+		return NULL;
+	}
+	INIT_LIST_HEAD(&slot->link);
+	/*
+	 * for a first item grow, set the bin and offset which
+	 * are set in stone
+	 */
+	slot->offset = htbl->end;
+	slot->bin = bin;
+	htbl->end += ipa_hdr_bin_sz[bin];
+	list_add(&slot->link, &htbl->head_offset_list[bin]);
+
+	return slot;
+}
+
+static int ipa3_hdr_cmp_slot(const void *a, const void *b)
+{
+	const struct ipa_hdr_offset_entry *sa =
+		*(const struct ipa_hdr_offset_entry **)a;
+	const struct ipa_hdr_offset_entry *sb =
+		*(const struct ipa_hdr_offset_entry **)b;
+
+	if (sa->offset == sb->offset)
+		return 0;
+	return sa->offset < sb->offset ? -1 : 1;
+}
+
+/* merge adjacent free slots of a header table and re-bin them */
+static void ipa3_hdr_coalesce(struct ipa3_hdr_tbl *htbl)
+{
+	struct ipa_hdr_offset_entry **slots;
+	struct ipa_hdr_offset_entry *slot;
+	u32 num = 0, run_ofst, run_len;
+	u32 i, j, k;
+	int bin;
+
+	for (bin = IPA_HDR_BIN0; bin < IPA_HDR_BIN_MAX; bin++)
+		list_for_each_entry(slot, &htbl->head_free_offset_list[bin], link)
+			num++;
+
+	if (num < 2)
+		goto trim;
+
+	slots = kmalloc_array(num, sizeof(*slots), GFP_KERNEL);
+	if (!slots)
+		goto trim;
+
+	num = 0;
+	for (bin = IPA_HDR_BIN0; bin < IPA_HDR_BIN_MAX; bin++)
+		list_for_each_entry(slot, &htbl->head_free_offset_list[bin], link)
+			slots[num++] = slot;
+	sort(slots, num, sizeof(*slots), ipa3_hdr_cmp_slot, NULL);
+
+	for (i = 0; i < num; i = j) {
+		run_ofst = slots[i]->offset;
+		run_len = ipa_hdr_bin_sz[slots[i]->bin];
+		for (j = i + 1; j < num &&
+			slots[j]->offset == run_ofst + run_len; j++)
+			run_len += ipa_hdr_bin_sz[slots[j]->bin];
+
+		if (j - i < 2)
+			continue;
+
+		for (k = i; k < j; k++) {
+			list_del(&slots[k]->link);
+			kmem_cache_free(ipa3_ctx->hdr_offset_cache, slots[k]);
+		}
+		if (ipa3_hdr_fill_free(htbl, run_ofst, run_len))
+			IPAERR_RL("lost %u bytes of hdr tbl at %u\n",
+				run_len, run_ofst);
+	}
+
+	kfree(slots);
+trim:
+	ipa3_hdr_trim_tail(htbl);
+}
+
+/*
+ * A header that may be relocated: not the default header at offset 0, not
+ * the exception header and not one whose offset was handed out to a client.
+ */
+static bool ipa3_hdr_entry_movable(struct ipa3_hdr_entry *entry)
+{
+	return entry->offset_entry->offset && !entry->ofst_exported &&
+		entry->id != ipa3_ctx->excp_hdr_hdl;
+}
+
+/* free the slot a relocated header was copied from */
+static void ipa3_hdr_release_old_copy(struct ipa3_hdr_entry *entry)
+{
+	struct ipa3_hdr_tbl *htbl = entry->moved_from_lcl ?
+		&ipa3_ctx->hdr_tbl[HDR_TBL_LCL] :
+		&ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+
+	ipa3_hdr_free_slot(htbl, entry->moved_from);
+	entry->moved_from = NULL;
+	if (htbl->moving)
+		htbl->moving--;
+}
+
+/* give the free slots at the end of the proc ctx table back to the table */
+static void ipa3_hdr_proc_ctx_trim_tail(struct ipa3_hdr_proc_ctx_tbl *htbl)
+{
+	struct ipa3_hdr_proc_ctx_offset_entry *slot;
+	bool trimmed;
+	int bin;
+
+	do {
+		trimmed = false;
+		for (bin = IPA_HDR_PROC_CTX_BIN0;
+			bin < IPA_HDR_PROC_CTX_BIN_MAX && !trimmed; bin++) {
+			list_for_each_entry(slot,
+				&htbl->head_free_offset_list[bin], link) {
+				if (slot->offset + ipa_hdr_proc_ctx_bin_sz[bin] !=
+					htbl->end)
+					continue;
+				htbl->end = slot->offset;
+				list_del(&slot->link);
+				kmem_cache_free(
+					ipa3_ctx->hdr_proc_ctx_offset_cache,
+					slot);
+				trimmed = true;
+				break;
+			}
+		}
+	} while (trimmed);
+}
+
+static void ipa3_hdr_proc_ctx_free_slot(struct ipa3_hdr_proc_ctx_tbl *htbl,
+	struct ipa3_hdr_proc_ctx_offset_entry *slot)
+{
+	slot->ipacm_installed = false;
+	list_move(&slot->link, &htbl->head_free_offset_list[slot->bin]);
+	ipa3_hdr_proc_ctx_trim_tail(htbl);
+}
+
+/*
+ * Cut a free 64 bytes proc ctx slot in two 32 bytes ones. When that fails
+ * the 64 bytes slot is used whole.
+ */
+static struct ipa3_hdr_proc_ctx_offset_entry *ipa3_hdr_proc_ctx_split(
+	struct ipa3_hdr_proc_ctx_tbl *htbl)
+{
+	struct ipa3_hdr_proc_ctx_offset_entry *slot, *rest;
+
+	slot = list_first_entry(
+		&htbl->head_free_offset_list[IPA_HDR_PROC_CTX_BIN1],
+		struct ipa3_hdr_proc_ctx_offset_entry, link);
+
+	rest = kmem_cache_zalloc(ipa3_ctx->hdr_proc_ctx_offset_cache,
+				 GFP_KERNEL);
+	if (rest) {
+		INIT_LIST_HEAD(&rest->link);
+		rest->offset = slot->offset +
+			ipa_hdr_proc_ctx_bin_sz[IPA_HDR_PROC_CTX_BIN0];
+		rest->bin = IPA_HDR_PROC_CTX_BIN0;
+		list_add_tail(&rest->link,
+			&htbl->head_free_offset_list[IPA_HDR_PROC_CTX_BIN0]);
+		slot->bin = IPA_HDR_PROC_CTX_BIN0;
+	}
+
+	list_move(&slot->link, &htbl->head_offset_list[slot->bin]);
+	return slot;
+}
+
 static int __ipa_add_hdr_proc_ctx(struct ipa_hdr_proc_ctx_add *proc_ctx,
 	bool add_ref_hdr, bool user_only)
 {
@@ -493,12 +854,13 @@ static int __ipa_add_hdr_proc_ctx(struct ipa_hdr_proc_ctx_add *proc_ctx,
 	mem_size = (ipa3_ctx->hdr_proc_ctx_tbl_lcl) ?
 		IPA_MEM_PART(apps_hdr_proc_ctx_size) :
 		IPA_MEM_PART(apps_hdr_proc_ctx_size_ddr);
-	if (list_empty(&htbl->head_free_offset_list[bin])) {
-		if (htbl->end + ipa_hdr_proc_ctx_bin_sz[bin] > mem_size) {
-			IPAERR_RL("hdr proc ctx table overflow\n");
-			goto bad_len;
-		}
-
+	if (!list_empty(&htbl->head_free_offset_list[bin])) {
+		/* get the first free slot */
+		offset =
+		    list_first_entry(&htbl->head_free_offset_list[bin],
+				struct ipa3_hdr_proc_ctx_offset_entry, link);
+		list_move(&offset->link, &htbl->head_offset_list[bin]);
+	} else if (htbl->end + ipa_hdr_proc_ctx_bin_sz[bin] <= mem_size) {
 		offset = kmem_cache_zalloc(ipa3_ctx->hdr_proc_ctx_offset_cache,
 					   GFP_KERNEL);
 		if (!offset) {
@@ -512,18 +874,18 @@ static int __ipa_add_hdr_proc_ctx(struct ipa_hdr_proc_ctx_add *proc_ctx,
 		 */
 		offset->offset = htbl->end;
 		offset->bin = bin;
-		offset->ipacm_installed = user_only;
 		htbl->end += ipa_hdr_proc_ctx_bin_sz[bin];
 		list_add(&offset->link,
 				&htbl->head_offset_list[bin]);
+	} else if (bin == IPA_HDR_PROC_CTX_BIN0 && !list_empty(
+		&htbl->head_free_offset_list[IPA_HDR_PROC_CTX_BIN1])) {
+		/* table is full, borrow a free large slot */
+		offset = ipa3_hdr_proc_ctx_split(htbl);
 	} else {
-		/* get the first free slot */
-		offset =
-		    list_first_entry(&htbl->head_free_offset_list[bin],
-				struct ipa3_hdr_proc_ctx_offset_entry, link);
-		offset->ipacm_installed = user_only;
-		list_move(&offset->link, &htbl->head_offset_list[bin]);
+		IPAERR_RL("hdr proc ctx table overflow\n");
+		goto bad_len;
 	}
+	offset->ipacm_installed = user_only;
 
 	entry->offset_entry = offset;
 	list_add(&entry->link, &htbl->head_proc_ctx_entry_list);
@@ -544,8 +906,7 @@ static int __ipa_add_hdr_proc_ctx(struct ipa_hdr_proc_ctx_add *proc_ctx,
 	return 0;
 
 ipa_insert_failed:
-	list_move(&offset->link,
-		&htbl->head_free_offset_list[offset->bin]);
+	ipa3_hdr_proc_ctx_free_slot(htbl, offset);
 	entry->offset_entry = NULL;
 	list_del(&entry->link);
 	htbl->proc_ctx_cnt--;
@@ -563,7 +924,7 @@ static int __ipa_add_hdr(struct ipa_hdr_add *hdr, bool user,
 {
 	struct ipa3_hdr_entry *entry, *entry_t, *next;
 	struct ipa_hdr_offset_entry *offset = NULL;
-	u32 bin;
+	int bin;
 	struct ipa3_hdr_tbl *htbl;
 	int id;
 	int mem_size;
@@ -618,96 +979,41 @@ static int __ipa_add_hdr(struct ipa_hdr_add *hdr, bool user,
 		}
 	}
 
-	if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN0])
-		bin = IPA_HDR_BIN0;
-	else if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN1])
-		bin = IPA_HDR_BIN1;
-	else if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN2])
-		bin = IPA_HDR_BIN2;
-	else if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN3])
-		bin = IPA_HDR_BIN3;
-	else if (hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN4])
-		bin = IPA_HDR_BIN4;
-	/* Starting from IPA4.5, HW supports larger headers. */
-	else if ((hdr->hdr_len <= ipa_hdr_bin_sz[IPA_HDR_BIN5]) &&
-		 (ipa3_ctx->ipa_hw_type >= IPA_HW_v4_5))
-		 bin = IPA_HDR_BIN5;
-	else {
+	bin = ipa3_hdr_len_to_bin(hdr->hdr_len);
+	if (bin < 0) {
 		IPAERR_RL("unexpected hdr len %d\n", hdr->hdr_len);
 		goto bad_hdr_len;
 	}
 
-	htbl = entry->is_lcl ? &ipa3_ctx->hdr_tbl[HDR_TBL_LCL] : &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
-	mem_size = entry->is_lcl ? IPA_MEM_PART(apps_hdr_size) : IPA_MEM_PART(apps_hdr_size_ddr);
-
-	if (list_empty(&htbl->head_free_offset_list[bin])) {
-		/*
-		 * In case of a local header entry,
-		 * first iteration will check against SRAM partition space,
-		 * and the second iteration will check against DDR partition space.
-		 * In case of a system header entry, the loop will iterate only once,
-		 * and check against DDR partition space.
-		 */
-		while (htbl->end + ipa_hdr_bin_sz[bin] > mem_size) {
-			if (entry->is_lcl) {
-				/* if header does not fit to SRAM table, place it in DDR */
-				IPADBG_LOW("SRAM header table was full allocting DDR header table! Requested: %d Left: %d name %s, end %d\n",
-						ipa_hdr_bin_sz[bin], mem_size - htbl->end, entry->name, htbl->end);
-				htbl = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
-				mem_size = IPA_MEM_PART(apps_hdr_size_ddr);
-				entry->is_lcl = false;
-			}
-
-			/* check if DDR free list */
-			if (list_empty(&htbl->head_free_offset_list[bin])) {
-				if (!entry->is_lcl && (htbl->end + ipa_hdr_bin_sz[bin] > mem_size)) {
-					IPAERR("No space in DDR header buffer! Requested: %d Left: %d name %s, end %d\n",
-							ipa_hdr_bin_sz[bin], mem_size - htbl->end, entry->name, htbl->end);
-					goto bad_hdr_len;
-				}
-
-				IPADBG_LOW("No free offset in DDR allocating new offset Requested: %d Left: %d name %s, end %d\n",
-						ipa_hdr_bin_sz[bin], mem_size - htbl->end, entry->name, htbl->end);
-				goto create_entry;
-			} else {
-				/* get the first free slot */
-				offset = list_first_entry(&htbl->head_free_offset_list[bin],
-						struct ipa_hdr_offset_entry, link);
-				list_move(&offset->link, &htbl->head_offset_list[bin]);
-				entry->offset_entry = offset;
-				offset->ipacm_installed = user;
-				goto free_list;
-			}
+	/* a header spilled to DDR may be moved to SRAM by compaction */
+	entry->lcl_eligible = entry->is_lcl;
+	if (entry->is_lcl) {
+		htbl = &ipa3_ctx->hdr_tbl[HDR_TBL_LCL];
+		offset = ipa3_hdr_alloc_slot(htbl, bin,
+			IPA_MEM_PART(apps_hdr_size));
+		if (!offset) {
+			/* if header does not fit to SRAM table, place it in DDR */
+			IPADBG_LOW("SRAM header table was full allocting DDR header table! Requested: %d Left: %d name %s, end %d\n",
+					ipa_hdr_bin_sz[bin],
+					IPA_MEM_PART(apps_hdr_size) - htbl->end,
+					entry->name, htbl->end);
+			entry->is_lcl = false;
 		}
-create_entry:
-		offset = kmem_cache_zalloc(ipa3_ctx->hdr_offset_cache,
-					   GFP_KERNEL);
+	}
+
+	if (!entry->is_lcl) {
+		htbl = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+		mem_size = IPA_MEM_PART(apps_hdr_size_ddr);
+		offset = ipa3_hdr_alloc_slot(htbl, bin, mem_size);
 		if (!offset) {
-			IPAERR("failed to alloc hdr offset object\n");
+			IPAERR("No space in DDR header buffer! Requested: %d Left: %d name %s, end %d\n",
+					ipa_hdr_bin_sz[bin], mem_size - htbl->end,
+					entry->name, htbl->end);
 			goto bad_hdr_len;
 		}
-		INIT_LIST_HEAD(&offset->link);
-		/*
-		 * for a first item grow, set the bin and offset which
-		 * are set in stone
-		 */
-		offset->offset = htbl->end;
-		offset->bin = bin;
-		htbl->end += ipa_hdr_bin_sz[bin];
-		list_add(&offset->link,
-				&htbl->head_offset_list[bin]);
-		entry->offset_entry = offset;
-		offset->ipacm_installed = user;
-	} else {
-		/* get the first free slot */
-		offset = list_first_entry(&htbl->head_free_offset_list[bin],
-			struct ipa_hdr_offset_entry, link);
-		list_move(&offset->link, &htbl->head_offset_list[bin]);
-		entry->offset_entry = offset;
-		offset->ipacm_installed = user;
 	}
-
-free_list:
+	entry->offset_entry = offset;
+	offset->ipacm_installed = user;
 
 	list_add(&entry->link, &htbl->head_hdr_entry_list);
 	htbl->hdr_cnt++;
@@ -732,9 +1038,7 @@ free_list:
 	return 0;
 
 ipa_insert_failed:
-	if (offset)
-		list_move(&offset->link,
-			  &htbl->head_free_offset_list[offset->bin]);
+	ipa3_hdr_free_slot(htbl, offset);
 	entry->offset_entry = NULL;
 	htbl->hdr_cnt--;
 	list_del(&entry->link);
@@ -779,8 +1083,7 @@ static int __ipa3_del_hdr_proc_ctx(u32 proc_ctx_hdl,
 		__ipa3_del_hdr(entry->hdr->id, false);
 
 	/* move the offset entry to appropriate free list */
-	list_move(&entry->offset_entry->link,
-		&htbl->head_free_offset_list[entry->offset_entry->bin]);
+	ipa3_hdr_proc_ctx_free_slot(htbl, entry->offset_entry);
 	list_del(&entry->link);
 	htbl->proc_ctx_cnt--;
 	entry->cookie = 0;
@@ -867,10 +1170,13 @@ int __ipa3_del_hdr(u32 hdr_hdl, bool by_user)
 
 	if (entry->proc_ctx)
 		__ipa3_del_hdr_proc_ctx(entry->proc_ctx->id, false, false);
-	else
-		/* move the offset entry to appropriate free list */
-		list_move(&entry->offset_entry->link,
-			&htbl->head_free_offset_list[entry->offset_entry->bin]);
+
+	/* no rule refers to the header any more, drop a pending old copy */
+	if (entry->moved_from)
+		ipa3_hdr_release_old_copy(entry);
+
+	/* move the offset entry to appropriate free list */
+	ipa3_hdr_free_slot(htbl, entry->offset_entry);
 	list_del(&entry->link);
 	htbl->hdr_cnt--;
 	entry->cookie = 0;
@@ -1235,6 +1541,292 @@ int ipa3_del_hdr_proc_ctx(struct ipa_ioc_del_hdr_proc_ctx *hdls)
 }
 EXPORT_SYMBOL(ipa3_del_hdr_proc_ctx);
 
+static void __ipa3_get_hdr_mem_stats(enum hdr_tbl_storage loc,
+	struct ipa3_hdr_mem_stats *stats)
+{
+	struct ipa3_hdr_tbl *htbl = &ipa3_ctx->hdr_tbl[loc];
+	struct ipa_hdr_offset_entry *slot;
+	int bin;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->size = (loc == HDR_TBL_LCL) ? IPA_MEM_PART(apps_hdr_size) :
+		IPA_MEM_PART(apps_hdr_size_ddr);
+	stats->end = htbl->end;
+
+	for (bin = IPA_HDR_BIN0; bin < IPA_HDR_BIN_MAX; bin++) {
+		list_for_each_entry(slot, &htbl->head_offset_list[bin], link)
+			stats->used += ipa_hdr_bin_sz[bin];
+		list_for_each_entry(slot, &htbl->head_free_offset_list[bin],
+			link) {
+			stats->free += ipa_hdr_bin_sz[bin];
+			stats->free_slots[bin]++;
+			stats->largest_free = max(stats->largest_free,
+				ipa_hdr_bin_sz[bin]);
+		}
+	}
+}
+
+/**
+ * ipa3_get_hdr_mem_stats() - get the space usage of a header table
+ * @loc:	[in] storage type of the header table (local or system)
+ * @stats:	[out] space usage, in bytes
+ *
+ * Note:	Should not be called from atomic context
+ */
+void ipa3_get_hdr_mem_stats(enum hdr_tbl_storage loc,
+	struct ipa3_hdr_mem_stats *stats)
+{
+	mutex_lock(&ipa3_ctx->lock);
+	__ipa3_get_hdr_mem_stats(loc, stats);
+	mutex_unlock(&ipa3_ctx->lock);
+}
+
+/**
+ * ipa3_get_hdr_proc_ctx_mem_stats() - get the space usage of the header
+ * processing context table
+ * @stats:	[out] space usage, in bytes
+ *
+ * Note:	Should not be called from atomic context
+ */
+void ipa3_get_hdr_proc_ctx_mem_stats(struct ipa3_hdr_mem_stats *stats)
+{
+	struct ipa3_hdr_proc_ctx_tbl *htbl = &ipa3_ctx->hdr_proc_ctx_tbl;
+	struct ipa3_hdr_proc_ctx_offset_entry *slot;
+	int bin;
+
+	memset(stats, 0, sizeof(*stats));
+
+	mutex_lock(&ipa3_ctx->lock);
+	stats->size = (ipa3_ctx->hdr_proc_ctx_tbl_lcl) ?
+		IPA_MEM_PART(apps_hdr_proc_ctx_size) :
+		IPA_MEM_PART(apps_hdr_proc_ctx_size_ddr);
+	stats->end = htbl->end;
+
+	for (bin = IPA_HDR_PROC_CTX_BIN0; bin < IPA_HDR_PROC_CTX_BIN_MAX;
+		bin++) {
+		list_for_each_entry(slot, &htbl->head_offset_list[bin], link)
+			stats->used += ipa_hdr_proc_ctx_bin_sz[bin];
+		list_for_each_entry(slot, &htbl->head_free_offset_list[bin],
+			link) {
+			stats->free += ipa_hdr_proc_ctx_bin_sz[bin];
+			stats->free_slots[bin]++;
+			stats->largest_free = max(stats->largest_free,
+				ipa_hdr_proc_ctx_bin_sz[bin]);
+		}
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+}
+
+/*
+ * Worth compacting when a header spilled to DDR fits in SRAM again, or when
+ * a large part of the SRAM table is made of holes. No new pass is started
+ * while relocated headers still wait for their old copy to be released.
+ */
+static bool ipa3_hdr_want_compact(void)
+{
+	struct ipa3_hdr_tbl *lcl = &ipa3_ctx->hdr_tbl[HDR_TBL_LCL];
+	struct ipa3_hdr_tbl *sys = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+	struct ipa3_hdr_mem_stats stats;
+	struct ipa3_hdr_entry *entry;
+	u32 room;
+
+	if (lcl->moving || sys->moving)
+		return false;
+
+	if (!IPA_MEM_PART(apps_hdr_size))
+		return false;
+
+	__ipa3_get_hdr_mem_stats(HDR_TBL_LCL, &stats);
+	room = max(stats.largest_free, stats.size - stats.end);
+
+	list_for_each_entry(entry, &sys->head_hdr_entry_list, link)
+		if (entry->lcl_eligible && ipa3_hdr_entry_movable(entry) &&
+			ipa_hdr_bin_sz[entry->offset_entry->bin] <= room)
+			return true;
+
+	return stats.free >= IPA_HDR_COMPACT_MIN_FREE &&
+		stats.free * 4 >= stats.end;
+}
+
+static int ipa3_hdr_cmp_entry_desc(const void *a, const void *b)
+{
+	const struct ipa3_hdr_entry *ea = *(const struct ipa3_hdr_entry **)a;
+	const struct ipa3_hdr_entry *eb = *(const struct ipa3_hdr_entry **)b;
+
+	if (ea->offset_entry->offset == eb->offset_entry->offset)
+		return 0;
+	return ea->offset_entry->offset > eb->offset_entry->offset ? -1 : 1;
+}
+
+/* give a relocated header its own slot back */
+static void ipa3_hdr_undo_move(struct ipa3_hdr_entry *entry)
+{
+	struct ipa3_hdr_tbl *lcl = &ipa3_ctx->hdr_tbl[HDR_TBL_LCL];
+	struct ipa3_hdr_tbl *sys = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+	struct ipa_hdr_offset_entry *slot = entry->offset_entry;
+
+	entry->offset_entry = entry->moved_from;
+	entry->moved_from = NULL;
+	ipa3_hdr_free_slot(lcl, slot);
+
+	if (!entry->moved_from_lcl) {
+		entry->is_lcl = false;
+		list_move(&entry->link, &sys->head_hdr_entry_list);
+		lcl->hdr_cnt--;
+		sys->hdr_cnt++;
+	}
+}
+
+/* the rt rules point at the new slots, drop the old copies */
+static void ipa3_hdr_finish_move(void)
+{
+	struct ipa3_hdr_tbl *lcl = &ipa3_ctx->hdr_tbl[HDR_TBL_LCL];
+	struct ipa3_hdr_tbl *sys = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+	struct ipa3_hdr_compact_stats *cstats = &ipa3_ctx->hdr_compact;
+	struct ipa3_hdr_entry *entry;
+
+	list_for_each_entry(entry, &lcl->head_hdr_entry_list, link) {
+		if (!entry->moved_from)
+			continue;
+		if (entry->moved_from_lcl)
+			cstats->moved++;
+		else
+			cstats->promoted++;
+		ipa3_hdr_release_old_copy(entry);
+	}
+	lcl->moving = 0;
+	sys->moving = 0;
+	ipa3_hdr_coalesce(lcl);
+	ipa3_hdr_coalesce(sys);
+	cstats->runs++;
+}
+
+/**
+ * ipa3_hdr_rt_committed() - the rt tables of a family reached IPA HW
+ * @ip: the ip address family type
+ *
+ * Releases the old copies of the relocated headers once every family whose
+ * rules pointed at them was committed.
+ *
+ * Note: Called with ipa3_ctx->lock held
+ */
+void ipa3_hdr_rt_committed(enum ipa_ip_type ip)
+{
+	if (!ipa3_ctx->hdr_rt_pending)
+		return;
+
+	ipa3_ctx->hdr_rt_pending &= ~BIT(ip);
+	if (!ipa3_ctx->hdr_rt_pending)
+		ipa3_hdr_finish_move();
+}
+
+/*
+ * Slide the movable SRAM headers down into the holes, highest offset first,
+ * and bring back the headers that spilled to DDR.
+ *
+ * A relocated header is written at both places until the routing tables
+ * pointing at it are committed with the new offset. Those tables are only
+ * marked dirty here: they are rewritten by the next routing commit of their
+ * family, so that rules added without a commit are not pushed to HW behind
+ * the caller's back. The old slots are freed from ipa3_hdr_rt_committed().
+ */
+static int __ipa3_compact_hdr(void)
+{
+	struct ipa3_hdr_tbl *lcl = &ipa3_ctx->hdr_tbl[HDR_TBL_LCL];
+	struct ipa3_hdr_tbl *sys = &ipa3_ctx->hdr_tbl[HDR_TBL_SYS];
+	struct ipa3_hdr_compact_stats *cstats = &ipa3_ctx->hdr_compact;
+	struct ipa3_hdr_entry **entries;
+	struct ipa3_hdr_entry *entry, *next;
+	struct ipa_hdr_offset_entry *slot;
+	u32 num = 0, i;
+	int bin;
+
+	/* the previous pass waits for the rt commits */
+	if (lcl->moving || sys->moving)
+		return 0;
+
+	if (!IPA_MEM_PART(apps_hdr_size))
+		return 0;
+
+	ipa3_hdr_coalesce(lcl);
+
+	entries = kmalloc_array(lcl->hdr_cnt ? : 1, sizeof(*entries),
+		GFP_KERNEL);
+	if (!entries) {
+		IPAERR("failed to alloc hdr compaction array\n");
+		return -ENOMEM;
+	}
+
+	list_for_each_entry(entry, &lcl->head_hdr_entry_list, link)
+		if (num < lcl->hdr_cnt && ipa3_hdr_entry_movable(entry))
+			entries[num++] = entry;
+	sort(entries, num, sizeof(*entries), ipa3_hdr_cmp_entry_desc, NULL);
+
+	for (i = 0; i < num; i++) {
+		entry = entries[i];
+		bin = ipa3_hdr_len_to_bin(entry->hdr_len);
+		slot = ipa3_hdr_take_free(lcl, bin,
+			entry->offset_entry->offset);
+		if (!slot)
+			continue;
+		slot->ipacm_installed = entry->offset_entry->ipacm_installed;
+		entry->moved_from = entry->offset_entry;
+		entry->moved_from_lcl = true;
+		entry->offset_entry = slot;
+		lcl->moving++;
+	}
+	kfree(entries);
+
+	list_for_each_entry_safe(entry, next, &sys->head_hdr_entry_list, link) {
+		if (!entry->lcl_eligible || !ipa3_hdr_entry_movable(entry))
+			continue;
+		bin = ipa3_hdr_len_to_bin(entry->hdr_len);
+		slot = ipa3_hdr_alloc_slot(lcl, bin,
+			IPA_MEM_PART(apps_hdr_size));
+		if (!slot)
+			continue;
+		slot->ipacm_installed = entry->offset_entry->ipacm_installed;
+		entry->moved_from = entry->offset_entry;
+		entry->moved_from_lcl = false;
+		entry->offset_entry = slot;
+		entry->is_lcl = true;
+		list_move(&entry->link, &lcl->head_hdr_entry_list);
+		sys->hdr_cnt--;
+		lcl->hdr_cnt++;
+		sys->moving++;
+	}
+
+	if (!lcl->moving && !sys->moving)
+		return 0;
+
+	IPADBG("relocating %u SRAM hdrs, promoting %u DDR hdrs\n",
+		lcl->moving, sys->moving);
+
+	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
+		IPAERR_RL("fail to commit compacted hdr tbl\n");
+		list_for_each_entry_safe(entry, next,
+			&lcl->head_hdr_entry_list, link)
+			if (entry->moved_from)
+				ipa3_hdr_undo_move(entry);
+		lcl->moving = 0;
+		sys->moving = 0;
+		cstats->failed++;
+		return -EPERM;
+	}
+
+	ipa3_ctx->hdr_rt_pending = 0;
+	if (ipa3_set_rt_tbls_hdr_moved(IPA_IP_v4))
+		ipa3_ctx->hdr_rt_pending |= BIT(IPA_IP_v4);
+	if (ipa3_set_rt_tbls_hdr_moved(IPA_IP_v6))
+		ipa3_ctx->hdr_rt_pending |= BIT(IPA_IP_v6);
+
+	/* no rule points at a relocated header */
+	if (!ipa3_ctx->hdr_rt_pending)
+		ipa3_hdr_finish_move();
+
+	return 0;
+}
+
 /**
  * ipa3_commit_hdr() - commit to IPA HW the current header table in SW
  *
@@ -1260,6 +1852,11 @@ int ipa3_commit_hdr(void)
 		result = -EPERM;
 		goto bail;
 	}
+
+	/* failing to compact leaves a valid, if fragmented, table */
+	if (ipa3_hdr_want_compact())
+		__ipa3_compact_hdr();
+
 	result = 0;
 bail:
 	mutex_unlock(&ipa3_ctx->lock);
@@ -1267,6 +1864,27 @@ bail:
 }
 EXPORT_SYMBOL(ipa3_commit_hdr);
 
+/**
+ * ipa3_compact_hdr() - compact the header table and commit it to IPA HW
+ *
+ * The old copies of the relocated headers are kept until the next routing
+ * commit of the families that point at them.
+ *
+ * Returns:	0 on success, negative on failure
+ *
+ * Note:	Should not be called from atomic context
+ */
+int ipa3_compact_hdr(void)
+{
+	int result;
+
+	mutex_lock(&ipa3_ctx->lock);
+	result = __ipa3_compact_hdr();
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return result;
+}
+
 /**
  * ipa3_reset_hdr() - reset the current header table in SW (does not commit to
  * HW)
@@ -1328,10 +1946,10 @@ int ipa3_reset_hdr(bool user_only)
 					entry->proc_ctx = NULL;
 				}
 				/* move the offset entry to free list */
-				entry->offset_entry->ipacm_installed = false;
-				list_move(&entry->offset_entry->link,
-				&ipa3_ctx->hdr_tbl[hdr_tbl_loc].head_free_offset_list[
-					entry->offset_entry->bin]);
+				if (entry->moved_from)
+					ipa3_hdr_release_old_copy(entry);
+				ipa3_hdr_free_slot(&ipa3_ctx->hdr_tbl[hdr_tbl_loc],
+					entry->offset_entry);
 
 				/* delete the hdr entry from headers list */
 				list_del(&entry->link);
@@ -1372,8 +1990,11 @@ int ipa3_reset_hdr(bool user_only)
 			/* there is one header of size 8 */
 			ipa3_ctx->hdr_tbl[hdr_tbl_loc].end = 8;
 			ipa3_ctx->hdr_tbl[hdr_tbl_loc].hdr_cnt = 1;
+			ipa3_ctx->hdr_tbl[hdr_tbl_loc].moving = 0;
 		}
 	}
+	if (!user_only)
+		ipa3_ctx->hdr_rt_pending = 0;
 
 	IPADBG("reset hdr proc ctx\n");
 	list_for_each_entry_safe(
@@ -1392,9 +2013,8 @@ int ipa3_reset_hdr(bool user_only)
 		if (!user_only ||
 				ctx_entry->ipacm_installed) {
 			/* move the offset entry to appropriate free list */
-			list_move(&ctx_entry->offset_entry->link,
-				&htbl_proc->head_free_offset_list[
-					ctx_entry->offset_entry->bin]);
+			ipa3_hdr_proc_ctx_free_slot(htbl_proc,
+				ctx_entry->offset_entry);
 			list_del(&ctx_entry->link);
 			htbl_proc->proc_ctx_cnt--;
 			ctx_entry->ref_cnt = 0;
@@ -1428,6 +2048,10 @@ int ipa3_reset_hdr(bool user_only)
 		htbl_proc->proc_ctx_cnt = 0;
 	}
 
+	/* surviving rt rules may still point at the removed entries */
+	ipa3_set_rt_tbls_dirty(IPA_IP_v4);
+	ipa3_set_rt_tbls_dirty(IPA_IP_v6);
+
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
 		IPAERR("fail to commit hdr\n");
@@ -1531,6 +2155,8 @@ int ipa3_get_hdr_offset(char* name, u32* offset)
 	entry = __ipa_find_hdr(name);
 	if (entry && entry->offset_entry) {
 		*offset = entry->offset_entry->offset;
+		/* the client keeps the offset, never relocate the header */
+		entry->ofst_exported = true;
 		result = 0;
 	}
 
@@ -1750,3 +2376,18 @@ u32 ipa3_get_hdr_bin_size(int index)
 		return U32_MAX;
 	return ipa_hdr_bin_sz[index];
 }
+
+/**
+ * ipa3_get_hdr_proc_ctx_bin_size() - Get header processing context bin size
+ * from specified index
+ *
+ * @index:	[in] index in the bin sizes array
+ *
+ * Returns:	bin size on success, MAX_UINT32 on failure
+ */
+u32 ipa3_get_hdr_proc_ctx_bin_size(int index)
+{
+	if (index < 0 || index >= IPA_HDR_PROC_CTX_BIN_MAX)
+		return U32_MAX;
+	return ipa_hdr_proc_ctx_bin_sz[index];
+}
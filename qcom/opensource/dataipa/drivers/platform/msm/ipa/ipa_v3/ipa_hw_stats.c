@@ -7,6 +7,7 @@
 #include <linux/debugfs.h>
 #include <linux/kernel.h>
 #include <linux/delay.h>
+#include <linux/vmalloc.h>
 #include "ipa_i.h"
 #include "ipahal.h"
 #include "ipahal_hw_stats.h"
@@ -15,6 +16,16 @@
 #define IPA_INIT_TETH_STATS_MAX_CMD_NUM 5
 #define IPA_INIT_QUOTA_STATS_MAX_CMD_NUM 5
 
+/* counter groups read by a hw stats snapshot */
+enum ipa_hw_stats_snap_grp {
+	IPA_HW_STATS_SNAP_QUOTA,
+	IPA_HW_STATS_SNAP_TETH,
+	IPA_HW_STATS_SNAP_DROP,
+	IPA_HW_STATS_SNAP_GRP_MAX
+};
+
+static void ipa_hw_stats_snap_work(struct work_struct *work);
+
 static inline u32 ipa_hw_stats_get_ep_bit_n_idx(enum ipa_client_type client,
 	u32 *reg_idx)
 {
@@ -43,6 +54,19 @@ int ipa_hw_stats_init(void)
 		return -ENOMEM;
 	}
 
+	ipa3_ctx->hw_stats->snap = vzalloc(sizeof(*ipa3_ctx->hw_stats->snap));
+	if (!ipa3_ctx->hw_stats->snap) {
+		IPAERR("mem allocated failed!\n");
+		kfree(ipa3_ctx->hw_stats);
+		ipa3_ctx->hw_stats = NULL;
+		return -ENOMEM;
+	}
+	mutex_init(&ipa3_ctx->hw_stats->snap->lock);
+	seqcount_mutex_init(&ipa3_ctx->hw_stats->snap->seq,
+		&ipa3_ctx->hw_stats->snap->lock);
+	INIT_DELAYED_WORK(&ipa3_ctx->hw_stats->snap->work,
+		ipa_hw_stats_snap_work);
+
 	/* initialize stats here */
 	ipa3_ctx->hw_stats->enabled = true;
 
@@ -441,11 +465,37 @@ int ipa_hw_stats_init(void)
 
 fail_free_stats_ctx:
 	kfree(teth_stats_init);
+	vfree(ipa3_ctx->hw_stats->snap);
 	kfree(ipa3_ctx->hw_stats);
 	ipa3_ctx->hw_stats = NULL;
 	return ret;
 }
 
+void ipa_hw_stats_destroy(void)
+{
+	struct ipa_hw_stats_snap *snap;
+
+	if (!ipa3_ctx->hw_stats)
+		return;
+
+	snap = ipa3_ctx->hw_stats->snap;
+
+	mutex_lock(&snap->lock);
+	WRITE_ONCE(snap->interval_ms, 0);
+	mutex_unlock(&snap->lock);
+
+	cancel_delayed_work_sync(&snap->work);
+	if (snap->wq)
+		destroy_workqueue(snap->wq);
+	if (snap->mem.base)
+		dma_free_coherent(ipa3_ctx->pdev, snap->mem.size,
+			snap->mem.base, snap->mem.phys_base);
+	vfree(snap);
+
+	kfree(ipa3_ctx->hw_stats);
+	ipa3_ctx->hw_stats = NULL;
+}
+
 static void ipa_close_coal_frame(struct ipahal_imm_cmd_pyld **coal_cmd_pyld)
 {
 	int i;
@@ -492,7 +542,37 @@ static bool ipa_validate_quota_stats_sram_size(u32 needed_len)
 	return true;
 }
 
-int ipa_init_quota_stats(u32 *pipe_bitmask)
+/*
+ * While snapshots are taken, queries are answered from the driver
+ * caches instead of reading the hardware themselves.
+ */
+static inline bool ipa_hw_stats_snap_active(struct ipa_hw_stats_snap *snap)
+{
+	return READ_ONCE(snap->interval_ms) != 0;
+}
+
+/* copy from the driver caches, without taking the snapshot lock */
+static void ipa_hw_stats_snap_copy(struct ipa_hw_stats_snap *snap,
+	void *dst, const void *src, size_t size)
+{
+	unsigned int seq;
+
+	do {
+		seq = read_seqcount_begin(&snap->seq);
+		memcpy(dst, src, size);
+	} while (read_seqcount_retry(&snap->seq, seq));
+}
+
+static inline void ipa_hw_stats_add_quota(struct ipa_quota_stats *dst,
+	u64 ipv4_bytes, u64 ipv4_pkts, u64 ipv6_bytes, u64 ipv6_pkts)
+{
+	dst->num_ipv4_bytes += ipv4_bytes;
+	dst->num_ipv4_pkts += ipv4_pkts;
+	dst->num_ipv6_bytes += ipv6_bytes;
+	dst->num_ipv6_pkts += ipv6_pkts;
+}
+
+static int __ipa_init_quota_stats(u32 *pipe_bitmask)
 {
 	struct ipahal_stats_init_pyld *pyld;
 	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
@@ -516,7 +596,9 @@ int ipa_init_quota_stats(u32 *pipe_bitmask)
 		return -EPERM;
 
 	/* reset driver's cache */
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(&ipa3_ctx->hw_stats->quota, 0, sizeof(ipa3_ctx->hw_stats->quota));
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 	for (i = 0; i < IPA5_PIPE_REG_NUM; i++) {
 		ipa3_ctx->hw_stats->quota.init.enabled_bitmask[i] =
 			pipe_bitmask[i];
@@ -674,7 +756,53 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+int ipa_init_quota_stats(u32 *pipe_bitmask)
+{
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+	ret = __ipa_init_quota_stats(pipe_bitmask);
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+
+	return ret;
+}
+
+/*
+ * Fold quota counters read from hardware into the driver cache, and
+ * into the snapshot sample if there is one. Called with the snapshot
+ * lock held, within a write section.
+ */
+static void ipa_hw_stats_fold_quota(struct ipahal_stats_quota_all *stats,
+	struct ipa_hw_stats_sample *sample)
+{
+	struct ipahal_stats_quota *hw;
+	int i;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		hw = &stats->stats[ep_idx];
+		ipa_hw_stats_add_quota(
+			&ipa3_ctx->hw_stats->quota.stats.client[ep_idx],
+			hw->num_ipv4_bytes, hw->num_ipv4_pkts,
+			hw->num_ipv6_bytes, hw->num_ipv6_pkts);
+		if (sample)
+			ipa_hw_stats_add_quota(&sample->quota.client[ep_idx],
+				hw->num_ipv4_bytes, hw->num_ipv4_pkts,
+				hw->num_ipv6_bytes, hw->num_ipv6_pkts);
+	}
+}
+
+static int __ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 {
 	int i;
 	int ret;
@@ -771,24 +899,9 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	 * the stats were read from hardware with clear_after_read meaning
 	 * hardware stats are 0 now
 	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->quota.stats.client[ep_idx].num_ipv4_bytes +=
-			stats->stats[ep_idx].num_ipv4_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[ep_idx].num_ipv4_pkts +=
-			stats->stats[ep_idx].num_ipv4_pkts;
-		ipa3_ctx->hw_stats->quota.stats.client[ep_idx].num_ipv6_bytes +=
-			stats->stats[ep_idx].num_ipv6_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[ep_idx].num_ipv6_pkts +=
-			stats->stats[ep_idx].num_ipv6_pkts;
-	}
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
+	ipa_hw_stats_fold_quota(stats, NULL);
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 
 	/* copy results to out parameter */
 	if (out)
@@ -805,6 +918,29 @@ free_dma_mem:
 
 }
 
+int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+{
+	struct ipa_hw_stats_snap *snap;
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	snap = ipa3_ctx->hw_stats->snap;
+	if (ipa_hw_stats_snap_active(snap)) {
+		if (out)
+			ipa_hw_stats_snap_copy(snap, out,
+				&ipa3_ctx->hw_stats->quota.stats, sizeof(*out));
+		return 0;
+	}
+
+	mutex_lock(&snap->lock);
+	ret = __ipa_get_quota_stats(out);
+	mutex_unlock(&snap->lock);
+
+	return ret;
+}
+
 int ipa_reset_quota_stats(enum ipa_client_type client)
 {
 	int ret;
@@ -819,23 +955,30 @@ int ipa_reset_quota_stats(enum ipa_client_type client)
 		return -EINVAL;
 	}
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	ep_idx = ipa_get_ep_mapping(client);
 	if (ep_idx == IPA_EP_NOT_ALLOCATED) {
 		IPAERR("EP not allocated for client %d\n", client);
-		return EINVAL;
+		ret = EINVAL;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats.client[ep_idx];
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
 int ipa_reset_all_quota_stats(void)
@@ -846,20 +989,26 @@ int ipa_reset_all_quota_stats(void)
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats;
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
-int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
+static int __ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
 {
 	struct ipahal_stats_init_pyld *pyld;
 	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
@@ -910,12 +1059,16 @@ int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
 	/* reset driver's cache */
 	memset(&ipa3_ctx->hw_stats->teth.init, 0,
 		sizeof(ipa3_ctx->hw_stats->teth.init));
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	for (i = 0; i < IPA5_PIPES_NUM; i++) {
 		memset(&ipa3_ctx->hw_stats->teth.prod_stats_sum[i], 0,
 			sizeof(ipa3_ctx->hw_stats->teth.prod_stats_sum[i]));
 		memset(&ipa3_ctx->hw_stats->teth.prod_stats[i], 0,
 			sizeof(ipa3_ctx->hw_stats->teth.prod_stats[i]));
 	}
+	memset(ipa3_ctx->hw_stats->snap->teth_pending, 0,
+		sizeof(ipa3_ctx->hw_stats->snap->teth_pending));
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 	for (i = 0; i < IPA5_PIPE_REG_NUM; i++) {
 		ipa3_ctx->hw_stats->teth.init.prod_bitmask[i] = in->prod_mask[i];
 	}
@@ -1078,10 +1231,119 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_teth_stats(void)
+int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
+{
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+	ret = __ipa_init_teth_stats(in);
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+
+	return ret;
+}
+
+/*
+ * Hand the tethering deltas read by snapshots since the last
+ * ipa_get_teth_stats() over to prod_stats. Called with the snapshot
+ * lock held, within a write section.
+ */
+static void ipa_hw_stats_teth_take_pending(void)
+{
+	struct ipa_hw_stats_snap *snap = ipa3_ctx->hw_stats->snap;
+
+	BUILD_BUG_ON(sizeof(snap->teth_pending) !=
+		sizeof(ipa3_ctx->hw_stats->teth.prod_stats));
+
+	memcpy(ipa3_ctx->hw_stats->teth.prod_stats, snap->teth_pending,
+		sizeof(snap->teth_pending));
+	memset(snap->teth_pending, 0, sizeof(snap->teth_pending));
+}
+
+/*
+ * Fold tethering counters read from hardware into the driver cache.
+ * Snapshots add the deltas to teth_pending rather than to prod_stats,
+ * which only ipa_get_teth_stats() refreshes. Called with the snapshot
+ * lock held, within a write section.
+ */
+static void ipa_hw_stats_fold_teth(struct ipahal_stats_tethering_all *stats_all,
+	bool to_pending, struct ipa_hw_stats_sample *sample)
 {
 	int i, j;
 	int prod_reg, cons_reg;
+	struct ipa_hw_stats_teth *sw_stats = &ipa3_ctx->hw_stats->teth;
+	struct ipahal_stats_tethering *stats;
+	struct ipa_quota_stats *quota_stats;
+	struct ipahal_stats_init_tethering *init = &sw_stats->init;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		for (j = 0; j < IPA_CLIENT_MAX; j++) {
+			int prod_idx = ipa_get_ep_mapping(i);
+			int cons_idx = ipa_get_ep_mapping(j);
+
+			if (prod_idx == -1 ||
+				prod_idx >= ipa3_get_max_num_pipes())
+				continue;
+
+			if (cons_idx == -1 ||
+				cons_idx >= ipa3_get_max_num_pipes())
+				continue;
+
+			prod_reg = ipahal_get_ep_reg_idx(prod_idx);
+			cons_reg = ipahal_get_ep_reg_idx(cons_idx);
+
+			/* save hw-query result */
+			if ((init->prod_bitmask[prod_reg] &
+				ipahal_get_ep_bit(prod_idx)) &&
+				(init->cons_bitmask[prod_idx][cons_reg]
+					& ipahal_get_ep_bit(cons_idx))) {
+				IPADBG_LOW("prod %d cons %d\n",
+					prod_idx, cons_idx);
+				stats = &stats_all->stats[prod_idx][cons_idx];
+				IPADBG_LOW("num_ipv4_bytes %lld\n",
+					stats->num_ipv4_bytes);
+				IPADBG_LOW("num_ipv4_pkts %lld\n",
+					stats->num_ipv4_pkts);
+				IPADBG_LOW("num_ipv6_pkts %lld\n",
+					stats->num_ipv6_pkts);
+				IPADBG_LOW("num_ipv6_bytes %lld\n",
+					stats->num_ipv6_bytes);
+
+				/* update stats*/
+				if (to_pending)
+					quota_stats = &ipa3_ctx->hw_stats->snap->
+						teth_pending[prod_idx].client[cons_idx];
+				else
+					quota_stats =
+						&sw_stats->prod_stats[prod_idx].client[cons_idx];
+				ipa_hw_stats_add_quota(quota_stats,
+					stats->num_ipv4_bytes, stats->num_ipv4_pkts,
+					stats->num_ipv6_bytes, stats->num_ipv6_pkts);
+
+				/* Accumulated stats */
+				quota_stats =
+					&sw_stats->prod_stats_sum[prod_idx].client[cons_idx];
+				ipa_hw_stats_add_quota(quota_stats,
+					stats->num_ipv4_bytes, stats->num_ipv4_pkts,
+					stats->num_ipv6_bytes, stats->num_ipv6_pkts);
+
+				if (sample)
+					ipa_hw_stats_add_quota(
+						&sample->teth.client[prod_idx],
+						stats->num_ipv4_bytes,
+						stats->num_ipv4_pkts,
+						stats->num_ipv6_bytes,
+						stats->num_ipv6_pkts);
+			}
+		}
+	}
+}
+
+static int __ipa_get_teth_stats(void)
+{
+	int i;
 	int ret;
 	struct ipahal_stats_get_offset_tethering get_offset;
 	struct ipahal_stats_offset offset = {0};
@@ -1090,20 +1352,12 @@ int ipa_get_teth_stats(void)
 	struct ipa_mem_buffer mem;
 	struct ipa3_desc desc[2];
 	struct ipahal_stats_tethering_all *stats_all;
-	struct ipa_hw_stats_teth *sw_stats;
-	struct ipahal_stats_tethering *stats;
-	struct ipa_quota_stats *quota_stats;
-	struct ipahal_stats_init_tethering *init;
 	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
 		ipa3_ctx->hw_stats->teth_stats_enabled))
 		return 0;
 
-	sw_stats = &ipa3_ctx->hw_stats->teth;
-	init = (struct ipahal_stats_init_tethering *)
-			&ipa3_ctx->hw_stats->teth.init;
-
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
 	memset(&get_offset, 0, sizeof(get_offset));
@@ -1182,81 +1436,19 @@ int ipa_get_teth_stats(void)
 		goto free_stats;
 	}
 
-	/* reset prod_stats cache */
-	for (i = 0; i < IPA5_PIPES_NUM; i++) {
-		memset(&ipa3_ctx->hw_stats->teth.prod_stats[i], 0,
-			sizeof(ipa3_ctx->hw_stats->teth.prod_stats[i]));
-	}
-
 	/*
 	 * update driver cache.
 	 * the stats were read from hardware with clear_after_read meaning
 	 * hardware stats are 0 now
 	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		for (j = 0; j < IPA_CLIENT_MAX; j++) {
-			int prod_idx = ipa_get_ep_mapping(i);
-			int cons_idx = ipa_get_ep_mapping(j);
-
-			if (prod_idx == -1 ||
-				prod_idx >= ipa3_get_max_num_pipes())
-				continue;
-
-			if (cons_idx == -1 ||
-				cons_idx >= ipa3_get_max_num_pipes())
-				continue;
-
-			prod_reg = ipahal_get_ep_reg_idx(prod_idx);
-			cons_reg = ipahal_get_ep_reg_idx(cons_idx);
-
-			/* save hw-query result */
-			if ((init->prod_bitmask[prod_reg] &
-				ipahal_get_ep_bit(prod_idx)) &&
-				(init->cons_bitmask[prod_idx][cons_reg]
-					& ipahal_get_ep_bit(cons_idx))) {
-				IPADBG_LOW("prod %d cons %d\n",
-					prod_idx, cons_idx);
-				stats = &stats_all->stats[prod_idx][cons_idx];
-				IPADBG_LOW("num_ipv4_bytes %lld\n",
-					stats->num_ipv4_bytes);
-				IPADBG_LOW("num_ipv4_pkts %lld\n",
-					stats->num_ipv4_pkts);
-				IPADBG_LOW("num_ipv6_pkts %lld\n",
-					stats->num_ipv6_pkts);
-				IPADBG_LOW("num_ipv6_bytes %lld\n",
-					stats->num_ipv6_bytes);
-
-				/* update stats*/
-				quota_stats =
-					&sw_stats->prod_stats[prod_idx].client[cons_idx];
-				quota_stats->num_ipv4_bytes =
-					stats->num_ipv4_bytes;
-				quota_stats->num_ipv4_pkts =
-					stats->num_ipv4_pkts;
-				quota_stats->num_ipv6_bytes =
-					stats->num_ipv6_bytes;
-				quota_stats->num_ipv6_pkts =
-					stats->num_ipv6_pkts;
-
-				/* Accumulated stats */
-				quota_stats =
-					&sw_stats->prod_stats_sum[prod_idx].client[cons_idx];
-				quota_stats->num_ipv4_bytes +=
-					stats->num_ipv4_bytes;
-				quota_stats->num_ipv4_pkts +=
-					stats->num_ipv4_pkts;
-				quota_stats->num_ipv6_bytes +=
-					stats->num_ipv6_bytes;
-				quota_stats->num_ipv6_pkts +=
-					stats->num_ipv6_pkts;
-			}
-		}
-	}
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
+	ipa_hw_stats_teth_take_pending();
+	ipa_hw_stats_fold_teth(stats_all, false, NULL);
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 
 	ret = 0;
 free_stats:
 	vfree(stats_all);
-	stats = NULL;
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -1266,6 +1458,29 @@ free_dma_mem:
 
 }
 
+int ipa_get_teth_stats(void)
+{
+	struct ipa_hw_stats_snap *snap;
+	int ret = 0;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
+		ipa3_ctx->hw_stats->teth_stats_enabled))
+		return 0;
+
+	snap = ipa3_ctx->hw_stats->snap;
+	mutex_lock(&snap->lock);
+	if (ipa_hw_stats_snap_active(snap)) {
+		write_seqcount_begin(&snap->seq);
+		ipa_hw_stats_teth_take_pending();
+		write_seqcount_end(&snap->seq);
+	} else {
+		ret = __ipa_get_teth_stats();
+	}
+	mutex_unlock(&snap->lock);
+
+	return ret;
+}
+
 int ipa_query_teth_stats(enum ipa_client_type prod,
 	struct ipa_quota_stats_all *out, bool reset)
 {
@@ -1288,9 +1503,13 @@ int ipa_query_teth_stats(enum ipa_client_type prod,
 
 	/* copy results to out parameter */
 	if (reset)
-		*out = ipa3_ctx->hw_stats->teth.prod_stats[ipa_ep_idx];
+		ipa_hw_stats_snap_copy(ipa3_ctx->hw_stats->snap, out,
+			&ipa3_ctx->hw_stats->teth.prod_stats[ipa_ep_idx],
+			sizeof(*out));
 	else
-		*out = ipa3_ctx->hw_stats->teth.prod_stats_sum[ipa_ep_idx];
+		ipa_hw_stats_snap_copy(ipa3_ctx->hw_stats->snap, out,
+			&ipa3_ctx->hw_stats->teth.prod_stats_sum[ipa_ep_idx],
+			sizeof(*out));
 	return 0;
 }
 
@@ -1321,17 +1540,23 @@ int ipa_reset_teth_stats(enum ipa_client_type prod, enum ipa_client_type cons)
 		return EINVAL;
 	}
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats();
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[prod_ep_idx].client[cons_ep_idx];
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
 int ipa_reset_all_cons_teth_stats(enum ipa_client_type prod)
@@ -1356,20 +1581,25 @@ int ipa_reset_all_cons_teth_stats(enum ipa_client_type prod)
 		return EINVAL;
 	}
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats();
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	for (i = 0; i < IPA5_PIPES_NUM; i++) {
 		stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[ipa_ep_idx].client[i];
 		memset(stats, 0, sizeof(*stats));
 	}
-
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
 int ipa_reset_all_teth_stats(void)
@@ -1382,13 +1612,15 @@ int ipa_reset_all_teth_stats(void)
 		ipa3_ctx->hw_stats->teth_stats_enabled))
 		return 0;
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		if (IPA_CLIENT_IS_PROD(i) && ipa_get_ep_mapping(i) != -1) {
-			ret = ipa_get_teth_stats();
+			ret = __ipa_get_teth_stats();
 			if (ret) {
 				IPAERR("ipa_get_teth_stats failed %d\n", ret);
-				return ret;
+				goto unlock;
 			}
 			/* a single iteration will reset all hardware stats */
 			break;
@@ -1396,12 +1628,16 @@ int ipa_reset_all_teth_stats(void)
 	}
 
 	/* reset driver's cache */
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	for (i = 0; i < IPA5_PIPES_NUM; i++) {
 		stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[i];
 		memset(stats, 0, sizeof(*stats));
 	}
-
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+	ret = 0;
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
 int ipa_init_flt_rt_stats(void)
@@ -1935,7 +2171,7 @@ int ipa_drop_stats_init(void)
 	return ipa_init_drop_stats(pipe_bitmask);
 }
 
-int ipa_init_drop_stats(u32 *pipe_bitmask)
+static int __ipa_init_drop_stats(u32 *pipe_bitmask)
 {
 	struct ipahal_stats_init_pyld *pyld;
 	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
@@ -1990,8 +2226,10 @@ int ipa_init_drop_stats(u32 *pipe_bitmask)
 	}
 
 	/* reset driver's cache and copy the bitmask of new drop enabled pipes */
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(&ipa3_ctx->hw_stats->drop, 0, sizeof(ipa3_ctx->hw_stats->drop));
 	ipa3_ctx->hw_stats->drop = tmp_drop;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 
 	dma_address = dma_map_single(ipa3_ctx->pdev,
 		pyld->data,
@@ -2135,7 +2373,54 @@ fail_free_desc:
 	return ret;
 }
 
-int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
+int ipa_init_drop_stats(u32 *pipe_bitmask)
+{
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+	ret = __ipa_init_drop_stats(pipe_bitmask);
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+
+	return ret;
+}
+
+/*
+ * Fold drop counters read from hardware into the driver cache, and
+ * into the snapshot sample if there is one. Called with the snapshot
+ * lock held, within a write section.
+ */
+static void ipa_hw_stats_fold_drop(struct ipahal_stats_drop_all *stats,
+	struct ipa_hw_stats_sample *sample)
+{
+	int i;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
+			stats->stats[ep_idx].drop_byte_cnt;
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
+			stats->stats[ep_idx].drop_packet_cnt;
+
+		if (sample) {
+			sample->drop.client[i].drop_byte_cnt +=
+				stats->stats[ep_idx].drop_byte_cnt;
+			sample->drop.client[i].drop_packet_cnt +=
+				stats->stats[ep_idx].drop_packet_cnt;
+		}
+	}
+}
+
+static int __ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 {
 	int i;
 	int ret;
@@ -2232,21 +2517,9 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 	 * the stats were read from hardware with clear_after_read meaning
 	 * hardware stats are 0 now
 	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
-			stats->stats[ep_idx].drop_byte_cnt;
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
-			stats->stats[ep_idx].drop_packet_cnt;
-	}
-
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
+	ipa_hw_stats_fold_drop(stats, NULL);
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
 
 	if (!out) {
 		ret = 0;
@@ -2268,6 +2541,29 @@ free_dma_mem:
 
 }
 
+int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
+{
+	struct ipa_hw_stats_snap *snap;
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	snap = ipa3_ctx->hw_stats->snap;
+	if (ipa_hw_stats_snap_active(snap)) {
+		if (out)
+			ipa_hw_stats_snap_copy(snap, out,
+				&ipa3_ctx->hw_stats->drop.stats, sizeof(*out));
+		return 0;
+	}
+
+	mutex_lock(&snap->lock);
+	ret = __ipa_get_drop_stats(out);
+	mutex_unlock(&snap->lock);
+
+	return ret;
+}
+
 int ipa_reset_drop_stats(enum ipa_client_type client)
 {
 	int ret;
@@ -2281,17 +2577,23 @@ int ipa_reset_drop_stats(enum ipa_client_type client)
 		return -EINVAL;
 	}
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
+	ret = __ipa_get_drop_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_drop_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->drop.stats.client[client];
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
 }
 
 int ipa_reset_all_drop_stats(void)
@@ -2302,19 +2604,313 @@ int ipa_reset_all_drop_stats(void)
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
+	mutex_lock(&ipa3_ctx->hw_stats->snap->lock);
+
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
+	ret = __ipa_get_drop_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_drop_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->drop.stats;
+	write_seqcount_begin(&ipa3_ctx->hw_stats->snap->seq);
 	memset(stats, 0, sizeof(*stats));
+	write_seqcount_end(&ipa3_ctx->hw_stats->snap->seq);
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->snap->lock);
+	return ret;
+}
+
+/*
+ * hw stats snapshots
+ *
+ * When enabled, a work item reads the quota, tethering and drop
+ * counters every interval_ms, all in one batch of immediate commands
+ * into one DMA buffer, and folds them into the driver caches. The
+ * deltas of the most recent snapshots are kept in a ring. Meanwhile
+ * ipa_get_quota_stats(), ipa_get_drop_stats() and ipa_get_teth_stats()
+ * answer from the driver caches, so frequent polling by several
+ * clients no longer costs a DMA per query. Answers lag the hardware
+ * by at most one interval.
+ */
+static int ipa_hw_stats_snap_read(struct ipa_hw_stats_snap *snap)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipahal_stats_get_offset_quota quota_offset = { { 0 } };
+	struct ipahal_stats_get_offset_tethering teth_offset;
+	struct ipahal_stats_get_offset_drop drop_offset = { { 0 } };
+	struct ipahal_stats_offset offset[IPA_HW_STATS_SNAP_GRP_MAX];
+	u32 sram_ofst[IPA_HW_STATS_SNAP_GRP_MAX];
+	u32 buf_ofst[IPA_HW_STATS_SNAP_GRP_MAX];
+	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[IPA_HW_STATS_SNAP_GRP_MAX + 1];
+	struct ipa3_desc desc[IPA_HW_STATS_SNAP_GRP_MAX + 1];
+	struct ipa_hw_stats_sample *sample;
+	bool first_dma = true;
+	u32 size = 0;
+	int num_cmd = 0;
+	int i, ret;
+
+	memset(offset, 0, sizeof(offset));
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+	memset(&teth_offset, 0, sizeof(teth_offset));
+
+	quota_offset.init = hw_stats->quota.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_QUOTA, &quota_offset,
+		&offset[IPA_HW_STATS_SNAP_QUOTA]);
+	if (ret) {
+		IPAERR("failed to get quota offset from hal %d\n", ret);
+		return ret;
+	}
+	sram_ofst[IPA_HW_STATS_SNAP_QUOTA] = IPA_MEM_PART(stats_quota_ap_ofst);
+
+	if (hw_stats->teth_stats_enabled) {
+		teth_offset.init = hw_stats->teth.init;
+		ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_TETHERING,
+			&teth_offset, &offset[IPA_HW_STATS_SNAP_TETH]);
+		if (ret) {
+			IPAERR("failed to get teth offset from hal %d\n", ret);
+			return ret;
+		}
+	}
+	sram_ofst[IPA_HW_STATS_SNAP_TETH] = IPA_MEM_PART(stats_tethering_ofst);
+
+	drop_offset.init = hw_stats->drop.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_DROP, &drop_offset,
+		&offset[IPA_HW_STATS_SNAP_DROP]);
+	if (ret) {
+		IPAERR("failed to get drop offset from hal %d\n", ret);
+		return ret;
+	}
+	sram_ofst[IPA_HW_STATS_SNAP_DROP] = IPA_MEM_PART(stats_drop_ofst);
+
+	for (i = 0; i < IPA_HW_STATS_SNAP_GRP_MAX; i++) {
+		buf_ofst[i] = size;
+		size += ALIGN(offset[i].size, 8);
+	}
+
+	if (size == 0)
+		return 0;
+
+	/* the buffer is kept from one snapshot to the next */
+	if (size > snap->mem.size) {
+		if (snap->mem.base)
+			dma_free_coherent(ipa3_ctx->pdev, snap->mem.size,
+				snap->mem.base, snap->mem.phys_base);
+		snap->mem.size = size;
+		snap->mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
+			snap->mem.size, &snap->mem.phys_base, GFP_KERNEL);
+		if (!snap->mem.base) {
+			IPAERR("fail to alloc DMA memory\n");
+			snap->mem.size = 0;
+			return -ENOMEM;
+		}
+	}
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
+		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			return -ENOMEM;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	/*
+	 * One pipeline clear ahead of the first read is enough for all
+	 * of the groups.
+	 */
+	for (i = 0; i < IPA_HW_STATS_SNAP_GRP_MAX; i++) {
+		if (offset[i].size == 0)
+			continue;
+
+		cmd.is_read = true;
+		cmd.clear_after_read = true;
+		cmd.skip_pipeline_clear = !first_dma;
+		cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		cmd.size = offset[i].size;
+		cmd.system_addr = snap->mem.phys_base + buf_ofst[i];
+		cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
+			sram_ofst[i] + offset[i].offset;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+		first_dma = false;
+	}
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	if (offset[IPA_HW_STATS_SNAP_QUOTA].size) {
+		ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
+			&hw_stats->quota.init,
+			snap->mem.base + buf_ofst[IPA_HW_STATS_SNAP_QUOTA],
+			&snap->quota_all);
+		if (ret) {
+			IPAERR("failed to parse quota stats (error %d)\n", ret);
+			goto destroy_imm;
+		}
+	}
+
+	if (offset[IPA_HW_STATS_SNAP_TETH].size) {
+		ret = ipahal_parse_stats(IPAHAL_HW_STATS_TETHERING,
+			&hw_stats->teth.init,
+			snap->mem.base + buf_ofst[IPA_HW_STATS_SNAP_TETH],
+			&snap->teth_all);
+		if (ret) {
+			IPAERR("failed to parse teth stats (error %d)\n", ret);
+			goto destroy_imm;
+		}
+	}
+
+	if (offset[IPA_HW_STATS_SNAP_DROP].size) {
+		ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
+			&hw_stats->drop.init,
+			snap->mem.base + buf_ofst[IPA_HW_STATS_SNAP_DROP],
+			&snap->drop_all);
+		if (ret) {
+			IPAERR("failed to parse drop stats (error %d)\n", ret);
+			goto destroy_imm;
+		}
+	}
+
+	write_seqcount_begin(&snap->seq);
+	sample = &snap->ring[snap->head];
+	memset(sample, 0, sizeof(*sample));
+	sample->ts = ktime_get();
+	if (offset[IPA_HW_STATS_SNAP_QUOTA].size)
+		ipa_hw_stats_fold_quota(&snap->quota_all, sample);
+	if (offset[IPA_HW_STATS_SNAP_TETH].size)
+		ipa_hw_stats_fold_teth(&snap->teth_all, true, sample);
+	if (offset[IPA_HW_STATS_SNAP_DROP].size)
+		ipa_hw_stats_fold_drop(&snap->drop_all, sample);
+	snap->head = (snap->head + 1) % IPA_HW_STATS_SNAP_RING;
+	snap->num_samples++;
+	write_seqcount_end(&snap->seq);
+
+destroy_imm:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+	return ret;
+}
+
+static void ipa_hw_stats_snap_work(struct work_struct *work)
+{
+	struct ipa_hw_stats_snap *snap = container_of(to_delayed_work(work),
+		struct ipa_hw_stats_snap, work);
+	int ret;
+
+	mutex_lock(&snap->lock);
+	if (!snap->interval_ms)
+		goto unlock;
+
+	ret = ipa_hw_stats_snap_read(snap);
+	if (ret)
+		IPAERR_RL("hw stats snapshot failed %d\n", ret);
+
+	queue_delayed_work(snap->wq, &snap->work,
+		msecs_to_jiffies(snap->interval_ms));
+unlock:
+	mutex_unlock(&snap->lock);
+}
+
+/**
+ * ipa_hw_stats_set_snapshot() - start, retune or stop hw stats snapshots
+ * @interval_ms: snapshot interval, 0 to stop taking snapshots
+ *
+ * Return codes: 0 on success, negative on failure
+ */
+int ipa_hw_stats_set_snapshot(u32 interval_ms)
+{
+	struct ipa_hw_stats_snap *snap;
+	u32 prev;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return -EPERM;
+
+	if (interval_ms && interval_ms < IPA_HW_STATS_SNAP_MIN_MS) {
+		IPAERR("interval %u ms below %u ms\n", interval_ms,
+			IPA_HW_STATS_SNAP_MIN_MS);
+		return -EINVAL;
+	}
+
+	snap = ipa3_ctx->hw_stats->snap;
+
+	mutex_lock(&snap->lock);
+	if (interval_ms && !snap->wq) {
+		snap->wq = alloc_workqueue("ipa_hw_stats_snap", WQ_UNBOUND, 1);
+		if (!snap->wq) {
+			IPAERR("failed to create workqueue\n");
+			mutex_unlock(&snap->lock);
+			return -ENOMEM;
+		}
+	}
+
+	prev = snap->interval_ms;
+	WRITE_ONCE(snap->interval_ms, interval_ms);
+
+	if (!interval_ms)
+		cancel_delayed_work(&snap->work);
+	else
+		mod_delayed_work(snap->wq, &snap->work,
+			prev ? msecs_to_jiffies(interval_ms) : 0);
+	mutex_unlock(&snap->lock);
+
+	IPADBG("hw stats snapshot interval %u ms -> %u ms\n", prev, interval_ms);
 	return 0;
 }
 
+/**
+ * ipa_hw_stats_get_samples() - get the deltas of recent hw stats snapshots
+ * @out: where to copy the samples to, newest first
+ * @max: room in @out, in samples
+ *
+ * Does not take the snapshot lock.
+ *
+ * Return codes: number of samples copied, negative on failure
+ */
+int ipa_hw_stats_get_samples(struct ipa_hw_stats_sample *out, int max)
+{
+	struct ipa_hw_stats_snap *snap;
+	unsigned int seq;
+	int i, n;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return -EPERM;
+
+	if (!out || max < 0)
+		return -EINVAL;
+
+	snap = ipa3_ctx->hw_stats->snap;
+
+	do {
+		seq = read_seqcount_begin(&snap->seq);
+		n = min_t(u64, snap->num_samples, IPA_HW_STATS_SNAP_RING);
+		n = min(n, max);
+		for (i = 0; i < n; i++)
+			out[i] = snap->ring[(snap->head +
+				IPA_HW_STATS_SNAP_RING - 1 - i) %
+				IPA_HW_STATS_SNAP_RING];
+	} while (read_seqcount_retry(&snap->seq, seq));
+
+	return n;
+}
+
 
 #ifndef CONFIG_DEBUG_FS
 int ipa_debugfs_init_stats(struct dentry *parent) { return 0; }
@@ -2843,6 +3439,81 @@ bail:
 	return ret;
 }
 
+static ssize_t ipa_debugfs_set_snapshot(struct file *file,
+	const char __user *ubuf, size_t count, loff_t *ppos)
+{
+	u32 interval_ms;
+	int ret;
+
+	ret = kstrtou32_from_user(ubuf, count, 0, &interval_ms);
+	if (ret)
+		return ret;
+
+	ret = ipa_hw_stats_set_snapshot(interval_ms);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
+static ssize_t ipa_debugfs_print_snapshot(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	int nbytes = 0;
+	struct ipa_hw_stats_sample *samples;
+	struct ipa_quota_stats *quota;
+	ktime_t now = ktime_get();
+	u64 quota_bytes, teth_bytes;
+	u32 drop_pkts;
+	int i, j, n;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	samples = kcalloc(IPA_HW_STATS_SNAP_RING, sizeof(*samples), GFP_KERNEL);
+	if (!samples)
+		return -ENOMEM;
+
+	n = ipa_hw_stats_get_samples(samples, IPA_HW_STATS_SNAP_RING);
+	if (n < 0) {
+		kfree(samples);
+		return n;
+	}
+
+	mutex_lock(&ipa3_ctx->lock);
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"interval_ms=%u samples=%llu\n",
+		READ_ONCE(ipa3_ctx->hw_stats->snap->interval_ms),
+		READ_ONCE(ipa3_ctx->hw_stats->snap->num_samples));
+
+	for (i = 0; i < n; i++) {
+		quota_bytes = teth_bytes = 0;
+		drop_pkts = 0;
+
+		for (j = 0; j < IPA5_PIPES_NUM; j++) {
+			quota = &samples[i].quota.client[j];
+			quota_bytes += quota->num_ipv4_bytes +
+				quota->num_ipv6_bytes;
+			quota = &samples[i].teth.client[j];
+			teth_bytes += quota->num_ipv4_bytes +
+				quota->num_ipv6_bytes;
+		}
+
+		for (j = 0; j < IPA_CLIENT_MAX; j++)
+			drop_pkts += samples[i].drop.client[j].drop_packet_cnt;
+
+		nbytes += scnprintf(dbg_buff + nbytes,
+			IPA_MAX_MSG_LEN - nbytes,
+			"age_ms=%lld quota_bytes=%llu teth_bytes=%llu drop_pkts=%u\n",
+			ktime_ms_delta(now, samples[i].ts),
+			quota_bytes, teth_bytes, drop_pkts);
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+	kfree(samples);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
 static const struct file_operations ipa3_quota_ops = {
 	.read = ipa_debugfs_print_quota_stats,
 	.write = ipa_debugfs_reset_quota_stats,
@@ -2867,6 +3538,11 @@ static const struct file_operations ipa3_enable_drop_ops = {
 	.write = ipa_debugfs_enable_disable_drop_stats,
 };
 
+static const struct file_operations ipa3_snapshot_ops = {
+	.read = ipa_debugfs_print_snapshot,
+	.write = ipa_debugfs_set_snapshot,
+};
+
 int ipa_debugfs_init_stats(struct dentry *parent)
 {
 	const mode_t read_write_mode = 0664;
@@ -2918,6 +3594,13 @@ int ipa_debugfs_init_stats(struct dentry *parent)
 		goto fail;
 	}
 
+	file = debugfs_create_file("snapshot", read_write_mode, dent, NULL,
+		&ipa3_snapshot_ops);
+	if (IS_ERR_OR_NULL(file)) {
+		IPAERR("fail to create file %s\n", "snapshot");
+		goto fail;
+	}
+
 	return 0;
 fail:
 	debugfs_remove_recursive(dent);
@@ -78,6 +78,7 @@
 #define IPA_QMAP_HEADER_LENGTH (4)
 #define IPA_DL_CHECKSUM_LENGTH (8)
 #define IPA_NUM_DESC_PER_SW_TX (3)
+#define IPA_SEND_MAX_DESC (20)
 #define IPA_GENERIC_RX_POOL_SZ_WAN 224
 #define IPA_GENERIC_RX_POOL_SZ 192
 #define IPA_GENERIC_RX_PAGE_POOL_SZ_FACTOR 2
@@ -800,6 +801,8 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @dirty: rules changed since the last successful commit
+ * @lcl_bdy: copy of the local body generated on the last commit
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
@@ -816,6 +819,8 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	bool dirty;
+	u8 *lcl_bdy[IPA_RULE_TYPE_MAX];
 };
 
 /**
@@ -836,6 +841,12 @@ struct ipa3_rt_tbl {
  * @user_deleted: is the header deleted by the user?
  * @ipacm_installed: indicate if installed by ipacm
  * @is_lcl: is the entry in the SRAM?
+ * @lcl_eligible: may the entry be in the SRAM? it may have been put in DDR
+ *  only for lack of space
+ * @ofst_exported: the offset was handed out, the entry is never relocated
+ * @moved_from: previous slot of an entry being relocated, still written
+ *  until the routing rules point at the new one
+ * @moved_from_lcl: is @moved_from in the SRAM table?
  */
 struct ipa3_hdr_entry {
 	struct list_head link;
@@ -854,6 +865,10 @@ struct ipa3_hdr_entry {
 	bool user_deleted;
 	bool ipacm_installed;
 	bool is_lcl;
+	bool lcl_eligible;
+	bool ofst_exported;
+	struct ipa_hdr_offset_entry *moved_from;
+	bool moved_from_lcl;
 };
 
 /**
@@ -863,6 +878,7 @@ struct ipa3_hdr_entry {
  * @head_free_offset_list: header free offset list
  * @hdr_cnt: number of headers
  * @end: the last header index
+ * @moving: number of relocated headers whose old copy is in this table
  */
 struct ipa3_hdr_tbl {
 	struct list_head head_hdr_entry_list;
@@ -870,6 +886,39 @@ struct ipa3_hdr_tbl {
 	struct list_head head_free_offset_list[IPA_HDR_BIN_MAX];
 	u32 hdr_cnt;
 	u32 end;
+	u32 moving;
+};
+
+/**
+ * struct ipa3_hdr_mem_stats - occupancy of a header or proc ctx table
+ * @size: size of the memory partition of the table
+ * @end: bytes handed out from the start of the table
+ * @used: bytes of the slots holding entries
+ * @free: bytes of the free slots below @end
+ * @largest_free: size of the largest free slot
+ * @free_slots: number of free slots per bin
+ */
+struct ipa3_hdr_mem_stats {
+	u32 size;
+	u32 end;
+	u32 used;
+	u32 free;
+	u32 largest_free;
+	u32 free_slots[IPA_HDR_BIN_MAX];
+};
+
+/**
+ * struct ipa3_hdr_compact_stats - header table compaction counters
+ * @runs: passes that relocated headers
+ * @moved: headers moved to a lower slot of the SRAM table
+ * @promoted: headers moved from the DDR table to the SRAM table
+ * @failed: passes that could not be committed
+ */
+struct ipa3_hdr_compact_stats {
+	u64 runs;
+	u64 moved;
+	u64 promoted;
+	u64 failed;
 };
 
 /**
@@ -944,6 +993,9 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: rules changed since the last successful commit
+ * @sys_valid: curr_mem holds the body of the last commit
+ * @lcl_bdy: copy of the local body generated on the last commit
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -955,6 +1007,9 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty;
+	bool sys_valid[IPA_RULE_TYPE_MAX];
+	u8 *lcl_bdy[IPA_RULE_TYPE_MAX];
 };
 
 struct ipa3_flt_tbl_nhash_lcl {
@@ -1174,10 +1229,82 @@ struct ipa3_repl_ctx {
 	atomic_t pending;
 };
 
+/**
+ * struct ipa3_page_repl_ctx - pre-mapped RX page pool of a pipe
+ * @page_repl_head: pages of the pool, free once only the pool refers to them
+ * @capacity: number of pages allocated up front
+ * @pending: replenish pending
+ * @adopted: temporary pages kept in the pool after use
+ * @adopt_max: bound on @adopted
+ */
 struct ipa3_page_repl_ctx {
 	struct list_head page_repl_head;
 	u32 capacity;
 	atomic_t pending;
+	u32 adopted;
+	u32 adopt_max;
+};
+
+#define IPA_TX_BATCH_HIST_MAX 6
+
+/**
+ * struct ipa3_tx_batch_stats - TX doorbell batching statistics of a pipe
+ * @doorbell: number of doorbells rung for queued packets
+ * @deferred: number of packets queued with the doorbell deferred
+ * @timer_flush: number of doorbells rung by the deferral timer
+ * @hist: packets per doorbell, bucket n counts 2^n to 2^(n+1)-1 packets
+ */
+struct ipa3_tx_batch_stats {
+	u64 doorbell;
+	u64 deferred;
+	u64 timer_flush;
+	u64 hist[IPA_TX_BATCH_HIST_MAX];
+};
+
+/*
+ * RX latency histogram buckets: values below IPA_LL_LAT_SUB ns get a bucket
+ * each, above that every power of two is split in IPA_LL_LAT_SUB buckets.
+ */
+#define IPA_LL_LAT_SUB_BITS 2
+#define IPA_LL_LAT_SUB (1 << IPA_LL_LAT_SUB_BITS)
+#define IPA_LL_LAT_HIST_MAX ((32 - IPA_LL_LAT_SUB_BITS + 1) * IPA_LL_LAT_SUB)
+
+/**
+ * struct ipa3_ll_rx_poll - busy poll and RX latency of the low lat data pipe
+ * @lock: serializes configuration against pipe setup and teardown
+ * @state_lock: protects @thread and @spinning against the NAPI poll
+ * @thread: busy poll thread, bound to @cpu; NULL when busy poll is off
+ * @sys: sys context of the low lat data consumer while it is set up
+ * @cpu: CPU the busy poll thread runs on
+ * @idle_us: busy poll is left for interrupts after this much idle time
+ * @spinning: the channel is kept in polling mode by the busy poll thread
+ * @last_active: last time the NAPI poll found completions
+ * @irq_ts: time of the last GSI interrupt of the channel
+ * @last_poll: last time the NAPI poll looked at the ring
+ * @busy_enter: number of switches from interrupts to busy polling
+ * @busy_exit: number of switches from busy polling back to interrupts
+ * @busy_polls: number of NAPI polls scheduled by the busy poll thread
+ * @lat_samples: number of completions in @lat_hist
+ * @lat_max: largest latency seen, in ns
+ * @lat_hist: completions per latency bucket
+ */
+struct ipa3_ll_rx_poll {
+	struct mutex lock;
+	spinlock_t state_lock;
+	struct task_struct *thread;
+	struct ipa3_sys_context *sys;
+	int cpu;
+	u32 idle_us;
+	bool spinning;
+	ktime_t last_active;
+	ktime_t irq_ts;
+	ktime_t last_poll;
+	u64 busy_enter;
+	u64 busy_exit;
+	u64 busy_polls;
+	u64 lat_samples;
+	u64 lat_max;
+	u64 lat_hist[IPA_LL_LAT_HIST_MAX];
 };
 
 /**
@@ -1197,6 +1324,10 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @db_pending: packets queued to GSI whose doorbell is still deferred
+ * @tx_batch: doorbell batching statistics of a TX pipe
+ * @db_defer_timer: bounds how long a deferred doorbell may wait
+ * @db_defer_work: rings the deferred doorbell once db_defer_timer expires
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1220,6 +1351,7 @@ struct ipa3_sys_context {
 	unsigned int len_partial;
 	bool drop_packet;
 	struct work_struct work;
+	struct work_struct db_defer_work;
 	struct delayed_work replenish_rx_work;
 	struct work_struct repl_work;
 	void (*repl_hdlr)(struct ipa3_sys_context *sys);
@@ -1245,6 +1377,8 @@ struct ipa3_sys_context {
 	struct ipa3_sys_context *common_sys;
 	atomic_t page_avilable;
 	u32 napi_sort_page_thrshld_cnt;
+	atomic_t db_pending;
+	struct ipa3_tx_batch_stats tx_batch;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1254,6 +1388,7 @@ struct ipa3_sys_context {
 	u32 avail_tx_wrapper;
 	spinlock_t spinlock;
 	struct hrtimer db_timer;
+	struct hrtimer db_defer_timer;
 	struct workqueue_struct *wq;
 	struct workqueue_struct *repl_wq;
 	struct ipa3_status_stats *status_stat;
@@ -1576,6 +1711,7 @@ struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 page_adopted;
 };
 
 struct ipa3_cache_recycle_stats {
@@ -1976,6 +2112,56 @@ struct ipa_hw_stats_drop {
 	struct ipa_drop_stats_all stats;
 };
 
+#define IPA_HW_STATS_SNAP_RING 8
+#define IPA_HW_STATS_SNAP_MIN_MS 100
+
+/**
+ * struct ipa_hw_stats_sample - counter deltas read by one snapshot
+ * @ts: when the snapshot was taken
+ * @quota: quota deltas, per pipe
+ * @teth: tethering deltas, per producer pipe, summed over consumers
+ * @drop: drop deltas, per client
+ */
+struct ipa_hw_stats_sample {
+	ktime_t ts;
+	struct ipa_quota_stats_all quota;
+	struct ipa_quota_stats_all teth;
+	struct ipa_drop_stats_all drop;
+};
+
+/**
+ * struct ipa_hw_stats_snap - periodic hw stats snapshots
+ * @interval_ms: sampling interval, 0 when not sampling
+ * @wq: workqueue running @work
+ * @work: takes a snapshot and reschedules itself
+ * @lock: serializes hw stats reads, resets and inits
+ * @seq: lets the driver caches and @ring be read without @lock
+ * @mem: DMA buffer the counter groups are read into
+ * @quota_all: parsed quota counters of the last snapshot
+ * @teth_all: parsed tethering counters of the last snapshot
+ * @drop_all: parsed drop counters of the last snapshot
+ * @teth_pending: tethering deltas read by snapshots since the last
+ *	ipa_get_teth_stats(), handed over to teth.prod_stats by it
+ * @ring: deltas of the most recent snapshots
+ * @head: where the next snapshot goes in @ring
+ * @num_samples: snapshots taken so far
+ */
+struct ipa_hw_stats_snap {
+	u32 interval_ms;
+	struct workqueue_struct *wq;
+	struct delayed_work work;
+	struct mutex lock;
+	seqcount_mutex_t seq;
+	struct ipa_mem_buffer mem;
+	struct ipahal_stats_quota_all quota_all;
+	struct ipahal_stats_tethering_all teth_all;
+	struct ipahal_stats_drop_all drop_all;
+	struct ipa_quota_stats_all teth_pending[IPA5_PIPES_NUM];
+	struct ipa_hw_stats_sample ring[IPA_HW_STATS_SNAP_RING];
+	u32 head;
+	u64 num_samples;
+};
+
 struct ipa_hw_stats {
 	bool enabled;
 	struct ipa_hw_stats_quota quota;
@@ -1983,6 +2169,7 @@ struct ipa_hw_stats {
 	struct ipa_hw_stats_flt_rt flt_rt;
 	struct ipa_hw_stats_drop drop;
 	bool teth_stats_enabled;
+	struct ipa_hw_stats_snap *snap;
 };
 
 struct ipa_cne_evt {
@@ -2234,6 +2421,9 @@ enum ipa_per_usb_enum_type_e {
  * @ipa_cfg_offset: offset from IPA_WRAPPER_BASE to IPA registers
  * @hdr_tbl: IPA header table
  * @hdr_proc_ctx_tbl: IPA processing context table
+ * @hdr_compact: header table compaction counters
+ * @hdr_rt_pending: ip families whose rt tables still have to be committed
+ *  before the old copies of relocated headers are released
  * @rt_tbl_set: list of routing tables each of which is a list of rules
  * @reap_rt_tbl_set: list of sys mem routing tables waiting to be reaped
  * @flt_rule_cache: filter rule cache
@@ -2331,6 +2521,7 @@ enum ipa_per_usb_enum_type_e {
  * @ipa_gpi_event_rp_ddr: use DDR to access event RP for GPI channels
  * @rmnet_ctl_enable: enable pipe support fow low latency data
  * @rmnet_ll_enable: enable pipe support fow low latency data
+ * @ll_rx_poll: busy poll state and RX latency of the low lat data pipe
  * @gsi_fw_file_name: GSI IPA fw file name
  * @uc_fw_file_name: uC IPA fw file name
  * @eth_info: ethernet client mapping
@@ -2357,6 +2548,8 @@ struct ipa3_context {
 	bool set_evict_reg;
 	struct ipa3_hdr_tbl hdr_tbl[HDR_TBLS_TOTAL];
 	struct ipa3_hdr_proc_ctx_tbl hdr_proc_ctx_tbl;
+	struct ipa3_hdr_compact_stats hdr_compact;
+	u32 hdr_rt_pending;
 	struct ipa3_rt_tbl_set rt_tbl_set[IPA_IP_MAX];
 	struct ipa3_rt_tbl_set reap_rt_tbl_set[IPA_IP_MAX];
 	struct kmem_cache *flt_rule_cache;
@@ -2553,6 +2746,7 @@ struct ipa3_context {
 	bool ipa_gpi_event_rp_ddr;
 	bool rmnet_ctl_enable;
 	bool rmnet_ll_enable;
+	struct ipa3_ll_rx_poll ll_rx_poll;
 	char *gsi_fw_file_name;
 	char *uc_fw_file_name;
 	struct ipa3_eth_info
@@ -3079,6 +3273,17 @@ int ipa3_copy_hdr(struct ipa_ioc_copy_hdr *copy);
 
 u32 ipa3_get_hdr_bin_size(int index);
 
+u32 ipa3_get_hdr_proc_ctx_bin_size(int index);
+
+int ipa3_compact_hdr(void);
+
+void ipa3_hdr_rt_committed(enum ipa_ip_type ip);
+
+void ipa3_get_hdr_mem_stats(enum hdr_tbl_storage loc,
+	struct ipa3_hdr_mem_stats *stats);
+
+void ipa3_get_hdr_proc_ctx_mem_stats(struct ipa3_hdr_mem_stats *stats);
+
 /*
  * Header Processing Context
  */
@@ -3297,6 +3502,8 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		u32 num_desc,
 		struct ipa3_desc *desc,
 		bool in_atomic);
+void ipa3_get_rx_page_pool_occupancy(enum ipa_client_type client,
+		u32 *ring, u32 *pool);
 int ipa_get_ep_mapping(enum ipa_client_type client);
 int ipa_get_ep_group(enum ipa_client_type client);
 
@@ -3394,6 +3601,8 @@ int _ipa_init_flt6_v3(void);
 
 int __ipa_commit_flt_v3(enum ipa_ip_type ip);
 int __ipa_commit_rt_v3(enum ipa_ip_type ip);
+void ipa3_set_rt_tbls_dirty(enum ipa_ip_type ip);
+bool ipa3_set_rt_tbls_hdr_moved(enum ipa_ip_type ip);
 
 int __ipa_commit_hdr_v3_0(void);
 void ipa3_skb_recycle(struct sk_buff *skb);
@@ -3493,6 +3702,12 @@ struct ipa_teth_stats_endpoints {
 
 int ipa_hw_stats_init(void);
 
+void ipa_hw_stats_destroy(void);
+
+int ipa_hw_stats_set_snapshot(u32 interval_ms);
+
+int ipa_hw_stats_get_samples(struct ipa_hw_stats_sample *out, int max);
+
 int ipa_init_flt_rt_stats(void);
 
 int ipa_debugfs_init_stats(struct dentry *parent);
@@ -3590,6 +3805,10 @@ int ipa3_setup_apps_low_lat_cons_pipe(bool rmnet_config,
 	struct rmnet_ingress_param *ingress_param);
 int ipa3_teardown_apps_low_lat_pipes(void);
 int ipa3_rmnet_ll_init(void);
+void ipa3_rmnet_ll_rx_poll_init(void);
+int ipa3_rmnet_ll_set_busy_poll(int cpu, u32 idle_us);
+u64 ipa3_rmnet_ll_rx_lat_quantile(u32 per_10k);
+void ipa3_rmnet_ll_rx_lat_reset(void);
 int ipa3_setup_apps_low_lat_data_prod_pipe(
 	struct rmnet_egress_param *egress_param,
 	struct net_device *dev);
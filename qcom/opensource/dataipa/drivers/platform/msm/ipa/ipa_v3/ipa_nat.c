@@ -1943,16 +1943,17 @@ int ipa3_table_dma_cmd(
 	enum ipahal_imm_cmd_name cmd_name = IPA_IMM_CMD_NAT_DMA;
 
 	struct ipahal_imm_cmd_table_dma cmd;
-	struct ipahal_imm_cmd_pyld *cmd_pyld[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
-	struct ipa3_desc desc[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
+	struct ipahal_imm_cmd_pyld *cmd_pyld_buf[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
+	struct ipa3_desc desc_buf[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
+	struct ipahal_imm_cmd_pyld **cmd_pyld = cmd_pyld_buf;
+	struct ipa3_desc *desc = desc_buf;
 
-	uint8_t cnt, num_cmd = 0;
+	int cnt, num_cmd = 0, num_desc;
 
 	int result = 0;
 	int i;
 	struct ipahal_reg_valmask valmask;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
-	int max_dma_table_cmds = IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC;
 
 	IPADBG("In\n");
 
@@ -1975,25 +1976,38 @@ int ipa3_table_dma_cmd(
 	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(dma->mem_type));
 
 	memset(&cmd, 0, sizeof(cmd));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-	memset(desc, 0, sizeof(desc));
-
-	/**
-	 * We use a descriptor for closing coalsceing endpoint
-	 * by immediate command. So, DMA entries should be less than
-	 * IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC - 1 to overcome
-	 * buffer overflow of ipa3_desc array.
-	 */
-	if (ipa_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1)
-		max_dma_table_cmds -= 1;
+	memset(cmd_pyld_buf, 0, sizeof(cmd_pyld_buf));
+	memset(desc_buf, 0, sizeof(desc_buf));
 
-	if (!dma->entries || dma->entries > (max_dma_table_cmds - 1)) {
+	if (!dma->entries || dma->entries > IPA_TABLE_DMA_CMD_MAX_ENTRIES) {
 		IPAERR_RL("Invalid number of entries %d\n",
 			dma->entries);
 		result = -EPERM;
 		goto bail;
 	}
 
+	/**
+	 * Besides the DMA entries, one descriptor is used for the NOP
+	 * and one more for closing the coalescing endpoint by immediate
+	 * command. All of them go out chained in one ipa3_send_cmd().
+	 * Batches which do not fit the on-stack arrays, such as bulk rule
+	 * updates from user space, get them allocated.
+	 */
+	BUILD_BUG_ON(IPA_TABLE_DMA_CMD_MAX_ENTRIES + 2 > IPA_SEND_MAX_DESC);
+	num_desc = dma->entries + 1;
+	if (ipa_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1)
+		num_desc += 1;
+
+	if (num_desc > IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC) {
+		cmd_pyld = kcalloc(num_desc, sizeof(*cmd_pyld), GFP_KERNEL);
+		desc = kcalloc(num_desc, sizeof(*desc), GFP_KERNEL);
+		if (!cmd_pyld || !desc) {
+			IPAERR("Failed to allocate %d descriptors\n", num_desc);
+			result = -ENOMEM;
+			goto free_desc;
+		}
+	}
+
 	for (cnt = 0; cnt < dma->entries; ++cnt) {
 
 		result = ipa3_table_validate_table_dma_one(
@@ -2088,6 +2102,12 @@ destroy_imm_cmd:
 	for (cnt = 0; cnt < num_cmd; ++cnt)
 		ipahal_destroy_imm_cmd(cmd_pyld[cnt]);
 
+free_desc:
+	if (cmd_pyld != cmd_pyld_buf)
+		kfree(cmd_pyld);
+	if (desc != desc_buf)
+		kfree(desc);
+
 bail:
 	IPADBG("Out\n");
 
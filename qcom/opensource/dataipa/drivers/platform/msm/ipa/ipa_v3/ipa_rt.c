@@ -133,6 +133,78 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	return res;
 }
 
+/**
+ * ipa_rt_tbl_save_lcl_bdy() - keep a copy of a freshly generated local body
+ * @tbl: the rt tbl the body belongs to
+ * @rlt: the rule type of the body
+ * @bdy: the generated body inside the sram image
+ * @len: body length
+ *
+ * The copy lets the next commit lay out the sram image without regenerating
+ * the rules of a table that did not change. Failing to allocate it only
+ * costs a regeneration later.
+ */
+static void ipa_rt_tbl_save_lcl_bdy(struct ipa3_rt_tbl *tbl,
+	enum ipa_rule_type rlt, const u8 *bdy, u32 len)
+{
+	kfree(tbl->lcl_bdy[rlt]);
+	tbl->lcl_bdy[rlt] = len ? kmemdup(bdy, len, GFP_ATOMIC) : NULL;
+}
+
+static void ipa_rt_tbl_free(struct ipa3_rt_tbl *tbl)
+{
+	int i;
+
+	for (i = 0; i < IPA_RULE_TYPE_MAX; i++)
+		kfree(tbl->lcl_bdy[i]);
+	kmem_cache_free(ipa3_ctx->rt_tbl_cache, tbl);
+}
+
+/**
+ * ipa3_set_rt_tbls_dirty() - force regeneration of all rt tables bodies
+ *  on the next commit
+ * @ip: the ip address family type
+ *
+ * Used when something the rules point to (e.g. headers) went away without
+ * the rules themselves being touched.
+ */
+void ipa3_set_rt_tbls_dirty(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl *tbl;
+
+	list_for_each_entry(tbl, &ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list,
+		link)
+		tbl->dirty = true;
+}
+
+/**
+ * ipa3_set_rt_tbls_hdr_moved() - force regeneration of the rt tables bodies
+ *  that point at a relocated header
+ * @ip: the ip address family type
+ *
+ * Returns: true if at least one table was marked
+ */
+bool ipa3_set_rt_tbls_hdr_moved(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl *tbl;
+	struct ipa3_rt_entry *entry;
+	bool marked = false;
+
+	list_for_each_entry(tbl, &ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list,
+		link) {
+		list_for_each_entry(entry, &tbl->head_rt_rule_list, link) {
+			if (!entry->proc_ctx && entry->hdr &&
+				entry->hdr->moved_from) {
+				tbl->dirty = true;
+				marked = true;
+				break;
+			}
+		}
+	}
+
+	return marked;
+}
+
 /**
  * ipa_translate_rt_tbl_to_hw_fmt() - translate the routing driver structures
  *  (rules and tables) to HW format and fill it in the given buffers
@@ -144,6 +216,10 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  *  ipa sram (for local body usage)
  * @apps_start_idx: the first rt table index of apps tables
  *
+ * Tables which did not change since the last commit are not regenerated:
+ * a sys body is left where it is and only its address is written to the
+ * header, a local body is copied from the cache kept by the last commit.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -161,13 +237,25 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	int res;
 	u64 offset;
 	u8 *body_i;
+	u8 *tbl_bdy;
+	u32 bdy_len;
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	body_i = base;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
 		if (tbl->sz[rlt] == 0)
 			continue;
-		if (tbl->in_sys[rlt]) {
+		bdy_len = tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width();
+		if (tbl->in_sys[rlt] && !tbl->dirty &&
+			tbl->curr_mem[rlt].phys_base) {
+			/* body is unchanged, only point the hdr at it */
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base, hdr,
+				tbl->idx - apps_start_idx, true)) {
+				IPAERR_RL("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+		} else if (tbl->in_sys[rlt]) {
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -217,18 +305,29 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_rt_rule_list,
-					link) {
-				if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa_generate_rt_hw_rule(ip, entry,
-					body_i);
-				if (res) {
-					IPAERR_RL("failed to gen HW RT rule\n");
-					goto err;
+			if (!tbl->dirty && tbl->lcl_bdy[rlt]) {
+				memcpy(body_i, tbl->lcl_bdy[rlt], bdy_len);
+				body_i += bdy_len;
+			} else {
+				tbl_bdy = body_i;
+
+				/* generate the rule-set */
+				list_for_each_entry(entry,
+					&tbl->head_rt_rule_list, link) {
+					if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa_generate_rt_hw_rule(ip, entry,
+						body_i);
+					if (res) {
+						IPAERR_RL(
+						"failed to gen HW RT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+
+				ipa_rt_tbl_save_lcl_bdy(tbl, rlt, tbl_bdy,
+					body_i - tbl_bdy);
 			}
 
 			/**
@@ -283,7 +382,7 @@ static void __ipa_reap_sys_rt_tbls(enum ipa_ip_type ip)
 			}
 		}
 		list_del(&tbl->link);
-		kmem_cache_free(ipa3_ctx->rt_tbl_cache, tbl);
+		ipa_rt_tbl_free(tbl);
 	}
 }
 
@@ -534,7 +633,8 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
-		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+		/* clean tables keep the sizes of the last commit */
+		if (tbl->dirty && ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
 			rc = -EPERM;
 			goto no_rt_tbls;
 		}
@@ -758,7 +858,11 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 			alloc_params.nhash_bdy.size);
 	}
 
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+
 	__ipa_reap_sys_rt_tbls(ip);
+	ipa3_hdr_rt_committed(ip);
 
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
@@ -894,6 +998,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		entry->cookie = IPA_RT_TBL_COOKIE;
 		entry->in_sys[IPA_RULE_HASHABLE] = !ipa3_ctx->rt_tbl_hash_lcl[ip];
 		entry->in_sys[IPA_RULE_NON_HASHABLE] = !ipa3_ctx->rt_tbl_nhash_lcl[ip];
+		entry->dirty = true;
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
 		list_add(&entry->link, &set->head_rt_tbl_list);
@@ -963,7 +1068,7 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 		entry->set->tbl_cnt--;
 		IPADBG("del rt tbl_idx=%d tbl_cnt=%d ip=%d\n",
 			entry->idx, entry->set->tbl_cnt, ip);
-		kmem_cache_free(ipa3_ctx->rt_tbl_cache, entry);
+		ipa_rt_tbl_free(entry);
 	}
 
 	/* remove the handle from the database */
@@ -1111,6 +1216,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		tbl->rule_cnt++;
 	else
 		return -EINVAL;
+	tbl->dirty = true;
 	if (entry->hdr)
 		entry->hdr->ref_cnt++;
 	else if (entry->proc_ctx)
@@ -1823,6 +1929,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
 		entry->rule_id, entry->tbl->ref_cnt);
@@ -2015,6 +2122,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					}
 				}
 				tbl->rule_cnt--;
+				tbl->dirty = true;
 				list_del(&rule->link);
 				if (rule->hdr &&
 					(!ipa3_check_idr_if_freed(
@@ -2064,8 +2172,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					  &ipa3_ctx->rt_idx_bitmap[ip]);
 					IPADBG("rst rt tbl_idx=%d tbl_cnt=%d\n",
 						tbl->idx, set->tbl_cnt);
-					kmem_cache_free(ipa3_ctx->rt_tbl_cache,
-						tbl);
+					ipa_rt_tbl_free(tbl);
 				}
 				/* remove the handle from the database */
 				ipa3_id_remove(id);
@@ -2244,6 +2351,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 	entry->rule = rtrule->rule;
 	entry->hdr = hdr;
 	entry->proc_ctx = proc_ctx;
+	entry->tbl->dirty = true;
 
 	if (entry->hdr)
 		entry->hdr->ref_cnt++;
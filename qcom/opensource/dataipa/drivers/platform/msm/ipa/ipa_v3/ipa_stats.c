@@ -1497,6 +1497,41 @@ static int ipa_get_page_recycle_stats(unsigned long arg)
 	return 0;
 }
 
+static int ipa_get_pg_pool_stats(unsigned long arg)
+{
+	struct ipa_lnx_pg_pool_stats pg_pool_stats;
+
+	if (!(ipa_lnx_agent_ctx.log_type_mask & TLPD_IPA_LOG_TYPE_PG_POOL_STATS)) {
+		IPA_STATS_ERR("Log type PG_POOL mask not set\n");
+		return -EFAULT;
+	}
+
+	memset(&pg_pool_stats, 0, sizeof(pg_pool_stats));
+	pg_pool_stats.coal_recycled_buff =
+		ipa3_ctx->stats.page_recycle_stats[0].page_recycled;
+	pg_pool_stats.coal_adopted_buff =
+		ipa3_ctx->stats.page_recycle_stats[0].page_adopted;
+	pg_pool_stats.def_recycled_buff =
+		ipa3_ctx->stats.page_recycle_stats[1].page_recycled;
+	pg_pool_stats.def_adopted_buff =
+		ipa3_ctx->stats.page_recycle_stats[1].page_adopted;
+	ipa3_get_rx_page_pool_occupancy(IPA_CLIENT_APPS_WAN_COAL_CONS,
+		&pg_pool_stats.coal_ring_buff,
+		&pg_pool_stats.coal_pool_buff);
+	ipa3_get_rx_page_pool_occupancy(IPA_CLIENT_APPS_WAN_CONS,
+		&pg_pool_stats.def_ring_buff,
+		&pg_pool_stats.def_pool_buff);
+
+	if(copy_to_user((void __user *)arg,
+		(u8 *)&pg_pool_stats,
+		sizeof(pg_pool_stats))) {
+		IPA_STATS_ERR("copy to user failed");
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
 static int ipa_stats_get_alloc_info(unsigned long arg)
 {
 	int i = 0;
@@ -1795,6 +1830,11 @@ static long ipa_lnx_stats_ioctl(struct file *filp,
 		retval = IPA_LNX_STATS_SUCCESS;
 #endif
 		break;
+	case IPA_LNX_IOC_GET_PG_POOL_STATS:
+		retval = ipa_get_pg_pool_stats(arg);
+		if (retval)
+			IPA_STATS_ERR("ipa get page pool stats fail");
+		break;
 	case IPA_LNX_IOC_GET_CONSOLIDATED_STATS:
 		consolidated_stats = (struct ipa_lnx_consolidated_stats *) memdup_user((
 				const void __user *)arg, sizeof(struct ipa_lnx_consolidated_stats));
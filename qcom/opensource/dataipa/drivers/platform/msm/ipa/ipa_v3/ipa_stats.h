@@ -47,6 +47,10 @@
 	IPA_LNX_CMD_CONSOLIDATED_STATS, \
 	int)
 
+#define IPA_LNX_IOC_GET_PG_POOL_STATS _IOWR(IPA_LNX_STATS_IOC_MAGIC, \
+	IPA_LNX_CMD_PG_POOL_STATS, \
+	struct ipa_lnx_pg_pool_stats)
+
 #define IPA_LNX_STATS_SUCCESS 0
 #define IPA_LNX_STATS_FAILURE -1
 
@@ -70,6 +74,7 @@
 #define TLPD_IPA_LOG_TYPE_USB_STATS       0x00010
 #define TLPD_IPA_LOG_TYPE_MHIP_STATS      0x00020
 #define TLPD_IPA_LOG_TYPE_RECYCLE_STATS   0x00040
+#define TLPD_IPA_LOG_TYPE_PG_POOL_STATS   0x00080
 
 
 /**
@@ -366,6 +371,25 @@ struct ipa_lnx_pipe_page_recycling_stats {
 	struct ipa_lnx_recycling_stats rx_channel[RX_CHANNEL_MAX][IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT];
 };
 
+/**
+ * Page pool state of the coal and default pipes. Kept apart from
+ * pg_recycle_stats so the generic stats layout does not change.
+ * @*_recycled_buff: pool pages reused for replenish
+ * @*_adopted_buff: temporary pages taken into the pool
+ * @*_ring_buff: pages currently posted to the ring
+ * @*_pool_buff: size of the pool
+ */
+struct ipa_lnx_pg_pool_stats {
+	uint64_t coal_recycled_buff;
+	uint64_t coal_adopted_buff;
+	uint64_t def_recycled_buff;
+	uint64_t def_adopted_buff;
+	uint32_t coal_ring_buff;
+	uint32_t coal_pool_buff;
+	uint32_t def_ring_buff;
+	uint32_t def_pool_buff;
+};
+
 /* Explain below structures */
 struct ipa_lnx_each_inst_alloc_info {
 	uint32_t pipes_client_type[TLPD_NUM_MAX_PIPES];
@@ -410,6 +434,7 @@ enum ipa_lnx_stats_ioc_cmd_type {
 	IPA_LNX_CMD_USB_INST_STATS,
 	IPA_LNX_CMD_MHIP_INST_STATS,
 	IPA_LNX_CMD_CONSOLIDATED_STATS,
+	IPA_LNX_CMD_PG_POOL_STATS,
 	IPA_LNX_CMD_STATS_MAX,
 };
 
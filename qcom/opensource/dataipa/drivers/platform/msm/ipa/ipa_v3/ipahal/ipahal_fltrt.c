@@ -4786,6 +4786,18 @@ u32 ipahal_get_hw_prefetch_buf_size(void)
 	return ipahal_fltrt_objs[ipahal_ctx->hw_type].prefetech_buf_size;
 }
 
+/* Get the H/W table (flt/rt) width, which is also the terminator size */
+u32 ipahal_get_hw_tbl_width(void)
+{
+	return ipahal_fltrt_objs[ipahal_ctx->hw_type].tbl_width;
+}
+
+/* Get the max size a H/W (flt/rt) rule may utilize */
+u32 ipahal_get_hw_rule_buf_size(void)
+{
+	return ipahal_fltrt_objs[ipahal_ctx->hw_type].rule_buf_size;
+}
+
 /*
  * Rule priority is used to distinguish rules order
  * at the integrated table consisting from hashable and
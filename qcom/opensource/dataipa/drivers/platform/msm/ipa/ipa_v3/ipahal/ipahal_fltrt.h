@@ -152,6 +152,12 @@ u32 ipahal_get_lcl_tbl_addr_alignment(void);
 /* Get the H/W (flt/rt) prefetch buf size */
 u32 ipahal_get_hw_prefetch_buf_size(void);
 
+/* Get the H/W table (flt/rt) width, which is also the terminator size */
+u32 ipahal_get_hw_tbl_width(void);
+
+/* Get the max size a H/W (flt/rt) rule may utilize */
+u32 ipahal_get_hw_rule_buf_size(void);
+
 /*
  * Rule priority is used to distinguish rules order
  * at the integrated table consisting from hashable and
@@ -1431,6 +1431,7 @@ static netdev_tx_t ipa3_wwan_xmit(struct sk_buff *skb, struct net_device *dev)
 	int ret = 0;
 	bool qmap_check;
 	struct ipa3_wwan_private *wwan_ptr = netdev_priv(dev);
+	struct ipa_tx_meta meta = { 0 };
 	unsigned long flags;
 
 	if (rmnet_ipa3_ctx->ipa_config_is_apq) {
@@ -1525,9 +1526,13 @@ send:
 
 	/*
 	 * both data packets and command will be routed to
-	 * IPA_CLIENT_Q6_WAN_CONS based on status configuration
+	 * IPA_CLIENT_Q6_WAN_CONS based on status configuration.
+	 * Let IPA hold the doorbell while the stack has more to send.
 	 */
-	ret = ipa_tx_dp(IPA_CLIENT_APPS_WAN_PROD, skb, NULL);
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 2, 0))
+	meta.xmit_more = netdev_xmit_more();
+#endif
+	ret = ipa_tx_dp(IPA_CLIENT_APPS_WAN_PROD, skb, &meta);
 	if (ret) {
 		atomic_dec(&wwan_ptr->outstanding_pkts);
 		if (ret == -EPIPE) {
@@ -169,6 +169,91 @@ static ssize_t rmnet_ll_ipa3_write_free_credit_threshld
 	return count;
 }
 
+static ssize_t rmnet_ll_ipa3_read_busy_poll
+(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	int nbytes;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"cpu=%d\n"
+		"idle_us=%u\n"
+		"spinning=%u\n"
+		"busy_enter=%llu\n"
+		"busy_exit=%llu\n"
+		"busy_polls=%llu\n",
+		ll->cpu, ll->idle_us, ll->spinning,
+		ll->busy_enter, ll->busy_exit, ll->busy_polls);
+	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
+}
+
+/* "<cpu> <idle_us>", idle_us of 0 turns busy poll off */
+static ssize_t rmnet_ll_ipa3_write_busy_poll
+(struct file *file, const char __user *buf, size_t count, loff_t *ppos) {
+
+	unsigned long missing;
+	char *sptr, *token;
+	u32 cpu, idle_us;
+	int ret;
+
+	if (count >= sizeof(dbg_buff))
+		return -EFAULT;
+
+	missing = copy_from_user(dbg_buff, buf, count);
+	if (missing)
+		return -EFAULT;
+
+	dbg_buff[count] = '\0';
+
+	sptr = dbg_buff;
+
+	token = strsep(&sptr, " ");
+	if (!token)
+		return -EINVAL;
+	if (kstrtou32(token, 0, &cpu))
+		return -EINVAL;
+
+	token = strsep(&sptr, " ");
+	if (!token)
+		return -EINVAL;
+	if (kstrtou32(token, 0, &idle_us))
+		return -EINVAL;
+
+	ret = ipa3_rmnet_ll_set_busy_poll(cpu, idle_us);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
+static ssize_t rmnet_ll_ipa3_read_rx_latency
+(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+
+	struct ipa3_ll_rx_poll *ll = &ipa3_ctx->ll_rx_poll;
+	int nbytes;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"samples=%llu\n"
+		"p50_ns=%llu\n"
+		"p99_ns=%llu\n"
+		"p999_ns=%llu\n"
+		"max_ns=%llu\n",
+		ll->lat_samples,
+		ipa3_rmnet_ll_rx_lat_quantile(5000),
+		ipa3_rmnet_ll_rx_lat_quantile(9900),
+		ipa3_rmnet_ll_rx_lat_quantile(9990),
+		ll->lat_max);
+	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
+}
+
+/* any write clears the histogram */
+static ssize_t rmnet_ll_ipa3_write_rx_latency
+(struct file *file, const char __user *buf, size_t count, loff_t *ppos) {
+
+	ipa3_rmnet_ll_rx_lat_reset();
+	return count;
+}
+
 
 #define READ_WRITE_MODE 0664
 #define READ_ONLY_MODE  0444
@@ -182,6 +267,16 @@ static const struct rmnet_ll_ipa3_debugfs_file debugfs_files[] = {
 			.read = rmnet_ll_ipa3_read_free_credit_threshld,
 			.write = rmnet_ll_ipa3_write_free_credit_threshld,
 		}
+	}, {
+		"busy_poll", READ_WRITE_MODE, NULL, {
+			.read = rmnet_ll_ipa3_read_busy_poll,
+			.write = rmnet_ll_ipa3_write_busy_poll,
+		}
+	}, {
+		"rx_latency", READ_WRITE_MODE, NULL, {
+			.read = rmnet_ll_ipa3_read_rx_latency,
+			.write = rmnet_ll_ipa3_write_rx_latency,
+		}
 	},
 };
 
@@ -270,6 +365,7 @@ int ipa3_rmnet_ll_init(void)
 	spin_lock_init(&rmnet_ll_ipa3_ctx->tx_lock);
 	rmnet_ll_ipa3_ctx->pipe_state = IPA_RMNET_LL_PIPE_NOT_READY;
 	rmnet_ll_ipa3_ctx->free_credit_thrshld = IPA_RMNET_LL_FREE_CREDIT_THRSHLD;
+	ipa3_rmnet_ll_rx_poll_init();
 	rmnet_ll_ipa3_debugfs_init();
 	return 0;
 }
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA_FLTRT_HOST_IPA_H_
+#define _IPA_FLTRT_HOST_IPA_H_
+
+/*
+ * Stands in for include/linux/ipa.h on the host: the kernel integer types
+ * and the uapi definitions the ipahal headers are written against.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef long long s64;
+typedef u64 dma_addr_t;
+
+#define __packed __attribute__((packed))
+
+#include <linux/msm_ipa.h>
+
+#endif /* _IPA_FLTRT_HOST_IPA_H_ */
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA_FLTRT_HOST_COMMON_I_H_
+#define _IPA_FLTRT_HOST_COMMON_I_H_
+
+/*
+ * Stands in for ipa_common_i.h on the host, with just what ipahal_fltrt.c
+ * uses from the kernel and from the IPA core. Logging goes to stderr, DMA
+ * memory is plain heap memory.
+ */
+
+#include <stdio.h>
+#include <arpa/inet.h>
+#include "ipa.h"
+
+#define __iomem
+#define unlikely(x) __builtin_expect(!!(x), 0)
+#define likely(x) __builtin_expect(!!(x), 1)
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define BIT(nr) (1UL << (nr))
+#define hweight_long(w) __builtin_popcountl(w)
+
+#define GFP_KERNEL 0
+#define GFP_ATOMIC 1
+typedef unsigned int gfp_t;
+#define kzalloc(size, flags) calloc(1, (size))
+#define kfree(ptr) free(ptr)
+
+#define pr_err(fmt, args...) fprintf(stderr, fmt, ## args)
+#define pr_debug(fmt, args...) do { } while (0)
+#define pr_err_ratelimited_ipa(fmt, args...) pr_err(fmt, ## args)
+#define IPA_IPC_LOGGING(buf, fmt, args...) do { } while (0)
+
+#define WARN_ON(condition) ({ \
+	int __ret = !!(condition); \
+	if (__ret) \
+		pr_err("WARN_ON(%s) at %s:%d\n", #condition, __func__, \
+			__LINE__); \
+	__ret; \
+})
+#define WARN_ON_RATELIMIT_IPA(condition) WARN_ON(condition)
+
+void ipa_assert(void);
+#define ipa_assert_on(condition) \
+do { \
+	if (unlikely(condition)) \
+		ipa_assert(); \
+} while (0)
+
+struct device;
+struct dentry;
+struct ipa_hdr_offset_entry;
+
+struct ipa_mem_buffer {
+	void *base;
+	dma_addr_t phys_base;
+	u32 size;
+};
+
+void *dma_alloc_coherent(struct device *dev, size_t size,
+	dma_addr_t *dma_handle, int flags);
+void dma_free_coherent(struct device *dev, size_t size, void *cpu_addr,
+	dma_addr_t dma_handle);
+
+void *ipa3_get_ipc_logbuf(void);
+void *ipa3_get_ipc_logbuf_low(void);
+
+u8 *ipa_write_64(u64 w, u8 *dest);
+u8 *ipa_write_32(u32 w, u8 *dest);
+u8 *ipa_write_16(u16 hw, u8 *dest);
+u8 *ipa_write_8(u8 b, u8 *dest);
+u8 *ipa_pad_to_64(u8 *dest);
+
+#endif /* _IPA_FLTRT_HOST_COMMON_I_H_ */
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/* Host versions of the IPA core and ipahal.c helpers ipahal_fltrt.c calls */
+
+#include "ipahal_i.h"
+
+static struct ipahal_context ipahal_host_ctx;
+struct ipahal_context *ipahal_ctx = &ipahal_host_ctx;
+
+void ipa_assert(void)
+{
+	pr_err("IPA: unrecoverable error has occurred, asserting\n");
+	abort();
+}
+
+void *ipa3_get_ipc_logbuf(void)
+{
+	return NULL;
+}
+
+void *ipa3_get_ipc_logbuf_low(void)
+{
+	return NULL;
+}
+
+/* the tables only have to be aligned as the HW expects */
+void *dma_alloc_coherent(struct device *dev, size_t size,
+	dma_addr_t *dma_handle, int flags)
+{
+	void *base = aligned_alloc(4096, (size + 4095) & ~4095UL);
+
+	*dma_handle = (dma_addr_t)(uintptr_t)base;
+	return base;
+}
+
+void dma_free_coherent(struct device *dev, size_t size, void *cpu_addr,
+	dma_addr_t dma_handle)
+{
+	free(cpu_addr);
+}
+
+void ipahal_free_dma_mem(struct ipa_mem_buffer *mem)
+{
+	if (likely(mem)) {
+		dma_free_coherent(ipahal_ctx->ipa_pdev, mem->size, mem->base,
+			mem->phys_base);
+		mem->size = 0;
+		mem->base = NULL;
+		mem->phys_base = 0;
+	}
+}
+
+u8 *ipa_write_64(u64 w, u8 *dest)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		*dest++ = (u8)((w >> (8 * i)) & 0xFF);
+
+	return dest;
+}
+
+u8 *ipa_write_32(u32 w, u8 *dest)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		*dest++ = (u8)((w >> (8 * i)) & 0xFF);
+
+	return dest;
+}
+
+u8 *ipa_write_16(u16 hw, u8 *dest)
+{
+	*dest++ = (u8)(hw & 0xFF);
+	*dest++ = (u8)((hw >> 8) & 0xFF);
+
+	return dest;
+}
+
+u8 *ipa_write_8(u8 b, u8 *dest)
+{
+	*dest++ = b;
+
+	return dest;
+}
+
+u8 *ipa_pad_to_64(u8 *dest)
+{
+	int i = (long)dest & 0x7;
+	int j;
+
+	if (i)
+		for (j = 0; j < (8 - i); j++)
+			*dest++ = 0;
+
+	return dest;
+}
@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA_FLTRT_HOST_H_
+#define _IPA_FLTRT_HOST_H_
+
+/* What ipa_test_fltrt_gen.c takes from the kernel and the UT framework */
+
+#include <time.h>
+#include "ipa_common_i.h"
+
+#define IPA_UT_ERR(fmt, args...) \
+	fprintf(stderr, "%s:%d " fmt, __func__, __LINE__, ## args)
+
+#define IPA_UT_INFO(fmt, args...) \
+	fprintf(stdout, fmt, ## args)
+
+#define swap(a, b) \
+	do { typeof(a) __tmp = (a); (a) = (b); (b) = __tmp; } while (0)
+
+#define div_u64(dividend, divisor) ((u64)(dividend) / (divisor))
+
+static inline u64 ktime_get_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif /* _IPA_FLTRT_HOST_H_ */
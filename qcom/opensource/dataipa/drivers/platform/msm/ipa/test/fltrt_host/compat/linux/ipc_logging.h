@@ -0,0 +1,9 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/* nothing from this header is used on the host */
+#ifndef _IPA_FLTRT_HOST_IPC_LOGGING_H_
+#define _IPA_FLTRT_HOST_IPC_LOGGING_H_
+#endif /* _IPA_FLTRT_HOST_IPC_LOGGING_H_ */
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Host harness for the rt/flt rule image generation of ipahal_fltrt.c.
+ * ipahal is initialized for every IPA version in turn (or the one given
+ * with -v), then random rules are fuzzed for image size mistakes and a few
+ * typical rule sets are timed, with their image size per rule.
+ */
+
+#include <unistd.h>
+#include "ipa_fltrt_host.h"
+#include "ipa_test_fltrt_gen.h"
+#include "ipahal_i.h"
+#include "ipahal_fltrt_i.h"
+
+#define IPA_FLTRT_HOST_FUZZ_ITER 65536
+#define IPA_FLTRT_HOST_DST_PIPE 1
+
+static int ipa_fltrt_host_run(enum ipa_hw_type hw_type, u64 seed, u32 iter)
+{
+	struct ipa_test_fltrt_bench_res res;
+	const struct ipa_test_fltrt_profile *prof;
+	u32 accepted, rejected, i;
+	int is_flt, ret;
+
+	ipahal_ctx->hw_type = hw_type;
+	if (ipahal_fltrt_init(hw_type)) {
+		IPA_UT_ERR("ipahal init failed for IPA HW %d\n", hw_type);
+		return -EFAULT;
+	}
+
+	printf("IPA HW %d: max rule size %u\n", hw_type,
+		ipahal_get_hw_rule_buf_size());
+
+	ret = ipa_test_fltrt_fuzz(hw_type, IPA_FLTRT_HOST_DST_PIPE, seed, iter,
+		&accepted, &rejected);
+	printf("  fuzz seed 0x%llx: accepted %u rejected %u%s\n", seed,
+		accepted, rejected, ret ? " BAD IMAGE" : "");
+
+	for (i = 0; !ret && i < ipa_test_fltrt_num_profiles; i++) {
+		prof = &ipa_test_fltrt_profiles[i];
+		for (is_flt = 0; is_flt <= 1; is_flt++) {
+			ret = ipa_test_fltrt_bench(prof, is_flt,
+				IPA_FLTRT_HOST_DST_PIPE, &res);
+			if (ret)
+				break;
+			if (!res.num) {
+				printf("  %s %s: not supported\n", prof->name,
+					is_flt ? "flt" : "rt");
+				continue;
+			}
+			printf("  %s %s: %llu ns/rule %u bytes/rule\n",
+				prof->name, is_flt ? "flt" : "rt",
+				res.ns_per_rule, res.bytes_per_rule);
+		}
+	}
+
+	ipahal_fltrt_destroy();
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int hw_type = -1;
+	u64 seed = ktime_get_ns();
+	u32 iter = IPA_FLTRT_HOST_FUZZ_ITER;
+	int opt, hw, ret = 0;
+
+	while ((opt = getopt(argc, argv, "v:s:n:")) != -1) {
+		switch (opt) {
+		case 'v':
+			hw_type = strtol(optarg, NULL, 0);
+			break;
+		case 's':
+			seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'n':
+			iter = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr,
+				"usage: %s [-v hw_type] [-s seed] [-n iter]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+
+	if (hw_type != -1 && (hw_type < IPA_HW_v3_0 || hw_type >= IPA_HW_MAX)) {
+		fprintf(stderr, "hw_type %d not in [%d, %d)\n", hw_type,
+			IPA_HW_v3_0, IPA_HW_MAX);
+		return 2;
+	}
+
+	for (hw = IPA_HW_v3_0; hw < IPA_HW_MAX; hw++) {
+		if (hw_type != -1 && hw != hw_type)
+			continue;
+		if (ipa_fltrt_host_run(hw, seed, iter))
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include <linux/ktime.h>
+#include <linux/random.h>
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+#include "ipa_test_fltrt_gen.h"
+
+/**
+ * Routing commit latency suite
+ * Measures the cost of an rt commit against the number of rules installed
+ * in tables which are not touched by the commit. Two tables are used:
+ * a static one holding the measured number of rules and a small one which
+ * is modified before every commit, the way tethering and firewall churn
+ * touch a single table at a time.
+ */
+
+#define IPA_UT_FLTRT_STATIC_TBL "ipa_ut_fltrt_static"
+#define IPA_UT_FLTRT_CHURN_TBL "ipa_ut_fltrt_churn"
+#define IPA_UT_FLTRT_ITER 32
+#define IPA_UT_FLTRT_BASE_PORT 20000
+
+static const u8 ipa_test_fltrt_rule_cnt[] = { 4, 16, 64 };
+
+static void ipa_test_fltrt_fill_rule(struct ipa_rt_rule *rule, u16 port)
+{
+	memset(rule, 0, sizeof(*rule));
+	rule->dst = IPA_CLIENT_APPS_LAN_CONS;
+	rule->attrib.attrib_mask = IPA_FLT_DST_PORT;
+	rule->attrib.dst_port = port;
+}
+
+static int ipa_test_fltrt_add(const char *name, u8 num, u16 port,
+	u32 *hdls)
+{
+	struct ipa_ioc_add_rt_rule *add;
+	int i, ret = 0;
+
+	add = kzalloc(sizeof(*add) + num * sizeof(add->rules[0]), GFP_KERNEL);
+	if (!add)
+		return -ENOMEM;
+
+	add->commit = 0;
+	add->ip = IPA_IP_v4;
+	add->num_rules = num;
+	strlcpy(add->rt_tbl_name, name, IPA_RESOURCE_NAME_MAX);
+	for (i = 0; i < num; i++) {
+		ipa_test_fltrt_fill_rule(&add->rules[i].rule, port + i);
+		add->rules[i].at_rear = 1;
+	}
+
+	if (ipa_add_rt_rule(add)) {
+		IPA_UT_ERR("failed to add %u rules to %s\n", num, name);
+		ret = -EFAULT;
+		goto free;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (add->rules[i].status) {
+			IPA_UT_ERR("rule %d status %d\n", i,
+				add->rules[i].status);
+			ret = -EFAULT;
+		}
+		hdls[i] = add->rules[i].rt_rule_hdl;
+	}
+
+free:
+	kfree(add);
+	return ret;
+}
+
+static void ipa_test_fltrt_del(u32 *hdls, u8 num)
+{
+	struct ipa_ioc_del_rt_rule *del;
+	int i;
+
+	del = kzalloc(sizeof(*del) + num * sizeof(del->hdl[0]), GFP_KERNEL);
+	if (!del)
+		return;
+
+	del->commit = 1;
+	del->ip = IPA_IP_v4;
+	del->num_hdls = num;
+	for (i = 0; i < num; i++)
+		del->hdl[i].hdl = hdls[i];
+
+	if (ipa3_del_rt_rule(del))
+		IPA_UT_ERR("failed to delete %u rules\n", num);
+
+	kfree(del);
+}
+
+static int ipa_test_fltrt_mdfy(u32 hdl, u16 port)
+{
+	struct ipa_ioc_mdfy_rt_rule *mdfy;
+	int ret = 0;
+
+	mdfy = kzalloc(sizeof(*mdfy) + sizeof(mdfy->rules[0]), GFP_KERNEL);
+	if (!mdfy)
+		return -ENOMEM;
+
+	mdfy->commit = 0;
+	mdfy->ip = IPA_IP_v4;
+	mdfy->num_rules = 1;
+	mdfy->rules[0].rt_rule_hdl = hdl;
+	ipa_test_fltrt_fill_rule(&mdfy->rules[0].rule, port);
+
+	if (ipa3_mdfy_rt_rule(mdfy) || mdfy->rules[0].status)
+		ret = -EFAULT;
+
+	kfree(mdfy);
+	return ret;
+}
+
+/*
+ * Average commit latency, in ns, over IPA_UT_FLTRT_ITER commits.
+ * @full: regenerate every table on each commit, as before the dirty
+ *  tracking was added, instead of only the churned one
+ */
+static int ipa_test_fltrt_measure(u32 churn_hdl, bool full, u64 *avg_ns)
+{
+	u64 start, total = 0;
+	int i;
+
+	for (i = 0; i < IPA_UT_FLTRT_ITER; i++) {
+		if (ipa_test_fltrt_mdfy(churn_hdl, IPA_UT_FLTRT_BASE_PORT +
+			(i & 1))) {
+			IPA_UT_ERR("failed to modify churn rule\n");
+			return -EFAULT;
+		}
+
+		if (full) {
+			mutex_lock(&ipa3_ctx->lock);
+			ipa3_set_rt_tbls_dirty(IPA_IP_v4);
+			mutex_unlock(&ipa3_ctx->lock);
+		}
+
+		start = ktime_get_ns();
+		if (ipa3_commit_rt(IPA_IP_v4)) {
+			IPA_UT_ERR("commit failed\n");
+			return -EFAULT;
+		}
+		total += ktime_get_ns() - start;
+	}
+
+	*avg_ns = div_u64(total, IPA_UT_FLTRT_ITER);
+	return 0;
+}
+
+static int ipa_test_fltrt_rt_commit_latency(void *priv)
+{
+	u32 hdls[64];
+	u32 churn_hdl;
+	u64 delta_ns, full_ns;
+	u8 num;
+	int i, ret = 0;
+
+	if (ipa_test_fltrt_add(IPA_UT_FLTRT_CHURN_TBL, 1,
+		IPA_UT_FLTRT_BASE_PORT, &churn_hdl)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add churn rule");
+		return -EFAULT;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ipa_test_fltrt_rule_cnt); i++) {
+		num = ipa_test_fltrt_rule_cnt[i];
+
+		ret = ipa_test_fltrt_add(IPA_UT_FLTRT_STATIC_TBL, num,
+			IPA_UT_FLTRT_BASE_PORT + 2, hdls);
+		if (ret) {
+			IPA_UT_TEST_FAIL_REPORT("fail to add static rules");
+			break;
+		}
+
+		ret = ipa_test_fltrt_measure(churn_hdl, false, &delta_ns);
+		if (!ret)
+			ret = ipa_test_fltrt_measure(churn_hdl, true, &full_ns);
+		ipa_test_fltrt_del(hdls, num);
+		if (ret) {
+			IPA_UT_TEST_FAIL_REPORT("fail to measure commit");
+			break;
+		}
+
+		IPA_UT_INFO("rules %u: dirty-only commit %llu ns full %llu ns\n",
+			num, delta_ns, full_ns);
+	}
+
+	ipa_test_fltrt_del(&churn_hdl, 1);
+
+	return ret;
+}
+
+/**
+ * Rule image generation
+ * Runs the shared rule generator of ipa_test_fltrt_gen.c against the ipahal
+ * of the running IPA version. The host harness in fltrt_host/ runs the same
+ * generator against every IPA version.
+ */
+
+#define IPA_UT_FLTRT_FUZZ_ITER 4096
+
+static int ipa_test_fltrt_gen_fuzz(void *priv)
+{
+	u32 accepted, rejected;
+	u64 seed;
+	int ret;
+
+	get_random_bytes(&seed, sizeof(seed));
+	IPA_UT_INFO("seed 0x%llx\n", seed);
+
+	ret = ipa_test_fltrt_fuzz(ipa3_ctx->ipa_hw_type,
+		ipa_get_ep_mapping(IPA_CLIENT_APPS_LAN_CONS), seed,
+		IPA_UT_FLTRT_FUZZ_ITER, &accepted, &rejected);
+	IPA_UT_INFO("rules accepted %u rejected %u\n", accepted, rejected);
+	if (ret)
+		IPA_UT_TEST_FAIL_REPORT("bad rule image");
+
+	return ret;
+}
+
+static void ipa_test_fltrt_bench_profile(
+	const struct ipa_test_fltrt_profile *prof, bool is_flt)
+{
+	struct ipa_test_fltrt_bench_res res;
+	u32 sram_sz;
+
+	if (ipa_test_fltrt_bench(prof, is_flt,
+		ipa_get_ep_mapping(IPA_CLIENT_APPS_LAN_CONS), &res)) {
+		IPA_UT_ERR("%s %s: bench failed\n", prof->name,
+			is_flt ? "flt" : "rt");
+		return;
+	}
+
+	if (!res.num) {
+		IPA_UT_INFO("%s %s: not supported\n", prof->name,
+			is_flt ? "flt" : "rt");
+		return;
+	}
+
+	if (is_flt)
+		sram_sz = (prof->ip == IPA_IP_v4) ?
+			IPA_MEM_PART(v4_flt_nhash_size) :
+			IPA_MEM_PART(v6_flt_nhash_size);
+	else
+		sram_sz = (prof->ip == IPA_IP_v4) ?
+			IPA_MEM_PART(v4_rt_nhash_size) :
+			IPA_MEM_PART(v6_rt_nhash_size);
+
+	/* table headers and terminators are left out of the fit estimate */
+	IPA_UT_INFO("%s %s: %llu ns/rule %u bytes/rule ~%u rules in %u SRAM bytes\n",
+		prof->name, is_flt ? "flt" : "rt", res.ns_per_rule,
+		res.bytes_per_rule,
+		res.bytes_per_rule ? sram_sz / res.bytes_per_rule : 0, sram_sz);
+}
+
+static int ipa_test_fltrt_gen_bench(void *priv)
+{
+	int i;
+
+	IPA_UT_INFO("IPA HW type %d, max rule size %u\n",
+		ipa3_ctx->ipa_hw_type, ipahal_get_hw_rule_buf_size());
+
+	for (i = 0; i < ipa_test_fltrt_num_profiles; i++) {
+		ipa_test_fltrt_bench_profile(&ipa_test_fltrt_profiles[i],
+			false);
+		ipa_test_fltrt_bench_profile(&ipa_test_fltrt_profiles[i],
+			true);
+	}
+
+	return 0;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(fltrt, "FLT/RT commit and rule images",
+	NULL, NULL)
+{
+	IPA_UT_ADD_TEST(rt_commit_latency,
+		"RT commit latency vs. rules in untouched tables",
+		ipa_test_fltrt_rt_commit_latency,
+		true, IPA_HW_v4_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(rule_gen_fuzz,
+		"Random rules build to images of the reported size",
+		ipa_test_fltrt_gen_fuzz,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(rule_gen_bench,
+		"Rule image generation time and size per rule set",
+		ipa_test_fltrt_gen_bench,
+		false, IPA_HW_v3_0, IPA_HW_MAX),
+} IPA_UT_DEFINE_SUITE_END(fltrt);
@@ -0,0 +1,414 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifdef __KERNEL__
+#include <linux/ktime.h>
+#include "ipa_ut_framework.h"
+#else
+#include "ipa_fltrt_host.h"
+#endif
+#include "ipa_test_fltrt_gen.h"
+
+/**
+ * Rule image generation
+ * Random rule attributes are run through the ipahal rt/flt rule generators.
+ * Every accepted rule is checked for:
+ * - the size query (no buffer) matching the size of the built image
+ * - the image, and its terminator, not writing past the reported size
+ * - the image parsing back to the same size, id and priority
+ * The bench part reports generation time and image size per rule for a few
+ * typical rule sets.
+ */
+
+#define IPA_UT_FLTRT_BENCH_ITER 1024
+#define IPA_UT_FLTRT_GUARD_SZ 64
+#define IPA_UT_FLTRT_GUARD_BYTE 0xA5
+#define IPA_UT_FLTRT_BENCH_SEED 0x1f2e3d4c5b6a7988ULL
+
+/*
+ * Equation pools the ipahal rule body generators take attributes from. Each
+ * pool has two equations on every IPA version, see ipa3_0_ofst_meq32[] and
+ * friends in ipahal_fltrt.c. The other attributes have an equation of their
+ * own. TOS is counted on meq32, its fallback when the TOS equation is missing.
+ */
+enum ipa_test_fltrt_pool {
+	IPA_UT_FLTRT_POOL_NONE,
+	IPA_UT_FLTRT_POOL_MEQ32,
+	IPA_UT_FLTRT_POOL_MEQ128,
+	IPA_UT_FLTRT_POOL_IHL_MEQ32,
+	IPA_UT_FLTRT_POOL_IHL_RNG16,
+	IPA_UT_FLTRT_POOL_MAX,
+};
+
+#define IPA_UT_FLTRT_POOL_SZ 2
+
+struct ipa_test_fltrt_attr {
+	u32 mask;
+	enum ipa_test_fltrt_pool pool;
+};
+
+static const struct ipa_test_fltrt_attr ipa_test_fltrt_v4_attrs[] = {
+	{ IPA_FLT_TOS, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_PROTOCOL, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_SRC_ADDR, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_DST_ADDR, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_SRC_PORT_RANGE, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_DST_PORT_RANGE, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_TYPE, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_CODE, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_SPI, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_SRC_PORT, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_DST_PORT, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_META_DATA, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_FRAGMENT, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_TOS_MASKED, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_MAC_ETHER_TYPE, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_MAC_DST_ADDR_ETHER_II, IPA_UT_FLTRT_POOL_MEQ128 },
+	{ IPA_FLT_TCP_SYN, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_IS_PURE_ACK, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_VLAN_ID, IPA_UT_FLTRT_POOL_MEQ32 },
+};
+
+static const struct ipa_test_fltrt_attr ipa_test_fltrt_v6_attrs[] = {
+	{ IPA_FLT_TC, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_FLOW_LABEL, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_NEXT_HDR, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_SRC_ADDR, IPA_UT_FLTRT_POOL_MEQ128 },
+	{ IPA_FLT_DST_ADDR, IPA_UT_FLTRT_POOL_MEQ128 },
+	{ IPA_FLT_SRC_PORT_RANGE, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_DST_PORT_RANGE, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_TYPE, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_CODE, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_SPI, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_SRC_PORT, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_DST_PORT, IPA_UT_FLTRT_POOL_IHL_RNG16 },
+	{ IPA_FLT_META_DATA, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_FRAGMENT, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_MAC_ETHER_TYPE, IPA_UT_FLTRT_POOL_MEQ32 },
+	{ IPA_FLT_MAC_DST_ADDR_ETHER_II, IPA_UT_FLTRT_POOL_MEQ128 },
+	{ IPA_FLT_TCP_SYN, IPA_UT_FLTRT_POOL_IHL_MEQ32 },
+	{ IPA_FLT_IS_PURE_ACK, IPA_UT_FLTRT_POOL_NONE },
+	{ IPA_FLT_VLAN_ID, IPA_UT_FLTRT_POOL_MEQ32 },
+};
+
+const struct ipa_test_fltrt_profile ipa_test_fltrt_profiles[] = {
+	{ "v4 dst port", IPA_IP_v4, IPA_FLT_DST_PORT },
+	{ "v4 5-tuple", IPA_IP_v4, IPA_FLT_PROTOCOL | IPA_FLT_SRC_ADDR |
+		IPA_FLT_DST_ADDR | IPA_FLT_SRC_PORT | IPA_FLT_DST_PORT },
+	{ "v4 port range", IPA_IP_v4, IPA_FLT_PROTOCOL |
+		IPA_FLT_DST_PORT_RANGE },
+	{ "v4 metadata+tos", IPA_IP_v4, IPA_FLT_META_DATA |
+		IPA_FLT_TOS_MASKED },
+	{ "v6 dst port", IPA_IP_v6, IPA_FLT_DST_PORT },
+	{ "v6 5-tuple", IPA_IP_v6, IPA_FLT_NEXT_HDR | IPA_FLT_SRC_ADDR |
+		IPA_FLT_DST_ADDR | IPA_FLT_SRC_PORT | IPA_FLT_DST_PORT },
+	{ "v6 flow label", IPA_IP_v6, IPA_FLT_FLOW_LABEL | IPA_FLT_TC },
+};
+
+const u32 ipa_test_fltrt_num_profiles = ARRAY_SIZE(ipa_test_fltrt_profiles);
+
+/* xorshift64*, seeded per run so a failure can be replayed */
+static u32 ipa_test_fltrt_rand(u64 *state)
+{
+	u64 x = *state;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+
+	return (x * 0x2545F4914F6CDD1DULL) >> 32;
+}
+
+static void ipa_test_fltrt_rand_attrib(u64 *state, enum ipa_ip_type ip,
+	u32 attrib_mask, struct ipa_rule_attrib *attrib)
+{
+	u32 *word = (u32 *)attrib;
+	int i;
+
+	for (i = 0; i < sizeof(*attrib) / sizeof(u32); i++)
+		word[i] = ipa_test_fltrt_rand(state);
+
+	attrib->attrib_mask = attrib_mask;
+	attrib->ext_attrib_mask = 0;
+	attrib->is_frag_encoding = 0;
+	if (attrib->src_port_lo > attrib->src_port_hi)
+		swap(attrib->src_port_lo, attrib->src_port_hi);
+	if (attrib->dst_port_lo > attrib->dst_port_hi)
+		swap(attrib->dst_port_lo, attrib->dst_port_hi);
+	if (ip == IPA_IP_v6)
+		attrib->u.v6.flow_label &= 0xfffff;
+}
+
+/*
+ * One to four attributes valid for the IP family, leaving out the ones the
+ * HW can not express: an attribute whose equation pool is used up, or the
+ * pure ACK one before IPA v4.5.
+ */
+static u32 ipa_test_fltrt_rand_mask(u64 *state, enum ipa_hw_type hw_type,
+	enum ipa_ip_type ip)
+{
+	const struct ipa_test_fltrt_attr *attrs, *attr;
+	u8 used[IPA_UT_FLTRT_POOL_MAX] = { 0 };
+	u32 num, mask = 0;
+	int i, cnt = 1 + ipa_test_fltrt_rand(state) % 4;
+
+	if (ip == IPA_IP_v4) {
+		attrs = ipa_test_fltrt_v4_attrs;
+		num = ARRAY_SIZE(ipa_test_fltrt_v4_attrs);
+	} else {
+		attrs = ipa_test_fltrt_v6_attrs;
+		num = ARRAY_SIZE(ipa_test_fltrt_v6_attrs);
+	}
+
+	for (i = 0; i < cnt; i++) {
+		attr = &attrs[ipa_test_fltrt_rand(state) % num];
+		if (mask & attr->mask)
+			continue;
+		if (attr->mask == IPA_FLT_IS_PURE_ACK &&
+			hw_type < IPA_HW_v4_5)
+			continue;
+		if (attr->pool != IPA_UT_FLTRT_POOL_NONE &&
+			used[attr->pool] == IPA_UT_FLTRT_POOL_SZ)
+			continue;
+		used[attr->pool]++;
+		mask |= attr->mask;
+	}
+
+	return mask;
+}
+
+/*
+ * Build one rule image, rt when @flt is NULL, and return its size.
+ * @buf is filled with the guard pattern first, NULL only queries the size.
+ */
+static int ipa_test_fltrt_gen(struct ipahal_rt_rule_gen_params *rt,
+	struct ipahal_flt_rule_gen_params *flt, u8 *buf, u32 buf_sz,
+	u32 *hw_len)
+{
+	if (buf)
+		memset(buf, IPA_UT_FLTRT_GUARD_BYTE, buf_sz);
+
+	*hw_len = 0;
+	if (flt)
+		return ipahal_flt_generate_hw_rule(flt, hw_len, buf);
+	return ipahal_rt_generate_hw_rule(rt, hw_len, buf);
+}
+
+/* Returns 1 when the HW can not express the rule, -EFAULT on a bad image */
+static int ipa_test_fltrt_check_img(struct ipahal_rt_rule_gen_params *rt,
+	struct ipahal_flt_rule_gen_params *flt, u8 *buf, u32 buf_sz)
+{
+	struct ipahal_rt_rule_entry rt_parsed;
+	struct ipahal_flt_rule_entry flt_parsed;
+	u32 max_len = ipahal_get_hw_rule_buf_size();
+	u32 tbl_width = ipahal_get_hw_tbl_width();
+	u32 query_len, len, parsed_len, i;
+	u32 parsed_id, parsed_prio;
+
+	if (ipa_test_fltrt_gen(rt, flt, NULL, 0, &query_len))
+		return 1;
+
+	if (query_len > max_len) {
+		IPA_UT_ERR("rule size %u over max %u\n", query_len, max_len);
+		return -EFAULT;
+	}
+
+	if (ipa_test_fltrt_gen(rt, flt, buf, buf_sz, &len)) {
+		IPA_UT_ERR("rule of size %u failed to build\n", query_len);
+		return -EFAULT;
+	}
+
+	if (len != query_len) {
+		IPA_UT_ERR("rule size %u, size query %u\n", len, query_len);
+		return -EFAULT;
+	}
+
+	for (i = len + tbl_width; i < buf_sz; i++) {
+		if (buf[i] != IPA_UT_FLTRT_GUARD_BYTE) {
+			IPA_UT_ERR("rule of size %u wrote byte %u\n", len, i);
+			return -EFAULT;
+		}
+	}
+
+	if (flt) {
+		memset(&flt_parsed, 0, sizeof(flt_parsed));
+		if (ipahal_flt_parse_hw_rule(buf, &flt_parsed)) {
+			IPA_UT_ERR("failed to parse rule of size %u\n", len);
+			return -EFAULT;
+		}
+		parsed_len = flt_parsed.rule_size;
+		parsed_id = flt_parsed.id;
+		parsed_prio = flt_parsed.priority;
+	} else {
+		memset(&rt_parsed, 0, sizeof(rt_parsed));
+		if (ipahal_rt_parse_hw_rule(buf, &rt_parsed)) {
+			IPA_UT_ERR("failed to parse rule of size %u\n", len);
+			return -EFAULT;
+		}
+		parsed_len = rt_parsed.rule_size;
+		parsed_id = rt_parsed.id;
+		parsed_prio = rt_parsed.priority;
+	}
+
+	if (parsed_len != len) {
+		IPA_UT_ERR("rule size %u parsed as %u\n", len, parsed_len);
+		return -EFAULT;
+	}
+
+	if (parsed_id != (flt ? flt->id : rt->id) ||
+		parsed_prio != (flt ? flt->priority : rt->priority)) {
+		IPA_UT_ERR("rule id %u prio %u parsed as id %u prio %u\n",
+			flt ? flt->id : rt->id,
+			flt ? flt->priority : rt->priority,
+			parsed_id, parsed_prio);
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+static void ipa_test_fltrt_fill_params(u64 *state, enum ipa_ip_type ip,
+	u32 attrib_mask, int dst_pipe_idx, struct ipa_rt_rule_i *rt_rule,
+	struct ipa_flt_rule_i *flt_rule,
+	struct ipahal_rt_rule_gen_params *rt,
+	struct ipahal_flt_rule_gen_params *flt)
+{
+	memset(rt_rule, 0, sizeof(*rt_rule));
+	memset(flt_rule, 0, sizeof(*flt_rule));
+	memset(rt, 0, sizeof(*rt));
+	memset(flt, 0, sizeof(*flt));
+
+	ipa_test_fltrt_rand_attrib(state, ip, attrib_mask, &rt_rule->attrib);
+	rt_rule->dst = IPA_CLIENT_APPS_LAN_CONS;
+	rt->ipt = ip;
+	rt->dst_pipe_idx = dst_pipe_idx;
+	rt->hdr_type = IPAHAL_RT_RULE_HDR_NONE;
+	rt->priority = ipa_test_fltrt_rand(state) & 0xFF;
+	rt->id = ipahal_get_low_rule_id() + (ipa_test_fltrt_rand(state) & 0xFF);
+	rt->rule = rt_rule;
+
+	flt_rule->attrib = rt_rule->attrib;
+	flt_rule->action = ipa_test_fltrt_rand(state) %
+		(IPA_PASS_TO_EXCEPTION + 1);
+	flt_rule->rt_tbl_idx = ipa_test_fltrt_rand(state) & 0xF;
+	flt->ipt = ip;
+	flt->rt_tbl_idx = flt_rule->rt_tbl_idx;
+	flt->priority = rt->priority;
+	flt->id = rt->id;
+	flt->rule = flt_rule;
+}
+
+/**
+ * ipa_test_fltrt_fuzz() - check the images of random rt and flt rules
+ * @hw_type: IPA version ipahal was initialized for
+ * @dst_pipe_idx: destination pipe of the rt rules
+ * @seed: PRNG seed, printed on failure so the run can be replayed
+ * @iter: number of rules to build
+ * @accepted: [out] rules built and checked
+ * @rejected: [out] rules the HW can not express anyway
+ *
+ * Returns: 0 when every built image is sane, negative otherwise
+ */
+int ipa_test_fltrt_fuzz(enum ipa_hw_type hw_type, int dst_pipe_idx,
+	u64 seed, u32 iter, u32 *accepted, u32 *rejected)
+{
+	struct ipa_rt_rule_i rt_rule;
+	struct ipa_flt_rule_i flt_rule;
+	struct ipahal_rt_rule_gen_params rt;
+	struct ipahal_flt_rule_gen_params flt;
+	u32 buf_sz = ipahal_get_hw_rule_buf_size() + ipahal_get_hw_tbl_width() +
+		IPA_UT_FLTRT_GUARD_SZ;
+	enum ipa_ip_type ip;
+	u64 state = seed | 1;
+	u32 mask, i;
+	u8 *buf;
+	int ret = 0;
+
+	*accepted = 0;
+	*rejected = 0;
+
+	buf = kzalloc(buf_sz, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	for (i = 0; i < iter; i++) {
+		ip = (i & 1) ? IPA_IP_v6 : IPA_IP_v4;
+		mask = ipa_test_fltrt_rand_mask(&state, hw_type, ip);
+		ipa_test_fltrt_fill_params(&state, ip, mask, dst_pipe_idx,
+			&rt_rule, &flt_rule, &rt, &flt);
+
+		ret = ipa_test_fltrt_check_img(&rt, (i & 2) ? &flt : NULL,
+			buf, buf_sz);
+		if (ret > 0) {
+			(*rejected)++;
+			ret = 0;
+			continue;
+		}
+		if (ret) {
+			IPA_UT_ERR("seed 0x%llx iter %u ip %d %s mask 0x%x\n",
+				seed, i, ip, (i & 2) ? "flt" : "rt", mask);
+			break;
+		}
+		(*accepted)++;
+	}
+
+	kfree(buf);
+
+	return ret;
+}
+
+/**
+ * ipa_test_fltrt_bench() - time the image generation of a rule set
+ * @prof: the rule set
+ * @is_flt: build flt rules instead of rt ones
+ * @dst_pipe_idx: destination pipe of the rt rules
+ * @res: [out] the cost per rule, res->num is 0 when the HW can not
+ *  express the set
+ *
+ * Returns: 0 on success, negative on failure
+ */
+int ipa_test_fltrt_bench(const struct ipa_test_fltrt_profile *prof,
+	bool is_flt, int dst_pipe_idx, struct ipa_test_fltrt_bench_res *res)
+{
+	struct ipa_rt_rule_i rt_rule;
+	struct ipa_flt_rule_i flt_rule;
+	struct ipahal_rt_rule_gen_params rt;
+	struct ipahal_flt_rule_gen_params flt;
+	u32 buf_sz = ipahal_get_hw_rule_buf_size() + ipahal_get_hw_tbl_width();
+	u64 state = IPA_UT_FLTRT_BENCH_SEED;
+	u64 start, total_ns = 0, total_len = 0;
+	u32 len, i;
+	u8 *buf;
+
+	memset(res, 0, sizeof(*res));
+
+	buf = kzalloc(buf_sz, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	for (i = 0; i < IPA_UT_FLTRT_BENCH_ITER; i++) {
+		ipa_test_fltrt_fill_params(&state, prof->ip, prof->attrib_mask,
+			dst_pipe_idx, &rt_rule, &flt_rule, &rt, &flt);
+
+		start = ktime_get_ns();
+		len = 0;
+		if (is_flt ? ipahal_flt_generate_hw_rule(&flt, &len, buf) :
+			ipahal_rt_generate_hw_rule(&rt, &len, buf))
+			continue;
+		total_ns += ktime_get_ns() - start;
+		total_len += len;
+		res->num++;
+	}
+
+	kfree(buf);
+
+	if (res->num) {
+		res->ns_per_rule = div_u64(total_ns, res->num);
+		res->bytes_per_rule = div_u64(total_len, res->num);
+	}
+
+	return 0;
+}
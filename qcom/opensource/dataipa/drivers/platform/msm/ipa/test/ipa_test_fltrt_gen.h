@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA_TEST_FLTRT_GEN_H_
+#define _IPA_TEST_FLTRT_GEN_H_
+
+#include "ipahal.h"
+#include "ipahal_fltrt.h"
+
+/*
+ * Random rt/flt rule image generation, shared by the fltrt UT suite, which
+ * runs it against the IPA version of the device, and by the host harness in
+ * fltrt_host/, which runs it against every IPA version ipahal knows.
+ */
+
+/**
+ * struct ipa_test_fltrt_profile - a typical rule set to benchmark
+ * @name: name printed with the results
+ * @ip: IP family of the rules
+ * @attrib_mask: attributes every rule of the set matches on
+ */
+struct ipa_test_fltrt_profile {
+	const char *name;
+	enum ipa_ip_type ip;
+	u32 attrib_mask;
+};
+
+extern const struct ipa_test_fltrt_profile ipa_test_fltrt_profiles[];
+extern const u32 ipa_test_fltrt_num_profiles;
+
+/**
+ * struct ipa_test_fltrt_bench_res - image generation cost of a rule set
+ * @num: rules the HW could express
+ * @ns_per_rule: average generation time
+ * @bytes_per_rule: average image size
+ */
+struct ipa_test_fltrt_bench_res {
+	u32 num;
+	u64 ns_per_rule;
+	u32 bytes_per_rule;
+};
+
+int ipa_test_fltrt_fuzz(enum ipa_hw_type hw_type, int dst_pipe_idx,
+	u64 seed, u32 iter, u32 *accepted, u32 *rejected);
+
+int ipa_test_fltrt_bench(const struct ipa_test_fltrt_profile *prof,
+	bool is_flt, int dst_pipe_idx, struct ipa_test_fltrt_bench_res *res);
+
+#endif /* _IPA_TEST_FLTRT_GEN_H_ */
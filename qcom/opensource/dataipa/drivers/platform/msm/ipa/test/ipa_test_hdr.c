@@ -0,0 +1,405 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+
+/**
+ * Header table suite
+ * Checks the slot management of the header table: a freed slot is handed
+ * out again to a header of the same bin, a compaction pass which cannot be
+ * committed leaves every header where it was, and a relocated header keeps
+ * its old copy until the routing tables pointing at it are committed.
+ */
+
+#define IPA_UT_HDR_LEN 14
+#define IPA_UT_HDR_RT_TBL "ipa_ut_hdr_rt"
+#define IPA_UT_HDR_PORT 30000
+
+struct ipa_test_hdr_slot {
+	u32 ofst;
+	bool lcl;
+	bool moving;
+};
+
+static int ipa_test_hdr_add(const char *name, u32 *hdl)
+{
+	struct ipa_ioc_add_hdr *add;
+	int ret = 0;
+
+	add = kzalloc(sizeof(*add) + sizeof(add->hdr[0]), GFP_KERNEL);
+	if (!add)
+		return -ENOMEM;
+
+	add->commit = 1;
+	add->num_hdrs = 1;
+	strlcpy(add->hdr[0].name, name, IPA_RESOURCE_NAME_MAX);
+	add->hdr[0].hdr_len = IPA_UT_HDR_LEN;
+	add->hdr[0].type = IPA_HDR_L2_ETHERNET_II;
+	memset(add->hdr[0].hdr, 0xa5, IPA_UT_HDR_LEN);
+
+	if (ipa_add_hdr(add) || add->hdr[0].status) {
+		IPA_UT_ERR("failed to add hdr %s\n", name);
+		ret = -EFAULT;
+	}
+	*hdl = add->hdr[0].hdr_hdl;
+
+	kfree(add);
+	return ret;
+}
+
+static int ipa_test_hdr_del(u32 hdl)
+{
+	struct ipa_ioc_del_hdr *del;
+	int ret = 0;
+
+	del = kzalloc(sizeof(*del) + sizeof(del->hdl[0]), GFP_KERNEL);
+	if (!del)
+		return -ENOMEM;
+
+	del->commit = 1;
+	del->num_hdls = 1;
+	del->hdl[0].hdl = hdl;
+
+	if (ipa_del_hdr(del) || del->hdl[0].status) {
+		IPA_UT_ERR("failed to del hdr %u\n", hdl);
+		ret = -EFAULT;
+	}
+
+	kfree(del);
+	return ret;
+}
+
+static int ipa_test_hdr_get_slot(u32 hdl, struct ipa_test_hdr_slot *slot)
+{
+	struct ipa3_hdr_entry *entry;
+	int ret = 0;
+
+	mutex_lock(&ipa3_ctx->lock);
+	entry = ipa3_id_find(hdl);
+	if (!entry || entry->cookie != IPA_HDR_COOKIE) {
+		ret = -EINVAL;
+	} else {
+		slot->ofst = entry->offset_entry->offset;
+		slot->lcl = entry->is_lcl;
+		slot->moving = !!entry->moved_from;
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return ret;
+}
+
+static bool ipa_test_hdr_idle(void)
+{
+	bool idle;
+
+	mutex_lock(&ipa3_ctx->lock);
+	idle = !ipa3_ctx->hdr_tbl[HDR_TBL_LCL].moving &&
+		!ipa3_ctx->hdr_tbl[HDR_TBL_SYS].moving &&
+		!ipa3_ctx->hdr_rt_pending;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return idle;
+}
+
+/*
+ * Add two headers and delete the lower one, leaving a hole below the one
+ * kept in the SRAM table.
+ */
+static int ipa_test_hdr_make_hole(u32 *keep_hdl,
+	struct ipa_test_hdr_slot *keep)
+{
+	struct ipa_test_hdr_slot a, b;
+	u32 hdl_a, hdl_b;
+
+	if (ipa_test_hdr_add("ipa_ut_hdr_a", &hdl_a))
+		return -EFAULT;
+	if (ipa_test_hdr_add("ipa_ut_hdr_b", &hdl_b)) {
+		ipa_test_hdr_del(hdl_a);
+		return -EFAULT;
+	}
+
+	if (ipa_test_hdr_get_slot(hdl_a, &a) ||
+		ipa_test_hdr_get_slot(hdl_b, &b) || !a.lcl || !b.lcl) {
+		IPA_UT_ERR("test hdrs are not in the SRAM table\n");
+		ipa_test_hdr_del(hdl_a);
+		ipa_test_hdr_del(hdl_b);
+		return -EFAULT;
+	}
+
+	if (a.ofst < b.ofst) {
+		*keep_hdl = hdl_b;
+		*keep = b;
+		return ipa_test_hdr_del(hdl_a);
+	}
+
+	*keep_hdl = hdl_a;
+	*keep = a;
+	return ipa_test_hdr_del(hdl_b);
+}
+
+static int ipa_test_hdr_setup(void **ppriv)
+{
+	if (!IPA_MEM_PART(apps_hdr_size)) {
+		IPA_UT_ERR("no SRAM hdr table\n");
+		return -EFAULT;
+	}
+
+	if (!ipa_test_hdr_idle()) {
+		IPA_UT_ERR("a hdr compaction is pending\n");
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+static int ipa_test_hdr_alloc_free_reuse(void *priv)
+{
+	struct ipa3_hdr_mem_stats before, after;
+	struct ipa_test_hdr_slot a, b, c;
+	u32 hdl_a, hdl_b, hdl_c;
+	int ret = -EFAULT;
+
+	if (ipa_test_hdr_add("ipa_ut_hdr_a", &hdl_a)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add hdr a");
+		return -EFAULT;
+	}
+	if (ipa_test_hdr_add("ipa_ut_hdr_b", &hdl_b)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add hdr b");
+		ipa_test_hdr_del(hdl_a);
+		return -EFAULT;
+	}
+
+	ipa_test_hdr_get_slot(hdl_a, &a);
+	ipa_test_hdr_get_slot(hdl_b, &b);
+	if (a.lcl == b.lcl && a.ofst == b.ofst) {
+		IPA_UT_TEST_FAIL_REPORT("two hdrs share a slot");
+		ipa_test_hdr_del(hdl_a);
+		goto del_b;
+	}
+
+	ipa3_get_hdr_mem_stats(a.lcl ? HDR_TBL_LCL : HDR_TBL_SYS, &before);
+	if (ipa_test_hdr_del(hdl_a)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to del hdr a");
+		goto del_b;
+	}
+
+	if (ipa_test_hdr_add("ipa_ut_hdr_c", &hdl_c)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add hdr c");
+		goto del_b;
+	}
+
+	ipa_test_hdr_get_slot(hdl_c, &c);
+	ipa3_get_hdr_mem_stats(c.lcl ? HDR_TBL_LCL : HDR_TBL_SYS, &after);
+	IPA_UT_INFO("freed %s:%u, reused %s:%u\n",
+		a.lcl ? "lcl" : "sys", a.ofst, c.lcl ? "lcl" : "sys", c.ofst);
+
+	if (c.lcl != a.lcl || c.ofst != a.ofst) {
+		IPA_UT_TEST_FAIL_REPORT("freed slot not reused");
+	} else if (after.used != before.used || after.end != before.end) {
+		IPA_UT_TEST_FAIL_REPORT("hdr table grew on reuse");
+	} else {
+		ret = 0;
+	}
+
+	ipa_test_hdr_del(hdl_c);
+del_b:
+	ipa_test_hdr_del(hdl_b);
+	return ret;
+}
+
+static int ipa_test_hdr_commit_fail(void)
+{
+	return -EPERM;
+}
+
+static int ipa_test_hdr_compact_rollback(void *priv)
+{
+	struct ipa3_hdr_mem_stats before, after;
+	struct ipa_test_hdr_slot keep, slot;
+	int (*commit_hdr)(void);
+	u64 failed;
+	u32 hdl;
+	int res, ret = -EFAULT;
+
+	if (ipa_test_hdr_make_hole(&hdl, &keep)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to set up hdrs");
+		return -EFAULT;
+	}
+
+	ipa3_get_hdr_mem_stats(HDR_TBL_LCL, &before);
+
+	mutex_lock(&ipa3_ctx->lock);
+	failed = ipa3_ctx->hdr_compact.failed;
+	commit_hdr = ipa3_ctx->ctrl->ipa3_commit_hdr;
+	ipa3_ctx->ctrl->ipa3_commit_hdr = ipa_test_hdr_commit_fail;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	res = ipa3_compact_hdr();
+
+	mutex_lock(&ipa3_ctx->lock);
+	ipa3_ctx->ctrl->ipa3_commit_hdr = commit_hdr;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	ipa3_get_hdr_mem_stats(HDR_TBL_LCL, &after);
+	ipa_test_hdr_get_slot(hdl, &slot);
+
+	if (!res) {
+		IPA_UT_TEST_FAIL_REPORT("compaction ignored commit failure");
+	} else if (ipa3_ctx->hdr_compact.failed != failed + 1) {
+		IPA_UT_TEST_FAIL_REPORT("failed pass not counted");
+	} else if (!ipa_test_hdr_idle() || slot.moving) {
+		IPA_UT_TEST_FAIL_REPORT("moves left pending after rollback");
+	} else if (slot.ofst != keep.ofst || !slot.lcl) {
+		IPA_UT_TEST_FAIL_REPORT("hdr not back in its slot");
+	} else if (after.used != before.used || after.free != before.free) {
+		IPA_UT_TEST_FAIL_REPORT("slots leaked by rollback");
+	} else {
+		ret = 0;
+	}
+
+	ipa_test_hdr_del(hdl);
+	return ret;
+}
+
+static int ipa_test_hdr_add_rt_rule(u32 hdr_hdl, u16 port, u8 commit,
+	u32 *rule_hdl)
+{
+	struct ipa_ioc_add_rt_rule *add;
+	int ret = 0;
+
+	add = kzalloc(sizeof(*add) + sizeof(add->rules[0]), GFP_KERNEL);
+	if (!add)
+		return -ENOMEM;
+
+	add->commit = commit;
+	add->ip = IPA_IP_v4;
+	add->num_rules = 1;
+	strlcpy(add->rt_tbl_name, IPA_UT_HDR_RT_TBL, IPA_RESOURCE_NAME_MAX);
+	add->rules[0].at_rear = 1;
+	add->rules[0].rule.dst = IPA_CLIENT_APPS_LAN_CONS;
+	add->rules[0].rule.hdr_hdl = hdr_hdl;
+	add->rules[0].rule.attrib.attrib_mask = IPA_FLT_DST_PORT;
+	add->rules[0].rule.attrib.dst_port = port;
+
+	if (ipa_add_rt_rule(add) || add->rules[0].status) {
+		IPA_UT_ERR("failed to add rt rule\n");
+		ret = -EFAULT;
+	}
+	*rule_hdl = add->rules[0].rt_rule_hdl;
+
+	kfree(add);
+	return ret;
+}
+
+static void ipa_test_hdr_del_rt_rule(u32 rule_hdl)
+{
+	struct ipa_ioc_del_rt_rule *del;
+
+	del = kzalloc(sizeof(*del) + sizeof(del->hdl[0]), GFP_KERNEL);
+	if (!del)
+		return;
+
+	del->commit = 1;
+	del->ip = IPA_IP_v4;
+	del->num_hdls = 1;
+	del->hdl[0].hdl = rule_hdl;
+
+	if (ipa3_del_rt_rule(del))
+		IPA_UT_ERR("failed to del rt rule\n");
+
+	kfree(del);
+}
+
+static int ipa_test_hdr_compact_deferred_release(void *priv)
+{
+	struct ipa_test_hdr_slot keep, slot;
+	struct ipa3_rt_tbl *tbl;
+	u32 hdl, rule_hdl, pending_hdl;
+	bool dirty;
+	u32 pending;
+	int ret = -EFAULT;
+
+	if (ipa_test_hdr_make_hole(&hdl, &keep)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to set up hdrs");
+		return -EFAULT;
+	}
+
+	if (ipa_test_hdr_add_rt_rule(hdl, IPA_UT_HDR_PORT, 1, &rule_hdl)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add rt rule");
+		goto del_hdr;
+	}
+
+	/* left uncommitted, compaction must not push it to HW */
+	if (ipa_test_hdr_add_rt_rule(hdl, IPA_UT_HDR_PORT + 1, 0,
+		&pending_hdl)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to add pending rt rule");
+		goto del_rule;
+	}
+
+	if (ipa3_compact_hdr()) {
+		IPA_UT_TEST_FAIL_REPORT("fail to compact");
+		goto del_pending;
+	}
+
+	ipa_test_hdr_get_slot(hdl, &slot);
+	mutex_lock(&ipa3_ctx->lock);
+	tbl = __ipa3_find_rt_tbl(IPA_IP_v4, IPA_UT_HDR_RT_TBL);
+	dirty = tbl && tbl->dirty;
+	pending = ipa3_ctx->hdr_rt_pending;
+	mutex_unlock(&ipa3_ctx->lock);
+
+	if (!slot.moving) {
+		IPA_UT_INFO("hdr kept at %u, hole taken by another hdr\n",
+			slot.ofst);
+	} else if (!(pending & BIT(IPA_IP_v4))) {
+		IPA_UT_TEST_FAIL_REPORT("old copy released before rt commit");
+		goto del_pending;
+	} else if (!dirty) {
+		IPA_UT_TEST_FAIL_REPORT("rt tbl committed by compaction");
+		goto del_pending;
+	}
+
+	if (ipa3_commit_rt(IPA_IP_v4) ||
+		((pending & BIT(IPA_IP_v6)) && ipa3_commit_rt(IPA_IP_v6))) {
+		IPA_UT_TEST_FAIL_REPORT("fail to commit rt");
+		goto del_pending;
+	}
+
+	ipa_test_hdr_get_slot(hdl, &slot);
+	if (!ipa_test_hdr_idle() || slot.moving) {
+		IPA_UT_TEST_FAIL_REPORT("old copy kept after rt commit");
+		goto del_pending;
+	}
+
+	IPA_UT_INFO("hdr moved from %u to %u\n", keep.ofst, slot.ofst);
+	ret = 0;
+
+del_pending:
+	ipa_test_hdr_del_rt_rule(pending_hdl);
+del_rule:
+	ipa_test_hdr_del_rt_rule(rule_hdl);
+del_hdr:
+	ipa_test_hdr_del(hdl);
+	return ret;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(hdr, "Header table slots and compaction",
+	ipa_test_hdr_setup, NULL)
+{
+	IPA_UT_ADD_TEST(alloc_free_reuse,
+		"A freed hdr slot is reused by the next hdr of its bin",
+		ipa_test_hdr_alloc_free_reuse,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(compact_rollback,
+		"A compaction pass failing its commit moves nothing",
+		ipa_test_hdr_compact_rollback,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(compact_deferred_release,
+		"Relocated hdrs keep their old copy until the rt commit",
+		ipa_test_hdr_compact_deferred_release,
+		true, IPA_HW_v3_0, IPA_HW_MAX),
+} IPA_UT_DEFINE_SUITE_END(hdr);
@@ -941,6 +941,61 @@ static int ipa_test_hw_stats_reset_all_quota_stats(void *priv)
        return ret;
 }
 
+static int ipa_test_hw_stats_snapshot(void *priv)
+{
+	struct ipa_hw_stats_sample *samples;
+	struct ipa_quota_stats_all *out;
+	int n, ret;
+
+	IPA_UT_INFO("========hw stats snapshots========\n");
+
+	samples = kcalloc(IPA_HW_STATS_SNAP_RING, sizeof(*samples),
+		GFP_KERNEL);
+	out = kzalloc(sizeof(*out), GFP_KERNEL);
+	if (!samples || !out) {
+		ret = -ENOMEM;
+		goto free;
+	}
+
+	ret = ipa_hw_stats_set_snapshot(IPA_HW_STATS_SNAP_MIN_MS);
+	if (ret) {
+		IPA_UT_ERR("ipa_hw_stats_set_snapshot failed %d\n", ret);
+		goto free;
+	}
+
+	msleep(IPA_HW_STATS_SNAP_MIN_MS * 3 + IPA_HW_STATS_SNAP_MIN_MS / 2);
+
+	n = ipa_hw_stats_get_samples(samples, IPA_HW_STATS_SNAP_RING);
+	if (n < 3) {
+		IPA_UT_ERR("expected at least 3 samples, got %d\n", n);
+		ret = -EFAULT;
+		goto stop;
+	}
+
+	if (ktime_before(samples[0].ts, samples[n - 1].ts)) {
+		IPA_UT_ERR("samples not newest first\n");
+		ret = -EFAULT;
+		goto stop;
+	}
+
+	/* answered from the snapshot, without a DMA of its own */
+	ret = ipa_get_quota_stats(out);
+	if (ret)
+		IPA_UT_ERR("ipa_get_quota_stats failed %d\n", ret);
+
+stop:
+	if (ipa_hw_stats_set_snapshot(0)) {
+		IPA_UT_ERR("failed to stop snapshots\n");
+		ret = -EFAULT;
+	}
+
+	IPA_UT_INFO("================ done ============\n");
+free:
+	kfree(out);
+	kfree(samples);
+	return ret;
+}
+
 static int ipa_test_hw_stats_set_uc_event_ring(void *priv)
 {
 	struct ipa_ioc_flt_rt_counter_alloc *counter = NULL;
@@ -1181,6 +1236,10 @@ IPA_UT_DEFINE_SUITE_START(hw_stats, "HW stats test",
 		ipa_test_hw_stats_reset_all_quota_stats, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
 
+	IPA_UT_ADD_TEST(snapshot_stats, "Periodic stats snapshots",
+		ipa_test_hw_stats_snapshot, false,
+		IPA_HW_v4_5, IPA_HW_MAX),
+
 	IPA_UT_ADD_TEST(set_uc_evtring, "Set uc event ring",
 		ipa_test_hw_stats_set_uc_event_ring, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
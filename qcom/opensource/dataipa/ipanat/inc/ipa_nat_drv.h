@@ -168,6 +168,42 @@ int ipa_nat_add_ipv4_rule(uint32_t table_handle,
 int ipa_nat_del_ipv4_rule(uint32_t table_handle,
 				uint32_t rule_handle);
 
+/**
+ * ipa_nat_add_ipv4_rules_bulk() - to insert an array of ipv4 rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rules: [in] array of new rules
+ * @num_rules: [in] number of entries in rules
+ * @rule_handles: [out] handle of each added rule, 0 if it failed
+ * @results: [out] 0 or negative error of each rule
+ *
+ * To insert many ipv4 nat rules into ipv4 nat table under a single
+ * lock, posting their DMA commands in as few batches as possible
+ *
+ * Returns:	0  when all rules were added, otherwise the first failure
+ */
+int ipa_nat_add_ipv4_rules_bulk(uint32_t table_handle,
+				const ipa_nat_ipv4_rule *rules,
+				uint32_t num_rules,
+				uint32_t *rule_handles,
+				int *results);
+
+/**
+ * ipa_nat_del_ipv4_rules_bulk() - to delete an array of ipv4 nat rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rule_handles: [in] array of ipv4 nat rule handles
+ * @num_rules: [in] number of entries in rule_handles
+ * @results: [out] 0 or negative error of each rule
+ *
+ * To delete many ipv4 nat rules from ipv4 nat table under a single
+ * lock, posting their DMA commands in as few batches as possible
+ *
+ * Returns:	0  when all rules were deleted, otherwise the first failure
+ */
+int ipa_nat_del_ipv4_rules_bulk(uint32_t table_handle,
+				const uint32_t *rule_handles,
+				uint32_t num_rules,
+				int *results);
+
 
 /**
  * ipa_nat_query_timestamp() - to query timestamp
@@ -308,6 +308,17 @@ int ipa_nati_add_ipv4_rule(uint32_t tbl_hdl,
 int ipa_nati_del_ipv4_rule(uint32_t tbl_hdl,
 				uint32_t rule_hdl);
 
+int ipa_nati_add_ipv4_rules_bulk(uint32_t tbl_hdl,
+				const ipa_nat_ipv4_rule *clnt_rules,
+				uint32_t num_rules,
+				uint32_t *rule_hdls,
+				int *results);
+
+int ipa_nati_del_ipv4_rules_bulk(uint32_t tbl_hdl,
+				const uint32_t *rule_hdls,
+				uint32_t num_rules,
+				int *results);
+
 int ipa_nati_get_sram_size(
 	uint32_t* size_ptr);
 
@@ -379,6 +390,12 @@ int ipa_NATI_walk_ipv4_tbl(
 	ipa_table_walk_cb walk_cb,
 	void*             arb_data_ptr );
 
+int ipa_NATI_walk_ipv4_tbl_nolock(
+	uint32_t          tbl_hdl,
+	WhichTbl2Use      which,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr );
+
 int ipa_NATI_ipv4_tbl_stats(
 	uint32_t            tbl_hdl,
 	ipa_nati_tbl_stats* nat_stats_ptr,
@@ -389,6 +406,11 @@ int ipa_NATI_query_timestamp(
 	uint32_t  rule_hdl,
 	uint32_t* time_stamp);
 
+int ipa_NATI_query_timestamp_nolock(
+	uint32_t  tbl_hdl,
+	uint32_t  rule_hdl,
+	uint32_t* time_stamp);
+
 int ipa_NATI_add_ipv4_rule(
 	uint32_t                 tbl_hdl,
 	const ipa_nat_ipv4_rule* clnt_rule,
@@ -398,6 +420,19 @@ int ipa_NATI_del_ipv4_rule(
 	uint32_t tbl_hdl,
 	uint32_t rule_hdl);
 
+int ipa_NATI_add_ipv4_rules_bulk(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	int*                     results);
+
+int ipa_NATI_del_ipv4_rules_bulk(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	int*            results);
+
 int ipa_NATI_post_ipv4_init_cmd(
 	uint32_t tbl_hdl );
 
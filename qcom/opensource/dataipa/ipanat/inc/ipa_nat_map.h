@@ -84,6 +84,17 @@ int ipa_nat_map_add(
 	uint32_t      key,
 	uint32_t      val );
 
+/*
+ * Add num key/value pairs in one go. Room for all of them is made up
+ * front, so this is the preferred way to repopulate a map, e.g. after
+ * a table migration.
+ */
+int ipa_nat_map_add_bulk(
+	ipa_which_map   which,
+	const uint32_t* keys,
+	const uint32_t* vals,
+	uint32_t        num );
+
 int ipa_nat_map_find(
 	ipa_which_map which,
 	uint32_t      key,
@@ -94,6 +105,14 @@ int ipa_nat_map_del(
 	uint32_t      key,
 	uint32_t*     val_ptr );
 
+/*
+ * Preallocate a map for num_keys keys, so that it does no heap
+ * allocation until it holds more than that.
+ */
+int ipa_nat_map_reserve(
+	ipa_which_map which,
+	uint32_t      num_keys );
+
 int ipa_nat_map_clear(
 	ipa_which_map which );
 
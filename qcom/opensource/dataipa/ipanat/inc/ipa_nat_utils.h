@@ -65,8 +65,10 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include <string.h>
 #include <syslog.h>
+#include <sched.h>
 #include <time.h>
 #include <linux/msm_ipa.h>
 
@@ -81,6 +83,16 @@
 #define MAX_DMA_ENTRIES_FOR_ADD 4
 #define MAX_DMA_ENTRIES_FOR_DEL 3
 
+/*
+ * Bulk rule updates are batched into DMA commands of this size; older
+ * kernels take no more than a single rule's worth per command.
+ */
+#ifdef IPA_TABLE_DMA_CMD_MAX_ENTRIES
+#define MAX_DMA_ENTRIES_FOR_BULK IPA_TABLE_DMA_CMD_MAX_ENTRIES
+#else
+#define MAX_DMA_ENTRIES_FOR_BULK MAX_DMA_ENTRIES_FOR_ADD
+#endif
+
 #if !defined(MSM_IPA_TESTS) && !defined(FEATURE_IPA_ANDROID)
 #ifdef USE_GLIB
 #include <glib.h>
@@ -156,6 +168,112 @@ static inline char* prep_ioc_nat_dma_cmd_4print(
 	return buf_ptr;
 }
 
+/******************************************************************************/
+/*
+ * A reader gate, used to let table readers (eg. timestamp queries and
+ * table walks) run without taking the table mutex.
+ *
+ * Readers enter the gate for as long as they touch table memory.
+ * Writers that map or unmap table memory close the gate beforehand,
+ * which waits for the readers inside to leave and sends newcomers to
+ * the mutex protected path until the gate is opened again.  Since the
+ * readers being waited on may themselves be blocked on the mutex, the
+ * gate must be closed and opened without it held.
+ *
+ * Writers that change what a reader uses to locate a rule (eg. state
+ * or handle maps) do so within ipa_wr_seq_begin()/ipa_wr_seq_end(),
+ * with the mutex held.  Readers sample the sequence count before and
+ * check it after, retrying when it moved.
+ */
+typedef struct
+{
+	uint32_t readers;
+	uint32_t closed;
+	uint32_t seq;
+	uint32_t wr_depth;
+} ipa_rd_gate;
+
+#define IPA_RD_GATE_INITIALIZER { 0, 0, 0, 0 }
+
+/*
+ * How many times a reader retries before it gives up on the gate and
+ * takes the mutex...
+ */
+#define IPA_RD_GATE_TRIES 16
+
+static inline bool ipa_rd_gate_enter(
+	ipa_rd_gate* gate )
+{
+	__atomic_add_fetch(&gate->readers, 1, __ATOMIC_SEQ_CST);
+
+	if ( __atomic_load_n(&gate->closed, __ATOMIC_SEQ_CST) )
+	{
+		__atomic_sub_fetch(&gate->readers, 1, __ATOMIC_RELEASE);
+		return false;
+	}
+
+	return true;
+}
+
+static inline void ipa_rd_gate_exit(
+	ipa_rd_gate* gate )
+{
+	__atomic_sub_fetch(&gate->readers, 1, __ATOMIC_RELEASE);
+}
+
+static inline void ipa_rd_gate_close(
+	ipa_rd_gate* gate )
+{
+	__atomic_add_fetch(&gate->closed, 1, __ATOMIC_SEQ_CST);
+
+	while ( __atomic_load_n(&gate->readers, __ATOMIC_SEQ_CST) )
+		sched_yield();
+}
+
+static inline void ipa_rd_gate_open(
+	ipa_rd_gate* gate )
+{
+	__atomic_sub_fetch(&gate->closed, 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t ipa_rd_seq_begin(
+	ipa_rd_gate* gate )
+{
+	return __atomic_load_n(&gate->seq, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Returns true when what was read since ipa_rd_seq_begin() can't be
+ * trusted...
+ */
+static inline bool ipa_rd_seq_retry(
+	ipa_rd_gate* gate,
+	uint32_t     seq )
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return (seq & 1) || __atomic_load_n(&gate->seq, __ATOMIC_RELAXED) != seq;
+}
+
+static inline void ipa_wr_seq_begin(
+	ipa_rd_gate* gate )
+{
+	if ( gate->wr_depth++ == 0 )
+	{
+		__atomic_store_n(&gate->seq, gate->seq + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+}
+
+static inline void ipa_wr_seq_end(
+	ipa_rd_gate* gate )
+{
+	if ( --gate->wr_depth == 0 )
+	{
+		__atomic_store_n(&gate->seq, gate->seq + 1, __ATOMIC_RELEASE);
+	}
+}
+
 #undef NANOS_PER_SEC
 #undef MICROS_PER_SEC
 #undef MILLIS_PER_SEC
@@ -37,6 +37,17 @@
 
 #define IPA_TABLE_INVALID_ENTRY 0x0
 
+/*
+ * Expansion table free slot bitmap: one bit per expansion slot (set
+ * means free), plus a summary word per 64 bitmap words (set means the
+ * bitmap word has at least one free slot)...
+ */
+#define IPA_TABLE_MAP_BITS      64
+#define IPA_TABLE_MAP_WORDS \
+	( (IPA_TABLE_MAX_ENTRIES + IPA_TABLE_MAP_BITS - 1) / IPA_TABLE_MAP_BITS )
+#define IPA_TABLE_MAP_SUM_WORDS \
+	( (IPA_TABLE_MAP_WORDS + IPA_TABLE_MAP_BITS - 1) / IPA_TABLE_MAP_BITS )
+
 #undef  VALID_INDEX
 #define VALID_INDEX(idx) \
 	( (idx) != IPA_TABLE_INVALID_ENTRY )
@@ -170,6 +181,9 @@ typedef struct
 	uint16_t                   cur_tbl_cnt;
 	uint16_t                   cur_expn_tbl_cnt;
 
+	uint64_t                   expn_free_map[IPA_TABLE_MAP_WORDS];
+	uint64_t                   expn_free_sum[IPA_TABLE_MAP_SUM_WORDS];
+
 	ipa_table_entry_interface* entry_interface;
 
 	ipa_table_dma_cmd_helper*  dma_help[HELP_UPDATE_MAX];
@@ -93,9 +93,14 @@ static int table_entry_head_insert(void* entry, void* user_data, uint16_t* dma_c
 static int table_entry_tail_insert(void* entry, void* user_data);
 static uint16_t table_entry_get_delete_head_dma_command_data(void* head, void* next_entry);
 
+static int ipa_ipv6ct_get_timestamp(uint32_t table_handle, uint32_t rule_handle, uint32_t* time_stamp);
+
 static ipa_ipv6ct ipv6ct;
 static pthread_mutex_t ipv6ct_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* Lets timestamp queries run without ipv6ct_mutex. Closed by table deletion. */
+static ipa_rd_gate ipv6ct_gate = IPA_RD_GATE_INITIALIZER;
+
 static ipa_table_entry_interface entry_interface =
 {
 	table_entry_is_valid,
@@ -207,9 +212,12 @@ int ipa_ipv6ct_del_tbl(uint32_t table_handle)
 	}
 	IPADBG("Passed Table Handle: 0x%x\n", table_handle);
 
+	ipa_rd_gate_close(&ipv6ct_gate);
+
 	if (pthread_mutex_lock(&ipv6ct_mutex))
 	{
 		IPAERR("unable to lock the ipv6ct mutex\n");
+		ipa_rd_gate_open(&ipv6ct_gate);
 		return -EINVAL;
 	}
 
@@ -237,9 +245,11 @@ unlock:
 	if (pthread_mutex_unlock(&ipv6ct_mutex))
 	{
 		IPAERR("unable to unlock the ipv6ct mutex\n");
-		return (ret) ? ret : -EPERM;
+		ret = (ret) ? ret : -EPERM;
 	}
 
+	ipa_rd_gate_open(&ipv6ct_gate);
+
 	IPADBG("return\n");
 	return ret;
 }
@@ -423,8 +433,6 @@ unlock:
 int ipa_ipv6ct_query_timestamp(uint32_t table_handle, uint32_t rule_handle, uint32_t* time_stamp)
 {
 	int ret;
-	ipa_ipv6ct_table* ipv6ct_table;
-	ipa_ipv6ct_hw_entry *entry;
 
 	IPADBG("\n");
 
@@ -443,18 +451,48 @@ int ipa_ipv6ct_query_timestamp(uint32_t table_handle, uint32_t rule_handle, uint
 	}
 	IPADBG("Passed Table: %d and rule handle %d\n", table_handle, rule_handle);
 
+	/*
+	 * Rules are only ever read here, so as long as the table can't be
+	 * deleted underneath, there is no need to wait for adds and deletes
+	 */
+	if (ipa_rd_gate_enter(&ipv6ct_gate))
+	{
+		ret = ipa_ipv6ct_get_timestamp(table_handle, rule_handle, time_stamp);
+		ipa_rd_gate_exit(&ipv6ct_gate);
+
+		IPADBG("return\n");
+		return ret;
+	}
+
 	if (pthread_mutex_lock(&ipv6ct_mutex))
 	{
 		IPAERR("unable to lock the ipv6ct mutex\n");
 		return -EINVAL;
 	}
 
+	ret = ipa_ipv6ct_get_timestamp(table_handle, rule_handle, time_stamp);
+
+	if (pthread_mutex_unlock(&ipv6ct_mutex))
+	{
+		IPAERR("unable to unlock the ipv6ct mutex\n");
+		return (ret) ? ret : -EPERM;
+	}
+
+	IPADBG("return\n");
+	return ret;
+}
+
+static int ipa_ipv6ct_get_timestamp(uint32_t table_handle, uint32_t rule_handle, uint32_t* time_stamp)
+{
+	ipa_ipv6ct_table* ipv6ct_table;
+	ipa_ipv6ct_hw_entry *entry;
+	int ret;
+
 	ipv6ct_table = &ipv6ct.tables[table_handle - 1];
 	if (!ipv6ct_table->mem_desc.valid)
 	{
 		IPAERR("invalid table handle %d\n", table_handle);
-		ret = -EINVAL;
-		goto unlock;
+		return -EINVAL;
 	}
 
 	ret = ipa_table_get_entry(&ipv6ct_table->table, rule_handle, (void**)&entry, NULL);
@@ -462,20 +500,12 @@ int ipa_ipv6ct_query_timestamp(uint32_t table_handle, uint32_t rule_handle, uint
 	{
 		IPAERR("unable to retrive the entry with handle=%d in IPV6CT table with handle=%d\n",
 			rule_handle, table_handle);
-		goto unlock;
+		return ret;
 	}
 
 	*time_stamp = entry->time_stamp;
 
-unlock:
-	if (pthread_mutex_unlock(&ipv6ct_mutex))
-	{
-		IPAERR("unable to unlock the ipv6ct mutex\n");
-		return (ret) ? ret : -EPERM;
-	}
-
-	IPADBG("return\n");
-	return ret;
+	return 0;
 }
 
 /**
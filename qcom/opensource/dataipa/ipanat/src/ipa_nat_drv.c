@@ -169,6 +169,77 @@ int ipa_nat_del_ipv4_rule(
 	return 0;
 }
 
+/**
+ * ipa_nat_add_ipv4_rules_bulk() - to insert an array of ipv4 rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rules: [in] array of new rules
+ * @num_rules: [in] number of entries in rules
+ * @rule_handles: [out] handle of each added rule, 0 if it failed
+ * @results: [out] 0 or negative error of each rule
+ *
+ * To insert many ipv4 nat rules into ipv4 nat table under a single lock
+ *
+ * Returns:	0  when all rules were added, otherwise the first failure
+ */
+int ipa_nat_add_ipv4_rules_bulk(
+	uint32_t tbl_hdl,
+	const ipa_nat_ipv4_rule *clnt_rules,
+	uint32_t num_rules,
+	uint32_t *rule_hdls,
+	int *results)
+{
+	int result = -EINVAL;
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 clnt_rules == NULL ||
+		 rule_hdls == NULL ||
+		 results == NULL ) {
+		IPAERR(
+			"Invalid parameters tbl_hdl=%d clnt_rules=%pK rule_hdls=%pK results=%pK\n",
+			tbl_hdl, clnt_rules, rule_hdls, results);
+		return result;
+	}
+
+	IPADBG("Passed Table handle: 0x%x, %u rules\n", tbl_hdl, num_rules);
+
+	return ipa_nati_add_ipv4_rules_bulk(
+		tbl_hdl, clnt_rules, num_rules, rule_hdls, results);
+}
+
+/**
+ * ipa_nat_del_ipv4_rules_bulk() - to delete an array of ipv4 nat rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @rule_handles: [in] array of ipv4 nat rule handles
+ * @num_rules: [in] number of entries in rule_handles
+ * @results: [out] 0 or negative error of each rule
+ *
+ * To delete many ipv4 nat rules from ipv4 nat table under a single lock
+ *
+ * Returns:	0  when all rules were deleted, otherwise the first failure
+ */
+int ipa_nat_del_ipv4_rules_bulk(
+	uint32_t tbl_hdl,
+	const uint32_t *rule_hdls,
+	uint32_t num_rules,
+	int *results)
+{
+	int result = -EINVAL;
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 rule_hdls == NULL ||
+		 results == NULL ) {
+		IPAERR(
+			"Invalid parameters tbl_hdl=0x%08X rule_hdls=%pK results=%pK\n",
+			tbl_hdl, rule_hdls, results);
+		return result;
+	}
+
+	IPADBG("Passed Table: 0x%08X, %u rules\n", tbl_hdl, num_rules);
+
+	return ipa_nati_del_ipv4_rules_bulk(
+		tbl_hdl, rule_hdls, num_rules, results);
+}
+
 /**
  * ipa_nat_query_timestamp() - to query timestamp
  * @table_handle: [in] handle of ipv4 nat table
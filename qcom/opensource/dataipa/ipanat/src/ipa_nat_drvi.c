@@ -1552,7 +1552,12 @@ bail:
 	return ret;
 }
 
-int ipa_NATI_query_timestamp(
+/*
+ * The part of ipa_NATI_query_timestamp() that runs without nat_mutex.
+ * The caller guarantees the table stays mapped throughout (see the
+ * reader gate in ipa_nat_statemach.c)...
+ */
+int ipa_NATI_query_timestamp_nolock(
 	uint32_t  tbl_hdl,
 	uint32_t  rule_hdl,
 	uint32_t* time_stamp )
@@ -1581,16 +1586,10 @@ int ipa_NATI_query_timestamp(
 
 	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
 
-	if (pthread_mutex_lock(&nat_mutex)) {
-		IPAERR("unable to lock the nat mutex\n");
-		ret = -EINVAL;
-		goto bail;
-	}
-
 	if ( ! nat_table->mem_desc.valid ) {
 		IPAERR("invalid table handle %d\n", tbl_hdl);
 		ret = -EINVAL;
-		goto unlock;
+		goto bail;
 	}
 
 	ret = ipa_table_get_entry(
@@ -1603,7 +1602,7 @@ int ipa_NATI_query_timestamp(
 		IPAERR("Unable to retrive the entry with "
 			   "handle=%u in NAT table with handle=0x%08X\n",
 			   rule_hdl, tbl_hdl);
-		goto unlock;
+		goto bail;
 	}
 
 	IPADBG("rule_hdl(0x%08X) -> %s\n",
@@ -1612,7 +1611,29 @@ int ipa_NATI_query_timestamp(
 
 	*time_stamp = rule_ptr->time_stamp;
 
-unlock:
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_NATI_query_timestamp(
+	uint32_t  tbl_hdl,
+	uint32_t  rule_hdl,
+	uint32_t* time_stamp )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	ret = ipa_NATI_query_timestamp_nolock(tbl_hdl, rule_hdl, time_stamp);
+
 	if (pthread_mutex_unlock(&nat_mutex)) {
 		IPAERR("unable to unlock the nat mutex\n");
 		ret = (ret) ? ret : -EPERM;
@@ -1624,6 +1645,176 @@ bail:
 	return ret;
 }
 
+/*
+ * Sanity check the fields of a client rule that the hardware relies on
+ */
+static int ipa_nati_check_ipv4_rule(
+	const ipa_nat_ipv4_rule* clnt_rule)
+{
+	if (clnt_rule->protocol == IPAHAL_NAT_INVALID_PROTOCOL) {
+		IPAERR("invalid parameter protocol=%d\n", clnt_rule->protocol);
+		return -EINVAL;
+	}
+
+	/*
+	 * Verify that the rule's PDN is valid
+	 */
+	if (clnt_rule->pdn_index >= IPA_MAX_PDN_NUM ||
+		pdns[clnt_rule->pdn_index].public_ip == 0) {
+		IPAERR("invalid parameters, pdn index %d, public ip = 0x%X\n",
+			   clnt_rule->pdn_index, pdns[clnt_rule->pdn_index].public_ip);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Compute the head slots of the base and index table chains the rule
+ * will be linked into
+ */
+static void ipa_nati_hash_ipv4_rule(
+	struct ipa_nat_cache*           nat_cache_ptr,
+	struct ipa_nat_ip4_table_cache* nat_table,
+	const ipa_nat_ipv4_rule*        clnt_rule,
+	uint16_t*                       entry_index_ptr,
+	uint16_t*                       index_tbl_entry_index_ptr)
+{
+	uint16_t new_entry_index;
+	uint16_t new_index_tbl_entry_index;
+
+	/* src_only */
+	if (clnt_rule->src_only) {
+		new_entry_index = dst_hash(
+			nat_cache_ptr,
+			pdns[clnt_rule->pdn_index].public_ip,
+			clnt_rule->target_ip,
+			clnt_rule->target_port,
+			clnt_rule->public_port,
+			clnt_rule->protocol,
+			nat_table->table.table_entries - 1) + Hash_token;
+		new_entry_index = (new_entry_index & (nat_table->table.table_entries - 1));
+		if (new_entry_index == 0) {
+			new_entry_index = nat_table->table.table_entries - 1;
+		}
+		Hash_token++;
+	} else {
+	new_entry_index = dst_hash(
+		nat_cache_ptr,
+		pdns[clnt_rule->pdn_index].public_ip,
+		clnt_rule->target_ip,
+		clnt_rule->target_port,
+		clnt_rule->public_port,
+		clnt_rule->protocol,
+		nat_table->table.table_entries - 1);
+	}
+
+	/* dst_only */
+	if (clnt_rule->dst_only) {
+		new_index_tbl_entry_index =
+			src_hash(clnt_rule->private_ip,
+				 clnt_rule->private_port,
+				 clnt_rule->target_ip,
+				 clnt_rule->target_port,
+				 clnt_rule->protocol,
+				 nat_table->table.table_entries - 1) + Hash_token;
+		new_index_tbl_entry_index = (new_index_tbl_entry_index & (nat_table->table.table_entries - 1));
+		if (new_index_tbl_entry_index == 0) {
+			new_index_tbl_entry_index = nat_table->table.table_entries - 1;
+		}
+		Hash_token++;
+	} else {
+	new_index_tbl_entry_index =
+		src_hash(clnt_rule->private_ip,
+				 clnt_rule->private_port,
+				 clnt_rule->target_ip,
+				 clnt_rule->target_port,
+				 clnt_rule->protocol,
+				 nat_table->table.table_entries - 1);
+	}
+
+	*entry_index_ptr           = new_entry_index;
+	*index_tbl_entry_index_ptr = new_index_tbl_entry_index;
+}
+
+/*
+ * Link a rule into the base and index tables starting at the chain
+ * heads computed by ipa_nati_hash_ipv4_rule(), queueing the DMA
+ * commands into cmd. On return, the indexes point at the records used.
+ * On failure, nothing is left behind in the tables.
+ */
+static int ipa_nati_insert_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	const ipa_nat_ipv4_rule*        clnt_rule,
+	uint16_t*                       entry_index_ptr,
+	uint16_t*                       index_tbl_entry_index_ptr,
+	uint32_t*                       rule_hdl,
+	struct ipa_ioc_nat_dma_cmd*     cmd)
+{
+	struct ipa_nat_rule* rule;
+	char                 buf[1024];
+	int                  ret;
+
+	ret = ipa_table_add_entry(
+		&nat_table->table,
+		(void*) clnt_rule,
+		entry_index_ptr,
+		rule_hdl,
+		cmd);
+
+	if (ret) {
+		IPAERR("Failed to add a new NAT entry\n");
+		goto done;
+	}
+
+	ret = ipa_table_add_entry(
+		&nat_table->index_table,
+		(void*) entry_index_ptr,
+		index_tbl_entry_index_ptr,
+		NULL,
+		cmd);
+
+	if (ret) {
+		IPAERR("failed to add a new NAT index entry\n");
+		goto fail_add_index_entry;
+	}
+
+	rule = ipa_table_get_entry_by_index(
+		&nat_table->table,
+		*entry_index_ptr);
+
+	if (rule == NULL) {
+		IPAERR("Failed to retrieve the entry in index %d for NAT table\n",
+			   *entry_index_ptr);
+		ret = -EPERM;
+		goto bail;
+	}
+
+	rule->indx_tbl_entry = *index_tbl_entry_index_ptr;
+
+	rule->redirect   = clnt_rule->redirect;
+	rule->enable     = clnt_rule->enable;
+	rule->time_stamp = clnt_rule->time_stamp;
+
+	IPADBG("new entry:%d, new index entry: %d\n",
+		   *entry_index_ptr, *index_tbl_entry_index_ptr);
+
+	IPADBG("rule_hdl(0x%08X) -> %s\n",
+		   *rule_hdl,
+		   prep_nat_rule_4print(rule, buf, sizeof(buf)));
+
+	goto done;
+
+bail:
+	ipa_table_erase_entry(&nat_table->index_table, *index_tbl_entry_index_ptr);
+
+fail_add_index_entry:
+	ipa_table_erase_entry(&nat_table->table, *entry_index_ptr);
+
+done:
+	return ret;
+}
+
 int ipa_NATI_add_ipv4_rule(
 	uint32_t                 tbl_hdl,
 	const ipa_nat_ipv4_rule* clnt_rule,
@@ -1639,7 +1830,6 @@ int ipa_NATI_add_ipv4_rule(
 	enum ipa3_nat_mem_in            nmi;
 	struct ipa_nat_cache*           nat_cache_ptr;
 	struct ipa_nat_ip4_table_cache* nat_table;
-	struct ipa_nat_rule*            rule;
 
 	uint16_t new_entry_index;
 	uint16_t new_index_tbl_entry_index;
@@ -1683,20 +1873,9 @@ int ipa_NATI_add_ipv4_rule(
 
 	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
 
-	if (clnt_rule->protocol == IPAHAL_NAT_INVALID_PROTOCOL) {
-		IPAERR("invalid parameter protocol=%d\n", clnt_rule->protocol);
-		ret = -EINVAL;
-		goto done;
-	}
+	ret = ipa_nati_check_ipv4_rule(clnt_rule);
 
-	/*
-	 * Verify that the rule's PDN is valid
-	 */
-	if (clnt_rule->pdn_index >= IPA_MAX_PDN_NUM ||
-		pdns[clnt_rule->pdn_index].public_ip == 0) {
-		IPAERR("invalid parameters, pdn index %d, public ip = 0x%X\n",
-			   clnt_rule->pdn_index, pdns[clnt_rule->pdn_index].public_ip);
-		ret = -EINVAL;
+	if (ret) {
 		goto done;
 	}
 
@@ -1712,166 +1891,699 @@ int ipa_NATI_add_ipv4_rule(
 		goto unlock;
 	}
 
-	/* src_only */
-	if (clnt_rule->src_only) {
-		new_entry_index = dst_hash(
-			nat_cache_ptr,
-			pdns[clnt_rule->pdn_index].public_ip,
-			clnt_rule->target_ip,
-			clnt_rule->target_port,
-			clnt_rule->public_port,
-			clnt_rule->protocol,
-			nat_table->table.table_entries - 1) + Hash_token;
-		new_entry_index = (new_entry_index & (nat_table->table.table_entries - 1));
-		if (new_entry_index == 0) {
-			new_entry_index = nat_table->table.table_entries - 1;
-		}
-		Hash_token++;
-	} else {
-	new_entry_index = dst_hash(
+	ipa_nati_hash_ipv4_rule(
 		nat_cache_ptr,
-		pdns[clnt_rule->pdn_index].public_ip,
-		clnt_rule->target_ip,
-		clnt_rule->target_port,
-		clnt_rule->public_port,
-		clnt_rule->protocol,
-		nat_table->table.table_entries - 1);
-	}
+		nat_table,
+		clnt_rule,
+		&new_entry_index,
+		&new_index_tbl_entry_index);
 
-	ret = ipa_table_add_entry(
-		&nat_table->table,
-		(void*) clnt_rule,
+	ret = ipa_nati_insert_ipv4_rule(
+		nat_table,
+		clnt_rule,
 		&new_entry_index,
+		&new_index_tbl_entry_index,
 		&new_entry_handle,
 		cmd);
 
 	if (ret) {
-		IPAERR("Failed to add a new NAT entry\n");
 		goto unlock;
 	}
 
-	/* dst_only */
-	if (clnt_rule->dst_only) {
-		new_index_tbl_entry_index =
-			src_hash(clnt_rule->private_ip,
-				 clnt_rule->private_port,
-				 clnt_rule->target_ip,
-				 clnt_rule->target_port,
-				 clnt_rule->protocol,
-				 nat_table->table.table_entries - 1) + Hash_token;
-		new_index_tbl_entry_index = (new_index_tbl_entry_index & (nat_table->table.table_entries - 1));
-		if (new_index_tbl_entry_index == 0) {
-			new_index_tbl_entry_index = nat_table->table.table_entries - 1;
-		}
-		Hash_token++;
-	} else {
-	new_index_tbl_entry_index =
-		src_hash(clnt_rule->private_ip,
-				 clnt_rule->private_port,
-				 clnt_rule->target_ip,
-				 clnt_rule->target_port,
-				 clnt_rule->protocol,
-				 nat_table->table.table_entries - 1);
+	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+
+	if (ret) {
+		IPAERR("unable to post dma command\n");
+		goto bail;
 	}
-	ret = ipa_table_add_entry(
-		&nat_table->index_table,
-		(void*) &new_entry_index,
-		&new_index_tbl_entry_index,
-		NULL,
-		cmd);
 
-	if (ret) {
-		IPAERR("failed to add a new NAT index entry\n");
-		goto fail_add_index_entry;
-	}
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("unable to unlock the nat mutex\n");
+		ret = -EPERM;
+		goto done;
+	}
+
+	*rule_hdl = new_entry_handle;
+
+	IPADBG("rule_hdl value(%u)\n", *rule_hdl);
+
+	goto done;
+
+bail:
+	ipa_table_erase_entry(&nat_table->index_table, new_index_tbl_entry_index);
+	ipa_table_erase_entry(&nat_table->table, new_entry_index);
+
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex))
+		IPAERR("unable to unlock the nat mutex\n");
+done:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * Set up the base and index table iterators of the rule to be deleted
+ */
+static int ipa_nati_locate_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	uint32_t                        rule_hdl,
+	ipa_table_iterator*             table_iterator,
+	ipa_table_iterator*             index_table_iterator)
+{
+	struct ipa_nat_rule*          table_rule;
+	struct ipa_nat_indx_tbl_rule* index_table_rule;
+
+	uint16_t index;
+	char     buf[1024];
+	int      ret;
+
+	ret = ipa_table_get_entry(
+		&nat_table->table,
+		rule_hdl,
+		(void**) &table_rule,
+		&index);
+
+	if (ret) {
+		IPAERR("Unable to retrive the entry with rule_hdl=%u\n", rule_hdl);
+		goto bail;
+	}
+
+	IPADBG("rule_hdl(0x%08X) -> %s\n",
+		   rule_hdl,
+		   prep_nat_rule_4print(table_rule, buf, sizeof(buf)));
+
+	ret = ipa_table_iterator_init(
+		table_iterator,
+		&nat_table->table,
+		table_rule,
+		index);
+
+	if (ret) {
+		IPAERR("Unable to create iterator which points to the "
+			   "entry %u in NAT table\n",
+			   index);
+		goto bail;
+	}
+
+	index = table_rule->indx_tbl_entry;
+
+	index_table_rule = (struct ipa_nat_indx_tbl_rule*)
+		ipa_table_get_entry_by_index(&nat_table->index_table, index);
+
+	if (index_table_rule == NULL) {
+		IPAERR("Unable to retrieve the entry in index %u "
+			   "in NAT index table\n",
+			   index);
+		ret = -EPERM;
+		goto bail;
+	}
+
+	ret = ipa_table_iterator_init(
+		index_table_iterator,
+		&nat_table->index_table,
+		index_table_rule,
+		index);
+
+	if (ret) {
+		IPAERR("Unable to create iterator which points to the "
+			   "entry %u in NAT index table\n",
+			   index);
+		goto bail;
+	}
+
+bail:
+	return ret;
+}
+
+/*
+ * Queue the DMA commands unlinking a located rule into cmd. The index
+ * table iterator is moved on to the record actually being freed when
+ * the rule's index entry heads a list.
+ */
+static int ipa_nati_create_ipv4_del_cmd(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	ipa_table_iterator*             table_iterator,
+	ipa_table_iterator*             index_table_iterator,
+	struct ipa_ioc_nat_dma_cmd*     cmd)
+{
+	int ret = 0;
+
+	ipa_table_create_delete_command(
+		&nat_table->index_table,
+		cmd,
+		index_table_iterator);
+
+	if (ipa_table_iterator_is_head_with_tail(index_table_iterator)) {
+
+		ipa_nati_copy_second_index_entry_to_head(
+			nat_table, index_table_iterator, cmd);
+		/*
+		 * Iterate to the next entry which should be deleted
+		 */
+		ret = ipa_table_iterator_next(
+			index_table_iterator, &nat_table->index_table);
+
+		if (ret) {
+			IPAERR("Unable to move the iterator to the next entry "
+				   "(points to the entry %u in NAT index table)\n",
+				   index_table_iterator->curr_index);
+			goto bail;
+		}
+	}
+
+	ipa_table_create_delete_command(
+		&nat_table->table,
+		cmd,
+		table_iterator);
+
+bail:
+	return ret;
+}
+
+/*
+ * Release the records of a deleted rule once the IPA has processed
+ * its DMA commands
+ */
+static void ipa_nati_release_ipv4_rule(
+	struct ipa_nat_ip4_table_cache* nat_table,
+	ipa_table_iterator*             table_iterator,
+	ipa_table_iterator*             index_table_iterator)
+{
+	if (! ipa_table_iterator_is_head_with_tail(table_iterator)) {
+		/* The entry can be deleted */
+		uint8_t is_prev_empty =
+			(table_iterator->prev_entry != NULL &&
+			 ((struct ipa_nat_rule*)table_iterator->prev_entry)->protocol ==
+			 IPAHAL_NAT_INVALID_PROTOCOL);
+
+		ipa_table_delete_entry(
+			&nat_table->table, table_iterator, is_prev_empty);
+	}
+
+	ipa_table_delete_entry(
+		&nat_table->index_table,
+		index_table_iterator,
+		FALSE);
+
+	if (index_table_iterator->curr_index >= nat_table->index_table.table_entries)
+		nat_table->index_expn_table_meta[
+			index_table_iterator->curr_index - nat_table->index_table.table_entries].
+			prev_index = IPA_TABLE_INVALID_ENTRY;
+}
+
+int ipa_NATI_del_ipv4_rule(
+	uint32_t tbl_hdl,
+	uint32_t rule_hdl )
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_DEL * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+	struct ipa_ioc_nat_dma_cmd* cmd =
+		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+
+	enum ipa3_nat_mem_in            nmi;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+
+	ipa_table_iterator table_iterator;
+	ipa_table_iterator index_table_iterator;
+
+	int      ret = 0;
+
+	IPADBG("In\n");
+
+	memset(cmd_buf, 0, sizeof(cmd_buf));
+
+	IPADBG("tbl_hdl(0x%08X) rule_hdl(%u)\n", tbl_hdl, rule_hdl);
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(nmi));
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("Unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto done;
+	}
+
+	if (! nat_table->mem_desc.valid) {
+		IPAERR("Invalid table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	ret = ipa_nati_locate_ipv4_rule(
+		nat_table,
+		rule_hdl,
+		&table_iterator,
+		&index_table_iterator);
+
+	if (ret) {
+		goto unlock;
+	}
+
+	ret = ipa_nati_create_ipv4_del_cmd(
+		nat_table,
+		&table_iterator,
+		&index_table_iterator,
+		cmd);
+
+	if (ret) {
+		goto unlock;
+	}
+
+	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+
+	if (ret) {
+		IPAERR("Unable to post dma command\n");
+		goto unlock;
+	}
+
+	ipa_nati_release_ipv4_rule(
+		nat_table,
+		&table_iterator,
+		&index_table_iterator);
+
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("Unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
+done:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ * Bulk rule add/delete
+ *
+ * The DMA commands of many rules are gathered into a single
+ * IPA_IOC_TABLE_DMA_CMD. The catch is that the enable bits, the
+ * next_index links and the index table heads are only written by the
+ * IPA, hence the tables in memory lag behind until the batch is
+ * posted. A rule is therefore only queued behind others when it does
+ * not touch the records they touch, otherwise the pending batch is
+ * posted first. The outcome is the same as adding or deleting the
+ * rules one at a time, in order.
+ * ----------------------------------------------------------------------------
+ */
+#define MAX_BULK_PENDING_RULES MAX_DMA_ENTRIES_FOR_BULK
+
+typedef struct
+{
+	uint32_t pos;         /* index into the caller's arrays */
+	uint16_t head;        /* base table chain head */
+	uint16_t index_head;  /* index table chain head */
+	uint16_t entry_index;
+	uint16_t index_tbl_entry_index;
+	uint32_t rule_hdl;
+} nati_bulk_add;
+
+typedef struct
+{
+	uint32_t           pos;
+	ipa_table_iterator table_iterator;
+	ipa_table_iterator index_table_iterator;
+	/*
+	 * Records whose contents the delete depends on or changes
+	 */
+	uint16_t           recs[3];
+	uint16_t           index_recs[4];
+} nati_bulk_del;
+
+typedef struct
+{
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+	struct ipa_ioc_nat_dma_cmd*     cmd;
+	uint32_t                        cnt;
+	union {
+		nati_bulk_add add[MAX_BULK_PENDING_RULES];
+		nati_bulk_del del[MAX_BULK_PENDING_RULES];
+	};
+} nati_bulk_batch;
+
+static bool ipa_nati_bulk_batch_full(
+	nati_bulk_batch* batch,
+	uint32_t         dma_entries_needed)
+{
+	return batch->cnt == MAX_BULK_PENDING_RULES ||
+		batch->cmd->entries + dma_entries_needed > MAX_DMA_ENTRIES_FOR_BULK;
+}
+
+static bool ipa_nati_bulk_add_conflicts(
+	nati_bulk_batch* batch,
+	uint16_t         head,
+	uint16_t         index_head)
+{
+	uint32_t i;
+
+	for ( i = 0; i < batch->cnt; i++ ) {
+		if ( batch->add[i].head == head ||
+			 batch->add[i].index_head == index_head )
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Post the pending adds. On failure, the records they took are given
+ * back, exactly as the single rule path does.
+ */
+static void ipa_nati_bulk_add_flush(
+	nati_bulk_batch* batch,
+	uint32_t*        rule_hdls,
+	int*             results)
+{
+	nati_bulk_add* add;
+	uint32_t       i;
+	int            ret;
+
+	if ( batch->cnt == 0 )
+		return;
+
+	ret = ipa_nati_post_ipv4_dma_cmd(batch->nat_cache_ptr, batch->cmd);
+
+	if (ret) {
+		IPAERR("unable to post dma command for %u rules\n", batch->cnt);
+	}
+
+	for ( i = batch->cnt; i-- > 0; ) {
+		add = &batch->add[i];
+
+		if (ret) {
+			ipa_table_erase_entry(
+				&batch->nat_table->index_table, add->index_tbl_entry_index);
+			ipa_table_erase_entry(
+				&batch->nat_table->table, add->entry_index);
+		} else {
+			rule_hdls[add->pos] = add->rule_hdl;
+		}
+
+		results[add->pos] = ret;
+	}
+
+	batch->cmd->entries = 0;
+	batch->cnt          = 0;
+}
+
+int ipa_NATI_add_ipv4_rules_bulk(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	int*                     results)
+{
+	uint32_t cmd_sz =
+		sizeof(struct ipa_ioc_nat_dma_cmd) +
+		(MAX_DMA_ENTRIES_FOR_BULK * sizeof(struct ipa_ioc_nat_dma_one));
+	char cmd_buf[cmd_sz];
+
+	enum ipa3_nat_mem_in     nmi;
+	nati_bulk_batch          batch;
+	nati_bulk_add*           add;
+	const ipa_nat_ipv4_rule* clnt_rule;
+
+	uint16_t head, index_head;
+	uint32_t i;
+	uint8_t  entries;
 
-	rule = ipa_table_get_entry_by_index(
-		&nat_table->table,
-		new_entry_index);
+	int ret = 0;
 
-	if (rule == NULL) {
-		IPAERR("Failed to retrieve the entry in index %d for NAT table with handle=%d\n",
-			   new_entry_index, tbl_hdl);
-		ret = -EPERM;
-		goto bail;
-	}
+	IPADBG("In\n");
 
-	rule->indx_tbl_entry = new_index_tbl_entry_index;
+	memset(cmd_buf, 0, sizeof(cmd_buf));
 
-	rule->redirect   = clnt_rule->redirect;
-	rule->enable     = clnt_rule->enable;
-	rule->time_stamp = clnt_rule->time_stamp;
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 ! clnt_rules ||
+		 ! rule_hdls ||
+		 ! results )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) clnt_rules(%p) rule_hdls(%p) results(%p)\n",
+			   tbl_hdl, clnt_rules, rule_hdls, results);
+		ret = -EINVAL;
+		goto done;
+	}
 
-	IPADBG("new entry:%d, new index entry: %d\n",
-		   new_entry_index, new_index_tbl_entry_index);
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
 
-	IPADBG("rule_hdl(0x%08X) -> %s\n",
-		   new_entry_handle,
-		   prep_nat_rule_4print(rule, buf, sizeof(buf)));
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
 
-	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto done;
+	}
 
-	if (ret) {
-		IPAERR("unable to post dma command\n");
-		goto bail;
+	for ( i = 0; i < num_rules; i++ ) {
+		rule_hdls[i] = 0;
+		results[i]   = -EINVAL;
 	}
 
-	if (pthread_mutex_unlock(&nat_mutex)) {
-		IPAERR("unable to unlock the nat mutex\n");
-		ret = -EPERM;
+	batch.nat_cache_ptr = &ipv4_nat_cache[nmi];
+	batch.nat_table     = &batch.nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+	batch.cmd           = (struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+	batch.cnt           = 0;
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
 		goto done;
 	}
 
-	*rule_hdl = new_entry_handle;
+	if (! batch.nat_table->mem_desc.valid) {
+		IPAERR("invalid table handle %d\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
 
-	IPADBG("rule_hdl value(%u)\n", *rule_hdl);
+	for ( i = 0; i < num_rules; i++ ) {
 
-	goto done;
+		clnt_rule = &clnt_rules[i];
 
-bail:
-	ipa_table_erase_entry(&nat_table->index_table, new_index_tbl_entry_index);
+		if (ipa_nati_check_ipv4_rule(clnt_rule)) {
+			continue;
+		}
 
-fail_add_index_entry:
-	ipa_table_erase_entry(&nat_table->table, new_entry_index);
+		if (ipa_nati_bulk_batch_full(&batch, MAX_DMA_ENTRIES_FOR_ADD)) {
+			ipa_nati_bulk_add_flush(&batch, rule_hdls, results);
+		}
+
+		ipa_nati_hash_ipv4_rule(
+			batch.nat_cache_ptr,
+			batch.nat_table,
+			clnt_rule,
+			&head,
+			&index_head);
+
+		/*
+		 * A pending rule on the same chain may not be linked in yet
+		 */
+		if (ipa_nati_bulk_add_conflicts(&batch, head, index_head)) {
+			ipa_nati_bulk_add_flush(&batch, rule_hdls, results);
+		}
+
+		add = &batch.add[batch.cnt];
+
+		add->pos                   = i;
+		add->head                  = head;
+		add->index_head            = index_head;
+		add->entry_index           = head;
+		add->index_tbl_entry_index = index_head;
+
+		entries = batch.cmd->entries;
+
+		results[i] = ipa_nati_insert_ipv4_rule(
+			batch.nat_table,
+			clnt_rule,
+			&add->entry_index,
+			&add->index_tbl_entry_index,
+			&add->rule_hdl,
+			batch.cmd);
+
+		if ( results[i] ) {
+			/*
+			 * Drop whatever the failed rule queued
+			 */
+			batch.cmd->entries = entries;
+			continue;
+		}
+
+		batch.cnt++;
+	}
+
+	ipa_nati_bulk_add_flush(&batch, rule_hdls, results);
+
+	for ( i = 0; i < num_rules && ret == 0; i++ ) {
+		ret = results[i];
+	}
 
 unlock:
-	if (pthread_mutex_unlock(&nat_mutex))
+	if (pthread_mutex_unlock(&nat_mutex)) {
 		IPAERR("unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
 done:
 	IPADBG("Out\n");
 
 	return ret;
 }
 
-int ipa_NATI_del_ipv4_rule(
-	uint32_t tbl_hdl,
-	uint32_t rule_hdl )
+/*
+ * Gather the records a located delete reads or changes: the
+ * neighbours of the unlinked records in both tables, plus the record
+ * behind the second index entry when that one is moved to the head.
+ */
+static void ipa_nati_bulk_del_recs(
+	nati_bulk_del* del)
+{
+	ipa_table_iterator* it  = &del->table_iterator;
+	ipa_table_iterator* iit = &del->index_table_iterator;
+
+	del->recs[0] = it->prev_index;
+	del->recs[1] = it->curr_index;
+	del->recs[2] = it->next_index;
+
+	del->index_recs[0] = iit->prev_index;
+	del->index_recs[1] = iit->curr_index;
+	del->index_recs[2] = iit->next_index;
+	del->index_recs[3] = IPA_TABLE_INVALID_ENTRY;
+
+	if (ipa_table_iterator_is_head_with_tail(iit)) {
+		del->index_recs[3] =
+			((struct ipa_nat_indx_tbl_rule*) iit->next_entry)->next_index;
+	}
+}
+
+static bool ipa_nati_bulk_recs_overlap(
+	const uint16_t* a,
+	uint32_t        a_cnt,
+	const uint16_t* b,
+	uint32_t        b_cnt)
+{
+	uint32_t i, j;
+
+	for ( i = 0; i < a_cnt; i++ ) {
+		if ( a[i] == IPA_TABLE_INVALID_ENTRY )
+			continue;
+		for ( j = 0; j < b_cnt; j++ ) {
+			if ( a[i] == b[j] )
+				return true;
+		}
+	}
+
+	return false;
+}
+
+static bool ipa_nati_bulk_del_conflicts(
+	nati_bulk_batch* batch,
+	nati_bulk_del*   del)
+{
+	nati_bulk_del* pend;
+	uint32_t       i;
+
+	for ( i = 0; i < batch->cnt; i++ ) {
+		pend = &batch->del[i];
+
+		if ( ipa_nati_bulk_recs_overlap(
+				 del->recs, 3, pend->recs, 3) ||
+			 ipa_nati_bulk_recs_overlap(
+				 del->index_recs, 4, pend->index_recs, 4) )
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Post the pending deletes and release their records
+ */
+static void ipa_nati_bulk_del_flush(
+	nati_bulk_batch* batch,
+	int*             results)
+{
+	nati_bulk_del* del;
+	uint32_t       i;
+	int            ret;
+
+	if ( batch->cnt == 0 )
+		return;
+
+	ret = ipa_nati_post_ipv4_dma_cmd(batch->nat_cache_ptr, batch->cmd);
+
+	if (ret) {
+		IPAERR("Unable to post dma command for %u rules\n", batch->cnt);
+	}
+
+	for ( i = 0; i < batch->cnt; i++ ) {
+		del = &batch->del[i];
+
+		if ( ret == 0 ) {
+			ipa_nati_release_ipv4_rule(
+				batch->nat_table,
+				&del->table_iterator,
+				&del->index_table_iterator);
+		}
+
+		results[del->pos] = ret;
+	}
+
+	batch->cmd->entries = 0;
+	batch->cnt          = 0;
+}
+
+int ipa_NATI_del_ipv4_rules_bulk(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	int*            results)
 {
 	uint32_t cmd_sz =
 		sizeof(struct ipa_ioc_nat_dma_cmd) +
-		(MAX_DMA_ENTRIES_FOR_DEL * sizeof(struct ipa_ioc_nat_dma_one));
+		(MAX_DMA_ENTRIES_FOR_BULK * sizeof(struct ipa_ioc_nat_dma_one));
 	char cmd_buf[cmd_sz];
-	struct ipa_ioc_nat_dma_cmd* cmd =
-		(struct ipa_ioc_nat_dma_cmd*) cmd_buf;
 
-	enum ipa3_nat_mem_in            nmi;
-	struct ipa_nat_cache*           nat_cache_ptr;
-	struct ipa_nat_ip4_table_cache* nat_table;
-	struct ipa_nat_rule*            table_rule;
-	struct ipa_nat_indx_tbl_rule*   index_table_rule;
+	enum ipa3_nat_mem_in nmi;
+	nati_bulk_batch      batch;
+	nati_bulk_del*       del;
 
-	ipa_table_iterator table_iterator;
-	ipa_table_iterator index_table_iterator;
+	uint32_t i;
+	uint8_t  entries;
 
-	uint16_t index;
-	char     buf[1024];
-	int      ret = 0;
+	int ret = 0;
 
 	IPADBG("In\n");
 
 	memset(cmd_buf, 0, sizeof(cmd_buf));
 
-	IPADBG("tbl_hdl(0x%08X) rule_hdl(%u)\n", tbl_hdl, rule_hdl);
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 ! rule_hdls ||
+		 ! results )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) rule_hdls(%p) results(%p)\n",
+			   tbl_hdl, rule_hdls, results);
+		ret = -EINVAL;
+		goto done;
+	}
+
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
 
 	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
 
@@ -1881,11 +2593,14 @@ int ipa_NATI_del_ipv4_rule(
 		goto done;
 	}
 
-	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(nmi));
-
-	nat_cache_ptr = &ipv4_nat_cache[nmi];
+	for ( i = 0; i < num_rules; i++ ) {
+		results[i] = -EINVAL;
+	}
 
-	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+	batch.nat_cache_ptr = &ipv4_nat_cache[nmi];
+	batch.nat_table     = &batch.nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+	batch.cmd           = (struct ipa_ioc_nat_dma_cmd*) cmd_buf;
+	batch.cnt           = 0;
 
 	if (pthread_mutex_lock(&nat_mutex)) {
 		IPAERR("Unable to lock the nat mutex\n");
@@ -1893,121 +2608,84 @@ int ipa_NATI_del_ipv4_rule(
 		goto done;
 	}
 
-	if (! nat_table->mem_desc.valid) {
+	if (! batch.nat_table->mem_desc.valid) {
 		IPAERR("Invalid table handle 0x%08X\n", tbl_hdl);
 		ret = -EINVAL;
 		goto unlock;
 	}
 
-	ret = ipa_table_get_entry(
-		&nat_table->table,
-		rule_hdl,
-		(void**) &table_rule,
-		&index);
+	for ( i = 0; i < num_rules; i++ ) {
 
-	if (ret) {
-		IPAERR("Unable to retrive the entry with rule_hdl=%u\n", rule_hdl);
-		goto unlock;
-	}
+		if ( ! VALID_RULE_HDL(rule_hdls[i]) ) {
+			IPAERR("Invalid rule handle 0x%08X\n", rule_hdls[i]);
+			continue;
+		}
 
-	IPADBG("rule_hdl(0x%08X) -> %s\n",
-		   rule_hdl,
-		   prep_nat_rule_4print(table_rule, buf, sizeof(buf)));
+		if (ipa_nati_bulk_batch_full(&batch, MAX_DMA_ENTRIES_FOR_DEL)) {
+			ipa_nati_bulk_del_flush(&batch, results);
+		}
 
-	ret = ipa_table_iterator_init(
-		&table_iterator,
-		&nat_table->table,
-		table_rule,
-		index);
+		del = &batch.del[batch.cnt];
 
-	if (ret) {
-		IPAERR("Unable to create iterator which points to the "
-			   "entry %u in NAT table with handle=0x%08X\n",
-			   index, tbl_hdl);
-		goto unlock;
-	}
+		del->pos = i;
 
-	index = table_rule->indx_tbl_entry;
+		results[i] = ipa_nati_locate_ipv4_rule(
+			batch.nat_table,
+			rule_hdls[i],
+			&del->table_iterator,
+			&del->index_table_iterator);
 
-	index_table_rule = (struct ipa_nat_indx_tbl_rule*)
-		ipa_table_get_entry_by_index(&nat_table->index_table, index);
+		if ( results[i] ) {
+			continue;
+		}
 
-	if (index_table_rule == NULL) {
-		IPAERR("Unable to retrieve the entry in index %u "
-			   "in NAT index table with handle=0x%08X\n",
-			   index, tbl_hdl);
-		ret = -EPERM;
-		goto unlock;
-	}
+		ipa_nati_bulk_del_recs(del);
 
-	ret = ipa_table_iterator_init(
-		&index_table_iterator,
-		&nat_table->index_table,
-		index_table_rule,
-		index);
+		if (ipa_nati_bulk_del_conflicts(&batch, del)) {
+			/*
+			 * The chain is about to change under us, so look the
+			 * rule up again once the pending deletes are done
+			 */
+			ipa_nati_bulk_del_flush(&batch, results);
 
-	if (ret) {
-		IPAERR("Unable to create iterator which points to the "
-			   "entry %u in NAT index table with handle=0x%08X\n",
-			   index, tbl_hdl);
-		goto unlock;
-	}
+			del = &batch.del[0];
 
-	ipa_table_create_delete_command(
-		&nat_table->index_table,
-		cmd,
-		&index_table_iterator);
+			del->pos = i;
 
-	if (ipa_table_iterator_is_head_with_tail(&index_table_iterator)) {
+			results[i] = ipa_nati_locate_ipv4_rule(
+				batch.nat_table,
+				rule_hdls[i],
+				&del->table_iterator,
+				&del->index_table_iterator);
 
-		ipa_nati_copy_second_index_entry_to_head(
-			nat_table, &index_table_iterator, cmd);
-		/*
-		 * Iterate to the next entry which should be deleted
-		 */
-		ret = ipa_table_iterator_next(
-			&index_table_iterator, &nat_table->index_table);
+			if ( results[i] ) {
+				continue;
+			}
 
-		if (ret) {
-			IPAERR("Unable to move the iterator to the next entry "
-				   "(points to the entry %u in NAT index table)\n",
-				   index);
-			goto unlock;
+			ipa_nati_bulk_del_recs(del);
 		}
-	}
-
-	ipa_table_create_delete_command(
-		&nat_table->table,
-		cmd,
-		&table_iterator);
 
-	ret = ipa_nati_post_ipv4_dma_cmd(nat_cache_ptr, cmd);
+		entries = batch.cmd->entries;
 
-	if (ret) {
-		IPAERR("Unable to post dma command\n");
-		goto unlock;
-	}
+		results[i] = ipa_nati_create_ipv4_del_cmd(
+			batch.nat_table,
+			&del->table_iterator,
+			&del->index_table_iterator,
+			batch.cmd);
 
-	if (! ipa_table_iterator_is_head_with_tail(&table_iterator)) {
-		/* The entry can be deleted */
-		uint8_t is_prev_empty =
-			(table_iterator.prev_entry != NULL &&
-			 ((struct ipa_nat_rule*)table_iterator.prev_entry)->protocol ==
-			 IPAHAL_NAT_INVALID_PROTOCOL);
+		if ( results[i] ) {
+			batch.cmd->entries = entries;
+			continue;
+		}
 
-		ipa_table_delete_entry(
-			&nat_table->table, &table_iterator, is_prev_empty);
+		batch.cnt++;
 	}
 
-	ipa_table_delete_entry(
-		&nat_table->index_table,
-		&index_table_iterator,
-		FALSE);
+	ipa_nati_bulk_del_flush(&batch, results);
 
-	if (index_table_iterator.curr_index >= nat_table->index_table.table_entries)
-		nat_table->index_expn_table_meta[
-			index_table_iterator.curr_index - nat_table->index_table.table_entries].
-			prev_index = IPA_TABLE_INVALID_ENTRY;
+	for ( i = 0; i < num_rules && ret == 0; i++ ) {
+		ret = results[i];
+	}
 
 unlock:
 	if (pthread_mutex_unlock(&nat_mutex)) {
@@ -2329,7 +3007,12 @@ bail:
 	return ret;
 }
 
-int ipa_NATI_walk_ipv4_tbl(
+/*
+ * The part of ipa_NATI_walk_ipv4_tbl() that runs without nat_mutex.
+ * The caller guarantees the table stays mapped throughout (see the
+ * reader gate in ipa_nat_statemach.c)...
+ */
+int ipa_NATI_walk_ipv4_tbl_nolock(
 	uint32_t          tbl_hdl,
 	WhichTbl2Use      which,
 	ipa_table_walk_cb walk_cb,
@@ -2355,13 +3038,6 @@ int ipa_NATI_walk_ipv4_tbl(
 		goto bail;
 	}
 
-	if ( pthread_mutex_lock(&nat_mutex) )
-	{
-		IPAERR("unable to lock the nat mutex\n");
-		ret = -EINVAL;
-		goto bail;
-	}
-
 	/*
 	 * Now walk the table and pass the valid records to the user's
 	 * walk callback...
@@ -2372,7 +3048,7 @@ int ipa_NATI_walk_ipv4_tbl(
 	{
 		IPAERR("Bad cache type argument passed\n");
 		ret = -EINVAL;
-		goto unlock;
+		goto bail;
 	}
 
 	nat_cache_ptr = &ipv4_nat_cache[nmi];
@@ -2381,7 +3057,7 @@ int ipa_NATI_walk_ipv4_tbl(
 	{
 		IPAERR("No initialized table in NAT cache\n");
 		ret = -EINVAL;
-		goto unlock;
+		goto bail;
 	}
 
 	nat_table = &nat_cache_ptr->ip4_tbl[broken_tbl_hdl - 1];
@@ -2396,10 +3072,33 @@ int ipa_NATI_walk_ipv4_tbl(
 	if ( ret != 0 )
 	{
 		IPAERR("ipa_table_walk returned non-zero (%d)\n", ret);
-		goto unlock;
 	}
 
-unlock:
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_NATI_walk_ipv4_tbl(
+	uint32_t          tbl_hdl,
+	WhichTbl2Use      which,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( pthread_mutex_lock(&nat_mutex) )
+	{
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	ret = ipa_NATI_walk_ipv4_tbl_nolock(tbl_hdl, which, walk_cb, arb_data_ptr);
+
 	if ( pthread_mutex_unlock(&nat_mutex) )
 	{
 		IPAERR("unable to unlock the nat mutex\n");
@@ -26,14 +26,181 @@
  * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-#include <map>
-#include <iterator>
-
 #include "ipa_nat_utils.h"
 
 #include "ipa_nat_map.h"
 
-static std::map<uint32_t, uint32_t> map_array[MAP_NUM_MAX];
+/*
+ * Each map is a flat, open addressing (linear probing) hash table of
+ * key/value pairs. Capacity is always a power of two and the table is
+ * grown when it becomes three quarters full. Once a map has been
+ * reserved (see ipa_nat_map_reserve()) for the number of keys it will
+ * hold, adds, finds, deletes and clears do no heap allocation.
+ *
+ * MAP_EMPTY_KEY marks an unused slot. Since it is also a legal key,
+ * its value is kept outside of the slot array...
+ */
+#define MAP_EMPTY_KEY 0xFFFFFFFF
+#define MAP_MIN_SLOTS 64
+
+typedef struct
+{
+	uint32_t key;
+	uint32_t val;
+} map_slot;
+
+typedef struct
+{
+	map_slot* slots;
+	uint32_t  mask;
+	uint32_t  cnt;
+	bool      has_empty_key;
+	uint32_t  empty_key_val;
+} flat_map;
+
+static flat_map map_array[MAP_NUM_MAX];
+
+/******************************************************************************/
+
+static inline uint32_t map_hash(
+	const flat_map* map,
+	uint32_t        key )
+{
+	uint32_t h = key * 0x9E3779B1;
+
+	return (h ^ (h >> 16)) & map->mask;
+}
+
+static inline uint32_t map_slots(
+	const flat_map* map )
+{
+	return (map->slots) ? map->mask + 1 : 0;
+}
+
+static inline map_slot* map_lookup(
+	flat_map* map,
+	uint32_t  key )
+{
+	uint32_t i;
+
+	if ( ! map->slots )
+		return NULL;
+
+	for ( i = map_hash(map, key);
+		  map->slots[i].key != MAP_EMPTY_KEY;
+		  i = (i + 1) & map->mask )
+	{
+		if ( map->slots[i].key == key )
+			return &map->slots[i];
+	}
+
+	return NULL;
+}
+
+/*
+ * Place a key known not to be in the map. Caller guarantees room...
+ */
+static inline void map_place(
+	flat_map* map,
+	uint32_t  key,
+	uint32_t  val )
+{
+	uint32_t i = map_hash(map, key);
+
+	while ( map->slots[i].key != MAP_EMPTY_KEY )
+		i = (i + 1) & map->mask;
+
+	map->slots[i].key = key;
+	map->slots[i].val = val;
+
+	map->cnt++;
+}
+
+static int map_resize(
+	flat_map* map,
+	uint32_t  num_slots )
+{
+	map_slot* old_slots = map->slots;
+	uint32_t  old_num   = map_slots(map);
+	uint32_t  i;
+
+	map->slots = (map_slot*) malloc(num_slots * sizeof(map_slot));
+
+	if ( ! map->slots )
+	{
+		IPAERR("Unable to allocate %u map slots\n", num_slots);
+		map->slots = old_slots;
+		return -1;
+	}
+
+	memset(map->slots, 0xFF, num_slots * sizeof(map_slot));
+
+	map->mask = num_slots - 1;
+	map->cnt  = 0;
+
+	for ( i = 0; i < old_num; i++ )
+	{
+		if ( old_slots[i].key != MAP_EMPTY_KEY )
+			map_place(map, old_slots[i].key, old_slots[i].val);
+	}
+
+	free(old_slots);
+
+	return 0;
+}
+
+/*
+ * Make sure the map can hold num_keys keys while staying under
+ * three quarters full...
+ */
+static int map_make_room(
+	flat_map* map,
+	uint32_t  num_keys )
+{
+	uint32_t num_slots = MAP_MIN_SLOTS;
+
+	while ( num_keys * 4 > num_slots * 3 )
+		num_slots <<= 1;
+
+	if ( num_slots <= map_slots(map) )
+		return 0;
+
+	return map_resize(map, num_slots);
+}
+
+/*
+ * Take the key in slot i out and close the hole behind it, so that
+ * probe sequences never need tombstones...
+ */
+static void map_remove_slot(
+	flat_map* map,
+	uint32_t  i )
+{
+	uint32_t j = i, k;
+
+	while ( 1 )
+	{
+		j = (j + 1) & map->mask;
+
+		if ( map->slots[j].key == MAP_EMPTY_KEY )
+			break;
+
+		k = map_hash(map, map->slots[j].key);
+
+		/*
+		 * Move slot j into the hole unless its home slot k lies
+		 * cyclically in (i, j]...
+		 */
+		if ( (i <= j) ? (i < k && k <= j) : (i < k || k <= j) )
+			continue;
+
+		map->slots[i] = map->slots[j];
+		i = j;
+	}
+
+	map->slots[i].key = MAP_EMPTY_KEY;
+	map->cnt--;
+}
 
 /******************************************************************************/
 
@@ -42,9 +209,9 @@ int ipa_nat_map_add(
 	uint32_t      key,
 	uint32_t      val )
 {
-	int ret_val = 0;
+	flat_map* map;
 
-	std::pair<std::map<uint32_t, uint32_t>::iterator, bool> ret;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -58,14 +225,90 @@ int ipa_nat_map_add(
 	IPADBG("[%s] key(%u) -> val(%u)\n",
 		   ipa_which_map_as_str(which), key, val);
 
-	ret = map_array[which].insert(std::pair<uint32_t, uint32_t>(key, val));
+	map = &map_array[which];
 
-	if ( ret.second == false )
+	if ( key == MAP_EMPTY_KEY ? map->has_empty_key : map_lookup(map, key) != NULL )
 	{
 		IPAERR("[%s] key(%u) already exists in map\n",
 			   ipa_which_map_as_str(which),
 			   key);
 		ret_val = -1;
+		goto bail;
+	}
+
+	if ( key == MAP_EMPTY_KEY )
+	{
+		map->has_empty_key = true;
+		map->empty_key_val = val;
+		goto bail;
+	}
+
+	if ( map_make_room(map, map->cnt + 1) )
+	{
+		ret_val = -1;
+		goto bail;
+	}
+
+	map_place(map, key, val);
+
+bail:
+	IPADBG("Out\n");
+
+	return ret_val;
+}
+
+/******************************************************************************/
+
+int ipa_nat_map_add_bulk(
+	ipa_which_map   which,
+	const uint32_t* keys,
+	const uint32_t* vals,
+	uint32_t        num )
+{
+	flat_map* map;
+	uint32_t  i;
+
+	int ret_val = 0;
+
+	IPADBG("In\n");
+
+	if ( ! VALID_IPA_USE_MAP(which) || (num && (! keys || ! vals)) )
+	{
+		IPAERR("Bad arg which(%u) keys(%p) vals(%p)\n", which, keys, vals);
+		ret_val = -1;
+		goto bail;
+	}
+
+	IPADBG("[%s] num(%u)\n", ipa_which_map_as_str(which), num);
+
+	map = &map_array[which];
+
+	if ( map_make_room(map, map->cnt + num) )
+	{
+		ret_val = -1;
+		goto bail;
+	}
+
+	for ( i = 0; i < num; i++ )
+	{
+		if ( keys[i] == MAP_EMPTY_KEY )
+		{
+			ret_val = ipa_nat_map_add(which, keys[i], vals[i]);
+		}
+		else if ( map_lookup(map, keys[i]) )
+		{
+			IPAERR("[%s] key(%u) already exists in map\n",
+				   ipa_which_map_as_str(which),
+				   keys[i]);
+			ret_val = -1;
+		}
+		else
+		{
+			map_place(map, keys[i], vals[i]);
+		}
+
+		if ( ret_val )
+			break;
 	}
 
 bail:
@@ -81,9 +324,11 @@ int ipa_nat_map_find(
 	uint32_t      key,
 	uint32_t*     val_ptr )
 {
-	int ret_val = 0;
+	map_slot* slot = NULL;
+	uint32_t  val  = 0;
+	bool      found;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -97,9 +342,19 @@ int ipa_nat_map_find(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	if ( key == MAP_EMPTY_KEY )
+	{
+		found = map_array[which].has_empty_key;
+		val   = map_array[which].empty_key_val;
+	}
+	else
+	{
+		slot  = map_lookup(&map_array[which], key);
+		found = (slot != NULL);
+		val   = (slot) ? slot->val : 0;
+	}
 
-	if ( it == map_array[which].end() )
+	if ( ! found )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
@@ -110,7 +365,7 @@ int ipa_nat_map_find(
 	{
 		if ( val_ptr )
 		{
-			*val_ptr = it->second;
+			*val_ptr = val;
 			IPADBG("[%s] key(%u) -> val(%u)\n",
 				   ipa_which_map_as_str(which),
 				   key, *val_ptr);
@@ -130,9 +385,12 @@ int ipa_nat_map_del(
 	uint32_t      key,
 	uint32_t*     val_ptr )
 {
-	int ret_val = 0;
+	flat_map* map;
+	map_slot* slot = NULL;
+	uint32_t  val  = 0;
+	bool      found;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -146,9 +404,21 @@ int ipa_nat_map_del(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	map = &map_array[which];
 
-	if ( it == map_array[which].end() )
+	if ( key == MAP_EMPTY_KEY )
+	{
+		found = map->has_empty_key;
+		val   = map->empty_key_val;
+	}
+	else
+	{
+		slot  = map_lookup(map, key);
+		found = (slot != NULL);
+		val   = (slot) ? slot->val : 0;
+	}
+
+	if ( ! found )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
@@ -159,12 +429,16 @@ int ipa_nat_map_del(
 	{
 		if ( val_ptr )
 		{
-			*val_ptr = it->second;
+			*val_ptr = val;
 			IPADBG("[%s] key(%u) -> val(%u)\n",
 				   ipa_which_map_as_str(which),
 				   key, *val_ptr);
 		}
-		map_array[which].erase(it);
+
+		if ( slot )
+			map_remove_slot(map, slot - map->slots);
+		else
+			map->has_empty_key = false;
 	}
 
 bail:
@@ -173,9 +447,37 @@ bail:
 	return ret_val;
 }
 
+int ipa_nat_map_reserve(
+	ipa_which_map which,
+	uint32_t      num_keys )
+{
+	int ret_val = 0;
+
+	IPADBG("In\n");
+
+	if ( ! VALID_IPA_USE_MAP(which) )
+	{
+		IPAERR("Bad arg which(%u)\n", which);
+		ret_val = -1;
+		goto bail;
+	}
+
+	IPADBG("[%s] num_keys(%u)\n",
+		   ipa_which_map_as_str(which), num_keys);
+
+	ret_val = map_make_room(&map_array[which], num_keys);
+
+bail:
+	IPADBG("Out\n");
+
+	return ret_val;
+}
+
 int ipa_nat_map_clear(
 	ipa_which_map which )
 {
+	flat_map* map;
+
 	int ret_val = 0;
 
 	IPADBG("In\n");
@@ -187,7 +489,16 @@ int ipa_nat_map_clear(
 		goto bail;
 	}
 
-	map_array[which].clear();
+	map = &map_array[which];
+
+	/*
+	 * Keep the slots around for reuse...
+	 */
+	if ( map->slots )
+		memset(map->slots, 0xFF, map_slots(map) * sizeof(map_slot));
+
+	map->cnt           = 0;
+	map->has_empty_key = false;
 
 bail:
 	IPADBG("Out\n");
@@ -198,7 +509,8 @@ bail:
 int ipa_nat_map_dump(
 	ipa_which_map which )
 {
-	std::map<uint32_t, uint32_t>::iterator it;
+	flat_map* map;
+	uint32_t  i;
 
 	int ret_val = 0;
 
@@ -211,17 +523,29 @@ int ipa_nat_map_dump(
 		goto bail;
 	}
 
+	map = &map_array[which];
+
 	printf("Dumping: %s\n", ipa_which_map_as_str(which));
 
-	for ( it  = map_array[which].begin();
-		  it != map_array[which].end();
-		  it++ )
+	for ( i = 0; i < map_slots(map); i++ )
+	{
+		if ( map->slots[i].key == MAP_EMPTY_KEY )
+			continue;
+
+		printf("  Key[%u|0x%08X] -> Value[%u|0x%08X]\n",
+			   map->slots[i].key,
+			   map->slots[i].key,
+			   map->slots[i].val,
+			   map->slots[i].val);
+	}
+
+	if ( map->has_empty_key )
 	{
 		printf("  Key[%u|0x%08X] -> Value[%u|0x%08X]\n",
-			   it->first,
-			   it->first,
-			   it->second,
-			   it->second);
+			   MAP_EMPTY_KEY,
+			   MAP_EMPTY_KEY,
+			   map->empty_key_val,
+			   map->empty_key_val);
 	}
 
 bail:
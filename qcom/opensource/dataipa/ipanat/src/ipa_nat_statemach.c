@@ -172,6 +172,51 @@ static ipa_nati_obj nati_obj = {
 	.sw_stats = { {0, 0}, {0, 0} },
 };
 
+/*
+ * During a table switch, migrate_rule() stages the orig/new handle
+ * pairs of the rules it moves here. They are bulk added to the
+ * destination maps once the copy is done, rather than one map insert
+ * per rule. Sized when the hybrid tables are created...
+ */
+static struct
+{
+	uint32_t* orig_hdls;
+	uint32_t* new_hdls;
+	uint32_t  cnt;
+	uint32_t  max;
+} mig_stage;
+
+/*
+ * Lets timestamp queries and table walks run without nat_mutex below,
+ * so that conntrack aging, which polls timestamps for every rule,
+ * does not hold up rule adds and deletes.
+ *
+ * Table adds and deletes close the gate.  Everything that changes
+ * which table or handle a rule is found by (state changes, table
+ * switches, clears and handle map deletes) is done with the gate's
+ * sequence count odd.  Handle map adds need not be: open addressing
+ * inserts never move the other keys.
+ *
+ * Readers in a hybrid state look the handle maps up, which is only
+ * safe while the maps do not grow, ie. when mig_stage_alloc() managed
+ * to reserve them.
+ */
+static ipa_rd_gate nati_gate = IPA_RD_GATE_INITIALIZER;
+static bool        maps_reserved = false;
+
+#undef  IS_READ_TRIGGER
+#define IS_READ_TRIGGER(t) \
+	( (t) == NATI_TRIG_WLK_TABLE || \
+	  (t) == NATI_TRIG_TBL_STATS || \
+	  (t) == NATI_TRIG_GET_TSTAMP )
+
+#undef  IS_RULE_TRIGGER
+#define IS_RULE_TRIGGER(t) \
+	( (t) == NATI_TRIG_ADD_RULE  || \
+	  (t) == NATI_TRIG_DEL_RULE  || \
+	  (t) == NATI_TRIG_ADD_RULES || \
+	  (t) == NATI_TRIG_DEL_RULES )
+
 /*
  * The following needed to protect nati_obj above, as well as a number
  * of data stuctures within the file ipa_nat_drvi.c
@@ -269,6 +314,176 @@ static int give_mutex()
 	return ret;
 }
 
+/*
+ * Resolve, without nat_mutex, the table and rule handles to read from,
+ * the same way the state machine's walk and timestamp callbacks would.
+ * Only meaningful within a nati_gate read section.  Returns -EAGAIN
+ * when the lockless read can't be done in the current state...
+ */
+static int nati_rd_resolve(
+	uint32_t  tbl_hdl,
+	uint32_t  rule_hdl,
+	uint32_t* tbl_hdl_ptr,
+	uint32_t* rule_hdl_ptr )
+{
+	ipa_nati_state state = nati_obj.curr_state;
+
+	uint32_t orig2new_map, new2orig_map;
+
+	switch ( state )
+	{
+	case NATI_STATE_DDR_ONLY:
+	case NATI_STATE_SRAM_ONLY:
+		*tbl_hdl_ptr = tbl_hdl;
+
+		if ( rule_hdl_ptr )
+		{
+			*rule_hdl_ptr = rule_hdl;
+		}
+
+		return 0;
+
+	case NATI_STATE_HYBRID:
+	case NATI_STATE_HYBRID_DDR:
+		if ( ! maps_reserved )
+		{
+			return -EAGAIN;
+		}
+
+		*tbl_hdl_ptr =
+			(state == NATI_STATE_HYBRID) ?
+			tbl_hdl                      :
+			nati_obj.ddr_tbl_hdl;
+
+		if ( rule_hdl_ptr )
+		{
+			CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+			return ipa_nat_map_find(orig2new_map, rule_hdl, rule_hdl_ptr);
+		}
+
+		return 0;
+
+	default:
+		return -EAGAIN;
+	}
+}
+
+/*
+ * Lockless timestamp query.  Returns false when the query could not
+ * be done this way and needs to go through the state machine...
+ */
+static bool nati_rd_query_timestamp(
+	uint32_t  tbl_hdl,
+	uint32_t  rule_hdl,
+	uint32_t* time_stamp,
+	int*      ret_ptr )
+{
+	uint32_t seq, rd_tbl_hdl, rd_rule_hdl, ts = 0;
+	int      tries, ret = -EAGAIN;
+
+	if ( ! ipa_rd_gate_enter(&nati_gate) )
+	{
+		return false;
+	}
+
+	for ( tries = 0; tries < IPA_RD_GATE_TRIES; tries++ )
+	{
+		seq = ipa_rd_seq_begin(&nati_gate);
+
+		if ( seq & 1 )
+		{
+			sched_yield();
+			continue;
+		}
+
+		ret = nati_rd_resolve(tbl_hdl, rule_hdl, &rd_tbl_hdl, &rd_rule_hdl);
+
+		if ( ret == 0 )
+		{
+			ret = ipa_NATI_query_timestamp_nolock(rd_tbl_hdl, rd_rule_hdl, &ts);
+		}
+
+		if ( ret == -EAGAIN || ! ipa_rd_seq_retry(&nati_gate, seq) )
+		{
+			break;
+		}
+
+		ret = -EAGAIN;
+	}
+
+	ipa_rd_gate_exit(&nati_gate);
+
+	if ( ret == -EAGAIN )
+	{
+		return false;
+	}
+
+	if ( ret == 0 )
+	{
+		*time_stamp = ts;
+	}
+
+	*ret_ptr = ret;
+
+	return true;
+}
+
+/*
+ * Lockless table walk.  Only the choice of table is checked against
+ * the sequence count, since the walk callbacks can't be taken back:
+ * records are seen as they are when visited, and a walk that overlaps
+ * a table switch may see rules leaving the table.  As the walk holds
+ * the gate, its callbacks must not add or delete tables.  Returns
+ * false when the walk could not be done this way and needs to go
+ * through the state machine...
+ */
+static bool nati_rd_walk(
+	uint32_t          tbl_hdl,
+	WhichTbl2Use      which,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr,
+	int*              ret_ptr )
+{
+	uint32_t seq, rd_tbl_hdl;
+	int      tries, ret = -EAGAIN;
+
+	if ( ! ipa_rd_gate_enter(&nati_gate) )
+	{
+		return false;
+	}
+
+	for ( tries = 0; tries < IPA_RD_GATE_TRIES; tries++ )
+	{
+		seq = ipa_rd_seq_begin(&nati_gate);
+
+		if ( seq & 1 )
+		{
+			sched_yield();
+			continue;
+		}
+
+		ret = nati_rd_resolve(tbl_hdl, 0, &rd_tbl_hdl, NULL);
+
+		if ( ret == -EAGAIN || ! ipa_rd_seq_retry(&nati_gate, seq) )
+		{
+			break;
+		}
+
+		ret = -EAGAIN;
+	}
+
+	if ( ret == 0 )
+	{
+		*ret_ptr = ipa_NATI_walk_ipv4_tbl_nolock(
+			rd_tbl_hdl, which, walk_cb, arb_data_ptr);
+	}
+
+	ipa_rd_gate_exit(&nati_gate);
+
+	return ret == 0;
+}
+
 /*
  * ****************************************************************************
  *
@@ -293,8 +508,12 @@ int ipa_nati_add_ipv4_tbl(
 
 	IPADBG("In\n");
 
+	ipa_rd_gate_close(&nati_gate);
+
 	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_ADD_TABLE, args);
 
+	ipa_rd_gate_open(&nati_gate);
+
 	if ( ret == 0 )
 	{
 		IPADBG("tbl_hdl val(0x%08X)\n", *tbl_hdl);
@@ -316,8 +535,12 @@ int ipa_nati_del_ipv4_table(
 
 	IPADBG("In\n");
 
+	ipa_rd_gate_close(&nati_gate);
+
 	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_DEL_TABLE, args);
 
+	ipa_rd_gate_open(&nati_gate);
+
 	IPADBG("Out\n");
 
 	return ret;
@@ -358,7 +581,10 @@ int ipa_nati_walk_ipv4_tbl(
 
 	IPADBG("In\n");
 
-	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_WLK_TABLE, args);
+	if ( ! nati_rd_walk(tbl_hdl, which, walk_cb, arb_data_ptr, &ret) )
+	{
+		ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_WLK_TABLE, args);
+	}
 
 	IPADBG("Out\n");
 
@@ -434,6 +660,84 @@ int ipa_nati_del_ipv4_rule(
 	return ret;
 }
 
+int ipa_nati_add_ipv4_rules_bulk(
+	uint32_t                 tbl_hdl,
+	const ipa_nat_ipv4_rule* clnt_rules,
+	uint32_t                 num_rules,
+	uint32_t*                rule_hdls,
+	int*                     results )
+{
+	arb_t* args[] = {
+		(arb_t*)(arb_t)tbl_hdl,
+		(arb_t*) clnt_rules,
+		(arb_t*)(arb_t)num_rules,
+		(arb_t*) rule_hdls,
+		(arb_t*) results,
+	};
+
+	uint32_t i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		rule_hdls[i] = 0;
+		results[i]   = -EINVAL;
+	}
+
+	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_ADD_RULES, args);
+
+	/*
+	 * The outcome of each rule is in results, report the first failure
+	 */
+	for ( i = 0; i < num_rules && ret == 0; i++ )
+	{
+		ret = results[i];
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_nati_del_ipv4_rules_bulk(
+	uint32_t        tbl_hdl,
+	const uint32_t* rule_hdls,
+	uint32_t        num_rules,
+	int*            results )
+{
+	arb_t* args[] = {
+		(arb_t*)(arb_t)tbl_hdl,
+		(arb_t*) rule_hdls,
+		(arb_t*)(arb_t)num_rules,
+		(arb_t*) results,
+	};
+
+	uint32_t i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		results[i] = -EINVAL;
+	}
+
+	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_DEL_RULES, args);
+
+	for ( i = 0; i < num_rules && ret == 0; i++ )
+	{
+		ret = results[i];
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 int ipa_nati_query_timestamp(
 	uint32_t  tbl_hdl,
 	uint32_t  rule_hdl,
@@ -449,7 +753,10 @@ int ipa_nati_query_timestamp(
 
 	IPADBG("In\n");
 
-	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_GET_TSTAMP, args);
+	if ( ! nati_rd_query_timestamp(tbl_hdl, rule_hdl, time_stamp, &ret) )
+	{
+		ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_GET_TSTAMP, args);
+	}
 
 	if ( ret == 0 )
 	{
@@ -609,6 +916,107 @@ bool ipa_nat_is_sram_supported(void)
 	return VALID_TBL_HDL(nati_obj.sram_tbl_hdl);
 }
 
+/******************************************************************************/
+/*
+ * FUNCTION: mig_stage_alloc
+ *
+ * PARAMS:
+ *
+ *   sram_ents (IN) The number of rules the SRAM table can hold
+ *
+ *   ddr_ents  (IN) The number of rules the DDR table can hold
+ *
+ * DESCRIPTION:
+ *
+ *   Preallocate the handle maps and the migration staging area, so
+ *   that rule adds, deletes and table switches do no heap allocation
+ *   in steady state.  A failure here is not fatal: the maps grow on
+ *   demand (timestamp queries and walks then take nat_mutex) and
+ *   migrate_rule() falls back to per rule map inserts.
+ */
+static void mig_stage_alloc(
+	uint32_t sram_ents,
+	uint32_t ddr_ents )
+{
+	uint32_t max = (sram_ents > ddr_ents) ? sram_ents : ddr_ents;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	ret  = ipa_nat_map_reserve(nati_obj.map_pairs[SRAM_SUB].orig2new_map, sram_ents);
+	ret |= ipa_nat_map_reserve(nati_obj.map_pairs[SRAM_SUB].new2orig_map, sram_ents);
+	ret |= ipa_nat_map_reserve(nati_obj.map_pairs[DDR_SUB].orig2new_map,  ddr_ents);
+	ret |= ipa_nat_map_reserve(nati_obj.map_pairs[DDR_SUB].new2orig_map,  ddr_ents);
+
+	maps_reserved = (ret == 0);
+
+	if ( max > mig_stage.max )
+	{
+		free(mig_stage.orig_hdls);
+		free(mig_stage.new_hdls);
+
+		mig_stage.orig_hdls = (uint32_t*) malloc(max * sizeof(uint32_t));
+		mig_stage.new_hdls  = (uint32_t*) malloc(max * sizeof(uint32_t));
+		mig_stage.max       = max;
+
+		if ( ! mig_stage.orig_hdls || ! mig_stage.new_hdls )
+		{
+			IPAWARN("Unable to allocate migration staging for %u rules\n", max);
+
+			free(mig_stage.orig_hdls);
+			free(mig_stage.new_hdls);
+
+			mig_stage.orig_hdls = mig_stage.new_hdls = NULL;
+			mig_stage.max       = 0;
+		}
+	}
+
+	mig_stage.cnt = 0;
+
+	IPADBG("Out\n");
+}
+
+static void mig_stage_free(void)
+{
+	free(mig_stage.orig_hdls);
+	free(mig_stage.new_hdls);
+
+	memset(&mig_stage, 0, sizeof(mig_stage));
+}
+
+/*
+ * Move the staged handle pairs into the destination maps...
+ */
+static int mig_stage_flush(
+	uint32_t orig2new_map,
+	uint32_t new2orig_map )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	ret = ipa_nat_map_add_bulk(
+		orig2new_map, mig_stage.orig_hdls, mig_stage.new_hdls, mig_stage.cnt);
+
+	if ( ret == 0 )
+	{
+		ret = ipa_nat_map_add_bulk(
+			new2orig_map, mig_stage.new_hdls, mig_stage.orig_hdls, mig_stage.cnt);
+	}
+
+	if ( ret != 0 )
+	{
+		IPAERR("Bulk add of %u migrated rule handles failed\n", mig_stage.cnt);
+	}
+
+	mig_stage.cnt = 0;
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 /******************************************************************************/
 /*
  * FUNCTION: migrate_rule
@@ -779,7 +1187,32 @@ static int migrate_rule(
 	 *
 	 * Remember, original handle points to new and the new handle
 	 * points back to original.
+	 *
+	 * When staging is available, the pair is only recorded here and
+	 * the maps get updated in bulk at the end of the switch...
 	 */
+	if ( mig_stage.max )
+	{
+		if ( mig_stage.cnt == mig_stage.max )
+		{
+			ret = mig_stage_flush(dst_orig2new_map, dst_new2orig_map);
+
+			if ( ret != 0 )
+			{
+				goto bail;
+			}
+		}
+
+		mig_stage.orig_hdls[mig_stage.cnt] = orig_rule_hdl;
+		mig_stage.new_hdls[mig_stage.cnt]  = new_rule_hdl;
+		mig_stage.cnt++;
+
+		IPADBG("orig_rule_hdl(0x%08X) new_rule_hdl(0x%08X) staged\n",
+			   orig_rule_hdl, new_rule_hdl);
+
+		goto bail;
+	}
+
 	ret = ipa_nat_map_add(dst_orig2new_map, orig_rule_hdl, new_rule_hdl);
 
 	if ( ret != 0 )
@@ -1151,6 +1584,10 @@ static int _smAddSramAndDdrTbl(
 
 			if ( ret == 0 )
 			{
+				mig_stage_alloc(
+					nati_obj_ptr->tot_slots_in_sram,
+					number_of_entries);
+
 				/*
 				 * The following will tell the IPA to change focus to
 				 * SRAM...
@@ -1216,6 +1653,8 @@ static int _smDelSramAndDdrTbl(
 	ipa_nat_map_clear(nati_obj_ptr->map_pairs[DDR_SUB].orig2new_map);
 	ipa_nat_map_clear(nati_obj_ptr->map_pairs[DDR_SUB].new2orig_map);
 
+	mig_stage_free();
+
 	ret = _smDelTbl(nati_obj_ptr, trigger, arb_data_ptr);
 
 	if ( ret == 0 )
@@ -1757,12 +2196,19 @@ static int _smAddRuleHybrid(
 			 */
 			IPAINFO("Add of rule failed...attempting table switch\n");
 
+			ipa_wr_seq_begin(&nati_gate);
+
 			ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0);
 
 			if ( ret == 0 )
 			{
 				SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID_DDR);
+			}
 
+			ipa_wr_seq_end(&nati_gate);
+
+			if ( ret == 0 )
+			{
 				/*
 				 * Now add the rule to DDR...
 				 */
@@ -1776,6 +2222,78 @@ static int _smAddRuleHybrid(
 	return ret;
 }
 
+/******************************************************************************/
+/*
+ * FUNCTION: _smCheckBackToSram
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ * DESCRIPTION:
+ *
+ *   Called after rules have been deleted in a HYBRID state, to see
+ *   whether the rules left in DDR now fit back into SRAM.
+ *
+ * RETURNS:
+ *
+ *   Nothing
+ */
+static void _smCheckBackToSram(
+	ipa_nati_obj* nati_obj_ptr )
+{
+	uint32_t* cnt_ptr;
+
+	int ret;
+
+	if ( nati_obj_ptr->curr_state != NATI_STATE_HYBRID_DDR )
+	{
+		return;
+	}
+
+	/*
+	 * We need to check when/if we can go back to SRAM.
+	 *
+	 * How/why can we go back?
+	 *
+	 *   Given enough deletions, and when we get to a user
+	 *   defined threshold (ie. a percentage of what SRAM can
+	 *   hold), we can pop back to using SRAM.
+	 */
+	cnt_ptr = CHOOSE_CNTR();
+
+	if ( *cnt_ptr <= nati_obj_ptr->back_to_sram_thresh
+		 &&
+		 ! nati_obj_ptr->hold_state )
+	{
+		/*
+		 * The following will focus us on SRAM and cause the copy
+		 * of data from DDR to SRAM.
+		 */
+		IPAINFO("Switch back to SRAM threshold has been reached -> "
+				"Total rules in DDR(%u) <= SRAM THRESH(%u)\n",
+				*cnt_ptr,
+				nati_obj_ptr->back_to_sram_thresh);
+
+		ipa_wr_seq_begin(&nati_gate);
+
+		ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0);
+
+		if ( ret == 0 )
+		{
+			SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID);
+		}
+
+		ipa_wr_seq_end(&nati_gate);
+
+		/*
+		 * Otherwise, we stay in DDR for now, but the next delete
+		 * will trigger the switch logic above to run
+		 * again...perhaps it will work then.
+		 */
+	}
+}
+
 /******************************************************************************/
 /*
  * FUNCTION: _smDelRuleHybrid
@@ -1843,8 +2361,12 @@ static int _smDelRuleHybrid(
 	 * NOTE WELL: There are two sets of maps.  One for each memory
 	 *            type...
 	 */
+	ipa_wr_seq_begin(&nati_gate);
+
 	ret = ipa_nat_map_del(orig2new_map, orig_rule_hdl, &new_rule_hdl);
 
+	ipa_wr_seq_end(&nati_gate);
+
 	if ( ret == 0 )
 	{
 		arb_t* new_args[]  = {
@@ -1861,52 +2383,335 @@ static int _smDelRuleHybrid(
 
 		ret = _smDelRuleFromTbl(nati_obj_ptr, trigger, new_args);
 
-		if ( ret == 0 && nati_obj_ptr->curr_state == NATI_STATE_HYBRID_DDR )
+		if ( ret == 0 )
 		{
-			/*
-			 * We need to check when/if we can go back to SRAM.
-			 *
-			 * How/why can we go back?
-			 *
-			 *   Given enough deletions, and when we get to a user
-			 *   defined threshold (ie. a percentage of what SRAM can
-			 *   hold), we can pop back to using SRAM.
-			 */
-			uint32_t* cnt_ptr = CHOOSE_CNTR();
+			_smCheckBackToSram(nati_obj_ptr);
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smAddRulesToTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the addition of an array of NAT rules
+ *   into the DDR or SRAM based table, with their DMA commands posted
+ *   in as few batches as possible.  The outcome of each rule is
+ *   returned in the results array.
+ *
+ * RETURNS:
+ *
+ *   zero when all rules were added, otherwise non-zero
+ */
+static int _smAddRulesToTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t           tbl_hdl    = (uint32_t)           args[0];
+	ipa_nat_ipv4_rule* clnt_rules = (ipa_nat_ipv4_rule*) args[1];
+	uint32_t           num_rules  = (uint32_t)           args[2];
+	uint32_t*          rule_hdls  = (uint32_t*)          args[3];
+	int*               results    = (int*)               args[4];
+
+	uint32_t* cnt_ptr = CHOOSE_CNTR();
+	uint32_t  i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		clnt_rules[i].redirect = clnt_rules[i].enable = clnt_rules[i].time_stamp = 0;
+	}
+
+	ret = ipa_NATI_add_ipv4_rules_bulk(
+		tbl_hdl, clnt_rules, num_rules, rule_hdls, results);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		if ( results[i] == 0 )
+		{
+			(*cnt_ptr)++;
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smDelRulesFromTbl
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the deletion of an array of NAT rules
+ *   from the DDR or SRAM based table, with their DMA commands posted
+ *   in as few batches as possible.  The outcome of each rule is
+ *   returned in the results array.
+ *
+ * RETURNS:
+ *
+ *   zero when all rules were deleted, otherwise non-zero
+ */
+static int _smDelRulesFromTbl(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t  tbl_hdl   = (uint32_t)  args[0];
+	uint32_t* rule_hdls = (uint32_t*) args[1];
+	uint32_t  num_rules = (uint32_t)  args[2];
+	int*      results   = (int*)      args[3];
+
+	uint32_t* cnt_ptr = CHOOSE_CNTR();
+	uint32_t  i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X) num_rules(%u)\n", tbl_hdl, num_rules);
+
+	ret = ipa_NATI_del_ipv4_rules_bulk(tbl_hdl, rule_hdls, num_rules, results);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		if ( results[i] == 0 )
+		{
+			(*cnt_ptr)--;
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smAddRulesHybrid
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the addition of an array of NAT rules
+ *   into either the SRAM or DDR based table.
+ *
+ *   The rules are first added in bulk to the table currently in use.
+ *   Those that did not make it, typically because SRAM filled up,
+ *   are then retried one by one through _smAddRuleHybrid, which
+ *   knows how to move over to DDR.
+ *
+ * RETURNS:
+ *
+ *   zero when all rules were added, otherwise non-zero
+ */
+static int _smAddRulesHybrid(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t           tbl_hdl    = (uint32_t)           args[0];
+	ipa_nat_ipv4_rule* clnt_rules = (ipa_nat_ipv4_rule*) args[1];
+	uint32_t           num_rules  = (uint32_t)           args[2];
+	uint32_t*          rule_hdls  = (uint32_t*)          args[3];
+	int*               results    = (int*)               args[4];
+
+	arb_t*             new_args[] = {
+		(arb_t*)(arb_t)(nati_obj_ptr->curr_state == NATI_STATE_HYBRID) ?
+		         tbl_hdl :
+		         nati_obj_ptr->ddr_tbl_hdl,
+		(arb_t*) clnt_rules,
+		(arb_t*)(arb_t) num_rules,
+		(arb_t*) rule_hdls,
+		(arb_t*) results,
+	};
 
-			if ( *cnt_ptr <= nati_obj_ptr->back_to_sram_thresh
-				 &&
-				 ! nati_obj_ptr->hold_state )
+	uint32_t orig2new_map, new2orig_map;
+	uint32_t i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	_smAddRulesToTbl(nati_obj_ptr, trigger, new_args);
+
+	/*
+	 * See _smAddRuleHybrid for why the maps are needed.  They must be
+	 * in place before any of the retries below causes a table switch.
+	 */
+	CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		if ( results[i] == 0 )
+		{
+			results[i] = ipa_nat_map_add(orig2new_map, rule_hdls[i], rule_hdls[i]);
+
+			if ( results[i] == 0 )
 			{
-				/*
-				 * The following will focus us on SRAM and cause the copy
-				 * of data from DDR to SRAM.
-				 */
-				IPAINFO("Switch back to SRAM threshold has been reached -> "
-						"Total rules in DDR(%u) <= SRAM THRESH(%u)\n",
-						*cnt_ptr,
-						nati_obj_ptr->back_to_sram_thresh);
-
-				ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0);
-
-				if ( ret == 0 )
-				{
-					SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID);
-				}
-				else
-				{
-					/*
-					 * The following will force us stay in DDR for
-					 * now, but the next delete will trigger the
-					 * switch logic above to run again...perhaps it
-					 * will work then.
-					 */
-					ret = 0;
-				}
+				results[i] = ipa_nat_map_add(new2orig_map, rule_hdls[i], rule_hdls[i]);
 			}
 		}
+		else
+		{
+			arb_t* one_args[] = {
+				(arb_t*)(arb_t) tbl_hdl,
+				(arb_t*) &clnt_rules[i],
+				(arb_t*) &rule_hdls[i],
+			};
+
+			results[i] = _smAddRuleHybrid(nati_obj_ptr, NATI_TRIG_ADD_RULE, one_args);
+		}
+	}
+
+	for ( i = 0, ret = 0; i < num_rules && ret == 0; i++ )
+	{
+		ret = results[i];
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smDelRulesHybrid
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   The following will cause the deletion of an array of NAT rules
+ *   from either the SRAM or DDR based table.
+ *
+ *   The original handles are mapped to the rules' current handles
+ *   (see _smDelRuleHybrid), the rules are deleted in bulk, and the
+ *   move back to SRAM is considered once for the whole array.
+ *
+ * RETURNS:
+ *
+ *   zero when all rules were deleted, otherwise non-zero
+ */
+static int _smDelRulesHybrid(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t  tbl_hdl        = (uint32_t)  args[0];
+	uint32_t* orig_rule_hdls = (uint32_t*) args[1];
+	uint32_t  num_rules      = (uint32_t)  args[2];
+	int*      results        = (int*)      args[3];
+
+	uint32_t* new_rule_hdls;
+
+	uint32_t orig2new_map, new2orig_map;
+	uint32_t i;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	new_rule_hdls = (uint32_t*) malloc(num_rules * sizeof(uint32_t));
+
+	if ( new_rule_hdls == NULL && num_rules )
+	{
+		IPAERR("Unable to allocate %u rule handles\n", num_rules);
+		ret = -ENOMEM;
+		goto bail;
+	}
+
+	CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+	ipa_wr_seq_begin(&nati_gate);
+
+	for ( i = 0; i < num_rules; i++ )
+	{
+		/*
+		 * A handle the map knows nothing of stays invalid, hence
+		 * is reported back by the bulk delete
+		 */
+		new_rule_hdls[i] = IPA_TABLE_INVALID_ENTRY;
+
+		if ( ipa_nat_map_del(orig2new_map, orig_rule_hdls[i], &new_rule_hdls[i]) == 0 )
+		{
+			IPADBG("orig_rule_hdl(0x%08X) -> new_rule_hdl(0x%08X)\n",
+				   orig_rule_hdls[i], new_rule_hdls[i]);
+
+			ipa_nat_map_del(new2orig_map, new_rule_hdls[i], NULL);
+		}
+	}
+
+	ipa_wr_seq_end(&nati_gate);
+
+	{
+		arb_t* new_args[] = {
+			(arb_t*)(arb_t)(nati_obj_ptr->curr_state == NATI_STATE_HYBRID) ?
+			        tbl_hdl :
+			        nati_obj_ptr->ddr_tbl_hdl,
+			(arb_t*) new_rule_hdls,
+			(arb_t*)(arb_t) num_rules,
+			(arb_t*) results,
+		};
+
+		ret = _smDelRulesFromTbl(nati_obj_ptr, trigger, new_args);
 	}
 
+	free(new_rule_hdls);
+
+	_smCheckBackToSram(nati_obj_ptr);
+
+bail:
 	IPADBG("Out\n");
 
 	return ret;
@@ -2071,6 +2876,19 @@ static int _smSwitchFromDdrToSram(
 			nati_obj_ptr->sram_tbl_hdl,
 			migrate_rule);
 
+		/*
+		 * Whatever got migrated needs to be in the maps, even if
+		 * the copy failed part way...
+		 */
+		if ( mig_stage.cnt )
+		{
+			int flush_ret = mig_stage_flush(
+				nati_obj.map_pairs[SRAM_SUB].orig2new_map,
+				nati_obj.map_pairs[SRAM_SUB].new2orig_map);
+
+			ret = (ret) ? ret : flush_ret;
+		}
+
 		currTimeAs(TimeAsNanSecs, &stop);
 
 		if ( ret == 0 )
@@ -2241,6 +3059,19 @@ static int _smSwitchFromSramToDdr(
 			nati_obj_ptr->ddr_tbl_hdl,
 			migrate_rule);
 
+		/*
+		 * Whatever got migrated needs to be in the maps, even if
+		 * the copy failed part way...
+		 */
+		if ( mig_stage.cnt )
+		{
+			int flush_ret = mig_stage_flush(
+				nati_obj.map_pairs[DDR_SUB].orig2new_map,
+				nati_obj.map_pairs[DDR_SUB].new2orig_map);
+
+			ret = (ret) ? ret : flush_ret;
+		}
+
 		currTimeAs(TimeAsNanSecs, &stop);
 
 		if ( ret == 0 )
@@ -2468,6 +3299,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_ADD_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_DEL_RULES,  _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2484,6 +3317,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_ADD_RULES,  _smAddRulesToTbl ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_DEL_RULES,  _smDelRulesFromTbl ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2500,6 +3335,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_ADD_RULES,  _smAddRulesToTbl ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_DEL_RULES,  _smDelRulesFromTbl ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2516,6 +3353,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_ADD_RULES,  _smAddRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_DEL_RULES,  _smDelRulesHybrid ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2532,6 +3371,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_ADD_RULES,  _smAddRulesHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_DEL_RULES,  _smDelRulesHybrid ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2548,6 +3389,8 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_ADD_RULES,  _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_DEL_RULES,  _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_LAST,       _smUndef ),
 	},
 };
@@ -2619,6 +3462,12 @@ int ipa_nati_statemach(
 
 	bool vote = false;
 
+	/*
+	 * Rule triggers mark their own, narrower, write sections (see
+	 * nati_gate above)...
+	 */
+	bool write = ! IS_READ_TRIGGER(trigger) && ! IS_RULE_TRIGGER(trigger);
+
 	int ret;
 
 	IPADBG("In\n");
@@ -2632,6 +3481,11 @@ int ipa_nati_statemach(
 
 	IPADBG("STATE(%s) TRIGGER(%s) CB(%s)\n", ss_ptr, ts_ptr, cbs_ptr);
 
+	if ( write )
+	{
+		ipa_wr_seq_begin(&nati_gate);
+	}
+
 	vote = VOTE_REQUIRED(trigger);
 
 	if ( vote )
@@ -2662,6 +3516,11 @@ int ipa_nati_statemach(
 	}
 
 unlock:
+	if ( write )
+	{
+		ipa_wr_seq_end(&nati_gate);
+	}
+
 	ret = give_mutex();
 
 bail:
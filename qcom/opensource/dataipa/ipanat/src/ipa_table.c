@@ -70,6 +70,14 @@ static int FindExpnTblFreeEntry(
 	void**     free_entry,
 	uint16_t*  entry_index );
 
+static void ExpnSlotRelease(
+	ipa_table* table,
+	uint16_t   rec_index );
+
+static void ExpnSlotClaim(
+	ipa_table* table,
+	uint16_t   rec_index );
+
 static int Get2PowerTightUpperBound(
 	uint16_t num);
 
@@ -217,6 +225,14 @@ void ipa_table_reset(
 	for (i = 0; i < tot; i++)
 		table->expn_table_addr[i] = '\0';
 
+	/*
+	 * Every expansion slot is now open...
+	 */
+	memset(table->expn_free_map, 0, sizeof(table->expn_free_map));
+	memset(table->expn_free_sum, 0, sizeof(table->expn_free_sum));
+	for (i = 0; i < table->expn_table_entries; i++)
+		ExpnSlotRelease(table, table->table_entries + i);
+
 	IPADBG("Out\n");
 }
 
@@ -405,6 +421,8 @@ void ipa_table_erase_entry(
 	else
 	{
 		--table->cur_expn_tbl_cnt;
+
+		ExpnSlotRelease(table, index);
 	}
 
 	IPADBG("Out\n");
@@ -919,6 +937,8 @@ static int InsertTail(
 
 	++table->cur_expn_tbl_cnt;
 
+	ExpnSlotClaim(table, iterator.curr_index);
+
 	*rec_index_ptr = iterator.curr_index;
 
 bail:
@@ -974,32 +994,74 @@ static uint16_t MakeEntryHdl(
 	return entry_hdl;
 }
 
-static int mt_slot(
-	ipa_table*      table_ptr,
-	uint32_t        rule_hdl,
-	void*           record_ptr,
-	uint16_t        record_index,
-	void*           meta_record_ptr,
-	uint16_t        meta_record_index,
-	void*           arb_data_ptr )
+/*
+ * The following two keep the expansion table free slot bitmap in step
+ * with the records. rec_index is an absolute index, and base table
+ * indexes are silently ignored...
+ */
+static void ExpnSlotRelease(
+	ipa_table* table,
+	uint16_t   rec_index )
+{
+	uint16_t slot, word;
+
+	if ( rec_index < table->table_entries )
+		return;
+
+	slot = rec_index - table->table_entries;
+
+	if ( slot >= table->expn_table_entries )
+		return;
+
+	word = slot / IPA_TABLE_MAP_BITS;
+
+	table->expn_free_map[word] |=
+		(uint64_t) 1 << (slot % IPA_TABLE_MAP_BITS);
+	table->expn_free_sum[word / IPA_TABLE_MAP_BITS] |=
+		(uint64_t) 1 << (word % IPA_TABLE_MAP_BITS);
+}
+
+static void ExpnSlotClaim(
+	ipa_table* table,
+	uint16_t   rec_index )
 {
-	IPADBG("%s: Empty expansion slot: (%u) in table of size: (%u)\n",
-		   table_ptr->name,
-		   record_index,
-		   table_ptr->tot_tbl_ents);
+	uint16_t slot, word;
+
+	if ( rec_index < table->table_entries )
+		return;
+
+	slot = rec_index - table->table_entries;
+
+	if ( slot >= table->expn_table_entries )
+		return;
 
-	return record_index;
+	word = slot / IPA_TABLE_MAP_BITS;
+
+	table->expn_free_map[word] &=
+		~((uint64_t) 1 << (slot % IPA_TABLE_MAP_BITS));
+
+	if ( ! table->expn_free_map[word] )
+	{
+		table->expn_free_sum[word / IPA_TABLE_MAP_BITS] &=
+			~((uint64_t) 1 << (word % IPA_TABLE_MAP_BITS));
+	}
 }
 
 /*
  * returns expn table entry absolute index
+ *
+ * The lowest open expansion slot is taken from the free slot bitmap,
+ * rather than by walking the expansion table, so the cost does not
+ * grow with table occupancy...
  */
 static int FindExpnTblFreeEntry(
 	ipa_table* table,
 	void**     free_entry,
 	uint16_t*  entry_index )
 {
-	int ret;
+	uint32_t i, word, slot;
+
+	int ret = -1;
 
 	IPADBG("In\n");
 
@@ -1008,22 +1070,23 @@ static int FindExpnTblFreeEntry(
 		IPAERR("Bad arg: table(%p) and/or "
 			   "free_entry(%p) and/or entry_index(%p)\n",
 			   table, free_entry, entry_index);
-		ret = -1;
 		goto bail;
 	}
 
 	*entry_index = 0;
 	*free_entry  = NULL;
 
-	/*
-	 * The following will start walk at expansion slots
-	 * (ie. just after table->table_entries)...
-	 */
-	ret = ipa_table_walk(table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
-
-	if ( ret > 0 )
+	for ( i = 0; i < IPA_TABLE_MAP_SUM_WORDS; i++ )
 	{
-		*entry_index = (uint16_t) ret;
+		if ( ! table->expn_free_sum[i] )
+			continue;
+
+		word = i * IPA_TABLE_MAP_BITS +
+			__builtin_ctzll(table->expn_free_sum[i]);
+		slot = word * IPA_TABLE_MAP_BITS +
+			__builtin_ctzll(table->expn_free_map[word]);
+
+		*entry_index = (uint16_t) (table->table_entries + slot);
 
 		*free_entry = GOTO_REC(table, *entry_index);
 
@@ -1033,27 +1096,16 @@ static int FindExpnTblFreeEntry(
 			   *free_entry);
 
 		ret = 0;
+		goto bail;
 	}
-	else
-	{
-		if ( ret < 0 )
-		{
-			IPAERR("%s: While searching table for emtpy slot\n",
-				   table->name);
-		}
-		else
-		{
-			IPADBG("%s: No empty slots (ie. expansion table full): "
-				   "BASE (avail/used): (%u/%u) EXPN (avail/used): (%u/%u)\n",
-				   table->name,
-				   table->table_entries,
-				   table->cur_tbl_cnt,
-				   table->expn_table_entries,
-				   table->cur_expn_tbl_cnt);
-		}
 
-		ret = -1;
-	}
+	IPADBG("%s: No empty slots (ie. expansion table full): "
+		   "BASE (avail/used): (%u/%u) EXPN (avail/used): (%u/%u)\n",
+		   table->name,
+		   table->table_entries,
+		   table->cur_tbl_cnt,
+		   table->expn_table_entries,
+		   table->cur_expn_tbl_cnt);
 
 bail:
 	IPADBG("Out\n");
@@ -177,4 +177,9 @@ int ipa_nat_test022(const char*, u32, int, u32, int, void*);
 int ipa_nat_test023(const char*, u32, int, u32, int, void*);
 int ipa_nat_test024(const char*, u32, int, u32, int, void*);
 int ipa_nat_test025(const char*, u32, int, u32, int, void*);
+int ipa_nat_test026(const char*, u32, int, u32, int, void*);
+int ipa_nat_test027(const char*, u32, int, u32, int, void*);
+int ipa_nat_test028(const char*, u32, int, u32, int, void*);
+int ipa_nat_test029(const char*, u32, int, u32, int, void*);
+int ipa_nat_test030(const char*, u32, int, u32, int, void*);
 int ipa_nat_test999(const char*, u32, int, u32, int, void*);
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test026.c
+
+	@brief
+	Note: Measure add/delete throughput at a range of table fill levels:
+	1. Add ipv4 table
+	2. For each fill level, clear table and add ipv4 rules till the
+	   fill level is reached
+	3. Time a run of random delete followed by add, keeping the fill
+	   level constant, and print the ops per second
+	4. Delete ipv4 table
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+#define IPA_NAT_TEST026_OPS 2000
+
+static const u32 fill_pcnt[] = { 10, 25, 50, 75, 90, 95 };
+
+static double elapsed_secs(
+	struct timespec* start,
+	struct timespec* end )
+{
+	return (double) (end->tv_sec - start->tv_sec) +
+		(double) (end->tv_nsec - start->tv_nsec) / 1000000000.0;
+}
+
+static void fill_rule(
+	ipa_nat_ipv4_rule* rule )
+{
+	memset(rule, 0, sizeof(*rule));
+
+	rule->protocol     = IPPROTO_TCP;
+	rule->public_port  = RAN_PORT;
+	rule->target_ip    = RAN_ADDR;
+	rule->target_port  = RAN_PORT;
+	rule->private_ip   = RAN_ADDR;
+	rule->private_port = RAN_PORT;
+}
+
+int ipa_nat_test026(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	u32*               rule_hdls = NULL;
+
+	ipa_nati_tbl_stats nstats, istats;
+
+	struct timespec    start, end;
+
+	u32                i, j, tot, want, cnt;
+	u32                adds, dels;
+	double             add_secs, del_secs;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	tot = nstats.tot_ents;
+
+	rule_hdls = calloc(tot, sizeof(u32));
+
+	if ( ! rule_hdls )
+	{
+		ret = -1;
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	for ( i = 0; i < array_sz(fill_pcnt); i++ )
+	{
+		ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+		want = (tot * fill_pcnt[i]) / 100;
+
+		/*
+		 * Fill the table. With random rules, the expansion table may
+		 * run out before the requested fill level is reached...
+		 */
+		for ( cnt = 0; cnt < want; cnt++ )
+		{
+			fill_rule(&ipv4_rule);
+
+			if ( ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[cnt]) )
+				break;
+		}
+
+		if ( ! cnt )
+		{
+			IPAINFO("Unable to fill table to %u percent\n", fill_pcnt[i]);
+			continue;
+		}
+
+		add_secs = del_secs = 0.0;
+		adds = dels = 0;
+
+		for ( j = 0; j < IPA_NAT_TEST026_OPS; j++ )
+		{
+			u32 victim = rand() % cnt;
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[victim]);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+			del_secs += elapsed_secs(&start, &end);
+			++dels;
+
+			fill_rule(&ipv4_rule);
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[victim]);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+
+			if ( ret )
+			{
+				/*
+				 * Keep the fill level by moving the last handle into
+				 * the hole...
+				 */
+				rule_hdls[victim] = rule_hdls[--cnt];
+				if ( ! cnt )
+					break;
+				continue;
+			}
+
+			add_secs += elapsed_secs(&start, &end);
+			++adds;
+		}
+
+		ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+		IPAINFO("%s table fill (%u) percent (%u/%u) expn (%u/%u): "
+				"%.0f adds/sec %.0f dels/sec\n",
+				ipa3_nat_mem_in_as_str(nstats.nmi),
+				fill_pcnt[i],
+				cnt,
+				tot,
+				nstats.tot_expn_ents_filled,
+				nstats.tot_expn_ents,
+				(add_secs > 0.0) ? (double) adds / add_secs : 0.0,
+				(del_secs > 0.0) ? (double) dels / del_secs : 0.0);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+bail:
+	free(rule_hdls);
+
+	if ( sep )
+	{
+		ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+	}
+
+	IPADBG("Out\n");
+
+	return (ret) ? -1 : 0;
+}
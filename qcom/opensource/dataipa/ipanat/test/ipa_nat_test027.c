@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test027.c
+
+	@brief
+	Note: Measure SRAM <-> DDR migration time in HYBRID mode:
+	1. Add ipv4 table
+	2. Add ipv4 rules till the SRAM table is (almost) full
+	3. Repeatedly switch to DDR and back to SRAM, timing each switch
+	4. Delete rules and ipv4 table
+*/
+/*=========================================================================*/
+
+#include <strings.h>
+
+#include "ipa_nat_test.h"
+
+#define IPA_NAT_TEST027_SWITCHES 10
+#define IPA_NAT_TEST027_FILL     90
+
+static double elapsed_usecs(
+	struct timespec* start,
+	struct timespec* end )
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1000000.0 +
+		(double) (end->tv_nsec - start->tv_nsec) / 1000.0;
+}
+
+int ipa_nat_test027(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	u32*               rule_hdls = NULL;
+
+	ipa_nati_tbl_stats nstats, istats;
+
+	struct timespec    start, end;
+
+	u32                i, want, cnt = 0;
+	double             to_ddr = 0.0, to_sram = 0.0;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( strcasecmp(nat_mem_type, "HYBRID") )
+	{
+		IPAINFO("Test only meaningful in HYBRID mode, skipping\n");
+		return 0;
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	/*
+	 * Start from SRAM. The table is empty, so this is cheap...
+	 */
+	ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_SRAM, false);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	if ( nstats.nmi != IPA_NAT_MEM_IN_SRAM )
+	{
+		IPAINFO("SRAM table not in use, skipping\n");
+		goto bail;
+	}
+
+	want = (nstats.tot_ents * IPA_NAT_TEST027_FILL) / 100;
+
+	rule_hdls = calloc(want ? want : 1, sizeof(u32));
+
+	if ( ! rule_hdls )
+	{
+		ret = -1;
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	/*
+	 * Fill SRAM, but stop short of the automatic switch to DDR...
+	 */
+	for ( cnt = 0; cnt < want; cnt++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		if ( ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[cnt]) )
+			break;
+
+		ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+		if ( nstats.nmi != IPA_NAT_MEM_IN_SRAM )
+		{
+			/*
+			 * SRAM overflowed into DDR. Back off one rule so that
+			 * everything fits in SRAM again...
+			 */
+			ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[cnt]);
+
+			if ( ret == 0 )
+				ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_SRAM, false);
+
+			break;
+		}
+	}
+
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+	IPAINFO("Migrating (%u) rules between SRAM and DDR\n", cnt);
+
+	for ( i = 0; i < IPA_NAT_TEST027_SWITCHES; i++ )
+	{
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_DDR, false);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+		to_ddr += elapsed_usecs(&start, &end);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_SRAM, false);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+		to_sram += elapsed_usecs(&start, &end);
+	}
+
+	IPAINFO("(%u) rules: SRAM -> DDR avg (%.1f) usecs, DDR -> SRAM avg (%.1f) usecs\n",
+			cnt,
+			to_ddr / IPA_NAT_TEST027_SWITCHES,
+			to_sram / IPA_NAT_TEST027_SWITCHES);
+
+	/*
+	 * The original handles survive the switches...
+	 */
+	for ( i = 0; i < cnt; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+
+bail:
+	free(rule_hdls);
+
+	if ( sep )
+	{
+		ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+	}
+
+	IPADBG("Out\n");
+
+	return (ret) ? -1 : 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test028.c
+
+	@brief
+	Note: Compare per-rule and bulk rule add/delete:
+	1. Add ipv4 table
+	2. Add and delete ipv4 rules one at a time, timing each pass
+	3. Add and delete the same rules in bulk, timing each pass
+	4. Delete ipv4 table
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+#define IPA_NAT_TEST028_RULES 256
+
+static double elapsed_usecs(
+	struct timespec* start,
+	struct timespec* end )
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1000000.0 +
+		(double) (end->tv_nsec - start->tv_nsec) / 1000.0;
+}
+
+int ipa_nat_test028(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule* rules     = NULL;
+	u32*               rule_hdls = NULL;
+	int*               results   = NULL;
+
+	struct timespec    start, end;
+
+	u32                i, num;
+	double             one_add, one_del, bulk_add, bulk_del;
+
+	int ret = 0;
+
+	IPADBG("In\n");
+
+	num = (total_entries > 0 && total_entries < IPA_NAT_TEST028_RULES) ?
+		total_entries : IPA_NAT_TEST028_RULES;
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	rules     = calloc(num, sizeof(ipa_nat_ipv4_rule));
+	rule_hdls = calloc(num, sizeof(u32));
+	results   = calloc(num, sizeof(int));
+
+	if ( ! rules || ! rule_hdls || ! results )
+	{
+		ret = -1;
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+
+	for ( i = 0; i < num; i++ )
+	{
+		rules[i].protocol     = IPPROTO_TCP;
+		rules[i].public_port  = RAN_PORT;
+		rules[i].target_ip    = RAN_ADDR;
+		rules[i].target_port  = RAN_PORT;
+		rules[i].private_ip   = RAN_ADDR;
+		rules[i].private_port = RAN_PORT;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for ( i = 0; i < num; i++ )
+	{
+		ret = ipa_nat_add_ipv4_rule(tbl_hdl, &rules[i], &rule_hdls[i]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	one_add = elapsed_usecs(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for ( i = 0; i < num; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	one_del = elapsed_usecs(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ret = ipa_nat_add_ipv4_rules_bulk(tbl_hdl, rules, num, rule_hdls, results);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for ( i = 0; i < num; i++ )
+	{
+		if ( results[i] )
+		{
+			IPAERR("Bulk add of rule (%u) failed (%d)\n", i, results[i]);
+		}
+	}
+
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+	bulk_add = elapsed_usecs(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ret = ipa_nat_del_ipv4_rules_bulk(tbl_hdl, rule_hdls, num, results);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for ( i = 0; i < num; i++ )
+	{
+		if ( results[i] )
+		{
+			IPAERR("Bulk delete of rule (%u) failed (%d)\n", i, results[i]);
+		}
+	}
+
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+	bulk_del = elapsed_usecs(&start, &end);
+
+	IPAINFO("(%u) rules: add (%.1f) vs bulk (%.1f) usecs, del (%.1f) vs bulk (%.1f) usecs\n",
+			num, one_add, bulk_add, one_del, bulk_del);
+
+bail:
+	free(results);
+	free(rule_hdls);
+	free(rules);
+
+	if ( sep )
+	{
+		ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+	}
+
+	IPADBG("Out\n");
+
+	return (ret) ? -1 : 0;
+}
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test029.c
+
+	@brief
+	Note: Stress lockless timestamp queries and walks in HYBRID mode:
+	1. Add ipv4 table
+	2. Add a set of ipv4 rules that stay in place throughout
+	3. In parallel:
+	   - query the timestamps of those rules over and over
+	   - walk the table over and over
+	   - first, add and delete other rules for
+	     IPA_NAT_TEST029_CHURN_SECS seconds
+	   - then, repeatedly switch to DDR and back to SRAM, for at
+	     least IPA_NAT_TEST029_SECS seconds
+	4. Every timestamp query of the fixed rules must succeed
+	5. Delete rules and ipv4 table
+*/
+/*=========================================================================*/
+
+#include <strings.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "ipa_nat_test.h"
+
+#define IPA_NAT_TEST029_SWITCHES 20
+#define IPA_NAT_TEST029_SECS     3
+#define IPA_NAT_TEST029_QUERIERS 2
+#define IPA_NAT_TEST029_CHURN    8
+#define IPA_NAT_TEST029_CHURN_SECS 1
+
+typedef struct
+{
+	u32           tbl_hdl;
+	u32*          rule_hdls;
+	u32           num_rules;
+	volatile bool stop;
+	volatile bool stop_churn;
+
+	/* per thread results, written by each thread only */
+	u32           queries[IPA_NAT_TEST029_QUERIERS];
+	u32           failures[IPA_NAT_TEST029_QUERIERS];
+	double        max_usecs[IPA_NAT_TEST029_QUERIERS];
+	u32           walks;
+	u32           walk_failures;
+	u32           churned;
+	int           churn_ret;
+} test029_ctx;
+
+typedef struct
+{
+	test029_ctx* ctx;
+	int          id;
+} test029_thread;
+
+static double elapsed_usecs(
+	struct timespec* start,
+	struct timespec* end )
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1000000.0 +
+		(double) (end->tv_nsec - start->tv_nsec) / 1000.0;
+}
+
+static void* query_thread(
+	void* arg )
+{
+	test029_thread* thr = (test029_thread*) arg;
+	test029_ctx*    ctx = thr->ctx;
+
+	struct timespec start, end;
+	double          usecs;
+	u32             i, time_stamp;
+
+	while ( ! ctx->stop )
+	{
+		for ( i = 0; i < ctx->num_rules && ! ctx->stop; i++ )
+		{
+			clock_gettime(CLOCK_MONOTONIC, &start);
+
+			if ( ipa_nat_query_timestamp(ctx->tbl_hdl, ctx->rule_hdls[i], &time_stamp) )
+			{
+				IPAERR("Query of rule_hdl(0x%08X) failed\n", ctx->rule_hdls[i]);
+				ctx->failures[thr->id]++;
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &end);
+
+			usecs = elapsed_usecs(&start, &end);
+
+			if ( usecs > ctx->max_usecs[thr->id] )
+				ctx->max_usecs[thr->id] = usecs;
+
+			ctx->queries[thr->id]++;
+		}
+	}
+
+	return NULL;
+}
+
+static int count_rule(
+	ipa_table*      table_ptr,
+	uint32_t        rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	(*(u32*) arb_data_ptr)++;
+
+	return 0;
+}
+
+static void* walk_thread(
+	void* arg )
+{
+	test029_ctx* ctx = (test029_ctx*) arg;
+
+	u32 cnt;
+
+	while ( ! ctx->stop )
+	{
+		cnt = 0;
+
+		if ( ipa_nati_walk_ipv4_tbl(ctx->tbl_hdl, USE_NAT_TABLE, count_rule, &cnt) )
+		{
+			IPAERR("Walk failed\n");
+			ctx->walk_failures++;
+		}
+
+		ctx->walks++;
+	}
+
+	return NULL;
+}
+
+static void* churn_thread(
+	void* arg )
+{
+	test029_ctx* ctx = (test029_ctx*) arg;
+
+	ipa_nat_ipv4_rule ipv4_rule;
+	u32               hdls[IPA_NAT_TEST029_CHURN];
+	u32               i, cnt;
+
+	while ( ! ctx->stop_churn && ctx->churn_ret == 0 )
+	{
+		for ( cnt = 0; cnt < IPA_NAT_TEST029_CHURN; cnt++ )
+		{
+			memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+			ipv4_rule.protocol     = IPPROTO_UDP;
+			ipv4_rule.public_port  = RAN_PORT;
+			ipv4_rule.target_ip    = RAN_ADDR;
+			ipv4_rule.target_port  = RAN_PORT;
+			ipv4_rule.private_ip   = RAN_ADDR;
+			ipv4_rule.private_port = RAN_PORT;
+
+			if ( ipa_nat_add_ipv4_rule(ctx->tbl_hdl, &ipv4_rule, &hdls[cnt]) )
+				break;
+		}
+
+		for ( i = 0; i < cnt; i++ )
+		{
+			ctx->churn_ret |= ipa_nat_del_ipv4_rule(ctx->tbl_hdl, hdls[i]);
+		}
+
+		ctx->churned += cnt;
+	}
+
+	return NULL;
+}
+
+int ipa_nat_test029(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	ipa_nati_tbl_stats nstats, istats;
+
+	test029_ctx        ctx;
+	test029_thread     qthr[IPA_NAT_TEST029_QUERIERS];
+	pthread_t          qtid[IPA_NAT_TEST029_QUERIERS], wtid, ctid;
+	int                started = 0;
+
+	struct timespec    start, now;
+
+	u32                i, want, failures = 0;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( strcasecmp(nat_mem_type, "HYBRID") )
+	{
+		IPAINFO("Test only meaningful in HYBRID mode, skipping\n");
+		return 0;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_SRAM, false);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	/*
+	 * Leave SRAM room for the churn, so that only the switches below
+	 * move the rules around...
+	 */
+	want = nstats.tot_ents / 4;
+
+	ctx.tbl_hdl   = tbl_hdl;
+	ctx.rule_hdls = calloc(want ? want : 1, sizeof(u32));
+
+	if ( ! ctx.rule_hdls )
+	{
+		ret = -1;
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	for ( ctx.num_rules = 0; ctx.num_rules < want; ctx.num_rules++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &ctx.rule_hdls[ctx.num_rules]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+
+	for ( i = 0; i < IPA_NAT_TEST029_QUERIERS; i++, started++ )
+	{
+		qthr[i].ctx = &ctx;
+		qthr[i].id  = i;
+
+		if ( pthread_create(&qtid[i], NULL, query_thread, &qthr[i]) )
+			break;
+	}
+
+	if ( started == IPA_NAT_TEST029_QUERIERS &&
+		 pthread_create(&wtid, NULL, walk_thread, &ctx) == 0 )
+	{
+		started++;
+
+		if ( pthread_create(&ctid, NULL, churn_thread, &ctx) == 0 )
+			started++;
+	}
+
+	if ( started < IPA_NAT_TEST029_QUERIERS + 2 )
+	{
+		IPAERR("Unable to start test threads\n");
+		ret = -1;
+	}
+
+	/*
+	 * The churn is over before the first switch. A rule added after
+	 * a switch may be handed a handle that a migrated rule is still
+	 * known by, which the handle maps can't tell apart...
+	 */
+	if ( ret == 0 )
+		sleep(IPA_NAT_TEST029_CHURN_SECS);
+
+	ctx.stop_churn = true;
+
+	if ( started > IPA_NAT_TEST029_QUERIERS + 1 )
+		pthread_join(ctid, NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for ( i = 0; ret == 0; i++ )
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		if ( i >= IPA_NAT_TEST029_SWITCHES &&
+			 now.tv_sec - start.tv_sec >= IPA_NAT_TEST029_SECS )
+			break;
+
+		ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_DDR, false);
+
+		if ( ret == 0 )
+			ret = ipa_nat_switch_to(IPA_NAT_MEM_IN_SRAM, false);
+	}
+
+	IPAINFO("(%u) rules switched between SRAM and DDR (%u) times\n",
+			ctx.num_rules, i);
+
+	ctx.stop = true;
+
+	for ( i = 0; i < IPA_NAT_TEST029_QUERIERS && i < started; i++ )
+		pthread_join(qtid[i], NULL);
+
+	if ( started > IPA_NAT_TEST029_QUERIERS )
+		pthread_join(wtid, NULL);
+
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+	for ( i = 0; i < IPA_NAT_TEST029_QUERIERS; i++ )
+	{
+		IPAINFO("Querier %u: (%u) queries, (%u) failed, max (%.1f) usecs\n",
+				i, ctx.queries[i], ctx.failures[i], ctx.max_usecs[i]);
+
+		failures += ctx.failures[i];
+	}
+
+	IPAINFO("(%u) walks, (%u) failed, (%u) rules churned\n",
+			ctx.walks, ctx.walk_failures, ctx.churned);
+
+	failures += ctx.walk_failures;
+
+	ret = (failures || ctx.churn_ret) ? -1 : 0;
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+
+	for ( i = 0; i < ctx.num_rules; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, ctx.rule_hdls[i]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, goto bail);
+	}
+
+bail:
+	free(ctx.rule_hdls);
+
+	if ( sep )
+	{
+		ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+	}
+
+	IPADBG("Out\n");
+
+	return (ret) ? -1 : 0;
+}
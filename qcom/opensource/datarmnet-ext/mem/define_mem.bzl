@@ -12,6 +12,7 @@ def define_mem(target, variant):
 	hdrs = [ "rmnet_mem.h" ],
         srcs = [
             "rmnet_mem_main.c",
+            "rmnet_mem_cluster.c",
             "rmnet_mem_nl.c",
             "rmnet_mem_nl.h",
             "rmnet_mem_pool.c",
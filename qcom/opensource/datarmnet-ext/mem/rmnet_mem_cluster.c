@@ -0,0 +1,305 @@
+/* Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/mm.h>
+#include <linux/skbuff.h>
+#include <linux/cpumask.h>
+#include <linux/sched/clock.h>
+#include "rmnet_mem_nl.h"
+#include "rmnet_mem.h"
+#include "rmnet_mem_priv.h"
+
+/* Per-cluster page pools
+ *
+ * Each CPU cluster keeps its own set of order-2/order-3 pages so that
+ * ingress and UL aggregation never have to take the shared pool lock or go
+ * through the buddy allocator. Like the shared pool, the cluster pool keeps
+ * a reference on every page it owns and hands a page out again once its
+ * refcount has dropped back to 1. The pool starts with step pages and is
+ * grown by step pages at a time, up to limit, by a refill worker running
+ * on a CPU of the same cluster whenever all the pages probed are in use.
+ */
+
+/* Same probe depth as the shared pool */
+#define RMNET_MEM_CLUSTER_PROBES 5
+
+struct rmnet_mem_cluster_pool {
+	/* Protects the page array */
+	spinlock_t lock;
+	struct page **pages;
+	/* Number of pages owned by the pool */
+	u32 count;
+	/* Next page to probe */
+	u32 next;
+	/* Initial size and growth step */
+	u32 step;
+	/* Maximum number of pages owned */
+	u32 limit;
+	u8 order;
+	u8 cluster;
+	bool refill_pending;
+	struct work_struct refill_work;
+	struct rmnet_mem_pool_stats stats;
+};
+
+static struct rmnet_mem_cluster_pool
+rmnet_mem_cluster_pools[RMNET_MEM_MAX_CLUSTERS][POOL_LEN];
+static struct cpumask rmnet_mem_cluster_cpus[RMNET_MEM_MAX_CLUSTERS];
+static DEFINE_PER_CPU(u8, rmnet_mem_cpu_cluster);
+static bool rmnet_mem_cluster_ready;
+
+/* Default layout is little 0-1, mid 2-6, big 7 */
+static uint cluster_cpu_mask[RMNET_MEM_MAX_CLUSTERS] = {0x03, 0x7C, 0x80};
+module_param_array(cluster_cpu_mask, uint, NULL, 0444);
+MODULE_PARM_DESC(cluster_cpu_mask, "CPU mask per cluster");
+
+static uint cluster_pool_step[POOL_LEN] = {0, 0, 16, 8};
+module_param_array(cluster_pool_step, uint, NULL, 0444);
+MODULE_PARM_DESC(cluster_pool_step,
+		 "Cluster pool initial size and growth step per order");
+
+static uint cluster_pool_limit[POOL_LEN] = {0, 0, 64, 32};
+module_param_array(cluster_pool_limit, uint, NULL, 0444);
+MODULE_PARM_DESC(cluster_pool_limit, "Cluster pool maximum size per order");
+
+static void rmnet_mem_cluster_kick(struct rmnet_mem_cluster_pool *pool)
+{
+	int cpu;
+
+	if (pool->refill_pending || !mem_wq)
+		return;
+
+	cpu = cpumask_any_and(&rmnet_mem_cluster_cpus[pool->cluster],
+			      cpu_online_mask);
+	if (cpu >= nr_cpu_ids)
+		return;
+
+	pool->refill_pending = true;
+	queue_work_on(cpu, mem_wq, &pool->refill_work);
+}
+
+static void rmnet_mem_cluster_refill(struct work_struct *work)
+{
+	struct rmnet_mem_cluster_pool *pool;
+	unsigned long flags;
+	struct page *page;
+	u32 need;
+
+	pool = container_of(work, struct rmnet_mem_cluster_pool, refill_work);
+
+	spin_lock_irqsave(&pool->lock, flags);
+	need = min_t(u32, pool->limit - pool->count,
+		     pool->step ?: pool->limit);
+	spin_unlock_irqrestore(&pool->lock, flags);
+
+	/* Allocate outside the lock. Running on the cluster itself keeps the
+	 * pages coming from the local per-cpu free lists.
+	 */
+	while (need--) {
+		page = __dev_alloc_pages(GFP_KERNEL, pool->order);
+		if (!page)
+			break;
+
+		spin_lock_irqsave(&pool->lock, flags);
+		if (pool->count >= pool->limit) {
+			spin_unlock_irqrestore(&pool->lock, flags);
+			put_page(page);
+			break;
+		}
+
+		pool->pages[pool->count++] = page;
+		pool->stats.refill++;
+		spin_unlock_irqrestore(&pool->lock, flags);
+	}
+
+	spin_lock_irqsave(&pool->lock, flags);
+	pool->refill_pending = false;
+	spin_unlock_irqrestore(&pool->lock, flags);
+}
+
+/* Returns an owned page nobody else holds, with an extra reference taken for
+ * the caller. Called with the pool lock held.
+ */
+static struct page *
+rmnet_mem_cluster_recycle(struct rmnet_mem_cluster_pool *pool)
+{
+	struct page *page;
+	u32 i;
+
+	for (i = 0; i < min_t(u32, pool->count, RMNET_MEM_CLUSTER_PROBES);
+	     i++) {
+		if (pool->next >= pool->count)
+			pool->next = 0;
+
+		page = pool->pages[pool->next++];
+		if (page_ref_count(page) == 1) {
+			page_ref_inc(page);
+			return page;
+		}
+	}
+
+	return NULL;
+}
+
+struct page *rmnet_mem_get_pages_entry(gfp_t gfp_mask, unsigned int order,
+				       int *code, int *pageorder, unsigned id)
+{
+	struct rmnet_mem_cluster_pool *pool = NULL;
+	struct page *page = NULL;
+	unsigned long flags;
+	u64 start;
+	u8 cluster;
+
+	if (!READ_ONCE(rmnet_mem_cluster_ready) || order >= POOL_LEN)
+		return __rmnet_mem_get_pages_entry(gfp_mask, order, code,
+						   pageorder, id);
+
+	start = local_clock();
+	local_irq_save(flags);
+	cluster = this_cpu_read(rmnet_mem_cpu_cluster);
+	pool = &rmnet_mem_cluster_pools[cluster][order];
+	if (pool->pages) {
+		spin_lock(&pool->lock);
+		page = rmnet_mem_cluster_recycle(pool);
+		if (page) {
+			pool->stats.hit++;
+			pool->stats.hit_ns += local_clock() - start;
+		} else if (pool->count < pool->limit) {
+			rmnet_mem_cluster_kick(pool);
+		}
+		spin_unlock(&pool->lock);
+	}
+	local_irq_restore(flags);
+
+	if (page) {
+		if (pageorder)
+			*pageorder = order;
+		if (code)
+			*code = RMNET_MEM_SUCCESS;
+		return page;
+	}
+
+	page = __rmnet_mem_get_pages_entry(gfp_mask, order, code, pageorder,
+					   id);
+	if (pool->pages) {
+		spin_lock_irqsave(&pool->lock, flags);
+		pool->stats.fallback++;
+		pool->stats.fallback_ns += local_clock() - start;
+		spin_unlock_irqrestore(&pool->lock, flags);
+	}
+
+	return page;
+}
+EXPORT_SYMBOL(rmnet_mem_get_pages_entry);
+
+int rmnet_mem_cluster_fill_stats(struct sk_buff *skb, int attr)
+{
+	struct rmnet_mem_cluster_pool *pool;
+	struct rmnet_mem_pool_stats stats;
+	unsigned long flags;
+	int i, j, rc;
+
+	for (i = 0; i < RMNET_MEM_MAX_CLUSTERS; i++) {
+		for (j = 0; j < POOL_LEN; j++) {
+			pool = &rmnet_mem_cluster_pools[i][j];
+			if (!pool->pages)
+				continue;
+
+			spin_lock_irqsave(&pool->lock, flags);
+			stats = pool->stats;
+			stats.count = pool->count;
+			spin_unlock_irqrestore(&pool->lock, flags);
+
+			rc = nla_put(skb, attr, sizeof(stats), &stats);
+			if (rc)
+				return rc;
+		}
+	}
+
+	return 0;
+}
+
+int rmnet_mem_cluster_init(void)
+{
+	struct rmnet_mem_cluster_pool *pool;
+	int i, j, cpu;
+
+	for (i = 0; i < RMNET_MEM_MAX_CLUSTERS; i++) {
+		cpumask_clear(&rmnet_mem_cluster_cpus[i]);
+		for_each_possible_cpu(cpu) {
+			if (cpu < 32 && (cluster_cpu_mask[i] & BIT(cpu))) {
+				cpumask_set_cpu(cpu, &rmnet_mem_cluster_cpus[i]);
+				per_cpu(rmnet_mem_cpu_cluster, cpu) = i;
+			}
+		}
+
+		for (j = 0; j < POOL_LEN; j++) {
+			pool = &rmnet_mem_cluster_pools[i][j];
+			spin_lock_init(&pool->lock);
+			INIT_WORK(&pool->refill_work, rmnet_mem_cluster_refill);
+			pool->order = j;
+			pool->cluster = i;
+			pool->limit = cluster_pool_limit[j];
+			pool->step = min_t(u32, cluster_pool_step[j],
+					   pool->limit);
+			pool->stats.cluster = i;
+			pool->stats.order = j;
+			pool->stats.step = pool->step;
+			pool->stats.limit = pool->limit;
+		}
+	}
+
+	for (i = 0; i < RMNET_MEM_MAX_CLUSTERS; i++) {
+		if (cpumask_empty(&rmnet_mem_cluster_cpus[i]))
+			continue;
+
+		for (j = 0; j < POOL_LEN; j++) {
+			pool = &rmnet_mem_cluster_pools[i][j];
+			if (!pool->limit)
+				continue;
+
+			pool->pages = kcalloc(pool->limit,
+					      sizeof(*pool->pages),
+					      GFP_KERNEL);
+			if (!pool->pages)
+				goto err;
+
+			/* Pre-fill from the cluster itself */
+			rmnet_mem_cluster_kick(pool);
+		}
+	}
+
+	WRITE_ONCE(rmnet_mem_cluster_ready, true);
+	return 0;
+
+err:
+	rmnet_mem_cluster_exit();
+	return -ENOMEM;
+}
+
+void rmnet_mem_cluster_exit(void)
+{
+	struct rmnet_mem_cluster_pool *pool;
+	int i, j;
+
+	WRITE_ONCE(rmnet_mem_cluster_ready, false);
+	synchronize_rcu();
+
+	for (i = 0; i < RMNET_MEM_MAX_CLUSTERS; i++) {
+		for (j = 0; j < POOL_LEN; j++) {
+			pool = &rmnet_mem_cluster_pools[i][j];
+			cancel_work_sync(&pool->refill_work);
+
+			/* Pages still held by their users are freed by them */
+			while (pool->count)
+				put_page(pool->pages[--pool->count]);
+			pool->next = 0;
+
+			kfree(pool->pages);
+			pool->pages = NULL;
+		}
+	}
+}
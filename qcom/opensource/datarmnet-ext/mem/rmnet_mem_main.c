@@ -68,7 +68,7 @@ flags);for(i=(0xd2d+202-0xdf7);i<POOL_LEN;i++){list_for_each_safe(ptr,next,&
 rmnet_mem_pool[i]){mem_slot=list_entry(ptr,struct mem_info,mem_head);list_del(&
 mem_slot->mem_head);put_page(mem_slot->addr);static_pool_size[mem_slot->order]--
 ;kfree(mem_slot);}}spin_unlock_irqrestore(&rmnet_mem_lock,flags);}struct page*
-rmnet_mem_get_pages_entry(gfp_t gfp_mask,unsigned int order,int*code,int*
+__rmnet_mem_get_pages_entry(gfp_t gfp_mask,unsigned int order,int*code,int*
 pageorder,unsigned id){unsigned long flags;struct mem_info*mem_page;struct page*
 page=NULL;int i=(0xd2d+202-0xdf7);int j=(0xd2d+202-0xdf7);int 
 DATARMNET8224a106d8=(0xd2d+202-0xdf7);spin_lock_irqsave(&rmnet_mem_lock,flags);
@@ -91,9 +91,8 @@ pageorder){*pageorder=order;}}}}if(DATARMNET8224a106d8)spin_unlock_irqrestore(&
 rmnet_mem_lock,flags);if(pageorder&&code&&page){if(*pageorder==order)*code=
 RMNET_MEM_SUCCESS;else if(*pageorder>order)*code=RMNET_MEM_UPGRADE;else if(*
 pageorder<order)*code=RMNET_MEM_DOWNGRADE;}else if(pageorder&&code){*code=
-RMNET_MEM_FAIL;*pageorder=(0xd2d+202-0xdf7);}return page;}EXPORT_SYMBOL(
-rmnet_mem_get_pages_entry);void rmnet_mem_put_page_entry(struct page*page){
-put_page(page);}EXPORT_SYMBOL(rmnet_mem_put_page_entry);static void 
+RMNET_MEM_FAIL;*pageorder=(0xd2d+202-0xdf7);}return page;}void 
+rmnet_mem_put_page_entry(struct page*page){put_page(page);}EXPORT_SYMBOL(rmnet_mem_put_page_entry);static void 
 mem_update_pool_work(struct work_struct*work){int i;for(i=(0xd2d+202-0xdf7);i<
 POOL_LEN;i++){local_bh_disable();rmnet_mem_adjust(target_static_pool_size[i],i);
 if(i==POOL_NOTIF){rmnet_mem_mode_notify(target_static_pool_size[i]);}
@@ -116,10 +115,14 @@ rmnet_mem_pool[i]));}mem_wq=alloc_workqueue("\x6d\x65\x6d\x5f\x77\x71",
 WQ_HIGHPRI,(0xd2d+202-0xdf7));if(!mem_wq){pr_err(
 "\x25\x73\x28\x29\x3a\x20\x46\x61\x69\x6c\x65\x64\x20\x74\x6f\x20\x61\x6c\x6c\x6f\x63\x20\x77\x6f\x72\x6b\x71\x75\x65\x75\x65\x20" "\n"
 ,__func__);return-ENOMEM;}INIT_WORK(&pool_adjust_work,mem_update_pool_work);rc=
+rmnet_mem_cluster_init();if(rc){pr_err("%s(): Failed to init cluster pools\n",
+__func__);destroy_workqueue(mem_wq);mem_wq=NULL;return rc;}rc=
 rmnet_mem_nl_register();if(rc){pr_err(
 "\x25\x73\x28\x29\x3a\x20\x46\x61\x69\x6c\x65\x64\x20\x74\x6f\x20\x72\x65\x67\x69\x73\x74\x65\x72\x20\x67\x65\x6e\x65\x72\x69\x63\x20\x6e\x65\x74\x6c\x69\x6e\x6b\x20\x66\x61\x6d\x69\x6c\x79" "\n"
-,__func__);return-ENOMEM;}return(0xd2d+202-0xdf7);}void __exit 
-rmnet_mem_module_exit(void){rmnet_mem_nl_unregister();if(mem_wq){
+,__func__);rmnet_mem_cluster_exit();cancel_work_sync(&pool_adjust_work);
+destroy_workqueue(mem_wq);mem_wq=NULL;return rc;}return(0xd2d+202-0xdf7);}void __exit 
+rmnet_mem_module_exit(void){rmnet_mem_nl_unregister();
+rmnet_mem_cluster_exit();if(mem_wq){
 cancel_work_sync(&pool_adjust_work);drain_workqueue(mem_wq);destroy_workqueue(
 mem_wq);mem_wq=NULL;}rmnet_mem_free_all();}module_init(rmnet_mem_module_init);
 module_exit(rmnet_mem_module_exit);
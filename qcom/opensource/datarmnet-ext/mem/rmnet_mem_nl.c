@@ -7,14 +7,15 @@
 #define DATARMNETb005a78b72 "\x52\x4d\x4e\x45\x54\x5f\x4d\x45\x4d"
 #define DATARMNET39e021cd6f (0xd26+209-0xdf6)
 enum{DATARMNET5277047270,DATARMNET654ec9d727,DATARMNET579b73b6a1,
-DATARMNET99bbc5ae70,};
-#define DATARMNETb2539ccff0 (DATARMNETc820b7a9dc - (0xd26+209-0xdf6))
+RMNET_MEM_CMD_GET_POOL_STATS,DATARMNET99bbc5ae70,};
+#define DATARMNETb2539ccff0 (__RMNET_MEM_ATTR_MAX - (0xd26+209-0xdf6))
 uint32_t DATARMNET7c4038843f;static struct nla_policy DATARMNET93ad46699e[
 DATARMNETb2539ccff0+(0xd26+209-0xdf6)]={[DATARMNETe5184c7a76]=
 NLA_POLICY_EXACT_LEN(sizeof(struct DATARMNET5d6175c98d)),[DATARMNETb0428b7575]=
 NLA_POLICY_EXACT_LEN(sizeof(struct DATARMNET5d23779a8f)),};static const struct 
 genl_ops DATARMNETb68b0ed922[]={{.cmd=DATARMNET654ec9d727,.doit=
-DATARMNET291f036d31,},{.cmd=DATARMNET579b73b6a1,.doit=DATARMNET8e48a951e4,},};
+DATARMNET291f036d31,},{.cmd=DATARMNET579b73b6a1,.doit=DATARMNET8e48a951e4,},{.cmd=
+RMNET_MEM_CMD_GET_POOL_STATS,.doit=rmnet_mem_nl_cmd_get_pool_stats,},};
 struct genl_family DATARMNET595b5c3a9e __ro_after_init={.hdrsize=
 (0xd2d+202-0xdf7),.name=DATARMNETb005a78b72,.version=DATARMNET39e021cd6f,.
 maxattr=DATARMNETb2539ccff0,.policy=DATARMNET93ad46699e,.ops=DATARMNETb68b0ed922
@@ -37,3 +38,31 @@ DATARMNETbf4095f79e;rm_err(
 ,val);return-(0xd26+209-0xdf6);}int rmnet_mem_nl_register(void){return 
 genl_register_family(&DATARMNET595b5c3a9e);}void rmnet_mem_nl_unregister(void){
 genl_unregister_family(&DATARMNET595b5c3a9e);}
+
+int rmnet_mem_nl_cmd_get_pool_stats(struct sk_buff *skb, struct genl_info *info)
+{
+	struct sk_buff *msg;
+	void *msg_head;
+	int rc;
+
+	msg = genlmsg_new(NLMSG_GOODSIZE, GFP_KERNEL);
+	if (!msg)
+		return -ENOMEM;
+
+	msg_head = genlmsg_put_reply(msg, info, &DATARMNET595b5c3a9e, 0,
+				     RMNET_MEM_CMD_GET_POOL_STATS);
+	if (!msg_head) {
+		nlmsg_free(msg);
+		return -ENOMEM;
+	}
+
+	rc = rmnet_mem_cluster_fill_stats(msg, RMNET_MEM_ATTR_POOL_STATS);
+	if (rc) {
+		rm_err("MEM_GNL: FAILED to fill pool stats %d\n", rc);
+		nlmsg_free(msg);
+		return rc;
+	}
+
+	genlmsg_end(msg, msg_head);
+	return genlmsg_reply(msg, info);
+}
@@ -12,6 +12,7 @@ enum {
 	RMNET_MEM_ATTR_MODE,
 	RMNET_MEM_ATTR_POOL_SIZE,
 	RMNET_MEM_ATTR_INT,
+	RMNET_MEM_ATTR_POOL_STATS,
 	__RMNET_MEM_ATTR_MAX,
 };
 
@@ -24,11 +25,27 @@ struct rmnet_pool_update_req {
         unsigned valid_mask;
 };
 
+/* One RMNET_MEM_ATTR_POOL_STATS attribute is sent per cluster pool */
+struct rmnet_mem_pool_stats {
+	__u32 cluster;
+	__u32 order;
+	__u32 count;
+	__u32 step;
+	__u32 limit;
+	__u32 pad;
+	__u64 hit;
+	__u64 fallback;
+	__u64 refill;
+	__u64 hit_ns;
+	__u64 fallback_ns;
+};
+
 int rmnet_mem_nl_register(void);
 void rmnet_mem_nl_unregister(void);
 int rmnet_mem_nl_cmd_update_mode(struct sk_buff *skb, struct genl_info *info);
 int rmnet_mem_nl_cmd_update_pool_size(struct sk_buff *skb, struct genl_info *info);
 int rmnet_mem_genl_send_int_to_userspace_no_info(int val, struct genl_info *info);
+int rmnet_mem_nl_cmd_get_pool_stats(struct sk_buff *skb, struct genl_info *info);
 
 #endif /* _RMNET_MEM_GENL_H_ */
 
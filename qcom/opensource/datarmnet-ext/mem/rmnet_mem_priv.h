@@ -22,5 +22,13 @@ extern int max_pool_size[POOL_LEN];extern int static_pool_size[POOL_LEN];extern
 int pool_unbound_feature[POOL_LEN];extern int rmnet_mem_order_requests[POOL_LEN]
 ;extern int rmnet_mem_id_req[POOL_LEN];extern int rmnet_mem_id_recycled[POOL_LEN
 ];extern int target_static_pool_size[POOL_LEN];
+#define RMNET_MEM_MAX_CLUSTERS 3
+extern struct workqueue_struct *mem_wq;
+struct page *__rmnet_mem_get_pages_entry(gfp_t gfp_mask, unsigned int order,
+					 int *code, int *pageorder,
+					 unsigned id);
+int rmnet_mem_cluster_init(void);
+void rmnet_mem_cluster_exit(void);
+int rmnet_mem_cluster_fill_stats(struct sk_buff *skb, int attr);
 #endif
 
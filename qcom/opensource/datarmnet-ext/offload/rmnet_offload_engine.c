@@ -24,7 +24,7 @@
 #include "rmnet_offload_stats.h"
 #include "rmnet_offload_knob.h"
 #define DATARMNET644a5e11da \
-	(const_ilog2(DATARMNET78d9393ac8))
+	(RMNET_OFFLOAD_FLOW_HT_BITS)
 static DEFINE_HASHTABLE(DATARMNET4791268d67,DATARMNET644a5e11da);static u32 
 DATARMNET1993bae165(u8 DATARMNET06d2413ad2,struct list_head*DATARMNET6f9bfa17e6)
 {struct DATARMNETd7c9631acd*DATARMNET7c382e536d;int DATARMNETae0201901a;u32 
@@ -83,14 +83,19 @@ DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct
 DATARMNET907d58c807*DATARMNETa6f73cbe10;struct DATARMNETd7c9631acd*
 DATARMNET6745427f98;LIST_HEAD(DATARMNET6f9bfa17e6);DATARMNETa6f73cbe10=&
 DATARMNETe05748b000->DATARMNETebb45c8d86;if(DATARMNETa6f73cbe10->
-DATARMNET8dfc11cccd<DATARMNET78d9393ac8){DATARMNET6745427f98=&
+DATARMNET8dfc11cccd<DATARMNETa6f73cbe10->size){DATARMNET6745427f98=&
 DATARMNETa6f73cbe10->DATARMNET2846a01cce[DATARMNETa6f73cbe10->
-DATARMNET8dfc11cccd];DATARMNETa6f73cbe10->DATARMNET8dfc11cccd++;return 
-DATARMNET6745427f98;}DATARMNET6745427f98=&DATARMNETa6f73cbe10->
-DATARMNET2846a01cce[DATARMNETa6f73cbe10->DATARMNET57d435b225];
-DATARMNETa6f73cbe10->DATARMNET57d435b225++;DATARMNETa6f73cbe10->
-DATARMNET57d435b225%=DATARMNET78d9393ac8;hash_del(&DATARMNET6745427f98->
-DATARMNETbd5d7d96d8);if(DATARMNET6745427f98->DATARMNET1db11fa85e){
+DATARMNET8dfc11cccd];DATARMNETa6f73cbe10->DATARMNET8dfc11cccd++;list_add(&
+DATARMNET6745427f98->lru,&DATARMNETa6f73cbe10->lru);DATARMNET6745427f98->hits=
+(0xd2d+202-0xdf7);return DATARMNET6745427f98;}
+/* Table is full. Reuse the least recently used flow */
+DATARMNET6745427f98=list_last_entry(&DATARMNETa6f73cbe10->lru,struct 
+DATARMNETd7c9631acd,lru);list_move(&DATARMNET6745427f98->lru,&
+DATARMNETa6f73cbe10->lru);hash_del(&DATARMNET6745427f98->DATARMNETbd5d7d96d8);
+DATARMNETa00cda79d0(RMNET_OFFLOAD_STAT_FLOW_EVICT);DATARMNETbad3b5165e(
+RMNET_OFFLOAD_STAT_FLOW_EVICT_HITS,DATARMNET6745427f98->hits);
+DATARMNET6745427f98->hits=(0xd2d+202-0xdf7);if(DATARMNET6745427f98->
+DATARMNET1db11fa85e){
 DATARMNETa00cda79d0(DATARMNETf3f92fc0b9);DATARMNETa3055c21f2(DATARMNET6745427f98
 ,&DATARMNET6f9bfa17e6);}DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);return 
 DATARMNET6745427f98;}static void DATARMNETbe30d096c6(void){LIST_HEAD(
@@ -170,7 +175,10 @@ DATARMNET7fa8b2acbf;if(!DATARMNET2013036d80(DATARMNET9695aa5b1d)){
 DATARMNETa00cda79d0(DATARMNET6a894ab63d);return false;}hash_for_each_possible(
 DATARMNET4791268d67,DATARMNETaa568481cf,DATARMNETbd5d7d96d8,DATARMNET5fe4c722a8
 ->DATARMNET645e8912b8){bool DATARMNET2dd83daa1c;if(!DATARMNET6895620058(
-DATARMNETaa568481cf,DATARMNET5fe4c722a8))continue;DATARMNETc6f994577c:
+DATARMNETaa568481cf,DATARMNET5fe4c722a8))continue;list_move(&
+DATARMNETaa568481cf->lru,&DATARMNETc2a630b113()->DATARMNETebb45c8d86.lru);
+DATARMNETaa568481cf->hits++;DATARMNETa00cda79d0(RMNET_OFFLOAD_STAT_FLOW_HIT);
+DATARMNETc6f994577c:
 DATARMNET2dd83daa1c=DATARMNET5a0f9fc3a2(DATARMNETaa568481cf,DATARMNET5fe4c722a8)
 ;DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc=true;DATARMNET885970f252=true;switch(
 DATARMNET9695aa5b1d){case DATARMNETfd5c3d30e5:return DATARMNET4c7cdc25b7(
@@ -185,11 +193,37 @@ DATARMNETc6f994577c;}return false;}void DATARMNETb98b78b8e3(void){struct
 DATARMNETd7c9631acd*DATARMNETaa568481cf;struct hlist_node*DATARMNET0386f6f82a;
 int DATARMNETae0201901a;hash_for_each_safe(DATARMNET4791268d67,
 DATARMNETae0201901a,DATARMNET0386f6f82a,DATARMNETaa568481cf,DATARMNETbd5d7d96d8)
-hash_del(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);}int DATARMNETdbcaf01255(
-void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();u8 
-DATARMNETefc9df3df2;for(DATARMNETefc9df3df2=(0xd2d+202-0xdf7);
-DATARMNETefc9df3df2<DATARMNET78d9393ac8;DATARMNETefc9df3df2++){struct 
-DATARMNETd7c9631acd*DATARMNETaa568481cf;DATARMNETaa568481cf=&DATARMNETe05748b000
-->DATARMNETebb45c8d86.DATARMNET2846a01cce[DATARMNETefc9df3df2];INIT_LIST_HEAD(&
-DATARMNETaa568481cf->DATARMNETb76b79d0d5);INIT_HLIST_NODE(&DATARMNETaa568481cf->
-DATARMNETbd5d7d96d8);}return DATARMNET0529bb9c4e;}
+hash_del(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);
+DATARMNETaa568481cf=DATARMNETc2a630b113()->DATARMNETebb45c8d86.
+DATARMNET2846a01cce;DATARMNETc2a630b113()->DATARMNETebb45c8d86.
+DATARMNET2846a01cce=NULL;DATARMNETc2a630b113()->DATARMNETebb45c8d86.
+DATARMNET8dfc11cccd=(0xd2d+202-0xdf7);kfree(DATARMNETaa568481cf);}static struct 
+DATARMNETd7c9631acd*rmnet_offload_engine_alloc(u32 size,gfp_t gfp){struct 
+DATARMNETd7c9631acd*nodes;u32 i;nodes=kcalloc(size,sizeof(*nodes),gfp);if(!nodes
+)return NULL;for(i=(0xd2d+202-0xdf7);i<size;i++){INIT_LIST_HEAD(&nodes[i].
+DATARMNETb76b79d0d5);INIT_HLIST_NODE(&nodes[i].DATARMNETbd5d7d96d8);}return 
+nodes;}
+
+/* Called with the offload lock held when the flow table knob changes. All
+ * pending flows are flushed before the old table is released.
+ */
+int rmnet_offload_engine_resize(u64 old_size,u64 new_size){struct 
+DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNETd7c9631acd*nodes;LIST_HEAD(DATARMNET6f9bfa17e6);u32 
+DATARMNET737bbd41c3;if(!DATARMNETe05748b000)return(0xd2d+202-0xdf7);nodes=
+rmnet_offload_engine_alloc(new_size,GFP_ATOMIC);if(!nodes)return-ENOMEM;
+DATARMNET737bbd41c3=DATARMNETae70636c90(&DATARMNET6f9bfa17e6);
+DATARMNETbad3b5165e(DATARMNETddf572458d,DATARMNET737bbd41c3);
+DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);DATARMNETb98b78b8e3();
+DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNET2846a01cce=nodes;
+DATARMNETe05748b000->DATARMNETebb45c8d86.size=new_size;INIT_LIST_HEAD(&
+DATARMNETe05748b000->DATARMNETebb45c8d86.lru);return(0xd2d+202-0xdf7);}int 
+DATARMNETdbcaf01255(
+void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();
+struct DATARMNET907d58c807*DATARMNETa6f73cbe10=&DATARMNETe05748b000->
+DATARMNETebb45c8d86;DATARMNETa6f73cbe10->size=DATARMNETf1d1b8287f(
+RMNET_OFFLOAD_KNOB_FLOW_TABLE);DATARMNETa6f73cbe10->DATARMNET8dfc11cccd=
+(0xd2d+202-0xdf7);INIT_LIST_HEAD(&DATARMNETa6f73cbe10->lru);DATARMNETa6f73cbe10
+->DATARMNET2846a01cce=rmnet_offload_engine_alloc(DATARMNETa6f73cbe10->size,
+GFP_KERNEL);if(!DATARMNETa6f73cbe10->DATARMNET2846a01cce)return-ENOMEM;return 
+DATARMNET0529bb9c4e;}
\ No newline at end of file
@@ -29,8 +29,9 @@
 #define DATARMNET347bd5eb15 \
 	(const_ilog2(DATARMNET714c9c3081))
 enum{DATARMNETe0e37fef7a,DATARMNETf354672897,DATARMNET9cc765a89e,
-DATARMNETb03f9571a3,DATARMNET53c8cfb28e,DATARMNET74f0a28fec,DATARMNETaa18c75b61,
-};struct DATARMNET4b40fe9cd4{union{__be32 DATARMNETdfe430c2d6;struct in6_addr 
+DATARMNETb03f9571a3,DATARMNET53c8cfb28e,DATARMNET74f0a28fec,
+RMNET_PERF_TCP_STAT_SK_CACHED,RMNET_PERF_TCP_STAT_ACK_COALESCED,
+RMNET_PERF_TCP_STAT_SK_STALE,DATARMNETaa18c75b61,};struct DATARMNET4b40fe9cd4{union{__be32 DATARMNETdfe430c2d6;struct in6_addr 
 DATARMNET815cbb4bf5;};union{__be32 DATARMNET2cb607d686;struct in6_addr 
 DATARMNETc3f31215b7;};union{struct{__be16 DATARMNET08e913477e;__be16 
 DATARMNETda7f7fa492;};u32 DATARMNET556bcfcf8f;};u8 DATARMNET0d956cc77a;};struct 
@@ -38,7 +39,7 @@ DATARMNETddbc1e5435{struct hlist_node hash;struct rcu_head DATARMNET28bfe9e6ad;
 struct DATARMNET4b40fe9cd4 DATARMNET54338da2ff;unsigned long DATARMNET763f2e5fac
 ;u32 DATARMNETfef3675ce7;u32 DATARMNET9076d335ab;u32 DATARMNET9c389f3b86;u32 
 DATARMNET9a57846b4e;u32 DATARMNETb8fc35ed64;bool DATARMNET55056146f6;u8 
-DATARMNET1717afebc7;};struct DATARMNET74cfea3d20{struct delayed_work 
+DATARMNET1717afebc7;struct sock*sk;};struct DATARMNET74cfea3d20{struct delayed_work 
 DATARMNET190b4452e8;bool DATARMNETcd94e0d3c7;};static DEFINE_SPINLOCK(
 DATARMNET8e3721c47d);static DEFINE_HASHTABLE(DATARMNET1fd012f255,
 DATARMNET347bd5eb15);static u32 DATARMNET1c62a8e2c9;static struct 
@@ -55,7 +56,8 @@ DATARMNETc2d5c71ce1;DATARMNETc2d5c71ce1=msecs_to_jiffies(DATARMNET3dad3dfdc0);if
 DATARMNETc2d5c71ce1)return true;return false;}static void DATARMNET776e08992c(
 struct rcu_head*DATARMNET5d432e897f){struct DATARMNETddbc1e5435*
 DATARMNET63b1a086d5;DATARMNET63b1a086d5=container_of(DATARMNET5d432e897f,struct 
-DATARMNETddbc1e5435,DATARMNET28bfe9e6ad);kfree(DATARMNET63b1a086d5);}static bool
+DATARMNETddbc1e5435,DATARMNET28bfe9e6ad);if(DATARMNET63b1a086d5->sk)
+sock_gen_put(DATARMNET63b1a086d5->sk);kfree(DATARMNET63b1a086d5);}static bool
  DATARMNETb8167597bc(bool DATARMNETe78ad140cc){struct DATARMNETddbc1e5435*
 DATARMNET63b1a086d5;struct hlist_node*DATARMNET0386f6f82a;unsigned long 
 DATARMNET763f2e5fac;int DATARMNET5c2fd31d7b;DATARMNET763f2e5fac=jiffies;
@@ -118,7 +120,13 @@ READ_ONCE(DATARMNET63b1a086d5->DATARMNET9a57846b4e);}}static struct
 DATARMNETddbc1e5435*DATARMNET9f0aaf07cc(struct DATARMNET4b40fe9cd4*
 DATARMNET3396919a68,struct sk_buff*DATARMNET543491eb0f,bool DATARMNETd147c14c0e)
 __must_hold(RCU){struct DATARMNETddbc1e5435*DATARMNET63b1a086d5;unsigned long 
-DATARMNETfb0677cc3c;spin_lock_irqsave(&DATARMNET8e3721c47d,DATARMNETfb0677cc3c);
+DATARMNETfb0677cc3c;
+/* Existing flows are found without the lock. It is only needed to insert */
+hash_for_each_possible_rcu(DATARMNET1fd012f255,DATARMNET63b1a086d5,hash,
+DATARMNET3396919a68->DATARMNET556bcfcf8f){if(READ_ONCE(DATARMNET63b1a086d5->
+DATARMNET1717afebc7))continue;if(DATARMNET2f1039220d(&DATARMNET63b1a086d5->
+DATARMNET54338da2ff,DATARMNET3396919a68))return DATARMNET63b1a086d5;}
+spin_lock_irqsave(&DATARMNET8e3721c47d,DATARMNETfb0677cc3c);
 hash_for_each_possible_rcu(DATARMNET1fd012f255,DATARMNET63b1a086d5,hash,
 DATARMNET3396919a68->DATARMNET556bcfcf8f){if(DATARMNET63b1a086d5->
 DATARMNET1717afebc7)continue;if(DATARMNET2f1039220d(&DATARMNET63b1a086d5->
@@ -138,21 +146,46 @@ DATARMNETc96400be1e->ifindex);return __inet6_lookup_established(net,&
 tcp_hashinfo,&DATARMNET3396919a68->DATARMNET815cbb4bf5,DATARMNET3396919a68->
 DATARMNET08e913477e,&DATARMNET3396919a68->DATARMNETc3f31215b7,ntohs(
 DATARMNET3396919a68->DATARMNETda7f7fa492),DATARMNETc96400be1e->ifindex,
-(0xd2d+202-0xdf7));}static void DATARMNET31a7673e56(struct DATARMNETddbc1e5435*
+(0xd2d+202-0xdf7));}static bool rmnet_perf_tcp_sk_stale(struct sock*sk){return 
+sk->sk_state!=TCP_ESTABLISHED||sock_flag(sk,SOCK_DEAD)||sk_unhashed(sk);}static 
+void rmnet_perf_tcp_force_ack(struct DATARMNETddbc1e5435*
+DATARMNET63b1a086d5,struct sock*sk)__must_hold(RCU){u8 pending;
+/* An ACK that is already scheduled and forced covers this packet too */
+pending=READ_ONCE(inet_csk(sk)->icsk_ack.pending);if((pending&(ICSK_ACK_SCHED|
+ICSK_ACK_NOW))==(ICSK_ACK_SCHED|ICSK_ACK_NOW)){DATARMNET32b91c8ae6(
+RMNET_PERF_TCP_STAT_ACK_COALESCED);return;}bh_lock_sock(sk);if(sk->sk_state==
+TCP_ESTABLISHED&&!sock_flag(sk,SOCK_DEAD)&&!sk_unhashed(sk)&&sk->sk_shutdown!=
+SHUTDOWN_MASK){inet_csk(sk)->icsk_ack.pending|=ICSK_ACK_NOW;
+inet_csk_schedule_ack(sk);DATARMNET63b1a086d5->DATARMNETb8fc35ed64++;
+DATARMNET32b91c8ae6(DATARMNET53c8cfb28e);}bh_unlock_sock(sk);}static void 
+DATARMNET31a7673e56(struct DATARMNETddbc1e5435*
 DATARMNET63b1a086d5,struct sk_buff*DATARMNET543491eb0f)__must_hold(RCU){struct 
 sock*sk;if(DATARMNET543491eb0f->sk){sk=DATARMNET543491eb0f->sk;if(sk_fullsock(sk
 )){if(sk->sk_state==TCP_ESTABLISHED&&!sock_flag(sk,SOCK_DEAD)&&!sk_unhashed(sk)
 &&sk->sk_shutdown!=SHUTDOWN_MASK){inet_csk(sk)->icsk_ack.pending|=ICSK_ACK_NOW;
 DATARMNET63b1a086d5->DATARMNETb8fc35ed64++;DATARMNET32b91c8ae6(
-DATARMNET74f0a28fec);}}return;}sk=DATARMNETc0b5d624ae(&DATARMNET63b1a086d5->
+DATARMNET74f0a28fec);}}return;}sk=READ_ONCE(DATARMNET63b1a086d5->sk);if(sk){
+/* The cached socket may have been closed since it was looked up. Pin it for
+ * the check, and if it is stale drop it from the node and look the flow up
+ * again. The node must still hold it once pinned, or it may have been reused.
+ */
+if(refcount_inc_not_zero(&sk->sk_refcnt)){if(READ_ONCE(DATARMNET63b1a086d5->sk)
+==sk&&!rmnet_perf_tcp_sk_stale(sk)){
+DATARMNET32b91c8ae6(RMNET_PERF_TCP_STAT_SK_CACHED);rmnet_perf_tcp_force_ack(
+DATARMNET63b1a086d5,sk);sock_gen_put(sk);return;}sock_gen_put(sk);}if(cmpxchg(&
+DATARMNET63b1a086d5->sk,sk,NULL)==sk)sock_gen_put(sk);DATARMNET32b91c8ae6(
+RMNET_PERF_TCP_STAT_SK_STALE);}sk=
+DATARMNETc0b5d624ae(&DATARMNET63b1a086d5->
 DATARMNET54338da2ff,DATARMNET543491eb0f->dev);if(!sk){struct rmnet_skb_cb*
 DATARMNET1ec4882bf7=RMNET_SKB_CB(DATARMNET543491eb0f);DATARMNET32b91c8ae6(
 DATARMNETb03f9571a3);DATARMNET63b1a086d5->DATARMNET55056146f6=true;
-DATARMNET1ec4882bf7->tethered=true;return;}if(sk_fullsock(sk)){bh_lock_sock(sk);
-if(sk->sk_state==TCP_ESTABLISHED&&!sock_flag(sk,SOCK_DEAD)&&!sk_unhashed(sk)&&sk
-->sk_shutdown!=SHUTDOWN_MASK){inet_csk(sk)->icsk_ack.pending|=ICSK_ACK_NOW;
-inet_csk_schedule_ack(sk);DATARMNET63b1a086d5->DATARMNETb8fc35ed64++;
-DATARMNET32b91c8ae6(DATARMNET53c8cfb28e);}bh_unlock_sock(sk);}sock_gen_put(sk);}
+DATARMNET1ec4882bf7->tethered=true;return;}if(!sk_fullsock(sk)||
+rmnet_perf_tcp_sk_stale(sk)){sock_gen_put(sk);return;}
+rmnet_perf_tcp_force_ack(DATARMNET63b1a086d5,sk);
+/* Keep the reference in the flow node so later packets of this flow skip the
+ * socket lookup. It is dropped when the node is freed or found stale.
+ */
+if(cmpxchg(&DATARMNET63b1a086d5->sk,NULL,sk))sock_gen_put(sk);}
 static u32 DATARMNET62fb576113(struct sk_buff*DATARMNET543491eb0f){struct tcphdr
 *DATARMNET668416551c=tcp_hdr(DATARMNET543491eb0f);return DATARMNET543491eb0f->
 len-((u8*)DATARMNET668416551c-DATARMNET543491eb0f->data)-DATARMNET668416551c->
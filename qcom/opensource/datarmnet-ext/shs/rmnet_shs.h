@@ -31,6 +31,7 @@
 #include "qmi_rmnet.h"
 #define DATARMNETe603c3a4b3 DATARMNETbfe1afe595
 #define DATARMNET25437d35fd 9
+#define RMNET_SHS_HT_BITS 12
 #define DATARMNET4899358462 (0xeb7+1101-0x12f5)
 #define DATARMNET401583e606 DATARMNETecc0627c70.DATARMNET2f954f58f8
 #define DATARMNETc6782fed88  (0xd35+210-0xdff)
@@ -86,13 +87,15 @@ DATARMNETe250463eef;ktime_t DATARMNETdd3caf9200;struct wakeup_source*ws;u8
 DATARMNET2f954f58f8;u8 DATARMNETf510b48c29;u8 DATARMNET637025ccc1;u8 
 DATARMNET75af9f3c31;};struct DATARMNETa034b2e60c{struct sk_buff*head;struct 
 sk_buff*tail;u64 DATARMNETbaa5765693;u32 DATARMNET6215127f48;u32 
-DATARMNET35234676d4;};struct DATARMNET63d7680df2{union{struct iphdr 
+DATARMNET35234676d4;};
+/* Per-CPU packet and byte counts of a flow, summed by the workqueue */
+struct rmnet_shs_flow_pcpu{u64 rx_skb;u64 rx_bytes;};struct DATARMNET63d7680df2{union{struct iphdr 
 DATARMNETac9bbaad7c;struct ipv6hdr DATARMNET1688a97aa4;}ip_hdr;union{struct 
 tcphdr tp;struct udphdr up;}DATARMNETe33b41dad9;struct list_head 
 DATARMNET04c88b8191;struct net_device*dev;struct DATARMNET6c78e47d24*
 DATARMNET341ea38662;struct DATARMNETa034b2e60c DATARMNETae4b27456e;struct 
-hlist_node list;u64 DATARMNET11930c5df8;u64 DATARMNETa8940e4a7b;u64 
-DATARMNET2594c418db;u64 DATARMNET3ecedac168;u64 DATARMNETce5f56eab9;u32 
+hlist_node list;struct rmnet_shs_flow_pcpu __percpu*pcpu;struct rcu_head rcu;u64 
+DATARMNETa8940e4a7b;u64 DATARMNET3ecedac168;u64 DATARMNETce5f56eab9;u32 
 DATARMNET1743c92e66;u32 queue_head;u32 hash;u32 bif;u32 ack_thresh;u16 map_index
 ;u16 map_cpu;u16 DATARMNETfbbec4c537;u16 DATARMNETa59ce1fd2d;u8 
 DATARMNET85c698ec34;u16 DATARMNET0371465875;u16 DATARMNET1e9d25d9ff;u8 
@@ -160,7 +163,7 @@ DATARMNET5c98629e14;};extern struct DATARMNET37ef896af8 DATARMNET1731db288b;
 extern spinlock_t DATARMNETd83ee17944;extern spinlock_t DATARMNET3764d083f0;
 extern spinlock_t DATARMNETec2a4f5211;extern spinlock_t DATARMNETfbdbab2ef6;
 extern struct hlist_head DATARMNETe603c3a4b3[(0xd26+209-0xdf6)<<(
-DATARMNET25437d35fd)];extern int(*rmnet_shs_skb_entry)(struct sk_buff*skb,struct
+RMNET_SHS_HT_BITS)];extern int(*rmnet_shs_skb_entry)(struct sk_buff*skb,struct
  rmnet_shs_clnt_s*DATARMNET9e820fbfe3);extern int(*rmnet_shs_ll_skb_entry)(
 struct sk_buff*skb,struct rmnet_shs_clnt_s*DATARMNET9e820fbfe3);extern int(*
 rmnet_shs_switch)(struct sk_buff*skb,struct rmnet_shs_clnt_s*DATARMNET9e820fbfe3
@@ -184,7 +187,12 @@ DATARMNET9f4bc49c6f);void DATARMNET7f1d9480cb(void*port);void
 DATARMNETa4bd2ef52c(void*port);void DATARMNETe074a09496(void);void 
 DATARMNET23c7ddd780(struct DATARMNET63d7680df2*DATARMNET63b1a086d5,u8 
 DATARMNET5447204733);void DATARMNET349c3a0cab(u16 map_cpu,bool 
-DATARMNETb639f6e1b1);void DATARMNETe767554e6e(struct sk_buff*skb);u32 
+DATARMNETb639f6e1b1);void DATARMNETe767554e6e(struct sk_buff*skb);struct DATARMNET63d7680df2*
+rmnet_shs_flow_alloc(void);void rmnet_shs_flow_free(struct DATARMNET63d7680df2*
+node_p);void rmnet_shs_flow_stats(struct DATARMNET63d7680df2*node_p,u64*rx_skb,
+u64*rx_bytes);static inline void rmnet_shs_flow_count(struct 
+DATARMNET63d7680df2*node_p,u64 rx_skb,u64 rx_bytes){this_cpu_add(node_p->pcpu->
+rx_skb,rx_skb);this_cpu_add(node_p->pcpu->rx_bytes,rx_bytes);}u32 
 DATARMNETadb0248bd4(u8 DATARMNET42a992465f);
 #endif 
 
@@ -48,7 +48,7 @@ rm_err("\x25\x73",
 DATARMNETf3298dab6f(void){trace_rmnet_shs_high(DATARMNET1790979ccf,
 DATARMNET89958f9b63,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
 (0x16e8+787-0xc0c),NULL,NULL);unregister_netdevice_notifier(&DATARMNET5fc54f7a13
-);DATARMNETeabd69d1ab();pr_info(
+);DATARMNETeabd69d1ab();rcu_barrier();pr_info(
 "\x25\x73\x28\x29\x3a\x20\x45\x78\x69\x74\x69\x6e\x67\x20\x72\x6d\x6e\x65\x74\x20\x53\x48\x53\x20\x6d\x6f\x64\x75\x6c\x65" "\n"
 ,__func__);}static int DATARMNETe9173bbe0e(struct notifier_block*
 DATARMNET272c159b3c,unsigned long DATARMNET7f045a1e6e,void*data){struct 
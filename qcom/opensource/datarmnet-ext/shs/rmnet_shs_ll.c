@@ -323,8 +323,8 @@ DATARMNET3874292c18;node_p->map_index=DATARMNET04e8d1b862(node_p->map_cpu,map);
 break;}if(is_match_found)break;if(DATARMNETb925972e2a<(0xd2d+202-0xdf7)){
 DATARMNET68d84e7b98[DATARMNETa1f9420686]++;break;}if(atomic_long_read(&
 DATARMNETecc0627c70.DATARMNET64bb8a8f57)>DATARMNETbfe31ef643){
-DATARMNET68d84e7b98[DATARMNETe6e77f9f03]++;break;}node_p=kzalloc(sizeof(*node_p)
-,GFP_ATOMIC);if(!node_p){DATARMNET68d84e7b98[DATARMNET394acaf558]++;break;}
+DATARMNET68d84e7b98[DATARMNETe6e77f9f03]++;break;}node_p=rmnet_shs_flow_alloc();
+if(!node_p){DATARMNET68d84e7b98[DATARMNET394acaf558]++;break;}
 atomic_long_inc(&DATARMNETecc0627c70.DATARMNET64bb8a8f57);node_p->
 DATARMNETfbbec4c537=DATARMNET0bf01e7c6f->map_mask;node_p->DATARMNETa59ce1fd2d=
 DATARMNETecc0627c70.map_mask;node_p->dev=skb->dev;node_p->hash=skb->hash;node_p
@@ -355,15 +355,15 @@ DATARMNET8053357aa4&&DATARMNETdc7bead533(raw_smp_processor_id(),12000)){skb->
 hash=(0xd2d+202-0xdf7);skb->sw_hash=(0xd26+209-0xdf6);}else{node_p->
 DATARMNETd986107d55=DATARMNET46a17e3ec5;node_p->map_cpu=DATARMNETb925972e2a;
 node_p->map_index=DATARMNET04e8d1b862(node_p->map_cpu,map);}}}if(skb_shinfo(skb)
-->gso_segs){node_p->DATARMNET11930c5df8+=skb_shinfo(skb)->gso_segs;
+->gso_segs){rmnet_shs_flow_count(node_p,skb_shinfo(skb)->gso_segs,skb->len);
 DATARMNET0997c5650d[node_p->map_cpu].DATARMNET4133fc9428++;node_p->
-DATARMNETae4b27456e.DATARMNET35234676d4+=skb_shinfo(skb)->gso_segs;}else{node_p
-->DATARMNET11930c5df8+=(0xd26+209-0xdf6);DATARMNET0997c5650d[node_p->map_cpu].
+DATARMNETae4b27456e.DATARMNET35234676d4+=skb_shinfo(skb)->gso_segs;}else{
+rmnet_shs_flow_count(node_p,(0xd26+209-0xdf6),skb->len);DATARMNET0997c5650d[node_p->map_cpu].
 DATARMNET4133fc9428++;node_p->DATARMNETae4b27456e.DATARMNET35234676d4++;}node_p
 ->DATARMNETa8940e4a7b+=(0xd26+209-0xdf6);node_p->DATARMNET3ecedac168+=
 RMNET_SKB_CB(skb)->coal_bytes;node_p->DATARMNETce5f56eab9+=RMNET_SKB_CB(skb)->
-coal_bufsize;if(skb->priority==55834)node_p->DATARMNET1743c92e66++;node_p->
-DATARMNET2594c418db+=skb->len;}DATARMNETe767554e6e(skb);return(0xd2d+202-0xdf7);
+coal_bufsize;if(skb->priority==55834)node_p->DATARMNET1743c92e66++;}
+DATARMNETe767554e6e(skb);return(0xd2d+202-0xdf7);
 }void DATARMNET44499733f2(void){u8 DATARMNET0e4304d903;for(DATARMNET0e4304d903=
 (0xd2d+202-0xdf7);DATARMNET0e4304d903<DATARMNETc6782fed88;DATARMNET0e4304d903++)
 INIT_LIST_HEAD(&DATARMNET148e775ece[DATARMNET0e4304d903].DATARMNET3dc4262f53);}
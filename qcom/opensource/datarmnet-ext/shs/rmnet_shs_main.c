@@ -85,7 +85,7 @@ DATARMNET758a55f103
 #define DATARMNET48a89fcc16 (0xd26+209-0xdf6)
 #define DATARMNETbfe901fc62 (0xd2d+202-0xdf7)
 DEFINE_SPINLOCK(DATARMNET3764d083f0);DEFINE_HASHTABLE(DATARMNETe603c3a4b3,
-DATARMNET25437d35fd);struct DATARMNETe600c5b727 DATARMNET0997c5650d[
+RMNET_SHS_HT_BITS);struct DATARMNETe600c5b727 DATARMNET0997c5650d[
 DATARMNETc6782fed88];int DATARMNETcff375d916[DATARMNETc6782fed88];unsigned int 
 DATARMNET064fbe9e3a __read_mostly=(0xd2d+202-0xdf7);module_param(
 DATARMNET064fbe9e3a,uint,(0xdb7+6665-0x261c));MODULE_PARM_DESC(
@@ -234,7 +234,25 @@ DATARMNETe61d62310f=DATARMNET8a461bad56;}else{DATARMNETecc0627c70.
 DATARMNET132b9c7dc4[cpu].DATARMNETe61d62310f+=DATARMNET8a461bad56;}}void 
 DATARMNETe767554e6e(struct sk_buff*skb){DATARMNETda96251102(DATARMNET6b317c4c73,
 DATARMNET43225b7a7c,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
-(0x16e8+787-0xc0c),skb,NULL);netif_receive_skb(skb);}void DATARMNET514ce0bf59(
+(0x16e8+787-0xc0c),skb,NULL);rmnet_rx_batch_receive(skb);}struct 
+DATARMNET63d7680df2*rmnet_shs_flow_alloc(void){struct DATARMNET63d7680df2*node_p
+;node_p=kzalloc(sizeof(*node_p),GFP_ATOMIC);if(!node_p)return NULL;node_p->pcpu=
+alloc_percpu_gfp(struct rmnet_shs_flow_pcpu,GFP_ATOMIC);if(!node_p->pcpu){kfree(
+node_p);return NULL;}return node_p;}static void rmnet_shs_flow_free_rcu(struct 
+rcu_head*head){struct DATARMNET63d7680df2*node_p=container_of(head,struct 
+DATARMNET63d7680df2,rcu);free_percpu(node_p->pcpu);kfree(node_p);}
+/* The packet path looks flows up without the lock, so they are only freed once
+ * every reader which could still see them is done.
+ */
+void rmnet_shs_flow_free(struct DATARMNET63d7680df2*node_p){call_rcu(&node_p->
+rcu,rmnet_shs_flow_free_rcu);}void rmnet_shs_flow_stats(struct 
+DATARMNET63d7680df2*node_p,u64*rx_skb,u64*rx_bytes){struct rmnet_shs_flow_pcpu*
+stats;int cpu;*rx_skb=(0xd2d+202-0xdf7);*rx_bytes=(0xd2d+202-0xdf7);
+for_each_possible_cpu(cpu){stats=per_cpu_ptr(node_p->pcpu,cpu);*rx_skb+=
+READ_ONCE(stats->rx_skb);*rx_bytes+=READ_ONCE(stats->rx_bytes);}}static struct 
+DATARMNET63d7680df2*rmnet_shs_flow_lookup(u32 hash){struct DATARMNET63d7680df2*
+node_p;hash_for_each_possible_rcu(DATARMNETe603c3a4b3,node_p,list,hash){if(
+node_p->hash==hash)return node_p;}return NULL;}void DATARMNET514ce0bf59(
 struct sk_buff*skb){DATARMNETda96251102(DATARMNET6b317c4c73,DATARMNET43225b7a7c,
 (0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),skb,
 NULL);netif_rx(skb);}static struct sk_buff*DATARMNET0e315f0262(struct sk_buff*
@@ -259,11 +277,12 @@ DATARMNETcebafc57a4=NULL;struct sk_buff*DATARMNET39bcb0d197=NULL;int count=
 (0xd26+209-0xdf6),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
 DATARMNETe08e18123e,NULL);DATARMNET39bcb0d197=DATARMNET0e315f0262(
 DATARMNETe08e18123e,DATARMNET87636d0152);if(DATARMNET39bcb0d197==NULL){if(
-DATARMNETf345c1d909==DATARMNET0b15fd8b54)netif_receive_skb(DATARMNETe08e18123e);
+DATARMNETf345c1d909==DATARMNET0b15fd8b54)rmnet_rx_batch_receive(
+DATARMNETe08e18123e);
 else netif_rx(DATARMNETe08e18123e);return;}for((skb=DATARMNET39bcb0d197);skb!=
 NULL;skb=DATARMNETcebafc57a4){DATARMNETcebafc57a4=skb->next;skb->hash=
 DATARMNETe08e18123e->hash;skb->dev=DATARMNETe08e18123e->dev;skb->next=NULL;if(
-DATARMNETf345c1d909==DATARMNET0b15fd8b54)netif_receive_skb(skb);else netif_rx(
+DATARMNETf345c1d909==DATARMNET0b15fd8b54)rmnet_rx_batch_receive(skb);else netif_rx(
 skb);count+=(0xd26+209-0xdf6);}consume_skb(DATARMNETe08e18123e);return;}int 
 DATARMNET2efb1a51c7(struct DATARMNET63d7680df2*node_p){int ret=(0xd2d+202-0xdf7)
 ;int DATARMNET42c3ecbd5e=(0xd26+209-0xdf6);u16 idx=(0xd2d+202-0xdf7);for(idx=
@@ -613,9 +632,13 @@ DATARMNETecc0627c70.DATARMNETa2e32cdd3a<=(0xd2d+202-0xdf7))){DATARMNETecc0627c70
 .DATARMNETc252a1f55d=(0xd2d+202-0xdf7);DATARMNETecc0627c70.DATARMNETa2e32cdd3a=
 (0xd2d+202-0xdf7);DATARMNETecc0627c70.DATARMNETd9cfd2812b=(0xd2d+202-0xdf7);
 DATARMNETecc0627c70.DATARMNET34097703c8=DATARMNET8dcf06727b;}}void 
-DATARMNETa4bf9fbf64(u8 DATARMNETded3da1a77,u8 DATARMNET5447204733){spin_lock_bh(
+DATARMNETa4bf9fbf64(u8 DATARMNETded3da1a77,u8 DATARMNET5447204733){
+/* Deliver the packets of all per-CPU queues as one rmnet RX batch */
+struct rmnet_port*port=READ_ONCE(DATARMNETecc0627c70.port);local_bh_disable();if
+(port)rmnet_rx_batch_begin(port);spin_lock_bh(
 &DATARMNET3764d083f0);DATARMNETe377e0368d(DATARMNETded3da1a77,
-DATARMNET5447204733);spin_unlock_bh(&DATARMNET3764d083f0);if(DATARMNET5447204733
+DATARMNET5447204733);spin_unlock_bh(&DATARMNET3764d083f0);if(port)
+rmnet_rx_batch_end(port);local_bh_enable();if(DATARMNET5447204733
 ==DATARMNET5b5927fd7e){if(DATARMNET365ddeca1c&&DATARMNETecc0627c70.
 DATARMNETc252a1f55d&&DATARMNETecc0627c70.DATARMNETa2e32cdd3a){if(hrtimer_active(
 &DATARMNETecc0627c70.DATARMNET6fd692fc7a))hrtimer_cancel(&DATARMNETecc0627c70.
@@ -630,18 +653,17 @@ DATARMNET8fadb49f38]){DATARMNETe377e0368d((0xd2d+202-0xdf7),DATARMNET0b15fd8b54)
 ;DATARMNET14ed771dfb[DATARMNETc8058e2cff]++;DATARMNET7d63e92341=
 (0xd26+209-0xdf6);}
 #endif
-if(skb_shinfo(skb)->gso_segs){DATARMNET63b1a086d5->DATARMNET11930c5df8+=
-skb_shinfo(skb)->gso_segs;DATARMNET0997c5650d[DATARMNET63b1a086d5->map_cpu].
+if(skb_shinfo(skb)->gso_segs){rmnet_shs_flow_count(DATARMNET63b1a086d5,
+skb_shinfo(skb)->gso_segs,skb->len);DATARMNET0997c5650d[DATARMNET63b1a086d5->map_cpu].
 DATARMNET4133fc9428++;DATARMNET63b1a086d5->DATARMNETae4b27456e.
-DATARMNET35234676d4+=skb_shinfo(skb)->gso_segs;}else{DATARMNET63b1a086d5->
-DATARMNET11930c5df8+=(0xd26+209-0xdf6);DATARMNET0997c5650d[DATARMNET63b1a086d5->
+DATARMNET35234676d4+=skb_shinfo(skb)->gso_segs;}else{rmnet_shs_flow_count(
+DATARMNET63b1a086d5,(0xd26+209-0xdf6),skb->len);DATARMNET0997c5650d[DATARMNET63b1a086d5->
 map_cpu].DATARMNET4133fc9428++;DATARMNET63b1a086d5->DATARMNETae4b27456e.
 DATARMNET35234676d4++;}DATARMNET63b1a086d5->DATARMNETa8940e4a7b+=
 (0xd26+209-0xdf6);DATARMNET63b1a086d5->DATARMNET3ecedac168+=RMNET_SKB_CB(skb)->
 coal_bytes;DATARMNET63b1a086d5->DATARMNETce5f56eab9+=RMNET_SKB_CB(skb)->
 coal_bufsize;DATARMNET63b1a086d5->bif=RMNET_SKB_CB(skb)->bif;DATARMNET63b1a086d5
-->ack_thresh=RMNET_SKB_CB(skb)->ack_thresh;DATARMNET63b1a086d5->
-DATARMNET2594c418db+=skb->len;DATARMNET63b1a086d5->DATARMNETae4b27456e.
+->ack_thresh=RMNET_SKB_CB(skb)->ack_thresh;DATARMNET63b1a086d5->DATARMNETae4b27456e.
 DATARMNETbaa5765693+=skb->len;DATARMNETecc0627c70.DATARMNETc252a1f55d+=skb->len;
 if(DATARMNET63b1a086d5->DATARMNETae4b27456e.DATARMNET6215127f48>
 (0xd2d+202-0xdf7)){DATARMNET63b1a086d5->DATARMNETae4b27456e.tail->next=skb;
@@ -856,7 +878,7 @@ DATARMNETba5ea4329f(node_p->map_cpu))){hrtimer_start(&DATARMNETba5ea4329f(node_p
 ->map_cpu),ns_to_ktime((DATARMNET566e381630/(0xd1f+216-0xdf5))*
 DATARMNET68fc0be252),HRTIMER_MODE_REL);}}}int DATARMNET756778f14f(struct sk_buff
 *skb,struct rmnet_shs_clnt_s*DATARMNET0bf01e7c6f){struct DATARMNET63d7680df2*
-node_p;struct hlist_node*tmp;int map=DATARMNETecc0627c70.map_mask;int 
+node_p;u8 state;int map=DATARMNETecc0627c70.map_mask;int 
 DATARMNETcfb5dc7296;int map_cpu;u32 DATARMNET5c4a331b9c,hash;u8 is_match_found=
 (0xd2d+202-0xdf7);u8 DATARMNET935af10724=(0xd2d+202-0xdf7);u8 
 DATARMNET7c5ef97eab=(0xd2d+202-0xdf7);struct DATARMNETe600c5b727*
@@ -880,17 +902,29 @@ DATARMNETecc0627c70.DATARMNET6625085b71!=DATARMNETecc0627c70.DATARMNET7d667e828e
 .DATARMNETfeee6933fc>DATARMNETf4cacbb5dc){DATARMNETa4bf9fbf64(
 DATARMNETf3dfa53867,DATARMNET0b15fd8b54);DATARMNETa871eeb7e7();
 DATARMNET68d84e7b98[DATARMNET43405942ed]++;DATARMNETecc0627c70.
-DATARMNETfeee6933fc=(0xd2d+202-0xdf7);}return(0xd2d+202-0xdf7);}}spin_lock_bh(&
-DATARMNET3764d083f0);do{hash_for_each_possible_safe(DATARMNETe603c3a4b3,node_p,
-tmp,list,hash){if(hash!=node_p->hash)continue;DATARMNETda96251102(
+DATARMNETfeee6933fc=(0xd2d+202-0xdf7);}return(0xd2d+202-0xdf7);}}
+/* Flows moved to the LL path only need counting, so they skip the lock. Flows
+ * are unhashed under the lock and freed after a grace period, a flow removed or
+ * added since the lockless lookup is looked up again once the lock is held.
+ */
+rcu_read_lock();node_p=rmnet_shs_flow_lookup(hash);if(node_p){
+state=READ_ONCE(node_p->DATARMNET80eb31d7b8);if(
+state==DATARMNET6a801720f2||state==
+DATARMNETfb9ca677b8){DATARMNETda96251102(DATARMNET720469c0a9,DATARMNET08b6defcff
+,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),skb
+,NULL);rmnet_shs_flow_count(node_p,(0xd26+209-0xdf6),skb->len);rcu_read_unlock()
+;DATARMNETf5821256ad(skb,DATARMNET0bf01e7c6f);return(0xd2d+202-0xdf7);}}
+spin_lock_bh(&DATARMNET3764d083f0);if(!node_p||hlist_unhashed(&node_p->list))
+node_p=rmnet_shs_flow_lookup(hash);rcu_read_unlock();do{for(;node_p;node_p=NULL)
+{DATARMNETda96251102(
 DATARMNET720469c0a9,DATARMNET08b6defcff,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),
 (0x16e8+787-0xc0c),(0x16e8+787-0xc0c),skb,NULL);DATARMNET5c4a331b9c=node_p->
 map_index;is_match_found=(0xd26+209-0xdf6);DATARMNET935af10724=(0xd26+209-0xdf6)
 ;if(node_p->DATARMNET80eb31d7b8){if(node_p->DATARMNET80eb31d7b8==
 DATARMNET64165df74d){if(DATARMNETe24386452c(skb)){node_p->DATARMNET80eb31d7b8=
 DATARMNET6a801720f2;}else{node_p->DATARMNET80eb31d7b8=DATARMNETf8fcf5a1db;}}
-spin_unlock_bh(&DATARMNET3764d083f0);node_p->DATARMNET11930c5df8+=
-(0xd26+209-0xdf6);node_p->DATARMNET2594c418db+=skb->len;DATARMNETf5821256ad(skb,
+rmnet_shs_flow_count(node_p,(0xd26+209-0xdf6),skb->len);spin_unlock_bh(&
+DATARMNET3764d083f0);DATARMNETf5821256ad(skb,
 DATARMNET0bf01e7c6f);return(0xd2d+202-0xdf7);}if(node_p->DATARMNET85c698ec34){
 DATARMNETe074a09496();if(raw_smp_processor_id()!=DATARMNETecc0627c70.
 DATARMNET7d667e828e){DATARMNET68d84e7b98[DATARMNETbb641cd339]++;}if(
@@ -920,14 +954,14 @@ DATARMNETd0bfb31db5&~DATARMNETecc0627c70.DATARMNETba3f7a11ef&~
 DATARMNET121c8bc82a);}if(DATARMNETcfb5dc7296<(0xd2d+202-0xdf7)){
 DATARMNET68d84e7b98[DATARMNETa1f9420686]++;break;}if(atomic_long_read(&
 DATARMNETecc0627c70.DATARMNET64bb8a8f57)>DATARMNETbfe31ef643){
-DATARMNET68d84e7b98[DATARMNETe6e77f9f03]++;break;}node_p=kzalloc(sizeof(*node_p)
-,GFP_ATOMIC);if(!node_p){DATARMNET68d84e7b98[DATARMNET394acaf558]++;break;}
+DATARMNET68d84e7b98[DATARMNETe6e77f9f03]++;break;}node_p=rmnet_shs_flow_alloc();
+if(!node_p){DATARMNET68d84e7b98[DATARMNET394acaf558]++;break;}
 atomic_long_inc(&DATARMNETecc0627c70.DATARMNET64bb8a8f57);node_p->dev=skb->dev;
 node_p->hash=skb->hash;node_p->map_cpu=DATARMNETcfb5dc7296;node_p->map_index=
 DATARMNET04e8d1b862(node_p->map_cpu,map);INIT_LIST_HEAD(&node_p->
 DATARMNET04c88b8191);DATARMNET44459105b4(skb,node_p);DATARMNET350f55bfca(node_p)
 ;if(!node_p->DATARMNET341ea38662){atomic_long_dec(&DATARMNETecc0627c70.
-DATARMNET64bb8a8f57);kfree(node_p);break;}if(DATARMNET0bf01e7c6f->map_mask){
+DATARMNET64bb8a8f57);rmnet_shs_flow_free(node_p);break;}if(DATARMNET0bf01e7c6f->map_mask){
 DATARMNETe074a09496();DATARMNET02fc8b29a0(node_p,DATARMNET0bf01e7c6f,skb->dev);}
 else{node_p->DATARMNETfbbec4c537=DATARMNETecc0627c70.map_mask;node_p->
 DATARMNETa59ce1fd2d=DATARMNETecc0627c70.map_len;}map_cpu=node_p->map_cpu;
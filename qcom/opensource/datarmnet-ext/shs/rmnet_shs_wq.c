@@ -214,9 +214,10 @@ DATARMNETdbe9f3dbe3->DATARMNET61e1ee0e95[DATARMNETd7a3f55a51];
 DATARMNET6d75219ffb[DATARMNETdbe9f3dbe3->DATARMNETb5f5519502]=
 DATARMNETdbe9f3dbe3->DATARMNET61e1ee0e95[DATARMNETefe8657028];}u8 
 DATARMNETd245b71b63(struct DATARMNET6c78e47d24*DATARMNETdbe9f3dbe3,struct 
-DATARMNET63d7680df2*node_p){if(!DATARMNETdbe9f3dbe3||!node_p){
-DATARMNET68d84e7b98[DATARMNETac729c3d29]++;return(0xd2d+202-0xdf7);}if(node_p->
-DATARMNET11930c5df8==DATARMNETdbe9f3dbe3->DATARMNET4b4a76b094)return
+DATARMNET63d7680df2*node_p){u64 rx_skb,rx_bytes;if(!DATARMNETdbe9f3dbe3||!node_p){
+DATARMNET68d84e7b98[DATARMNETac729c3d29]++;return(0xd2d+202-0xdf7);}
+rmnet_shs_flow_stats(node_p,&rx_skb,&rx_bytes);if(
+rx_skb==DATARMNETdbe9f3dbe3->DATARMNET4b4a76b094)return
 (0xd2d+202-0xdf7);return(0xd26+209-0xdf6);}void DATARMNETb49b4f6385(struct 
 DATARMNET6c78e47d24*DATARMNETdbe9f3dbe3,struct DATARMNET63d7680df2*node_p){
 ktime_t DATARMNET96f21fddc1;if(!DATARMNETdbe9f3dbe3||!node_p){
@@ -227,13 +228,14 @@ DATARMNET394831f22a,DATARMNET08cee5b48c,DATARMNETdbe9f3dbe3->hash,
 DATARMNET96f21fddc1,(0x16e8+787-0xc0c),(0x16e8+787-0xc0c),DATARMNETdbe9f3dbe3,
 NULL);}void DATARMNET9a7769cf21(struct DATARMNET6c78e47d24*DATARMNETdbe9f3dbe3){
 ktime_t DATARMNET96f21fddc1;u64 DATARMNETee9f72f13f,DATARMNET539a572f34,
-DATARMNET33b006454e;struct DATARMNET63d7680df2*node_p;if(!DATARMNETdbe9f3dbe3){
+DATARMNET33b006454e;u64 rx_skb,rx_bytes;struct DATARMNET63d7680df2*node_p;if(!DATARMNETdbe9f3dbe3){
 DATARMNET68d84e7b98[DATARMNETac729c3d29]++;return;}node_p=DATARMNETdbe9f3dbe3->
 DATARMNET63b1a086d5;if(!DATARMNETd245b71b63(DATARMNETdbe9f3dbe3,node_p)){
 DATARMNETdbe9f3dbe3->DATARMNET324c1a8f98=(0xd2d+202-0xdf7);DATARMNETdbe9f3dbe3->
 DATARMNET253a9fc708=(0xd2d+202-0xdf7);DATARMNETdbe9f3dbe3->DATARMNETbb80fccd97=
 (0xd2d+202-0xdf7);DATARMNETb49b4f6385(DATARMNETdbe9f3dbe3,node_p);
-DATARMNETc55315279b(DATARMNETdbe9f3dbe3,node_p);return;}trace_rmnet_shs_wq_low(
+DATARMNETc55315279b(DATARMNETdbe9f3dbe3,node_p);return;}rmnet_shs_flow_stats(
+node_p,&rx_skb,&rx_bytes);trace_rmnet_shs_wq_low(
 DATARMNET394831f22a,DATARMNET91e905574d,DATARMNETdbe9f3dbe3->hash,
 (0x16e8+787-0xc0c),DATARMNETdbe9f3dbe3->DATARMNET324c1a8f98,DATARMNETdbe9f3dbe3
 ->DATARMNETbb80fccd97,DATARMNETdbe9f3dbe3,NULL);DATARMNET0aa47ce397(
@@ -248,14 +250,14 @@ DATARMNET341ea38662->DATARMNET3ecedac168;DATARMNETdbe9f3dbe3->
 DATARMNET96e0dea53e=node_p->DATARMNET341ea38662->DATARMNETce5f56eab9;
 DATARMNETdbe9f3dbe3->DATARMNETde6a309f37=node_p->DATARMNET341ea38662->rx_bytes;
 DATARMNETdbe9f3dbe3->DATARMNETadd51beef4=DATARMNETb3a4036d6d;DATARMNETdbe9f3dbe3
-->DATARMNET4b4a76b094=node_p->DATARMNET11930c5df8;DATARMNETdbe9f3dbe3->
+->DATARMNET4b4a76b094=rx_skb;DATARMNETdbe9f3dbe3->
 DATARMNET77b978dd84=node_p->DATARMNET1743c92e66;DATARMNETdbe9f3dbe3->
 DATARMNET29c6349349=DATARMNETdbe9f3dbe3->DATARMNET77b978dd84!=
 DATARMNETdbe9f3dbe3->DATARMNET3b7421773f;DATARMNETdbe9f3dbe3->
 DATARMNETa7352711af=node_p->DATARMNETa8940e4a7b;DATARMNETdbe9f3dbe3->
 DATARMNET3ecedac168=node_p->DATARMNET3ecedac168;DATARMNETdbe9f3dbe3->
 DATARMNETce5f56eab9=node_p->DATARMNETce5f56eab9;DATARMNETdbe9f3dbe3->rx_bytes=
-node_p->DATARMNET2594c418db;DATARMNET96f21fddc1=(DATARMNETdbe9f3dbe3->
+rx_bytes;DATARMNET96f21fddc1=(DATARMNETdbe9f3dbe3->
 DATARMNETadd51beef4-DATARMNETdbe9f3dbe3->DATARMNET68714ac92c);
 DATARMNET96f21fddc1=(DATARMNET96f21fddc1>DATARMNETac617c8dce(DATARMNET1fc3ad67fd
 )&&DATARMNET1fc3ad67fd>(0xd2d+202-0xdf7))?DATARMNET96f21fddc1:
@@ -462,12 +464,16 @@ DATARMNET61e1ee0e95[DATARMNETa3f89581b5]+=(0xd26+209-0xdf6);}static int
 DATARMNET6f56fe7597(u16 DATARMNET035f475d5c,u16 DATARMNETcfb5dc7296,struct 
 DATARMNET9b44b71ee9*ep,u32 DATARMNET4da4612f1e,u32 DATARMNETa3f89581b5){struct 
 DATARMNET63d7680df2*node_p;struct DATARMNET6c78e47d24*DATARMNET7b2c1bbf38;struct
- hlist_node*tmp;int rc=(0xd2d+202-0xdf7);u16 bkt;if(!ep){DATARMNET68d84e7b98[
+ hlist_node*tmp;int rc=(0xd2d+202-0xdf7);u16 bkt,bkt_end;if(!ep){DATARMNET68d84e7b98[
 DATARMNETb8fe2c0e64]++;return(0xd2d+202-0xdf7);}if(DATARMNET035f475d5c>=
 DATARMNETc6782fed88||DATARMNETcfb5dc7296>=DATARMNETc6782fed88){
-DATARMNET68d84e7b98[DATARMNET54b67b8a75]++;return(0xd2d+202-0xdf7);}spin_lock_bh
-(&DATARMNET3764d083f0);hash_for_each_safe(DATARMNETe603c3a4b3,bkt,tmp,node_p,
-list){if(!node_p)continue;if(!node_p->DATARMNET341ea38662)continue;
+DATARMNET68d84e7b98[DATARMNET54b67b8a75]++;return(0xd2d+202-0xdf7);}
+/* A single flow can only live in the bucket of its hash */
+if(DATARMNET4da4612f1e){bkt=hash_min(DATARMNET4da4612f1e,HASH_BITS(
+DATARMNETe603c3a4b3));bkt_end=bkt+(0xd26+209-0xdf6);}else{bkt=
+(0xd2d+202-0xdf7);bkt_end=HASH_SIZE(DATARMNETe603c3a4b3);}spin_lock_bh
+(&DATARMNET3764d083f0);for(;bkt<bkt_end;bkt++)hlist_for_each_entry_safe(node_p,
+tmp,&DATARMNETe603c3a4b3[bkt],list){if(!node_p)continue;if(!node_p->DATARMNET341ea38662)continue;
 DATARMNET7b2c1bbf38=node_p->DATARMNET341ea38662;if(DATARMNET4da4612f1e!=
 (0xd2d+202-0xdf7)){if(DATARMNET7b2c1bbf38->hash!=DATARMNET4da4612f1e)continue;}
 rm_err(
@@ -592,8 +598,9 @@ DATARMNET4da4612f1e,DATARMNETa3f89581b5)){rm_err(
 );spin_unlock_bh(&DATARMNETec2a4f5211);return(0xd26+209-0xdf6);}}spin_unlock_bh(
 &DATARMNETec2a4f5211);return(0xd2d+202-0xdf7);}int DATARMNETf85599b9d8(u32 
 DATARMNET8c11bd9466,u8 DATARMNET87636d0152){struct DATARMNET63d7680df2*node_p;
-struct DATARMNET6c78e47d24*DATARMNET7b2c1bbf38;u16 bkt;spin_lock_bh(&
-DATARMNET3764d083f0);hash_for_each(DATARMNETe603c3a4b3,bkt,node_p,list){if(!
+struct DATARMNET6c78e47d24*DATARMNET7b2c1bbf38;spin_lock_bh(&
+DATARMNET3764d083f0);hash_for_each_possible(DATARMNETe603c3a4b3,node_p,list,
+DATARMNET8c11bd9466){if(!
 node_p)continue;if(!node_p->DATARMNET341ea38662)continue;DATARMNET7b2c1bbf38=
 node_p->DATARMNET341ea38662;if(DATARMNET7b2c1bbf38->hash!=DATARMNET8c11bd9466)
 continue;rm_err(
@@ -749,10 +756,10 @@ DATARMNETd2a694d52a);DATARMNET23c7ddd780(node_p,DATARMNET5b5927fd7e);
 DATARMNET3669e7b703(DATARMNETd2a694d52a->DATARMNET7c894c2f8f);if(node_p){if(
 node_p->DATARMNET80eb31d7b8){spin_lock_bh(&DATARMNETd83ee17944);
 DATARMNETde8ee16f92(node_p);hash_del_rcu(&node_p->list);node_p->
-DATARMNET04c88b8191.next=NULL;node_p->DATARMNET04c88b8191.prev=NULL;kfree(node_p
-);spin_unlock_bh(&DATARMNETd83ee17944);}else{DATARMNETde8ee16f92(node_p);
+DATARMNET04c88b8191.next=NULL;node_p->DATARMNET04c88b8191.prev=NULL;
+rmnet_shs_flow_free(node_p);spin_unlock_bh(&DATARMNETd83ee17944);}else{DATARMNETde8ee16f92(node_p);
 hash_del_rcu(&node_p->list);node_p->DATARMNET04c88b8191.next=NULL;node_p->
-DATARMNET04c88b8191.prev=NULL;kfree(node_p);}}rm_err(
+DATARMNET04c88b8191.prev=NULL;rmnet_shs_flow_free(node_p);}}rm_err(
 "\x53\x48\x53\x5f\x46\x4c\x4f\x57\x3a\x20\x72\x65\x6d\x6f\x76\x69\x6e\x67\x20\x66\x6c\x6f\x77\x20\x30\x78\x25\x78\x20\x6f\x6e\x20\x63\x70\x75\x5b\x25\x64\x5d\x20"
 "\x70\x70\x73\x3a\x20\x25\x6c\x6c\x75\x20\x61\x76\x67\x5f\x70\x70\x73\x3a\x20\x25\x6c\x6c\x75"
 ,DATARMNETd2a694d52a->hash,DATARMNETd2a694d52a->DATARMNET7c894c2f8f,
@@ -0,0 +1,808 @@
+/* Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * RMNET ingress replay benchmark
+ *
+ * Replays synthetic or recorded MAP aggregation buffers through the frag
+ * descriptor ingress path without a modem attached. Buffers are split
+ * across page fragments the same way the IPA driver hands them to us, and
+ * each stage of the pipeline is timed separately.
+ *
+ * Usage (debugfs):
+ *   echo 1000 > /d/rmnet_bench/iters
+ *   echo coal_max > /d/rmnet_bench/run
+ *   cat /d/rmnet_bench/results
+ *
+ * A recorded aggregation buffer can be written to /d/rmnet_bench/trace and
+ * replayed with "recorded", using the ingress format in data_format.
+ */
+
+#include <linux/debugfs.h>
+#include <linux/ip.h>
+#include <linux/ipv6.h>
+#include <linux/tcp.h>
+#include <linux/udp.h>
+#include <linux/if_link.h>
+#include <linux/seq_file.h>
+#include <linux/vmalloc.h>
+#include <net/ip.h>
+#include <net/ipv6.h>
+#include <net/ip6_checksum.h>
+#include "rmnet_config.h"
+#include "rmnet_descriptor.h"
+#include "rmnet_map.h"
+#include "rmnet_private.h"
+#include "rmnet_bench.h"
+
+#define RMNET_BENCH_PAGE_ORDER 3
+#define RMNET_BENCH_PAGE_SIZE (PAGE_SIZE << RMNET_BENCH_PAGE_ORDER)
+#define RMNET_BENCH_MAX_PAGES MAX_SKB_FRAGS
+#define RMNET_BENCH_BUF_MAX (RMNET_BENCH_MAX_PAGES * RMNET_BENCH_PAGE_SIZE)
+#define RMNET_BENCH_DFLT_ITERS 1000
+#define RMNET_BENCH_MUX_ID 1
+#define RMNET_BENCH_MSS 1400
+
+enum {
+	RMNET_BENCH_TRACE_TINY,
+	RMNET_BENCH_TRACE_COAL_MAX,
+	RMNET_BENCH_TRACE_IPV6_EXT,
+	RMNET_BENCH_TRACE_MAPV4,
+	RMNET_BENCH_TRACE_RECORDED,
+	RMNET_BENCH_TRACE_MAX,
+};
+
+static const char * const rmnet_bench_trace_names[] = {
+	[RMNET_BENCH_TRACE_TINY] = "tiny",
+	[RMNET_BENCH_TRACE_COAL_MAX] = "coal_max",
+	[RMNET_BENCH_TRACE_IPV6_EXT] = "ipv6_ext",
+	[RMNET_BENCH_TRACE_MAPV4] = "mapv4",
+	[RMNET_BENCH_TRACE_RECORDED] = "recorded",
+};
+
+enum {
+	RMNET_BENCH_STAGE_DEAGG,
+	RMNET_BENCH_STAGE_SEGMENT,
+	RMNET_BENCH_STAGE_RELEASE,
+	RMNET_BENCH_STAGE_MAX,
+};
+
+static const char * const rmnet_bench_stage_names[] = {
+	[RMNET_BENCH_STAGE_DEAGG] = "deaggregate",
+	[RMNET_BENCH_STAGE_SEGMENT] = "segment",
+	[RMNET_BENCH_STAGE_RELEASE] = "release",
+};
+
+struct rmnet_bench_stage {
+	u64 ns;
+	u64 desc_allocs;
+};
+
+struct rmnet_bench_result {
+	int trace;
+	u32 iters;
+	u64 bytes;
+	u64 frames;
+	u64 pkts;
+	struct rmnet_bench_stage stages[RMNET_BENCH_STAGE_MAX];
+};
+
+/* Synthetic trace writer */
+struct rmnet_bench_gen {
+	u8 *buf;
+	u32 len;
+	u32 flow;
+	bool csum_err;
+};
+
+struct rmnet_bench_ctx {
+	/* Serializes runs against each other and trace updates */
+	struct mutex lock;
+	struct dentry *dir;
+	struct rmnet_port *port;
+	struct net_device *dev;
+	u32 iters;
+	u32 data_format;
+	bool gro;
+	bool csum_err;
+	/* Buffer replayed by the current run, and its page copy */
+	u8 *buf;
+	u32 buf_len;
+	struct page *pages[RMNET_BENCH_MAX_PAGES];
+	u32 nr_pages;
+	/* User supplied trace */
+	u8 *record;
+	u32 record_len;
+	struct rmnet_bench_result result;
+};
+
+static struct rmnet_bench_ctx rmnet_bench;
+
+static u32 rmnet_bench_put_ip(u8 *p, bool ipv6, bool ext, u8 proto,
+			      u32 l4_len, u32 flow)
+{
+	if (!ipv6) {
+		struct iphdr *iph = (struct iphdr *)p;
+
+		memset(iph, 0, sizeof(*iph));
+		iph->version = 4;
+		iph->ihl = 5;
+		iph->tot_len = htons(sizeof(*iph) + l4_len);
+		iph->id = htons((u16)flow);
+		iph->ttl = 64;
+		iph->protocol = proto;
+		iph->saddr = htonl(0x0a000001);
+		iph->daddr = htonl(0x0a800000 | (flow & 0x7fffff));
+		iph->check = ip_fast_csum(iph, iph->ihl);
+		return sizeof(*iph);
+	} else {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)p;
+		u32 len = sizeof(*ip6h);
+
+		memset(ip6h, 0, sizeof(*ip6h));
+		ip6h->version = 6;
+		ip6h->hop_limit = 64;
+		ip6h->nexthdr = proto;
+		ip6h->saddr.s6_addr[0] = 0xfd;
+		ip6h->saddr.s6_addr[15] = 1;
+		ip6h->daddr.s6_addr[0] = 0xfd;
+		ip6h->daddr.s6_addr32[3] = htonl(flow);
+
+		if (ext) {
+			/* Hop-by-hop and destination options, each padded
+			 * out to 8 bytes with a PadN option.
+			 */
+			u8 *opt = p + len;
+
+			ip6h->nexthdr = NEXTHDR_HOP;
+			memset(opt, 0, 16);
+			opt[0] = NEXTHDR_DEST;
+			opt[2] = IPV6_TLV_PADN;
+			opt[3] = 4;
+			opt[8] = proto;
+			opt[10] = IPV6_TLV_PADN;
+			opt[11] = 4;
+			len += 16;
+		}
+
+		ip6h->payload_len = htons(len - sizeof(*ip6h) + l4_len);
+		return len;
+	}
+}
+
+static u32 rmnet_bench_put_l4(u8 *p, u8 proto, u32 l4_len, u32 flow)
+{
+	if (proto == IPPROTO_TCP) {
+		struct tcphdr *th = (struct tcphdr *)p;
+
+		memset(th, 0, sizeof(*th));
+		th->source = htons(443);
+		th->dest = htons(1024 + (flow % 60000));
+		th->seq = htonl(flow << 16);
+		th->ack_seq = htonl(1);
+		th->doff = sizeof(*th) / 4;
+		th->ack = 1;
+		th->window = htons(65535);
+		return sizeof(*th);
+	} else {
+		struct udphdr *uh = (struct udphdr *)p;
+
+		uh->source = htons(443);
+		uh->dest = htons(1024 + (flow % 60000));
+		uh->len = htons(l4_len);
+		uh->check = 0;
+		return sizeof(*uh);
+	}
+}
+
+static void rmnet_bench_l4_csum(u8 *ip, u32 ip_len, bool ipv6, u8 proto,
+				u32 l4_len)
+{
+	u8 *l4 = ip + ip_len;
+	__sum16 *check;
+	__wsum csum;
+
+	check = (proto == IPPROTO_TCP) ? &((struct tcphdr *)l4)->check :
+					 &((struct udphdr *)l4)->check;
+	*check = 0;
+	csum = csum_partial(l4, l4_len, 0);
+	if (!ipv6) {
+		struct iphdr *iph = (struct iphdr *)ip;
+
+		*check = csum_tcpudp_magic(iph->saddr, iph->daddr, l4_len,
+					   proto, csum);
+	} else {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)ip;
+
+		*check = csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr, l4_len,
+					 proto, csum);
+	}
+
+	if (proto == IPPROTO_UDP && !*check)
+		*check = CSUM_MANGLED_0;
+}
+
+static void *rmnet_bench_reserve(struct rmnet_bench_gen *gen, u32 size)
+{
+	void *p;
+
+	if (gen->len + size > RMNET_BENCH_BUF_MAX)
+		return NULL;
+
+	p = gen->buf + gen->len;
+	gen->len += size;
+	return p;
+}
+
+static void rmnet_bench_put_maph(u8 *p, bool next_hdr, u32 pkt_len)
+{
+	struct rmnet_map_header *maph = (struct rmnet_map_header *)p;
+
+	memset(maph, 0, sizeof(*maph));
+	maph->next_hdr = next_hdr;
+	maph->mux_id = RMNET_BENCH_MUX_ID;
+	maph->pkt_len = htons(pkt_len);
+}
+
+/* Single packet with a MAPv5 checksum offload header */
+static bool rmnet_bench_gen_csum_pkt(struct rmnet_bench_gen *gen, bool ipv6,
+				     u8 proto, u32 payload)
+{
+	u32 hdrs = (ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr)) +
+		   ((proto == IPPROTO_TCP) ? sizeof(struct tcphdr) :
+					     sizeof(struct udphdr));
+	struct rmnet_map_v5_csum_header *csum_hdr;
+	u32 ip_len, l4_len;
+	u8 *p;
+
+	p = rmnet_bench_reserve(gen, sizeof(struct rmnet_map_header) +
+				     sizeof(*csum_hdr) + hdrs + payload);
+	if (!p)
+		return false;
+
+	rmnet_bench_put_maph(p, true, hdrs + payload);
+	p += sizeof(struct rmnet_map_header);
+	csum_hdr = (struct rmnet_map_v5_csum_header *)p;
+	memset(csum_hdr, 0, sizeof(*csum_hdr));
+	csum_hdr->header_type = RMNET_MAP_HEADER_TYPE_CSUM_OFFLOAD;
+	/* Force software validation when checksum errors are requested */
+	csum_hdr->csum_valid_required = !gen->csum_err;
+	p += sizeof(*csum_hdr);
+
+	l4_len = hdrs - (ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr)) +
+		 payload;
+	ip_len = rmnet_bench_put_ip(p, ipv6, false, proto, l4_len, gen->flow);
+	rmnet_bench_put_l4(p + ip_len, proto, l4_len, gen->flow);
+	memset(p + hdrs, 0xa5, payload);
+	rmnet_bench_l4_csum(p, ip_len, ipv6, proto, l4_len);
+	gen->flow++;
+	return true;
+}
+
+/* MAPv5 coalesced frame with one set of headers followed by the payload of
+ * every packet described by the NLO pairs.
+ */
+static bool rmnet_bench_gen_coal(struct rmnet_bench_gen *gen, bool ipv6,
+				 bool ext, u8 proto, const u16 *payloads,
+				 u8 num_nlos, u8 pkts_per_nlo)
+{
+	struct rmnet_map_v5_coal_header *coal_hdr;
+	u32 ip_len, l4_hdr, total = 0;
+	u8 *p, i;
+
+	ip_len = (ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr)) +
+		 (ext ? 16 : 0);
+	l4_hdr = (proto == IPPROTO_TCP) ? sizeof(struct tcphdr) :
+					  sizeof(struct udphdr);
+	for (i = 0; i < num_nlos; i++)
+		total += payloads[i] * pkts_per_nlo;
+
+	p = rmnet_bench_reserve(gen, sizeof(struct rmnet_map_header) +
+				     sizeof(*coal_hdr) + ip_len + l4_hdr +
+				     total);
+	if (!p)
+		return false;
+
+	rmnet_bench_put_maph(p, true, ip_len + l4_hdr + total);
+	p += sizeof(struct rmnet_map_header);
+	coal_hdr = (struct rmnet_map_v5_coal_header *)p;
+	memset(coal_hdr, 0, sizeof(*coal_hdr));
+	coal_hdr->header_type = RMNET_MAP_HEADER_TYPE_COALESCING;
+	coal_hdr->num_nlos = num_nlos;
+	coal_hdr->csum_valid = !gen->csum_err;
+	coal_hdr->close_type = RMNET_MAP_COAL_CLOSE_HW;
+	coal_hdr->close_value = RMNET_MAP_COAL_CLOSE_HW_PKT;
+	for (i = 0; i < num_nlos; i++) {
+		struct rmnet_map_v5_nl_pair *nlo = &coal_hdr->nl_pairs[i];
+
+		nlo->pkt_len = htons(ip_len + l4_hdr + payloads[i]);
+		nlo->num_packets = pkts_per_nlo;
+		/* Mark every other packet bad */
+		if (gen->csum_err)
+			nlo->csum_error_bitmap = 0x55;
+	}
+
+	p += sizeof(*coal_hdr);
+	rmnet_bench_put_ip(p, ipv6, ext, proto, l4_hdr + total, gen->flow);
+	rmnet_bench_put_l4(p + ip_len, proto, l4_hdr + total, gen->flow);
+	memset(p + ip_len + l4_hdr, 0x5a, total);
+	gen->flow++;
+	return true;
+}
+
+/* MAPv4 packet followed by a checksum trailer */
+static bool rmnet_bench_gen_v4(struct rmnet_bench_gen *gen, u32 payload)
+{
+	u32 hdrs = sizeof(struct iphdr) + sizeof(struct tcphdr);
+	u32 ip_len, l4_len = sizeof(struct tcphdr) + payload;
+	u8 *p;
+
+	p = rmnet_bench_reserve(gen, sizeof(struct rmnet_map_header) + hdrs +
+				     payload +
+				     sizeof(struct rmnet_map_dl_csum_trailer));
+	if (!p)
+		return false;
+
+	rmnet_bench_put_maph(p, false, hdrs + payload);
+	p += sizeof(struct rmnet_map_header);
+	ip_len = rmnet_bench_put_ip(p, false, false, IPPROTO_TCP, l4_len,
+				    gen->flow);
+	rmnet_bench_put_l4(p + ip_len, IPPROTO_TCP, l4_len, gen->flow);
+	memset(p + hdrs, 0xc3, payload);
+	rmnet_bench_l4_csum(p, ip_len, false, IPPROTO_TCP, l4_len);
+	memset(p + hdrs + payload, 0, sizeof(struct rmnet_map_dl_csum_trailer));
+	gen->flow++;
+	return true;
+}
+
+static int rmnet_bench_generate(struct rmnet_bench_ctx *ctx, int trace)
+{
+	static const u16 coal_max[RMNET_MAP_V5_MAX_NLOS] = {
+		RMNET_BENCH_MSS, RMNET_BENCH_MSS - 8, RMNET_BENCH_MSS - 16,
+		RMNET_BENCH_MSS - 24, RMNET_BENCH_MSS - 32, RMNET_BENCH_MSS - 40,
+	};
+	static const u16 ext_mix[RMNET_MAP_V5_MAX_NLOS] = {
+		1200, 900, 600, 300, 100, RMNET_BENCH_MSS,
+	};
+	struct rmnet_bench_gen gen = {
+		.buf = ctx->buf,
+		.csum_err = ctx->csum_err,
+	};
+	int i;
+
+	switch (trace) {
+	case RMNET_BENCH_TRACE_TINY:
+		/* Lots of distinct flows, each carrying a tiny packet */
+		ctx->port->data_format = RMNET_FLAGS_INGRESS_COALESCE |
+					 RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5;
+		for (i = 0; i < 1024; i++)
+			if (!rmnet_bench_gen_csum_pkt(&gen, i & 1,
+						      (i & 2) ? IPPROTO_TCP :
+								IPPROTO_UDP,
+						      32))
+				break;
+		break;
+	case RMNET_BENCH_TRACE_COAL_MAX:
+		/* Largest frames the HW can produce: 6 NLOs x 8 packets */
+		ctx->port->data_format = RMNET_FLAGS_INGRESS_COALESCE |
+					 RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5;
+		for (i = 0; i < 8; i++)
+			if (!rmnet_bench_gen_coal(&gen, false, false,
+						  IPPROTO_TCP, coal_max,
+						  RMNET_MAP_V5_MAX_NLOS,
+						  RMNET_MAP_V5_MAX_PACKETS /
+						  RMNET_MAP_V5_MAX_NLOS))
+				break;
+		break;
+	case RMNET_BENCH_TRACE_IPV6_EXT:
+		/* Extension headers disable GRO, so every packet is split */
+		ctx->port->data_format = RMNET_FLAGS_INGRESS_COALESCE |
+					 RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5;
+		for (i = 0; i < 16; i++)
+			if (!rmnet_bench_gen_coal(&gen, true, !!(i & 1),
+						  (i & 2) ? IPPROTO_UDP :
+							    IPPROTO_TCP,
+						  ext_mix,
+						  RMNET_MAP_V5_MAX_NLOS, 4))
+				break;
+		break;
+	case RMNET_BENCH_TRACE_MAPV4:
+		ctx->port->data_format = RMNET_FLAGS_INGRESS_MAP_CKSUMV4;
+		for (i = 0; i < 256; i++)
+			if (!rmnet_bench_gen_v4(&gen, RMNET_BENCH_MSS))
+				break;
+		break;
+	case RMNET_BENCH_TRACE_RECORDED:
+		if (!ctx->record_len)
+			return -ENODATA;
+
+		ctx->port->data_format = ctx->data_format;
+		memcpy(gen.buf, ctx->record, ctx->record_len);
+		gen.len = ctx->record_len;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (!gen.len)
+		return -ENOSPC;
+
+	ctx->buf_len = gen.len;
+	return 0;
+}
+
+/* Copy the trace into high order pages, splitting it at page boundaries
+ * regardless of where the MAP frames fall.
+ */
+static int rmnet_bench_load_pages(struct rmnet_bench_ctx *ctx)
+{
+	u32 off, i;
+
+	ctx->nr_pages = DIV_ROUND_UP(ctx->buf_len, RMNET_BENCH_PAGE_SIZE);
+	for (i = 0, off = 0; i < ctx->nr_pages; i++) {
+		u32 len = min_t(u32, ctx->buf_len - off,
+				RMNET_BENCH_PAGE_SIZE);
+
+		if (!ctx->pages[i]) {
+			ctx->pages[i] = alloc_pages(GFP_KERNEL | __GFP_COMP,
+						    RMNET_BENCH_PAGE_ORDER);
+			if (!ctx->pages[i])
+				return -ENOMEM;
+		}
+
+		memcpy(page_address(ctx->pages[i]), ctx->buf + off, len);
+		off += len;
+	}
+
+	return 0;
+}
+
+static struct sk_buff *rmnet_bench_build_skb(struct rmnet_bench_ctx *ctx)
+{
+	struct sk_buff *skb;
+	u32 off = 0, i;
+
+	skb = alloc_skb(0, GFP_KERNEL);
+	if (!skb)
+		return NULL;
+
+	for (i = 0; i < ctx->nr_pages; i++) {
+		u32 len = min_t(u32, ctx->buf_len - off,
+				RMNET_BENCH_PAGE_SIZE);
+
+		get_page(ctx->pages[i]);
+		skb_add_rx_frag(skb, i, ctx->pages[i], 0, len,
+				RMNET_BENCH_PAGE_SIZE);
+		off += len;
+	}
+
+	skb->dev = ctx->dev;
+	return skb;
+}
+
+/* Mirrors __rmnet_frag_ingress_handler() up to the point of delivery */
+static void rmnet_bench_segment(struct rmnet_bench_ctx *ctx,
+				struct rmnet_frag_descriptor *frag_desc,
+				struct list_head *segs)
+{
+	struct rmnet_port *port = ctx->port;
+	struct rmnet_map_header *qmap, __qmap;
+	u16 len;
+
+	qmap = rmnet_frag_header_ptr(frag_desc, 0, sizeof(*qmap), &__qmap);
+	if (!qmap || qmap->cd_bit)
+		goto recycle;
+
+	len = ntohs(qmap->pkt_len) - qmap->pad_len;
+	frag_desc->dev = ctx->dev;
+
+	if (qmap->next_hdr &&
+	    (port->data_format & (RMNET_FLAGS_INGRESS_COALESCE |
+				  RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5))) {
+		if (rmnet_frag_process_next_hdr_packet(frag_desc, port, segs,
+						       len))
+			goto recycle;
+
+		return;
+	}
+
+	if (!rmnet_frag_pull(frag_desc, port, sizeof(*qmap)))
+		return;
+
+	if (!rmnet_frag_trim(frag_desc, port, len))
+		return;
+
+	list_add_tail(&frag_desc->list, segs);
+	return;
+
+recycle:
+	rmnet_recycle_frag_descriptor(frag_desc, port);
+}
+
+/* Only frag descriptor allocations are counted, not skbs or pages */
+static u64 rmnet_bench_desc_allocs(struct rmnet_bench_ctx *ctx)
+{
+	struct rmnet_frag_desc_cache_stats stats = {};
+
+	rmnet_descriptor_get_stats(ctx->port, (u64 *)&stats,
+				   sizeof(stats) / sizeof(u64));
+	return stats.alloc;
+}
+
+static int rmnet_bench_run(struct rmnet_bench_ctx *ctx, int trace)
+{
+	struct rmnet_bench_result *res = &ctx->result;
+	struct rmnet_frag_descriptor *frag_desc, *tmp;
+	u64 t[RMNET_BENCH_STAGE_MAX + 1];
+	u64 a[RMNET_BENCH_STAGE_MAX + 1];
+	u32 iter;
+	int rc, i;
+
+	rc = rmnet_bench_generate(ctx, trace);
+	if (rc)
+		return rc;
+
+	rc = rmnet_bench_load_pages(ctx);
+	if (rc)
+		return rc;
+
+	if (ctx->gro)
+		ctx->dev->features |= NETIF_F_GRO_HW;
+	else
+		ctx->dev->features &= ~NETIF_F_GRO_HW;
+
+	memset(res, 0, sizeof(*res));
+	res->trace = trace;
+	res->iters = ctx->iters;
+
+	for (iter = 0; iter < ctx->iters; iter++) {
+		LIST_HEAD(desc_list);
+		LIST_HEAD(out);
+		struct sk_buff *skb;
+
+		skb = rmnet_bench_build_skb(ctx);
+		if (!skb)
+			return -ENOMEM;
+
+		res->bytes += skb->len;
+		local_bh_disable();
+		a[0] = rmnet_bench_desc_allocs(ctx);
+		t[0] = ktime_get_ns();
+		rmnet_frag_deaggregate(skb, ctx->port, &desc_list, 0);
+		t[1] = ktime_get_ns();
+		a[1] = rmnet_bench_desc_allocs(ctx);
+
+		list_for_each_entry_safe(frag_desc, tmp, &desc_list, list) {
+			LIST_HEAD(segs);
+
+			list_del_init(&frag_desc->list);
+			rmnet_bench_segment(ctx, frag_desc, &segs);
+			list_splice_tail(&segs, &out);
+			res->frames++;
+		}
+
+		t[2] = ktime_get_ns();
+		a[2] = rmnet_bench_desc_allocs(ctx);
+
+		/* Stand-in for delivery to the stack */
+		list_for_each_entry_safe(frag_desc, tmp, &out, list) {
+			rmnet_recycle_frag_descriptor(frag_desc, ctx->port);
+			res->pkts++;
+		}
+
+		t[3] = ktime_get_ns();
+		a[3] = rmnet_bench_desc_allocs(ctx);
+		local_bh_enable();
+
+		for (i = 0; i < RMNET_BENCH_STAGE_MAX; i++) {
+			res->stages[i].ns += t[i + 1] - t[i];
+			res->stages[i].desc_allocs += a[i + 1] - a[i];
+		}
+
+		consume_skb(skb);
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static void rmnet_bench_show_stage(struct seq_file *s,
+				   struct rmnet_bench_result *res,
+				   const char *name, u64 ns, u64 desc_allocs)
+{
+	u64 pkts = max_t(u64, res->pkts, 1);
+	u64 ps = div64_u64(ns * 1000, pkts);
+	u64 mallocs = div64_u64(desc_allocs * 1000, pkts);
+
+	seq_printf(s, "%-12s %10llu.%03llu %14llu %11llu.%03llu\n", name,
+		   div_u64(ps, 1000), ps % 1000,
+		   ns ? div64_u64(res->pkts * NSEC_PER_SEC, ns) : 0,
+		   div_u64(mallocs, 1000), mallocs % 1000);
+}
+
+static int rmnet_bench_results_show(struct seq_file *s, void *unused)
+{
+	struct rmnet_bench_ctx *ctx = s->private;
+	struct rmnet_bench_result *res = &ctx->result;
+	u64 ns = 0, desc_allocs = 0;
+	int i;
+
+	mutex_lock(&ctx->lock);
+	if (!res->iters) {
+		seq_puts(s, "No results\n");
+		goto out;
+	}
+
+	seq_printf(s, "trace: %s iters: %u bytes: %llu frames: %llu pkts: %llu\n",
+		   rmnet_bench_trace_names[res->trace], res->iters, res->bytes,
+		   res->frames, res->pkts);
+	seq_printf(s, "%-12s %14s %14s %15s\n", "stage", "ns/pkt",
+		   "pkts/sec", "desc allocs/pkt");
+	for (i = 0; i < RMNET_BENCH_STAGE_MAX; i++) {
+		rmnet_bench_show_stage(s, res, rmnet_bench_stage_names[i],
+				       res->stages[i].ns,
+				       res->stages[i].desc_allocs);
+		ns += res->stages[i].ns;
+		desc_allocs += res->stages[i].desc_allocs;
+	}
+
+	rmnet_bench_show_stage(s, res, "total", ns, desc_allocs);
+
+out:
+	mutex_unlock(&ctx->lock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(rmnet_bench_results);
+
+static ssize_t rmnet_bench_run_write(struct file *file,
+				     const char __user *ubuf, size_t count,
+				     loff_t *ppos)
+{
+	struct rmnet_bench_ctx *ctx = file->private_data;
+	char name[16];
+	int trace, rc;
+
+	if (!count || count >= sizeof(name))
+		return -EINVAL;
+
+	if (copy_from_user(name, ubuf, count))
+		return -EFAULT;
+
+	name[count] = '\0';
+	trace = sysfs_match_string(rmnet_bench_trace_names, name);
+	if (trace < 0)
+		return trace;
+
+	mutex_lock(&ctx->lock);
+	rc = rmnet_bench_run(ctx, trace);
+	mutex_unlock(&ctx->lock);
+
+	return rc ? rc : count;
+}
+
+static const struct file_operations rmnet_bench_run_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.write = rmnet_bench_run_write,
+};
+
+static ssize_t rmnet_bench_trace_write(struct file *file,
+				       const char __user *ubuf, size_t count,
+				       loff_t *ppos)
+{
+	struct rmnet_bench_ctx *ctx = file->private_data;
+	ssize_t rc;
+
+	mutex_lock(&ctx->lock);
+	/* Each new write from the start replaces the recorded trace */
+	if (!*ppos)
+		ctx->record_len = 0;
+
+	rc = simple_write_to_buffer(ctx->record, RMNET_BENCH_BUF_MAX, ppos,
+				    ubuf, count);
+	if (rc > 0)
+		ctx->record_len = max_t(u32, ctx->record_len, *ppos);
+	mutex_unlock(&ctx->lock);
+
+	return rc;
+}
+
+static const struct file_operations rmnet_bench_trace_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.write = rmnet_bench_trace_write,
+};
+
+static void rmnet_bench_dev_setup(struct net_device *dev)
+{
+	dev->features |= NETIF_F_RXCSUM;
+}
+
+static void rmnet_bench_free(struct rmnet_bench_ctx *ctx)
+{
+	int i;
+
+	debugfs_remove_recursive(ctx->dir);
+	ctx->dir = NULL;
+
+	for (i = 0; i < RMNET_BENCH_MAX_PAGES; i++) {
+		if (ctx->pages[i])
+			__free_pages(ctx->pages[i], RMNET_BENCH_PAGE_ORDER);
+		ctx->pages[i] = NULL;
+	}
+
+	if (ctx->port) {
+		rmnet_descriptor_deinit(ctx->port);
+		kfree(ctx->port);
+		ctx->port = NULL;
+	}
+
+	if (ctx->dev) {
+		free_netdev(ctx->dev);
+		ctx->dev = NULL;
+	}
+
+	vfree(ctx->buf);
+	ctx->buf = NULL;
+	vfree(ctx->record);
+	ctx->record = NULL;
+}
+
+int rmnet_bench_init(void)
+{
+	struct rmnet_bench_ctx *ctx = &rmnet_bench;
+	int rc;
+
+	mutex_init(&ctx->lock);
+	ctx->iters = RMNET_BENCH_DFLT_ITERS;
+	ctx->data_format = RMNET_FLAGS_INGRESS_COALESCE |
+			   RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5;
+
+	ctx->buf = vzalloc(RMNET_BENCH_BUF_MAX);
+	ctx->record = vzalloc(RMNET_BENCH_BUF_MAX);
+	ctx->port = kzalloc(sizeof(*ctx->port), GFP_KERNEL);
+	ctx->dev = alloc_netdev(sizeof(struct rmnet_priv), "rmnet_bench",
+				NET_NAME_UNKNOWN, rmnet_bench_dev_setup);
+	if (!ctx->buf || !ctx->record || !ctx->port || !ctx->dev) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	rc = rmnet_descriptor_init(ctx->port);
+	if (rc)
+		goto err;
+
+	ctx->dir = debugfs_create_dir("rmnet_bench", NULL);
+	if (IS_ERR_OR_NULL(ctx->dir)) {
+		rc = -ENODEV;
+		goto err;
+	}
+
+	debugfs_create_u32("iters", 0644, ctx->dir, &ctx->iters);
+	debugfs_create_x32("data_format", 0644, ctx->dir, &ctx->data_format);
+	debugfs_create_bool("gro", 0644, ctx->dir, &ctx->gro);
+	debugfs_create_bool("csum_err", 0644, ctx->dir, &ctx->csum_err);
+	debugfs_create_file("trace", 0200, ctx->dir, ctx,
+			    &rmnet_bench_trace_fops);
+	debugfs_create_file("run", 0200, ctx->dir, ctx,
+			    &rmnet_bench_run_fops);
+	debugfs_create_file("results", 0444, ctx->dir, ctx,
+			    &rmnet_bench_results_fops);
+	return 0;
+
+err:
+	rmnet_bench_free(ctx);
+	return rc;
+}
+
+void rmnet_bench_exit(void)
+{
+	rmnet_bench_free(&rmnet_bench);
+}
@@ -28,6 +28,7 @@
 #include "rmnet_genl.h"
 #include "rmnet_qmi.h"
 #include "qmi_rmnet.h"
+#include "rmnet_bench.h"
 #define CONFIG_QTI_QMI_RMNET 1
 #define CONFIG_QTI_QMI_DFC  1
 #define CONFIG_QTI_QMI_POWER_COLLAPSE 1
@@ -871,6 +872,7 @@ static int __init rmnet_init(void)
 	}
 
 	rmnet_core_genl_init();
+	rmnet_bench_init();
 
 	try_module_get(THIS_MODULE);
 	return rc;
@@ -882,6 +884,7 @@ static void __exit rmnet_exit(void)
 	rtnl_link_unregister(&rmnet_link_ops);
 	rmnet_ll_exit();
 	rmnet_core_genl_deinit();
+	rmnet_bench_exit();
 
 	module_put(THIS_MODULE);
 }
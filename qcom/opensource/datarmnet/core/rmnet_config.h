@@ -59,6 +59,12 @@ struct rmnet_agg_stats {
 	u64 ul_agg_alloc;
 };
 
+struct rmnet_agg_ring_stats {
+	u64 ul_agg_miss;
+	u64 ul_agg_grow;
+	u64 ul_agg_shrink;
+};
+
 struct rmnet_port_priv_stats {
 	u64 dl_hdr_last_qmap_vers;
 	u64 dl_hdr_last_ep_id;
@@ -78,6 +84,8 @@ struct rmnet_port_priv_stats {
 	u64 dl_frag_stat[5];
 	u64 pb_marker_count;
 	u64 pb_marker_seq;
+	u64 dl_rx_list_stat[5];
+	struct rmnet_agg_ring_stats agg_ring;
 };
 
 struct rmnet_egress_agg_params {
@@ -106,9 +114,17 @@ struct rmnet_aggregation_state {
 	int agg_state;
 	u8 agg_count;
 	u8 agg_size_order;
+	/* Pages owned only by the ring, ready to be handed out */
 	struct list_head agg_list;
-	struct rmnet_agg_page *agg_head;
+	/* Pages handed to the stack, oldest first */
+	struct list_head agg_inflight;
 	struct rmnet_agg_stats *stats;
+	struct rmnet_agg_ring_stats *ring_stats;
+	u16 agg_pages;
+	u16 agg_free;
+	u16 agg_target;
+	u16 agg_window;
+	u16 agg_window_miss;
 };
 
 
@@ -54,31 +54,112 @@ typedef void (*rmnet_perf_tether_ingress_hook_t)(struct tcphdr *tp, struct sk_bu
 rmnet_perf_tether_ingress_hook_t rmnet_perf_tether_ingress_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_ingress_hook);
 
-struct rmnet_frag_descriptor *
-rmnet_get_frag_descriptor(struct rmnet_port *port)
+static struct rmnet_fragment *
+rmnet_frag_alloc(struct rmnet_frag_descriptor *frag_desc)
+{
+	unsigned long avail;
+	struct rmnet_fragment *frag;
+
+	avail = ~frag_desc->inline_frags_used &
+		GENMASK(RMNET_FRAG_DESC_INLINE_FRAGS - 1, 0);
+	if (likely(avail)) {
+		unsigned long i = __ffs(avail);
+
+		frag_desc->inline_frags_used |= BIT(i);
+		frag = &frag_desc->inline_frags[i];
+		memset(frag, 0, sizeof(*frag));
+		return frag;
+	}
+
+	/* Out of inline space. Fall back to the allocator */
+	return kzalloc(sizeof(*frag), GFP_ATOMIC);
+}
+
+static void rmnet_frag_free(struct rmnet_frag_descriptor *frag_desc,
+			    struct rmnet_fragment *frag)
+{
+	if (frag >= frag_desc->inline_frags &&
+	    frag < frag_desc->inline_frags + RMNET_FRAG_DESC_INLINE_FRAGS) {
+		frag_desc->inline_frags_used &=
+			~BIT(frag - frag_desc->inline_frags);
+		return;
+	}
+
+	kfree(frag);
+}
+
+/* Move a batch of free descriptors from the shared pool into the per-CPU
+ * cache. Must be called with interrupts disabled and desc_pool_lock held.
+ */
+static void rmnet_frag_desc_cache_refill(struct rmnet_frag_descriptor_pool *pool,
+					 struct rmnet_frag_desc_cache *cache)
 {
-	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
 	struct rmnet_frag_descriptor *frag_desc;
-	unsigned long flags;
 
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	if (!list_empty(&pool->free_list)) {
+	while (cache->count < RMNET_FRAG_DESC_CACHE_BATCH &&
+	       !list_empty(&pool->free_list)) {
 		frag_desc = list_first_entry(&pool->free_list,
 					     struct rmnet_frag_descriptor,
 					     list);
 		list_del_init(&frag_desc->list);
-	} else {
-		frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
-		if (!frag_desc)
-			goto out;
+		cache->stack[cache->count++] = frag_desc;
+	}
+}
 
+/* Return up to 'count' descriptors from the per-CPU cache to the shared pool.
+ * Must be called with interrupts disabled and desc_pool_lock held.
+ */
+static void rmnet_frag_desc_cache_drain(struct rmnet_frag_descriptor_pool *pool,
+					struct rmnet_frag_desc_cache *cache,
+					u32 count)
+{
+	while (count-- && cache->count)
+		list_add_tail(&cache->stack[--cache->count]->list,
+			      &pool->free_list);
+}
+
+struct rmnet_frag_descriptor *
+rmnet_get_frag_descriptor(struct rmnet_port *port)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	struct rmnet_frag_descriptor *frag_desc = NULL;
+	struct rmnet_frag_desc_cache *cache;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	cache = this_cpu_ptr(pool->pcpu_cache);
+	if (likely(cache->count)) {
+		cache->stats.hit++;
+		goto out;
+	}
+
+	/* Per-CPU cache is empty. Refill from the shared pool, and allocate
+	 * a new descriptor if that is empty too.
+	 */
+	cache->stats.miss++;
+	spin_lock(&port->desc_pool_lock);
+	rmnet_frag_desc_cache_refill(pool, cache);
+	if (cache->count) {
+		spin_unlock(&port->desc_pool_lock);
+		cache->stats.refill++;
+		goto out;
+	}
+
+	frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
+	if (frag_desc) {
 		INIT_LIST_HEAD(&frag_desc->list);
 		INIT_LIST_HEAD(&frag_desc->frags);
 		pool->pool_size++;
+		cache->stats.alloc++;
 	}
 
+	spin_unlock(&port->desc_pool_lock);
+	local_irq_restore(flags);
+	return frag_desc;
+
 out:
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
+	frag_desc = cache->stack[--cache->count];
+	local_irq_restore(flags);
 	return frag_desc;
 }
 EXPORT_SYMBOL(rmnet_get_frag_descriptor);
@@ -87,6 +168,7 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 				   struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	struct rmnet_frag_desc_cache *cache;
 	struct rmnet_fragment *frag, *tmp;
 	unsigned long flags;
 
@@ -99,15 +181,26 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 			put_page(page);
 
 		list_del(&frag->list);
-		kfree(frag);
+		rmnet_frag_free(frag_desc, frag);
 	}
 
 	memset(frag_desc, 0, sizeof(*frag_desc));
 	INIT_LIST_HEAD(&frag_desc->list);
 	INIT_LIST_HEAD(&frag_desc->frags);
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	list_add_tail(&frag_desc->list, &pool->free_list);
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
+
+	local_irq_save(flags);
+	cache = this_cpu_ptr(pool->pcpu_cache);
+	if (unlikely(cache->count == RMNET_FRAG_DESC_CACHE_SIZE)) {
+		/* Cache is full. Hand half of it back to the shared pool */
+		spin_lock(&port->desc_pool_lock);
+		rmnet_frag_desc_cache_drain(pool, cache,
+					    RMNET_FRAG_DESC_CACHE_BATCH);
+		spin_unlock(&port->desc_pool_lock);
+		cache->stats.drain++;
+	}
+
+	cache->stack[cache->count++] = frag_desc;
+	local_irq_restore(flags);
 }
 EXPORT_SYMBOL(rmnet_recycle_frag_descriptor);
 
@@ -139,7 +232,7 @@ void *rmnet_frag_pull(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			size -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -189,7 +282,7 @@ void *rmnet_frag_trim(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			eat -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -283,7 +376,7 @@ int rmnet_frag_descriptor_add_frag(struct rmnet_frag_descriptor *frag_desc,
 {
 	struct rmnet_fragment *frag;
 
-	frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+	frag = rmnet_frag_alloc(frag_desc);
 	if (!frag)
 		return -ENOMEM;
 
@@ -1034,8 +1127,18 @@ skip_frags:
 		}
 
 		*check = pseudo;
-		csum = skb_checksum(head_skb, offset, head_skb->len - offset,
-				    0);
+		if (frag_desc->data_csum_set) {
+			/* The payload was already summed when the coalesced
+			 * frame was segmented. Only add in the header.
+			 */
+			csum = csum_partial(skb_transport_header(head_skb),
+					    frag_desc->trans_len, 0);
+			csum = csum_block_add(csum, frag_desc->data_csum,
+					      frag_desc->trans_len);
+		} else {
+			csum = skb_checksum(head_skb, offset,
+					    head_skb->len - offset, 0);
+		}
 		/* Add 1 to corrupt. This cannot produce a final value of 0
 		 * since csum_fold() can't return a value of 0xFFFF
 		 */
@@ -1142,7 +1245,7 @@ EXPORT_SYMBOL(rmnet_frag_deliver);
 static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 				      struct rmnet_port *port,
 				      struct list_head *list, u8 pkt_id,
-				      bool csum_valid)
+				      bool csum_valid, __wsum *data_csum)
 {
 	struct rmnet_priv *priv = netdev_priv(coal_desc->dev);
 	struct rmnet_frag_descriptor *new_desc;
@@ -1155,10 +1258,14 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 	if (!new_desc)
 		return;
 
-	/* Header information and most metadata is the same as the original */
-	memcpy(new_desc, coal_desc, sizeof(*coal_desc));
+	/* Header information and most metadata is the same as the original.
+	 * The inline fragment storage belongs to the new descriptor.
+	 */
+	memcpy(new_desc, coal_desc,
+	       offsetof(struct rmnet_frag_descriptor, inline_frags_used));
 	INIT_LIST_HEAD(&new_desc->list);
 	INIT_LIST_HEAD(&new_desc->frags);
+	new_desc->inline_frags_used = 0;
 	new_desc->len = 0;
 
 	/* Add the header fragments */
@@ -1228,6 +1335,12 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 	}
 
 	new_desc->csum_valid = csum_valid;
+	new_desc->data_csum_set = 0;
+	if (!csum_valid && data_csum) {
+		new_desc->data_csum = *data_csum;
+		new_desc->data_csum_set = 1;
+	}
+
 	priv->stats.coal.coal_reconstruct++;
 
 	/* Update meta information to move past the data we just segmented */
@@ -1280,6 +1393,77 @@ static bool rmnet_frag_validate_csum(struct rmnet_frag_descriptor *frag_desc)
 	return !csum_fold(csum);
 }
 
+/* Sum the payload of every packet flagged by nlo_err_mask in a single pass
+ * over the coalesced frame. The per-packet sums let each bad segment build
+ * its transport checksum without walking its payload again.
+ */
+static bool
+rmnet_frag_coal_csum_payloads(struct rmnet_frag_descriptor *coal_desc,
+			      struct rmnet_map_v5_coal_header *coal_hdr,
+			      u64 nlo_err_mask, __wsum *pkt_csum)
+{
+	u32 hlen = coal_desc->ip_len + coal_desc->trans_len;
+	struct rmnet_fragment *frag;
+	u32 skip = hlen, remaining = 0, done = 0;
+	u8 nlo = 0, pkt = 0, total_pkt = 0, num_pkts = 0;
+	__wsum csum = 0;
+
+	for (nlo = 0; nlo < coal_hdr->num_nlos; nlo++)
+		num_pkts += coal_hdr->nl_pairs[nlo].num_packets;
+
+	nlo = 0;
+	rmnet_descriptor_for_each_frag(frag, coal_desc) {
+		u8 *addr = skb_frag_address(&frag->frag);
+		u32 size = skb_frag_size(&frag->frag);
+
+		if (skip >= size) {
+			skip -= size;
+			continue;
+		}
+
+		addr += skip;
+		size -= skip;
+		skip = 0;
+
+		while (size && total_pkt < num_pkts) {
+			u32 len;
+
+			/* Move on to the next packet */
+			if (!remaining) {
+				while (pkt >= coal_hdr->nl_pairs[nlo].num_packets) {
+					nlo++;
+					pkt = 0;
+				}
+
+				remaining = ntohs(coal_hdr->nl_pairs[nlo].pkt_len);
+				if (remaining <= hlen)
+					return false;
+
+				remaining -= hlen;
+				csum = 0;
+				done = 0;
+			}
+
+			len = min_t(u32, size, remaining);
+			if (nlo_err_mask & BIT_ULL(total_pkt))
+				csum = csum_block_add(csum,
+						      csum_partial(addr, len, 0),
+						      done);
+
+			addr += len;
+			size -= len;
+			done += len;
+			remaining -= len;
+			if (!remaining) {
+				pkt_csum[total_pkt++] = csum;
+				pkt++;
+			}
+		}
+	}
+
+	return total_pkt == num_pkts;
+}
+
 /* Converts the coalesced frame into a list of descriptors */
 static void
 rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
@@ -1288,6 +1472,8 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 {
 	struct rmnet_priv *priv = netdev_priv(coal_desc->dev);
 	struct rmnet_map_v5_coal_header coal_hdr;
+	__wsum pkt_csum[RMNET_MAP_V5_MAX_PACKETS];
+	__wsum *csums = NULL;
 	struct rmnet_fragment *frag;
 	u8 *version;
 	u16 pkt_len;
@@ -1445,6 +1631,12 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		return;
 	}
 
+	/* Checksum the payload of all bad packets up front in one pass */
+	if (nlo_err_mask &&
+	    rmnet_frag_coal_csum_payloads(coal_desc, &coal_hdr, nlo_err_mask,
+					  pkt_csum))
+		csums = pkt_csum;
+
 	/* Segment the coalesced descriptor into new packets */
 	for (nlo = 0; nlo < coal_hdr.num_nlos; nlo++) {
 		pkt_len = ntohs(coal_hdr.nl_pairs[nlo].pkt_len);
@@ -1464,7 +1656,10 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 
 				__rmnet_frag_segment_data(coal_desc, port,
 							  list, total_pkt,
-							  !csum_err);
+							  !csum_err,
+							  csums ?
+							  &csums[total_pkt] :
+							  NULL);
 				continue;
 			}
 
@@ -1477,13 +1672,16 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 								  port,
 								  list,
 								  total_pkt,
-								  true);
+								  true, NULL);
 
 				/* Segment out the bad checksum */
 				coal_desc->gso_segs = 1;
 				__rmnet_frag_segment_data(coal_desc, port,
 							  list, total_pkt,
-							  false);
+							  false,
+							  csums ?
+							  &csums[total_pkt] :
+							  NULL);
 			} else {
 				coal_desc->gso_segs++;
 			}
@@ -1495,7 +1693,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		 */
 		if (coal_desc->gso_segs)
 			__rmnet_frag_segment_data(coal_desc, port, list,
-						  total_pkt, true);
+						  total_pkt, true, NULL);
 	}
 }
 
@@ -2014,13 +2212,64 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 	rcu_read_unlock();
 }
 
+int rmnet_descriptor_get_stats(struct rmnet_port *port, u64 *s, int n)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	struct rmnet_frag_desc_cache_stats total = {};
+	int cpu;
+
+	if (!pool || !pool->pcpu_cache || n <= 0)
+		return 0;
+
+	for_each_possible_cpu(cpu) {
+		struct rmnet_frag_desc_cache *cache;
+
+		cache = per_cpu_ptr(pool->pcpu_cache, cpu);
+		total.hit += cache->stats.hit;
+		total.miss += cache->stats.miss;
+		total.refill += cache->stats.refill;
+		total.drain += cache->stats.drain;
+		total.alloc += cache->stats.alloc;
+	}
+
+	n = min(n, (int)(sizeof(total) / sizeof(u64)));
+	memcpy(s, &total, n * sizeof(u64));
+	return n;
+}
+
+void rmnet_descriptor_reset_stats(struct rmnet_port *port)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	int cpu;
+
+	if (!pool || !pool->pcpu_cache)
+		return;
+
+	for_each_possible_cpu(cpu)
+		memset(&per_cpu_ptr(pool->pcpu_cache, cpu)->stats, 0,
+		       sizeof(struct rmnet_frag_desc_cache_stats));
+}
+
 void rmnet_descriptor_deinit(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool;
 	struct rmnet_frag_descriptor *frag_desc, *tmp;
+	int cpu;
 
 	pool = port->frag_desc_pool;
 	if (pool) {
+		if (pool->pcpu_cache) {
+			for_each_possible_cpu(cpu) {
+				struct rmnet_frag_desc_cache *cache;
+
+				cache = per_cpu_ptr(pool->pcpu_cache, cpu);
+				rmnet_frag_desc_cache_drain(pool, cache,
+							    cache->count);
+			}
+
+			free_percpu(pool->pcpu_cache);
+		}
+
 		list_for_each_entry_safe(frag_desc, tmp, &pool->free_list, list) {
 			kfree(frag_desc);
 			pool->pool_size--;
@@ -2044,6 +2293,10 @@ int rmnet_descriptor_init(struct rmnet_port *port)
 	INIT_LIST_HEAD(&pool->free_list);
 	port->frag_desc_pool = pool;
 
+	pool->pcpu_cache = alloc_percpu(struct rmnet_frag_desc_cache);
+	if (!pool->pcpu_cache)
+		return -ENOMEM;
+
 	for (i = 0; i < RMNET_FRAG_DESCRIPTOR_POOL_SIZE; i++) {
 		struct rmnet_frag_descriptor *frag_desc;
 
@@ -23,9 +23,30 @@
 #include "rmnet_config.h"
 #include "rmnet_map.h"
 
+/* Per-CPU descriptor cache sizing. Each CPU keeps a bounded stack of free
+ * descriptors and exchanges them with the shared pool in batches.
+ */
+#define RMNET_FRAG_DESC_CACHE_SIZE 64
+#define RMNET_FRAG_DESC_CACHE_BATCH (RMNET_FRAG_DESC_CACHE_SIZE / 2)
+
+struct rmnet_frag_desc_cache_stats {
+	u64 hit;
+	u64 miss;
+	u64 refill;
+	u64 drain;
+	u64 alloc;
+};
+
+struct rmnet_frag_desc_cache {
+	struct rmnet_frag_descriptor *stack[RMNET_FRAG_DESC_CACHE_SIZE];
+	u32 count;
+	struct rmnet_frag_desc_cache_stats stats;
+};
+
 struct rmnet_frag_descriptor_pool {
 	struct list_head free_list;
 	u32 pool_size;
+	struct rmnet_frag_desc_cache __percpu *pcpu_cache;
 };
 
 struct rmnet_fragment {
@@ -33,6 +54,11 @@ struct rmnet_fragment {
 	skb_frag_t frag;
 };
 
+/* Fragments stored directly in the descriptor. Most packets fit in these, so
+ * only larger ones need to allocate additional rmnet_fragment entries.
+ */
+#define RMNET_FRAG_DESC_INLINE_FRAGS 3
+
 struct rmnet_frag_descriptor {
 	struct list_head list;
 	struct list_head frags;
@@ -43,6 +69,7 @@ struct rmnet_frag_descriptor {
 	u32 hash;
 	u32 priority;
 	__be32 tcp_seq;
+	__wsum data_csum;
 	__be16 ip_id;
 	__be16 tcp_flags;
 	u16 data_offset;
@@ -59,7 +86,10 @@ struct rmnet_frag_descriptor {
 	   tcp_seq_set:1,
 	   flush_shs:1,
 	   tcp_flags_set:1,
-	   reserved:2;
+	   data_csum_set:1,
+	   reserved:1;
+	u8 inline_frags_used;
+	struct rmnet_fragment inline_frags[RMNET_FRAG_DESC_INLINE_FRAGS];
 };
 
 /* Descriptor management */
@@ -100,6 +130,8 @@ int rmnet_frag_process_next_hdr_packet(struct rmnet_frag_descriptor *frag_desc,
 void rmnet_frag_ingress_handler(struct sk_buff *skb,
 				struct rmnet_port *port);
 
+int rmnet_descriptor_get_stats(struct rmnet_port *port, u64 *s, int n);
+void rmnet_descriptor_reset_stats(struct rmnet_port *port);
 int rmnet_descriptor_init(struct rmnet_port *port);
 void rmnet_descriptor_deinit(struct rmnet_port *port);
 
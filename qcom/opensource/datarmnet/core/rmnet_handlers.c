@@ -107,6 +107,75 @@ int (*rmnet_shs_skb_entry_wq)(struct sk_buff *skb,
 			      struct rmnet_shs_clnt_s *cfg) __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_shs_skb_entry_wq);
 
+/* Packets delivered during one ingress pass when RMNET_INGRESS_FORMAT_RX_LIST
+ * is set. They are handed to the stack together with netif_receive_skb_list()
+ * once the pass completes.
+ */
+struct rmnet_rx_batch {
+	struct list_head list;
+	u32 count;
+	u32 depth;
+};
+
+static DEFINE_PER_CPU(struct rmnet_rx_batch, rmnet_rx_batch);
+
+static void rmnet_rx_batch_classify(u32 count, struct rmnet_port *port)
+{
+	u32 index = min_t(u32, ilog2(count), 4);
+
+	port->stats.dl_rx_list_stat[index]++;
+}
+
+/* Must be paired with rmnet_rx_batch_end() on the same CPU, BHs disabled */
+void rmnet_rx_batch_begin(struct rmnet_port *port)
+{
+	struct rmnet_rx_batch *batch;
+
+	if (!(port->data_format & RMNET_INGRESS_FORMAT_RX_LIST))
+		return;
+
+	batch = this_cpu_ptr(&rmnet_rx_batch);
+	if (!batch->depth++) {
+		INIT_LIST_HEAD(&batch->list);
+		batch->count = 0;
+	}
+}
+EXPORT_SYMBOL(rmnet_rx_batch_begin);
+
+void rmnet_rx_batch_end(struct rmnet_port *port)
+{
+	struct rmnet_rx_batch *batch = this_cpu_ptr(&rmnet_rx_batch);
+	LIST_HEAD(list);
+
+	if (!batch->depth || --batch->depth)
+		return;
+
+	if (!batch->count)
+		return;
+
+	/* The stack may re-enter rmnet, so detach the batch first */
+	rmnet_rx_batch_classify(batch->count, port);
+	list_splice_init(&batch->list, &list);
+	batch->count = 0;
+	netif_receive_skb_list(&list);
+}
+EXPORT_SYMBOL(rmnet_rx_batch_end);
+
+/* Joins the current batch of this CPU if one is open */
+void rmnet_rx_batch_receive(struct sk_buff *skb)
+{
+	struct rmnet_rx_batch *batch = this_cpu_ptr(&rmnet_rx_batch);
+
+	if (batch->depth) {
+		list_add_tail(&skb->list, &batch->list);
+		batch->count++;
+		return;
+	}
+
+	netif_receive_skb(skb);
+}
+EXPORT_SYMBOL(rmnet_rx_batch_receive);
+
 /* Generic handler */
 
 void
@@ -140,7 +209,7 @@ skip_shs:
 	if (rmnet_module_hook_shs_skb_ll_entry(NULL, skb, &port->shs_cfg))
 		return;
 
-	netif_receive_skb(skb);
+	rmnet_rx_batch_receive(skb);
 }
 EXPORT_SYMBOL(rmnet_deliver_skb);
 
@@ -176,7 +245,7 @@ rmnet_deliver_skb_wq(struct sk_buff *skb, struct rmnet_port *port,
 	rcu_read_unlock();
 
 	if (ctx == RMNET_NET_RX_CTX)
-		netif_receive_skb(skb);
+		rmnet_rx_batch_receive(skb);
 	else
 		gro_cells_receive(&priv->gro_cells, skb);
 }
@@ -469,7 +538,9 @@ rx_handler_result_t rmnet_rx_handler(struct sk_buff **pskb)
 		}
 		rcu_read_unlock();
 
+		rmnet_rx_batch_begin(port);
 		rmnet_map_ingress_handler(skb, port);
+		rmnet_rx_batch_end(port);
 		break;
 	case RMNET_EPMODE_BRIDGE:
 		rmnet_bridge_handler(skb, port->bridge_ep);
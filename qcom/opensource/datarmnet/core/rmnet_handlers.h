@@ -28,6 +28,9 @@ void rmnet_egress_handler(struct sk_buff *skb, bool low_latency);
 void rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port);
 void rmnet_deliver_skb_wq(struct sk_buff *skb, struct rmnet_port *port,
 			  enum rmnet_packet_context ctx);
+void rmnet_rx_batch_begin(struct rmnet_port *port);
+void rmnet_rx_batch_end(struct rmnet_port *port);
+void rmnet_rx_batch_receive(struct sk_buff *skb);
 void rmnet_set_skb_proto(struct sk_buff *skb);
 bool rmnet_slow_start_on(u32 hash_key);
 rx_handler_result_t _rmnet_map_ingress_handler(struct sk_buff *skb,
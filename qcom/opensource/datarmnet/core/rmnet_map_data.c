@@ -24,11 +24,21 @@
 #include "rmnet_handlers.h"
 #include "rmnet_ll.h"
 #include "rmnet_mem.h"
+#include "rmnet_trace.h"
 
 #define RMNET_MAP_PKT_COPY_THRESHOLD 64
 #define RMNET_MAP_DEAGGR_SPACING  64
 #define RMNET_MAP_DEAGGR_HEADROOM (RMNET_MAP_DEAGGR_SPACING / 2)
 #define RMNET_PAGE_COUNT 384
+#define RMNET_PAGE_COUNT_MIN 64
+#define RMNET_PAGE_COUNT_MAX 1024
+#define RMNET_PAGE_RESIZE_STEP 32
+#define RMNET_PAGE_RECLAIM_BUDGET 8
+/* Resize decisions are made every RMNET_PAGE_WINDOW page requests. The ring
+ * grows when more than 1 in RMNET_PAGE_GROW_RATIO requests missed.
+ */
+#define RMNET_PAGE_WINDOW 256
+#define RMNET_PAGE_GROW_RATIO 16
 
 struct rmnet_map_coal_metadata {
 	void *ip_header;
@@ -1338,37 +1348,141 @@ static void rmnet_free_agg_pages(struct rmnet_aggregation_state *state)
 		kfree(agg_page);
 	}
 
-	state->agg_head = NULL;
+	/* Pages still held by the stack are released by their last user */
+	list_for_each_entry_safe(agg_page, idx, &state->agg_inflight, list) {
+		list_del(&agg_page->list);
+		rmnet_mem_put_page_entry(agg_page->page);
+		kfree(agg_page);
+	}
+
+	state->agg_pages = 0;
+	state->agg_free = 0;
+	state->agg_window = 0;
+	state->agg_window_miss = 0;
+}
+
+static void rmnet_release_agg_page(struct rmnet_aggregation_state *state,
+				   struct rmnet_agg_page *agg_page)
+{
+	list_del(&agg_page->list);
+	rmnet_mem_put_page_entry(agg_page->page);
+	kfree(agg_page);
+	state->agg_pages--;
+}
+
+/* Move pages the stack has finished with back to the free list. Pages are
+ * handed out in order and usually complete in order, so only the oldest
+ * in-flight pages are checked. A page that is still busy is rotated to the
+ * tail so that a single held skb cannot block reclaim of the pages behind it.
+ */
+static void rmnet_reclaim_agg_pages(struct rmnet_aggregation_state *state)
+{
+	struct rmnet_agg_page *agg_page;
+	int budget = RMNET_PAGE_RECLAIM_BUDGET;
+
+	while (budget--) {
+		agg_page = list_first_entry_or_null(&state->agg_inflight,
+						    struct rmnet_agg_page, list);
+		if (!agg_page)
+			break;
+
+		if (page_ref_count(agg_page->page) != 1) {
+			list_move_tail(&agg_page->list, &state->agg_inflight);
+			break;
+		}
+
+		/* Ring is larger than it needs to be. Give the page back */
+		if (state->agg_pages > state->agg_target) {
+			rmnet_release_agg_page(state, agg_page);
+			continue;
+		}
+
+		list_move_tail(&agg_page->list, &state->agg_list);
+		state->agg_free++;
+	}
+}
+
+/* Resize the ring once per sampling window based on the reuse miss rate.
+ * Growth happens lazily as pages allocated on a miss are adopted by the
+ * ring, while shrinking trims the free list right away.
+ */
+static void rmnet_adapt_agg_pages(struct rmnet_aggregation_state *state)
+{
+	struct rmnet_agg_page *agg_page;
+	u16 miss = state->agg_window_miss;
+
+	state->agg_window = 0;
+	state->agg_window_miss = 0;
+
+	if (miss * RMNET_PAGE_GROW_RATIO >= RMNET_PAGE_WINDOW) {
+		if (state->agg_target >= RMNET_PAGE_COUNT_MAX)
+			return;
+
+		state->agg_target = min_t(u16, RMNET_PAGE_COUNT_MAX,
+					  state->agg_target +
+					  RMNET_PAGE_RESIZE_STEP);
+		state->ring_stats->ul_agg_grow++;
+		trace_rmnet_ul_agg_grow(state, state->agg_pages,
+					state->agg_free, state->agg_target);
+		return;
+	}
+
+	/* Only shrink once a whole window was served from the ring and a
+	 * good part of it was left idle.
+	 */
+	if (miss || state->agg_free < state->agg_target / 2 ||
+	    state->agg_target <= RMNET_PAGE_COUNT_MIN)
+		return;
+
+	state->agg_target = max_t(u16, RMNET_PAGE_COUNT_MIN,
+				  state->agg_target - RMNET_PAGE_RESIZE_STEP);
+	while (state->agg_pages > state->agg_target && state->agg_free) {
+		agg_page = list_first_entry(&state->agg_list,
+					    struct rmnet_agg_page, list);
+		rmnet_release_agg_page(state, agg_page);
+		state->agg_free--;
+	}
+
+	state->ring_stats->ul_agg_shrink++;
+	trace_rmnet_ul_agg_shrink(state, state->agg_pages, state->agg_free,
+				  state->agg_target);
 }
 
 static struct page *rmnet_get_agg_pages(struct rmnet_aggregation_state *state)
 {
 	struct rmnet_agg_page *agg_page;
 	struct page *page = NULL;
-	int i = 0;
+	bool recycle;
 	int rc;
 	int pageorder = 2;
 
-	if (!(state->params.agg_features & RMNET_PAGE_RECYCLE))
+	recycle = (state->params.agg_features & RMNET_PAGE_RECYCLE) &&
+		  state->agg_target;
+	if (!recycle)
 		goto alloc;
 
-	do {
-		agg_page = state->agg_head;
-		if (unlikely(!agg_page))
-			break;
+	rmnet_reclaim_agg_pages(state);
 
-		if (page_ref_count(agg_page->page) == 1) {
-			page = agg_page->page;
-			page_ref_inc(agg_page->page);
+	agg_page = list_first_entry_or_null(&state->agg_list,
+					    struct rmnet_agg_page, list);
+	if (agg_page) {
+		page = agg_page->page;
+		page_ref_inc(page);
+		list_move_tail(&agg_page->list, &state->agg_inflight);
+		state->agg_free--;
 
-			state->stats->ul_agg_reuse++;
-			state->agg_head = list_next_entry(agg_page, list);
-			break;
-		}
+		state->stats->ul_agg_reuse++;
+		trace_rmnet_ul_agg_reuse(state, state->agg_pages,
+					 state->agg_free, state->agg_target);
+	} else {
+		state->agg_window_miss++;
+		state->ring_stats->ul_agg_miss++;
+		trace_rmnet_ul_agg_miss(state, state->agg_pages,
+					state->agg_free, state->agg_target);
+	}
 
-		state->agg_head = list_next_entry(agg_page, list);
-		i++;
-	} while (i <= 5);
+	if (++state->agg_window >= RMNET_PAGE_WINDOW)
+		rmnet_adapt_agg_pages(state);
 
 alloc:
 	if (!page) {
@@ -1376,6 +1490,21 @@ alloc:
 						 &pageorder, RMNET_CORE_ID);
 
 		state->stats->ul_agg_alloc++;
+
+		/* Adopt the new page into the ring while it is below its
+		 * target size. The ring keeps its own reference so the page
+		 * comes back to it once the stack is done with it.
+		 */
+		if (page && recycle && state->agg_pages < state->agg_target) {
+			agg_page = kzalloc(sizeof(*agg_page), GFP_ATOMIC);
+			if (agg_page) {
+				agg_page->page = page;
+				page_ref_inc(page);
+				list_add_tail(&agg_page->list,
+					      &state->agg_inflight);
+				state->agg_pages++;
+			}
+		}
 	}
 
 	return page;
@@ -1412,15 +1541,17 @@ static void rmnet_alloc_agg_pages(struct rmnet_aggregation_state *state)
 	struct rmnet_agg_page *agg_page = NULL;
 	int i = 0;
 
+	state->agg_target = RMNET_PAGE_COUNT;
+
 	for (i = 0; i < RMNET_PAGE_COUNT; i++) {
 		agg_page = __rmnet_alloc_agg_pages(state);
 
-		if (agg_page)
+		if (agg_page) {
 			list_add_tail(&agg_page->list, &state->agg_list);
+			state->agg_pages++;
+			state->agg_free++;
+		}
 	}
-
-	state->agg_head = list_first_entry_or_null(&state->agg_list,
-						   struct rmnet_agg_page, list);
 }
 
 static struct sk_buff *
@@ -1560,6 +1691,7 @@ void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 	state->params.agg_features = features;
 
 	rmnet_free_agg_pages(state);
+	state->agg_target = 0;
 
 	/* This effectively disables recycling in case the UL aggregation
 	 * size is lesser than PAGE_SIZE.
@@ -1590,11 +1722,13 @@ void rmnet_map_tx_aggregate_init(struct rmnet_port *port)
 
 		spin_lock_init(&state->agg_lock);
 		INIT_LIST_HEAD(&state->agg_list);
+		INIT_LIST_HEAD(&state->agg_inflight);
 		hrtimer_init(&state->hrtimer, CLOCK_MONOTONIC,
 			     HRTIMER_MODE_REL);
 		state->hrtimer.function = rmnet_map_flush_tx_packet_queue;
 		INIT_WORK(&state->agg_wq, rmnet_map_flush_tx_packet_work);
 		state->stats = &port->stats.agg;
+		state->ring_stats = &port->stats.agg_ring;
 
 		/* Since PAGE_SIZE - 1 is specified here, no pages are
 		 * pre-allocated. This is done to reduce memory usage in cases
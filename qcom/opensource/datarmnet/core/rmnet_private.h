@@ -40,6 +40,9 @@ RMNET_INGRESS_FORMAT_DL_MARKER_V2)
 #define RMNET_INGRESS_FORMAT_PS                 BIT(27)
 #define RMNET_FORMAT_PS_NOTIF                   BIT(26)
 
+/* Batched delivery to the network stack */
+#define RMNET_INGRESS_FORMAT_RX_LIST            BIT(25)
+
 /* UL Aggregation parameters */
 #define RMNET_PAGE_RECYCLE                      BIT(0)
 
@@ -491,6 +491,61 @@ TRACE_EVENT
 TP_printk("freq policy update core:%u policy freq floor :%u freq ceil :%u",
 	  __entry->core, __entry->lowfreq, __entry->highfreq)
 );
+
+DECLARE_EVENT_CLASS
+	(rmnet_ul_agg_template,
+
+	 TP_PROTO(void *state, u32 pages, u32 free, u32 target),
+
+	 TP_ARGS(state, pages, free, target),
+
+	 TP_STRUCT__entry(__field(void *, state)
+			  __field(u32, pages)
+			  __field(u32, free)
+			  __field(u32, target)
+	 ),
+
+	 TP_fast_assign(__entry->state = state;
+			__entry->pages = pages;
+			__entry->free = free;
+			__entry->target = target;
+	 ),
+
+TP_printk("state:0x%pK pages:%u free:%u target:%u",
+	  __entry->state, __entry->pages, __entry->free, __entry->target)
+);
+
+DEFINE_EVENT
+	(rmnet_ul_agg_template, rmnet_ul_agg_reuse,
+
+	 TP_PROTO(void *state, u32 pages, u32 free, u32 target),
+
+	 TP_ARGS(state, pages, free, target)
+);
+
+DEFINE_EVENT
+	(rmnet_ul_agg_template, rmnet_ul_agg_miss,
+
+	 TP_PROTO(void *state, u32 pages, u32 free, u32 target),
+
+	 TP_ARGS(state, pages, free, target)
+);
+
+DEFINE_EVENT
+	(rmnet_ul_agg_template, rmnet_ul_agg_grow,
+
+	 TP_PROTO(void *state, u32 pages, u32 free, u32 target),
+
+	 TP_ARGS(state, pages, free, target)
+);
+
+DEFINE_EVENT
+	(rmnet_ul_agg_template, rmnet_ul_agg_shrink,
+
+	 TP_PROTO(void *state, u32 pages, u32 free, u32 target),
+
+	 TP_ARGS(state, pages, free, target)
+);
 #endif /* _TRACE_RMNET_H */
 
 #include <trace/define_trace.h>
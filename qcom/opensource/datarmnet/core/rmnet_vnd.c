@@ -27,6 +27,7 @@
 #include <net/pkt_sched.h>
 #include <net/ipv6.h>
 #include "rmnet_config.h"
+#include "rmnet_descriptor.h"
 #include "rmnet_handlers.h"
 #include "rmnet_private.h"
 #include "rmnet_map.h"
@@ -604,6 +605,28 @@ static const char rmnet_qmap_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"QMAP TX complete (MHI)",
 };
 
+static const char rmnet_desc_gstrings_stats[][ETH_GSTRING_LEN] = {
+	"DL desc cache hits",
+	"DL desc cache misses",
+	"DL desc cache refills",
+	"DL desc cache drains",
+	"DL desc cache allocs",
+};
+
+static const char rmnet_rx_list_gstrings_stats[][ETH_GSTRING_LEN] = {
+	"DL RX list batch = 1",
+	"DL RX list batch [2-3]",
+	"DL RX list batch [4-7]",
+	"DL RX list batch [8-15]",
+	"DL RX list batch >= 16",
+};
+
+static const char rmnet_agg_ring_gstrings_stats[][ETH_GSTRING_LEN] = {
+	"UL agg miss",
+	"UL agg ring grow",
+	"UL agg ring shrink",
+};
+
 static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 {
 	size_t off = 0;
@@ -622,6 +645,15 @@ static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 		off += sizeof(rmnet_ll_gstrings_stats);
 		memcpy(buf + off, &rmnet_qmap_gstrings_stats,
 		       sizeof(rmnet_qmap_gstrings_stats));
+		off += sizeof(rmnet_qmap_gstrings_stats);
+		memcpy(buf + off, &rmnet_desc_gstrings_stats,
+		       sizeof(rmnet_desc_gstrings_stats));
+		off += sizeof(rmnet_desc_gstrings_stats);
+		memcpy(buf + off, &rmnet_rx_list_gstrings_stats,
+		       sizeof(rmnet_rx_list_gstrings_stats));
+		off += sizeof(rmnet_rx_list_gstrings_stats);
+		memcpy(buf + off, &rmnet_agg_ring_gstrings_stats,
+		       sizeof(rmnet_agg_ring_gstrings_stats));
 		break;
 	}
 }
@@ -633,7 +665,10 @@ static int rmnet_get_sset_count(struct net_device *dev, int sset)
 		return ARRAY_SIZE(rmnet_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_port_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_ll_gstrings_stats) +
-		       ARRAY_SIZE(rmnet_qmap_gstrings_stats);
+		       ARRAY_SIZE(rmnet_qmap_gstrings_stats) +
+		       ARRAY_SIZE(rmnet_desc_gstrings_stats) +
+		       ARRAY_SIZE(rmnet_rx_list_gstrings_stats) +
+		       ARRAY_SIZE(rmnet_agg_ring_gstrings_stats);
 	default:
 		return -EOPNOTSUPP;
 	}
@@ -649,6 +684,7 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 	struct rmnet_port *port;
 	size_t off = 0;
 	u64 qmap_s[ARRAY_SIZE(rmnet_qmap_gstrings_stats)];
+	u64 desc_s[ARRAY_SIZE(rmnet_desc_gstrings_stats)];
 
 	port = rmnet_get_port(priv->real_dev);
 
@@ -671,6 +707,20 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 	rmnet_ctl_get_stats(qmap_s, ARRAY_SIZE(rmnet_qmap_gstrings_stats));
 	memcpy(data + off, qmap_s,
 	       ARRAY_SIZE(rmnet_qmap_gstrings_stats) * sizeof(u64));
+
+	off += ARRAY_SIZE(rmnet_qmap_gstrings_stats);
+	memset(desc_s, 0, sizeof(desc_s));
+	rmnet_descriptor_get_stats(port, desc_s,
+				   ARRAY_SIZE(rmnet_desc_gstrings_stats));
+	memcpy(data + off, desc_s, sizeof(desc_s));
+
+	off += ARRAY_SIZE(rmnet_desc_gstrings_stats);
+	memcpy(data + off, stp->dl_rx_list_stat,
+	       ARRAY_SIZE(rmnet_rx_list_gstrings_stats) * sizeof(u64));
+
+	off += ARRAY_SIZE(rmnet_rx_list_gstrings_stats);
+	memcpy(data + off, &stp->agg_ring,
+	       ARRAY_SIZE(rmnet_agg_ring_gstrings_stats) * sizeof(u64));
 }
 
 static int rmnet_stats_reset(struct net_device *dev)
@@ -687,6 +737,7 @@ static int rmnet_stats_reset(struct net_device *dev)
 	stp = &port->stats;
 
 	memset(stp, 0, sizeof(*stp));
+	rmnet_descriptor_reset_stats(port);
 
 	st = &priv->stats;
 
@@ -73,6 +73,14 @@ def define_modules(target, variant):
             "core/rmnet_qmap.c",
             "core/rmnet_ll_qmap.c",
         ],
+        kconfig = "core/Kconfig",
+        conditional_srcs = {
+            "CONFIG_RMNET_BENCH": {
+                True: [
+                    "core/rmnet_bench.c",
+                ],
+            },
+        },
         local_defines = [
             "RMNET_TRACE_INCLUDE_PATH={}/core".format(include_base),
         ],
@@ -6068,7 +6068,7 @@ static QDF_STATUS dp_cp_peer_del_resp_handler(struct cdp_soc_t *soc_hdl,
 		   cookie,
 		   CDP_TXRX_AST_DELETED);
 	}
-	qdf_mem_free(ast_entry);
+	dp_peer_ast_entry_release(ast_entry);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -6327,6 +6327,17 @@ free_vdev:
 
 qdf_export_symbol(dp_vdev_unref_delete);
 
+/**
+ * dp_peer_free_rcu() - free the peer memory once no hash lookup can see it
+ * @head: rcu head of the peer
+ *
+ * Return: None
+ */
+static void dp_peer_free_rcu(qdf_rcu_head_t *head)
+{
+	qdf_mem_free(qdf_container_of(head, struct dp_peer, rcu_head));
+}
+
 void dp_peer_unref_delete(struct dp_peer *peer, enum dp_mod_id mod_id)
 {
 	struct dp_vdev *vdev = peer->vdev;
@@ -6392,7 +6403,11 @@ void dp_peer_unref_delete(struct dp_peer *peer, enum dp_mod_id mod_id)
 		dp_txrx_peer_detach(soc, peer);
 		dp_cfg_event_record_peer_evt(soc, DP_CFG_EVENT_PEER_UNREF_DEL,
 					     peer, vdev, 0);
-		qdf_mem_free(peer);
+		/*
+		 * dp_peer_find_hash_find() walks the hash bins locklessly and
+		 * may still be reading this peer's mac address and ref_cnt.
+		 */
+		qdf_call_rcu(&peer->rcu_head, dp_peer_free_rcu);
 
 		/*
 		 * Decrement ref count taken at peer create
@@ -389,21 +389,33 @@ struct dp_peer *dp_peer_find_hash_find(
 		mac_addr = &local_mac_addr_aligned;
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
-	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
-		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
-		    ((peer->vdev->vdev_id == vdev_id) ||
-		     (vdev_id == DP_VDEV_ALL))) {
-			/* take peer reference before returning */
-			if (dp_peer_get_ref(soc, peer, mod_id) !=
-						QDF_STATUS_SUCCESS)
-				peer = NULL;
 
-			qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	/*
+	 * The bins are walked locklessly, writers unlink peers under
+	 * peer_hash_lock and the peer memory is only released after a grace
+	 * period, see dp_peer_unref_delete(). A peer seen here may therefore
+	 * already be unlinked and on its way out: only once the try-get
+	 * reference succeeds is the peer, and the vdev it holds, stable.
+	 */
+	qdf_rcu_read_lock();
+	qdf_tailq_foreach_rcu(peer, &soc->peer_hash.bins[index],
+			      hash_list_elem) {
+		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr))
+			continue;
+
+		/* take peer reference before returning */
+		if (dp_peer_get_ref(soc, peer, mod_id) != QDF_STATUS_SUCCESS)
+			continue;
+
+		if (peer->vdev->vdev_id == vdev_id ||
+		    vdev_id == DP_VDEV_ALL) {
+			qdf_rcu_read_unlock();
 			return peer;
 		}
+
+		dp_peer_unref_delete(peer, mod_id);
 	}
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	qdf_rcu_read_unlock();
 	return NULL; /* failure */
 }
 
@@ -490,8 +502,8 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 		 * this ensures that if two entries with the same MAC address
 		 * are stored, the one added first will be found first.
 		 */
-		TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer,
-				  hash_list_elem);
+		qdf_tailq_insert_tail_rcu(&soc->peer_hash.bins[index], peer,
+					  hash_list_elem);
 
 		qdf_spin_unlock_bh(&soc->peer_hash_lock);
 	} else if (peer->peer_type == CDP_MLD_PEER_TYPE) {
@@ -523,8 +535,8 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 			}
 		}
 		QDF_ASSERT(found);
-		TAILQ_REMOVE(&soc->peer_hash.bins[index], peer,
-			     hash_list_elem);
+		qdf_tailq_remove_rcu(&soc->peer_hash.bins[index], peer,
+				     hash_list_elem);
 
 		dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
 		qdf_spin_unlock_bh(&soc->peer_hash_lock);
@@ -603,7 +615,8 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 	 * the same MAC address are stored, the one added first will be
 	 * found first.
 	 */
-	TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer, hash_list_elem);
+	qdf_tailq_insert_tail_rcu(&soc->peer_hash.bins[index], peer,
+				  hash_list_elem);
 
 	qdf_spin_unlock_bh(&soc->peer_hash_lock);
 }
@@ -626,7 +639,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 		}
 	}
 	QDF_ASSERT(found);
-	TAILQ_REMOVE(&soc->peer_hash.bins[index], peer, hash_list_elem);
+	qdf_tailq_remove_rcu(&soc->peer_hash.bins[index], peer, hash_list_elem);
 
 	dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
 	qdf_spin_unlock_bh(&soc->peer_hash_lock);
@@ -829,7 +842,8 @@ struct dp_mec_entry *dp_peer_mec_hash_find_by_pdevid(struct dp_soc *soc,
 	mac_addr = &local_mac_addr_aligned;
 
 	index = dp_peer_mec_hash_index(soc, mac_addr);
-	TAILQ_FOREACH(mecentry, &soc->mec_hash.bins[index], hash_list_elem) {
+	qdf_tailq_foreach_rcu(mecentry, &soc->mec_hash.bins[index],
+			      hash_list_elem) {
 		if ((pdev_id == mecentry->pdev_id) &&
 		    !dp_peer_find_mac_addr_cmp(mac_addr, &mecentry->mac_addr))
 			return mecentry;
@@ -854,7 +868,8 @@ static inline void dp_peer_mec_hash_add(struct dp_soc *soc,
 
 	index = dp_peer_mec_hash_index(soc, &mecentry->mac_addr);
 	qdf_spin_lock_bh(&soc->mec_lock);
-	TAILQ_INSERT_TAIL(&soc->mec_hash.bins[index], mecentry, hash_list_elem);
+	qdf_tailq_insert_tail_rcu(&soc->mec_hash.bins[index], mecentry,
+				  hash_list_elem);
 	qdf_spin_unlock_bh(&soc->mec_lock);
 }
 
@@ -923,9 +938,20 @@ void dp_peer_mec_detach_entry(struct dp_soc *soc, struct dp_mec_entry *mecentry,
 
 	TAILQ_HEAD(, dp_mec_entry) * free_list = ptr;
 
-	TAILQ_REMOVE(&soc->mec_hash.bins[index], mecentry,
-		     hash_list_elem);
-	TAILQ_INSERT_TAIL(free_list, mecentry, hash_list_elem);
+	qdf_tailq_remove_rcu(&soc->mec_hash.bins[index], mecentry,
+			     hash_list_elem);
+	TAILQ_INSERT_TAIL(free_list, mecentry, free_list_elem);
+}
+
+/**
+ * dp_peer_mec_free_rcu() - free a MEC entry once no lookup can see it
+ * @head: rcu head of the MEC entry
+ *
+ * Return: None
+ */
+static void dp_peer_mec_free_rcu(qdf_rcu_head_t *head)
+{
+	qdf_mem_free(qdf_container_of(head, struct dp_mec_entry, rcu_head));
 }
 
 void dp_peer_mec_free_list(struct dp_soc *soc, void *ptr)
@@ -934,11 +960,11 @@ void dp_peer_mec_free_list(struct dp_soc *soc, void *ptr)
 
 	TAILQ_HEAD(, dp_mec_entry) * free_list = ptr;
 
-	TAILQ_FOREACH_SAFE(mecentry, free_list, hash_list_elem,
+	TAILQ_FOREACH_SAFE(mecentry, free_list, free_list_elem,
 			   mecentry_next) {
 		dp_peer_debug("%pK: MEC delete for mac_addr " QDF_MAC_ADDR_FMT,
 			      soc, QDF_MAC_ADDR_REF(&mecentry->mac_addr));
-		qdf_mem_free(mecentry);
+		qdf_call_rcu(&mecentry->rcu_head, dp_peer_mec_free_rcu);
 		qdf_atomic_dec(&soc->mec_cnt);
 		DP_STATS_INC(soc, mec.deleted, 1);
 	}
@@ -971,6 +997,22 @@ void dp_peer_mec_hash_detach(struct dp_soc *soc)
 }
 #endif
 
+/**
+ * dp_peer_ast_entry_free_rcu() - free an AST entry once no lookup can see it
+ * @head: rcu head of the AST entry
+ *
+ * Return: None
+ */
+static void dp_peer_ast_entry_free_rcu(qdf_rcu_head_t *head)
+{
+	qdf_mem_free(qdf_container_of(head, struct dp_ast_entry, rcu_head));
+}
+
+void dp_peer_ast_entry_release(struct dp_ast_entry *ast_entry)
+{
+	qdf_call_rcu(&ast_entry->rcu_head, dp_peer_ast_entry_free_rcu);
+}
+
 #ifdef FEATURE_AST
 #ifdef WLAN_FEATURE_11BE_MLO
 /**
@@ -1135,11 +1177,11 @@ void dp_peer_ast_hash_detach(struct dp_soc *soc)
 		if (!TAILQ_EMPTY(&soc->ast_hash.bins[index])) {
 			TAILQ_FOREACH_SAFE(ast, &soc->ast_hash.bins[index],
 					   hash_list_elem, ast_next) {
-				TAILQ_REMOVE(&soc->ast_hash.bins[index], ast,
-					     hash_list_elem);
+				qdf_tailq_remove_rcu(&soc->ast_hash.bins[index],
+						     ast, hash_list_elem);
 				dp_peer_ast_cleanup(soc, ast);
 				soc->num_ast_entries--;
-				qdf_mem_free(ast);
+				dp_peer_ast_entry_release(ast);
 			}
 		}
 	}
@@ -1186,7 +1228,8 @@ static inline void dp_peer_ast_hash_add(struct dp_soc *soc,
 	uint32_t index;
 
 	index = dp_peer_ast_hash_index(soc, &ase->mac_addr);
-	TAILQ_INSERT_TAIL(&soc->ast_hash.bins[index], ase, hash_list_elem);
+	qdf_tailq_insert_tail_rcu(&soc->ast_hash.bins[index], ase,
+				  hash_list_elem);
 }
 
 void dp_peer_ast_hash_remove(struct dp_soc *soc,
@@ -1216,7 +1259,8 @@ void dp_peer_ast_hash_remove(struct dp_soc *soc,
 	QDF_ASSERT(found);
 
 	if (found)
-		TAILQ_REMOVE(&soc->ast_hash.bins[index], ase, hash_list_elem);
+		qdf_tailq_remove_rcu(&soc->ast_hash.bins[index], ase,
+				     hash_list_elem);
 }
 
 struct dp_ast_entry *dp_peer_ast_hash_find_by_vdevid(struct dp_soc *soc,
@@ -1232,7 +1276,8 @@ struct dp_ast_entry *dp_peer_ast_hash_find_by_vdevid(struct dp_soc *soc,
 	mac_addr = &local_mac_addr_aligned;
 
 	index = dp_peer_ast_hash_index(soc, mac_addr);
-	TAILQ_FOREACH(ase, &soc->ast_hash.bins[index], hash_list_elem) {
+	qdf_tailq_foreach_rcu(ase, &soc->ast_hash.bins[index],
+			      hash_list_elem) {
 		if ((vdev_id == ase->vdev_id) &&
 		    !dp_peer_find_mac_addr_cmp(mac_addr, &ase->mac_addr)) {
 			return ase;
@@ -1255,7 +1300,8 @@ struct dp_ast_entry *dp_peer_ast_hash_find_by_pdevid(struct dp_soc *soc,
 	mac_addr = &local_mac_addr_aligned;
 
 	index = dp_peer_ast_hash_index(soc, mac_addr);
-	TAILQ_FOREACH(ase, &soc->ast_hash.bins[index], hash_list_elem) {
+	qdf_tailq_foreach_rcu(ase, &soc->ast_hash.bins[index],
+			      hash_list_elem) {
 		if ((pdev_id == ase->pdev_id) &&
 		    !dp_peer_find_mac_addr_cmp(mac_addr, &ase->mac_addr)) {
 			return ase;
@@ -1280,7 +1326,8 @@ struct dp_ast_entry *dp_peer_ast_hash_find_soc(struct dp_soc *soc,
 	mac_addr = &local_mac_addr_aligned;
 
 	index = dp_peer_ast_hash_index(soc, mac_addr);
-	TAILQ_FOREACH(ase, &soc->ast_hash.bins[index], hash_list_elem) {
+	qdf_tailq_foreach_rcu(ase, &soc->ast_hash.bins[index],
+			      hash_list_elem) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &ase->mac_addr) == 0) {
 			return ase;
 		}
@@ -1892,7 +1939,7 @@ void dp_peer_free_ast_entry(struct dp_soc *soc,
 	DP_STATS_INC(soc, ast.deleted, 1);
 	dp_peer_ast_hash_remove(soc, ast_entry);
 	dp_peer_ast_cleanup(soc, ast_entry);
-	qdf_mem_free(ast_entry);
+	dp_peer_ast_entry_release(ast_entry);
 	soc->num_ast_entries--;
 }
 
@@ -2290,7 +2337,7 @@ static uint32_t dp_peer_ast_free_wds_entries(struct dp_soc *soc,
 					    ast_entry->cookie,
 					    CDP_TXRX_AST_DELETED);
 
-		qdf_mem_free(ast_entry);
+		dp_peer_ast_entry_release(ast_entry);
 	}
 
 	return num_ast;
@@ -3166,6 +3213,8 @@ dp_peer_find_detach(struct dp_soc *soc)
 	dp_peer_ast_hash_detach(soc);
 	dp_peer_ast_table_detach(soc);
 	dp_peer_mec_hash_detach(soc);
+	/* wait for the peer, AST and MEC frees deferred past lookups */
+	qdf_rcu_barrier();
 }
 #else
 void
@@ -3173,6 +3222,8 @@ dp_peer_find_detach(struct dp_soc *soc)
 {
 	dp_peer_find_map_detach(soc);
 	dp_peer_find_hash_detach(soc);
+	/* wait for the peer frees deferred past lookups */
+	qdf_rcu_barrier();
 }
 #endif
 
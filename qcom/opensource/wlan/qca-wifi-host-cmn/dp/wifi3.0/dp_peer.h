@@ -860,7 +860,8 @@ int dp_peer_update_ast(struct dp_soc *soc, struct dp_peer *peer,
  * @pdev_id: pdev Id
  *
  * It assumes caller has taken the ast lock to protect the access to
- * AST hash table
+ * AST hash table, or is in a qdf_rcu_read_lock() section in which case
+ * the entry returned may only be used until qdf_rcu_read_unlock()
  *
  * Return: AST entry
  */
@@ -875,7 +876,8 @@ struct dp_ast_entry *dp_peer_ast_hash_find_by_pdevid(struct dp_soc *soc,
  * @vdev_id: vdev Id
  *
  * It assumes caller has taken the ast lock to protect the access to
- * AST hash table
+ * AST hash table, or is in a qdf_rcu_read_lock() section in which case
+ * the entry returned may only be used until qdf_rcu_read_unlock()
  *
  * Return: AST entry
  */
@@ -889,7 +891,8 @@ struct dp_ast_entry *dp_peer_ast_hash_find_by_vdevid(struct dp_soc *soc,
  * @ast_mac_addr: Mac address
  *
  * It assumes caller has taken the ast lock to protect the access to
- * AST hash table
+ * AST hash table, or is in a qdf_rcu_read_lock() section in which case
+ * the entry returned may only be used until qdf_rcu_read_unlock()
  *
  * Return: AST entry
  */
@@ -976,6 +979,17 @@ void dp_peer_ast_hash_remove(struct dp_soc *soc,
 void dp_peer_free_ast_entry(struct dp_soc *soc,
 			    struct dp_ast_entry *ast_entry);
 
+/**
+ * dp_peer_ast_entry_release() - Release the AST entry memory
+ * @ast_entry: Address search entry, already removed from the AST hash table
+ *
+ * The memory is freed after an RCU grace period, as lockless hash lookups
+ * may still be looking at the entry.
+ *
+ * Return: None
+ */
+void dp_peer_ast_entry_release(struct dp_ast_entry *ast_entry);
+
 /**
  * dp_peer_unlink_ast_entry() - Free up the ast entry memory
  * @soc: SoC handle
@@ -1038,7 +1052,8 @@ QDF_STATUS dp_peer_mec_add_entry(struct dp_soc *soc,
  * @mec_mac_addr: MAC address of mec node
  *
  * It assumes caller has taken the mec_lock to protect the access to
- * MEC hash table
+ * MEC hash table, or is in a qdf_rcu_read_lock() section in which case
+ * the entry returned may only be used until qdf_rcu_read_unlock()
  *
  * Return: MEC entry
  */
@@ -134,16 +134,16 @@ bool dp_rx_mcast_echo_check(struct dp_soc *soc,
 		qdf_spin_unlock_bh(&soc->ast_lock);
 	}
 
-	qdf_spin_lock_bh(&soc->mec_lock);
+	qdf_rcu_read_lock();
 
 	mecentry = dp_peer_mec_hash_find_by_pdevid(soc, pdev->pdev_id,
 						   &data[QDF_MAC_ADDR_SIZE]);
 	if (!mecentry) {
-		qdf_spin_unlock_bh(&soc->mec_lock);
+		qdf_rcu_read_unlock();
 		return false;
 	}
 
-	qdf_spin_unlock_bh(&soc->mec_lock);
+	qdf_rcu_read_unlock();
 
 drop:
 	dp_rx_err_info("%pK: received pkt with same src mac " QDF_MAC_ADDR_FMT,
@@ -6024,6 +6024,48 @@ dp_print_wbm2sw_ring_stats_from_hal(struct dp_pdev *pdev)
 }
 #endif
 
+#if defined(QCA_LL_TX_FLOW_CONTROL_V2) && defined(DP_TX_DESC_CPU_CACHE)
+/**
+ * dp_print_tx_desc_cache_stats() - Print per CPU tx descriptor cache stats
+ * @soc: DP soc handle
+ *
+ * Return: None
+ */
+static void dp_print_tx_desc_cache_stats(struct dp_soc *soc)
+{
+	struct dp_tx_desc_pool_s *pool;
+	struct dp_tx_desc_cache_stats *stats;
+	uint8_t pool_id;
+	int cpu;
+
+	DP_PRINT_STATS("Tx Desc CPU Cache Stats:");
+	for (pool_id = 0; pool_id < MAX_TXDESC_POOLS; pool_id++) {
+		pool = &soc->tx_desc[pool_id];
+		if (pool->status == FLOW_POOL_INACTIVE)
+			continue;
+
+		DP_PRINT_STATS("Pool %u: cache_active = %u avail_desc = %u",
+			       pool_id, pool->cache_active, pool->avail_desc);
+		for (cpu = 0; cpu < DP_TX_DESC_CACHE_MAX_CPUS; cpu++) {
+			stats = &pool->cpu_cache[cpu].stats;
+			if (!stats->alloc_hit && !stats->alloc_miss &&
+			    !stats->free_hit && !stats->free_miss)
+				continue;
+
+			DP_PRINT_STATS("	CPU %d: cached = %u alloc hit/miss = %u/%u free hit/miss = %u/%u refill = %u flush = %u",
+				       cpu, pool->cpu_cache[cpu].count,
+				       stats->alloc_hit, stats->alloc_miss,
+				       stats->free_hit, stats->free_miss,
+				       stats->refill, stats->flush);
+		}
+	}
+}
+#else
+static inline void dp_print_tx_desc_cache_stats(struct dp_soc *soc)
+{
+}
+#endif
+
 /*
  * Format is:
  * [0 18 1728, 1 15 1222, 2 24 1969,...]
@@ -6283,6 +6325,7 @@ void dp_print_soc_tx_stats(struct dp_soc *soc)
 	DP_PRINT_STATS("Tx comp HP out of sync2 = %d",
 		       soc->stats.tx.hp_oos2);
 	dp_print_tx_ppeds_stats(soc);
+	dp_print_tx_desc_cache_stats(soc);
 }
 
 #define DP_INT_CTX_STATS_STRING_LEN 512
@@ -6466,6 +6509,7 @@ void dp_print_soc_tx_stats(struct dp_soc *soc)
 	DP_PRINT_STATS("TX invalid Desc from completion ring = %u",
 		       soc->stats.tx.invalid_tx_comp_desc);
 	dp_print_tx_ppeds_stats(soc);
+	dp_print_tx_desc_cache_stats(soc);
 }
 
 /* TODO: print CE intr stats? */
@@ -3796,17 +3796,17 @@ dp_tx_per_pkt_vdev_id_check(qdf_nbuf_t nbuf, struct dp_vdev *vdev)
 	    DP_FRAME_IS_BROADCAST((eh)->ether_dhost))
 		return QDF_STATUS_SUCCESS;
 
-	qdf_spin_lock_bh(&vdev->pdev->soc->ast_lock);
+	qdf_rcu_read_lock();
 	dst_ast_entry = dp_peer_ast_hash_find_by_vdevid(vdev->pdev->soc,
 							eh->ether_dhost,
 							vdev->vdev_id);
 
 	/* If there is no ast entry, return failure */
 	if (qdf_unlikely(!dst_ast_entry)) {
-		qdf_spin_unlock_bh(&vdev->pdev->soc->ast_lock);
+		qdf_rcu_read_unlock();
 		return QDF_STATUS_E_FAILURE;
 	}
-	qdf_spin_unlock_bh(&vdev->pdev->soc->ast_lock);
+	qdf_rcu_read_unlock();
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -4406,14 +4406,14 @@ qdf_nbuf_t dp_tx_send(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 			if (!soc->ast_offload_support) {
 				struct dp_ast_entry *ast_entry = NULL;
 
-				qdf_spin_lock_bh(&soc->ast_lock);
+				qdf_rcu_read_lock();
 				ast_entry = dp_peer_ast_hash_find_by_pdevid
 					(soc,
 					 (uint8_t *)(eh->ether_shost),
 					 vdev->pdev->pdev_id);
 				if (ast_entry)
 					sa_peer_id = ast_entry->peer_id;
-				qdf_spin_unlock_bh(&soc->ast_lock);
+				qdf_rcu_read_unlock();
 			}
 
 			dp_tx_nawds_handler(soc, vdev, &msdu_info, nbuf,
@@ -7121,6 +7121,7 @@ static QDF_STATUS dp_tx_alloc_static_pools(struct dp_soc *soc, int num_pool,
 
 	for (i = 0; i < num_pool; i++) {
 		qdf_spinlock_create(&soc->tx_desc[i].flow_pool_lock);
+		dp_tx_desc_cache_create(&soc->tx_desc[i]);
 		soc->tx_desc[i].status = FLOW_POOL_INACTIVE;
 	}
 
@@ -7157,8 +7158,10 @@ static void dp_tx_delete_static_pools(struct dp_soc *soc, int num_pool)
 {
 	uint8_t i;
 
-	for (i = 0; i < num_pool; i++)
+	for (i = 0; i < num_pool; i++) {
+		dp_tx_desc_cache_destroy(&soc->tx_desc[i]);
 		qdf_spinlock_destroy(&soc->tx_desc[i].flow_pool_lock);
+	}
 }
 
 static void dp_tx_spcl_delete_static_pools(struct dp_soc *soc, int num_pool)
@@ -289,12 +289,179 @@ void dp_tx_desc_pool_deinit(struct dp_soc *soc, uint8_t pool_id,
 		tx_desc_pool = dp_get_spcl_tx_desc_pool(soc, pool_id);
 	else
 		tx_desc_pool = dp_get_tx_desc_pool(soc, pool_id);
+	if (!spcl_tx_desc)
+		dp_tx_desc_cache_drain(tx_desc_pool);
 	soc->arch_ops.dp_tx_desc_pool_deinit(soc, tx_desc_pool,
 					     pool_id, spcl_tx_desc);
 	TX_DESC_POOL_MEMBER_CLEAN(tx_desc_pool);
 	TX_DESC_LOCK_DESTROY(&tx_desc_pool->lock);
 }
 
+#if defined(QCA_LL_TX_FLOW_CONTROL_V2) && defined(DP_TX_DESC_CPU_CACHE)
+/**
+ * dp_tx_desc_cache_low_wm() - lowest avail_desc the per CPU caches can be
+ *			       used at
+ * @pool: flow pool
+ *
+ * Return: first stop threshold plus one refill batch
+ */
+#ifdef QCA_AC_BASED_FLOW_CONTROL
+static inline uint16_t dp_tx_desc_cache_low_wm(struct dp_tx_desc_pool_s *pool)
+{
+	/* BE_BK is the first AC to be paused */
+	return pool->stop_th[DP_TH_BE_BK] + DP_TX_DESC_CACHE_BATCH;
+}
+#else
+static inline uint16_t dp_tx_desc_cache_low_wm(struct dp_tx_desc_pool_s *pool)
+{
+	return pool->stop_th + DP_TX_DESC_CACHE_BATCH;
+}
+#endif
+
+void dp_tx_desc_cache_create(struct dp_tx_desc_pool_s *pool)
+{
+	int cpu;
+
+	pool->cache_active = false;
+	for (cpu = 0; cpu < DP_TX_DESC_CACHE_MAX_CPUS; cpu++) {
+		qdf_spinlock_create(&pool->cpu_cache[cpu].lock);
+		pool->cpu_cache[cpu].freelist = NULL;
+		pool->cpu_cache[cpu].count = 0;
+		qdf_mem_zero(&pool->cpu_cache[cpu].stats,
+			     sizeof(pool->cpu_cache[cpu].stats));
+	}
+}
+
+void dp_tx_desc_cache_destroy(struct dp_tx_desc_pool_s *pool)
+{
+	int cpu;
+
+	for (cpu = 0; cpu < DP_TX_DESC_CACHE_MAX_CPUS; cpu++)
+		qdf_spinlock_destroy(&pool->cpu_cache[cpu].lock);
+}
+
+void dp_tx_desc_cache_drain(struct dp_tx_desc_pool_s *pool)
+{
+	struct dp_tx_desc_cpu_cache *cache;
+	struct dp_tx_desc_s *tx_desc;
+	int cpu;
+
+	/* Caches are only ever filled while active, and emptied here */
+	if (!pool->cache_active)
+		return;
+
+	/*
+	 * Clear the flag first: a CPU either completes its cache access
+	 * before its cache lock is taken below, or sees the flag cleared.
+	 */
+	pool->cache_active = false;
+	for (cpu = 0; cpu < DP_TX_DESC_CACHE_MAX_CPUS; cpu++) {
+		cache = &pool->cpu_cache[cpu];
+		qdf_spin_lock_bh(&cache->lock);
+		while (cache->freelist) {
+			tx_desc = cache->freelist;
+			cache->freelist = tx_desc->next;
+			dp_tx_put_desc_flow_pool(pool, tx_desc);
+		}
+		cache->count = 0;
+		qdf_spin_unlock_bh(&cache->lock);
+	}
+}
+
+void dp_tx_desc_cache_update(struct dp_tx_desc_pool_s *pool)
+{
+	uint16_t low_wm;
+
+	if (pool->status != FLOW_POOL_ACTIVE_UNPAUSED) {
+		dp_tx_desc_cache_drain(pool);
+		return;
+	}
+
+	low_wm = dp_tx_desc_cache_low_wm(pool);
+	if (pool->cache_active) {
+		if (pool->avail_desc < low_wm)
+			dp_tx_desc_cache_drain(pool);
+	} else if (pool->avail_desc >= low_wm + 2 * DP_TX_DESC_CACHE_BATCH) {
+		/* Margin above low_wm so the caches do not flap on and off */
+		pool->cache_active = true;
+	}
+}
+
+struct dp_tx_desc_s *
+dp_tx_desc_cache_refill(struct dp_tx_desc_pool_s *pool,
+			struct dp_tx_desc_cpu_cache *cache)
+{
+	struct dp_tx_desc_s *tx_desc = NULL;
+	int i;
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	qdf_spin_lock_bh(&cache->lock);
+	cache->stats.alloc_miss++;
+
+	/*
+	 * Never take avail_desc below low_wm, the caller then allocates from
+	 * the shared freelist, which drains the caches at low_wm.
+	 */
+	if (!pool->cache_active ||
+	    pool->avail_desc < dp_tx_desc_cache_low_wm(pool) +
+			       DP_TX_DESC_CACHE_BATCH)
+		goto unlock;
+
+	/* The cache may have been refilled meanwhile by a migrated task */
+	for (i = cache->count; i < DP_TX_DESC_CACHE_BATCH; i++) {
+		tx_desc = dp_tx_get_desc_flow_pool(pool);
+		tx_desc->next = cache->freelist;
+		cache->freelist = tx_desc;
+		cache->count++;
+	}
+	cache->stats.refill++;
+
+	tx_desc = cache->freelist;
+	cache->freelist = tx_desc->next;
+	cache->count--;
+
+unlock:
+	qdf_spin_unlock_bh(&cache->lock);
+	qdf_spin_unlock_bh(&pool->flow_pool_lock);
+
+	return tx_desc;
+}
+
+bool dp_tx_desc_cache_flush(struct dp_tx_desc_pool_s *pool,
+			    struct dp_tx_desc_cpu_cache *cache,
+			    struct dp_tx_desc_s *tx_desc)
+{
+	struct dp_tx_desc_s *flush_desc;
+	int i;
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	qdf_spin_lock_bh(&cache->lock);
+	if (!pool->cache_active) {
+		qdf_spin_unlock_bh(&cache->lock);
+		qdf_spin_unlock_bh(&pool->flow_pool_lock);
+		return false;
+	}
+
+	cache->stats.free_miss++;
+	for (i = 0; i < DP_TX_DESC_CACHE_BATCH && cache->freelist; i++) {
+		flush_desc = cache->freelist;
+		cache->freelist = flush_desc->next;
+		cache->count--;
+		dp_tx_put_desc_flow_pool(pool, flush_desc);
+	}
+	cache->stats.flush++;
+
+	tx_desc->next = cache->freelist;
+	cache->freelist = tx_desc;
+	cache->count++;
+
+	qdf_spin_unlock_bh(&cache->lock);
+	qdf_spin_unlock_bh(&pool->flow_pool_lock);
+
+	return true;
+}
+#endif /* QCA_LL_TX_FLOW_CONTROL_V2 && DP_TX_DESC_CPU_CACHE */
+
 QDF_STATUS
 dp_tx_ext_desc_pool_alloc_by_id(struct dp_soc *soc, uint32_t num_elem,
 				uint8_t pool_id)
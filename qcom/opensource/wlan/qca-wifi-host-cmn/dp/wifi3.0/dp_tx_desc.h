@@ -124,6 +124,194 @@ static inline void dp_tx_desc_set_magic(struct dp_tx_desc_s *tx_desc,
 }
 #endif
 
+#if defined(QCA_LL_TX_FLOW_CONTROL_V2) && defined(DP_TX_DESC_CPU_CACHE)
+/*
+ * Per CPU tx descriptor caches
+ *
+ * Every CPU keeps up to DP_TX_DESC_CACHE_SIZE free descriptors of a flow
+ * pool, moved from and to the shared freelist DP_TX_DESC_CACHE_BATCH at a
+ * time, so that most allocations and frees only take the CPU local cache
+ * lock instead of flow_pool_lock.
+ *
+ * Cached descriptors are not counted in avail_desc. To keep the flow control
+ * decisions exact, the caches are only used while the pool is unpaused and
+ * avail_desc alone stays above the stop threshold plus one batch: in that
+ * range no pause can be due whatever the caches hold. When avail_desc drops
+ * below it or the pool leaves the unpaused state, all caches are drained back
+ * under flow_pool_lock and the pool runs uncached, with avail_desc once again
+ * covering every free descriptor. Lock order is flow_pool_lock -> cache lock.
+ */
+#define DP_TX_DESC_CACHE_SIZE 64
+#define DP_TX_DESC_CACHE_BATCH 16
+
+/**
+ * dp_tx_desc_cache_create() - create the per CPU caches of a flow pool
+ * @pool: flow pool
+ *
+ * Return: None
+ */
+void dp_tx_desc_cache_create(struct dp_tx_desc_pool_s *pool);
+
+/**
+ * dp_tx_desc_cache_destroy() - destroy the per CPU caches of a flow pool
+ * @pool: flow pool
+ *
+ * Return: None
+ */
+void dp_tx_desc_cache_destroy(struct dp_tx_desc_pool_s *pool);
+
+/**
+ * dp_tx_desc_cache_drain() - disable the per CPU caches of a flow pool and
+ *			      return all cached descriptors to its freelist
+ * @pool: flow pool
+ *
+ * Caller must hold flow_pool_lock, or otherwise own the pool exclusively.
+ *
+ * Return: None
+ */
+void dp_tx_desc_cache_drain(struct dp_tx_desc_pool_s *pool);
+
+/**
+ * dp_tx_desc_cache_update() - enable or drain the per CPU caches of a flow
+ *			       pool according to its state and avail_desc
+ * @pool: flow pool
+ *
+ * Called with flow_pool_lock held, after each alloc/free done on the shared
+ * freelist.
+ *
+ * Return: None
+ */
+void dp_tx_desc_cache_update(struct dp_tx_desc_pool_s *pool);
+
+/**
+ * dp_tx_desc_cache_refill() - refill a CPU cache from the shared freelist
+ * @pool: flow pool
+ * @cache: empty cache of the current CPU
+ *
+ * Return: tx descriptor taken from the refilled cache, NULL if the pool is
+ *	   too close to its stop threshold to hand out a batch
+ */
+struct dp_tx_desc_s *
+dp_tx_desc_cache_refill(struct dp_tx_desc_pool_s *pool,
+			struct dp_tx_desc_cpu_cache *cache);
+
+/**
+ * dp_tx_desc_cache_flush() - return a batch of a full CPU cache to the
+ *			      shared freelist and cache @tx_desc
+ * @pool: flow pool
+ * @cache: full cache of the current CPU
+ * @tx_desc: descriptor being freed
+ *
+ * Return: true if @tx_desc was cached, false if caching got disabled
+ */
+bool dp_tx_desc_cache_flush(struct dp_tx_desc_pool_s *pool,
+			    struct dp_tx_desc_cpu_cache *cache,
+			    struct dp_tx_desc_s *tx_desc);
+
+/**
+ * dp_tx_desc_cache_alloc() - allocate a tx descriptor from the current CPU
+ *			      cache of a flow pool
+ * @pool: flow pool
+ *
+ * Return: tx descriptor, NULL if the allocation has to be done on the
+ *	   shared freelist
+ */
+static inline struct dp_tx_desc_s *
+dp_tx_desc_cache_alloc(struct dp_tx_desc_pool_s *pool)
+{
+	struct dp_tx_desc_cpu_cache *cache;
+	struct dp_tx_desc_s *tx_desc;
+	int cpu = qdf_get_cpu();
+
+	if (qdf_unlikely(cpu >= DP_TX_DESC_CACHE_MAX_CPUS ||
+			 !pool->cache_active))
+		return NULL;
+
+	/*
+	 * The task may migrate once the CPU is read, the cache lock keeps
+	 * that safe, the cache is just no longer local then.
+	 */
+	cache = &pool->cpu_cache[cpu];
+	qdf_spin_lock_bh(&cache->lock);
+	if (qdf_likely(pool->cache_active && cache->count)) {
+		tx_desc = cache->freelist;
+		cache->freelist = tx_desc->next;
+		cache->count--;
+		cache->stats.alloc_hit++;
+		qdf_spin_unlock_bh(&cache->lock);
+		return tx_desc;
+	}
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return dp_tx_desc_cache_refill(pool, cache);
+}
+
+/**
+ * dp_tx_desc_cache_free() - free a tx descriptor to the current CPU cache
+ *			     of a flow pool
+ * @pool: flow pool
+ * @tx_desc: tx descriptor, already reset
+ *
+ * Return: true if the descriptor was cached, false if it has to be freed to
+ *	   the shared freelist
+ */
+static inline bool
+dp_tx_desc_cache_free(struct dp_tx_desc_pool_s *pool,
+		      struct dp_tx_desc_s *tx_desc)
+{
+	struct dp_tx_desc_cpu_cache *cache;
+	int cpu = qdf_get_cpu();
+
+	if (qdf_unlikely(cpu >= DP_TX_DESC_CACHE_MAX_CPUS ||
+			 !pool->cache_active))
+		return false;
+
+	cache = &pool->cpu_cache[cpu];
+	qdf_spin_lock_bh(&cache->lock);
+	if (qdf_likely(pool->cache_active &&
+		       cache->count < DP_TX_DESC_CACHE_SIZE)) {
+		tx_desc->next = cache->freelist;
+		cache->freelist = tx_desc;
+		cache->count++;
+		cache->stats.free_hit++;
+		qdf_spin_unlock_bh(&cache->lock);
+		return true;
+	}
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return dp_tx_desc_cache_flush(pool, cache, tx_desc);
+}
+#else
+static inline void dp_tx_desc_cache_create(struct dp_tx_desc_pool_s *pool)
+{
+}
+
+static inline void dp_tx_desc_cache_destroy(struct dp_tx_desc_pool_s *pool)
+{
+}
+
+static inline void dp_tx_desc_cache_drain(struct dp_tx_desc_pool_s *pool)
+{
+}
+
+static inline void dp_tx_desc_cache_update(struct dp_tx_desc_pool_s *pool)
+{
+}
+
+static inline struct dp_tx_desc_s *
+dp_tx_desc_cache_alloc(struct dp_tx_desc_pool_s *pool)
+{
+	return NULL;
+}
+
+static inline bool
+dp_tx_desc_cache_free(struct dp_tx_desc_pool_s *pool,
+		      struct dp_tx_desc_s *tx_desc)
+{
+	return false;
+}
+#endif /* QCA_LL_TX_FLOW_CONTROL_V2 && DP_TX_DESC_CPU_CACHE */
+
 /**
  * dp_tx_desc_pool_alloc() - Allocate Tx Descriptor pool(s)
  * @soc: Handle to DP SoC structure
@@ -651,6 +839,15 @@ dp_tx_desc_alloc(struct dp_soc *soc, uint8_t desc_pool_id)
 	enum netif_reason_type reason;
 
 	if (qdf_likely(pool)) {
+		tx_desc = dp_tx_desc_cache_alloc(pool);
+		if (tx_desc) {
+			tx_desc->pool_id = desc_pool_id;
+			tx_desc->flags = DP_TX_DESC_FLAG_ALLOCATED;
+			dp_tx_desc_set_magic(tx_desc,
+					     DP_TX_MAGIC_PATTERN_INUSE);
+			return tx_desc;
+		}
+
 		qdf_spin_lock_bh(&pool->flow_pool_lock);
 		if (qdf_likely(pool->avail_desc &&
 		    pool->status != FLOW_POOL_INVALID &&
@@ -660,6 +857,7 @@ dp_tx_desc_alloc(struct dp_soc *soc, uint8_t desc_pool_id)
 			tx_desc->flags = DP_TX_DESC_FLAG_ALLOCATED;
 			dp_tx_desc_set_magic(tx_desc,
 					     DP_TX_MAGIC_PATTERN_INUSE);
+			dp_tx_desc_cache_update(pool);
 			is_pause = dp_tx_is_threshold_reached(pool,
 							      pool->avail_desc);
 
@@ -745,11 +943,14 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	enum netif_action_type act = WLAN_WAKE_ALL_NETIF_QUEUE;
 	enum netif_reason_type reason;
 
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
 	tx_desc->vdev_id = DP_INVALID_VDEV_ID;
 	tx_desc->nbuf = NULL;
 	tx_desc->flags = 0;
 	dp_tx_desc_set_magic(tx_desc, DP_TX_MAGIC_PATTERN_FREE);
+	if (dp_tx_desc_cache_free(pool, tx_desc))
+		return;
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
 	dp_tx_put_desc_flow_pool(pool, tx_desc);
 	switch (pool->status) {
 	case FLOW_POOL_ACTIVE_PAUSED:
@@ -828,6 +1029,7 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	if (act != WLAN_WAKE_ALL_NETIF_QUEUE)
 		soc->pause_cb(pool->flow_pool_id,
 			      act, reason);
+	dp_tx_desc_cache_update(pool);
 	qdf_spin_unlock_bh(&pool->flow_pool_lock);
 }
 
@@ -867,6 +1069,15 @@ dp_tx_desc_alloc(struct dp_soc *soc, uint8_t desc_pool_id)
 	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
 
 	if (pool) {
+		tx_desc = dp_tx_desc_cache_alloc(pool);
+		if (tx_desc) {
+			tx_desc->pool_id = desc_pool_id;
+			tx_desc->flags = DP_TX_DESC_FLAG_ALLOCATED;
+			dp_tx_desc_set_magic(tx_desc,
+					     DP_TX_MAGIC_PATTERN_INUSE);
+			return tx_desc;
+		}
+
 		qdf_spin_lock_bh(&pool->flow_pool_lock);
 		if (pool->status <= FLOW_POOL_ACTIVE_PAUSED &&
 		    pool->avail_desc) {
@@ -875,6 +1086,7 @@ dp_tx_desc_alloc(struct dp_soc *soc, uint8_t desc_pool_id)
 			tx_desc->flags = DP_TX_DESC_FLAG_ALLOCATED;
 			dp_tx_desc_set_magic(tx_desc,
 					     DP_TX_MAGIC_PATTERN_INUSE);
+			dp_tx_desc_cache_update(pool);
 			if (qdf_unlikely(pool->avail_desc < pool->stop_th)) {
 				pool->status = FLOW_POOL_ACTIVE_PAUSED;
 				qdf_spin_unlock_bh(&pool->flow_pool_lock);
@@ -915,11 +1127,14 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 {
 	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
 
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
 	tx_desc->vdev_id = DP_INVALID_VDEV_ID;
 	tx_desc->nbuf = NULL;
 	tx_desc->flags = 0;
 	dp_tx_desc_set_magic(tx_desc, DP_TX_MAGIC_PATTERN_FREE);
+	if (dp_tx_desc_cache_free(pool, tx_desc))
+		return;
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
 	dp_tx_put_desc_flow_pool(pool, tx_desc);
 	switch (pool->status) {
 	case FLOW_POOL_ACTIVE_PAUSED:
@@ -949,6 +1164,7 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 		break;
 	};
 
+	dp_tx_desc_cache_update(pool);
 	qdf_spin_unlock_bh(&pool->flow_pool_lock);
 }
 
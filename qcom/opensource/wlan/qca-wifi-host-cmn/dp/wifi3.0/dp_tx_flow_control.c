@@ -91,6 +91,7 @@ dp_tx_flow_pool_reattach(struct dp_tx_desc_pool_s *pool)
 		  "%s: flow pool already allocated, attached %d times",
 		  __func__, pool->pool_create_cnt);
 
+	dp_tx_desc_cache_drain(pool);
 	pool->status = FLOW_POOL_ACTIVE_UNPAUSED_REATTACH;
 	pool->pool_create_cnt++;
 }
@@ -180,6 +181,7 @@ dp_tx_flow_pool_reattach(struct dp_tx_desc_pool_s *pool)
 	QDF_TRACE(QDF_MODULE_ID_DP, QDF_TRACE_LEVEL_ERROR,
 		  "%s: flow pool already allocated, attached %d times",
 		  __func__, pool->pool_create_cnt);
+	dp_tx_desc_cache_drain(pool);
 	if (pool->avail_desc > pool->start_th)
 		pool->status = FLOW_POOL_ACTIVE_UNPAUSED;
 	else
@@ -471,6 +473,8 @@ int dp_tx_delete_flow_pool(struct dp_soc *soc, struct dp_tx_desc_pool_s *pool,
 		return -EAGAIN;
 	}
 
+	/* Count the descriptors held in the per CPU caches as available */
+	dp_tx_desc_cache_drain(pool);
 	if (pool->avail_desc < pool->pool_size) {
 		pool_status = pool->status;
 		pool->status = FLOW_POOL_INVALID;
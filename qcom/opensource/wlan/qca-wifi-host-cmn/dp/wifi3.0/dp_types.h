@@ -27,6 +27,7 @@
 #include <qdf_util.h>
 #include <qdf_list.h>
 #include <qdf_lro.h>
+#include <qdf_rcu.h>
 #include <queue.h>
 #include <htt_common.h>
 #include <htt.h>
@@ -782,6 +783,43 @@ struct dp_tx_tso_num_seg_pool_s {
 	qdf_spinlock_t lock;
 };
 
+#ifdef DP_TX_DESC_CPU_CACHE
+/* Number of CPUs that get a tx descriptor cache, others use the pool */
+#define DP_TX_DESC_CACHE_MAX_CPUS CDP_NR_CPUS
+
+/**
+ * struct dp_tx_desc_cache_stats - per CPU tx descriptor cache statistics
+ * @alloc_hit: allocations served from the CPU cache
+ * @alloc_miss: allocations the CPU cache could not serve
+ * @free_hit: frees returned to the CPU cache
+ * @free_miss: frees that found the CPU cache full
+ * @refill: batches moved from the shared pool into the CPU cache
+ * @flush: batches moved from the CPU cache back to the shared pool
+ */
+struct dp_tx_desc_cache_stats {
+	uint32_t alloc_hit;
+	uint32_t alloc_miss;
+	uint32_t free_hit;
+	uint32_t free_miss;
+	uint32_t refill;
+	uint32_t flush;
+};
+
+/**
+ * struct dp_tx_desc_cpu_cache - per CPU cache of free tx descriptors
+ * @lock: protects the cache, only contended when the pool drains it
+ * @freelist: chain of cached free descriptors
+ * @count: number of descriptors on @freelist
+ * @stats: cache hit/miss statistics
+ */
+struct dp_tx_desc_cpu_cache {
+	qdf_spinlock_t lock;
+	struct dp_tx_desc_s *freelist;
+	uint16_t count;
+	struct dp_tx_desc_cache_stats stats;
+} qdf_cacheline_aligned;
+#endif /* DP_TX_DESC_CPU_CACHE */
+
 /**
  * struct dp_tx_desc_pool_s - Tx Descriptor pool information
  * @elem_size: Size of each descriptor in the pool
@@ -802,6 +840,9 @@ struct dp_tx_tso_num_seg_pool_s {
  * @flow_pool_lock:
  * @pool_create_cnt:
  * @pool_owner_ctx:
+ * @cache_active: per CPU caches may hold descriptors of this pool
+ * @cpu_cache: per CPU caches of free descriptors, cached descriptors are
+ *	not counted in @avail_desc
  * @elem_count:
  * @num_free: Number of free descriptors
  * @lock: Lock for descriptor allocation/free from/to the pool
@@ -831,6 +872,10 @@ struct dp_tx_desc_pool_s {
 	qdf_spinlock_t flow_pool_lock;
 	uint8_t pool_create_cnt;
 	void *pool_owner_ctx;
+#ifdef DP_TX_DESC_CPU_CACHE
+	bool cache_active;
+	struct dp_tx_desc_cpu_cache cpu_cache[DP_TX_DESC_CACHE_MAX_CPUS];
+#endif
 #else
 	uint16_t elem_count;
 	uint32_t num_free;
@@ -1453,6 +1498,7 @@ struct dp_ast_free_cb_params {
  * @callback: ast free/unmap callback
  * @cookie: argument to callback
  * @hash_list_elem: node in soc AST hash list (mac address used as hash)
+ * @rcu_head: head to defer the free until hash lookups are done with it
  */
 struct dp_ast_entry {
 	uint16_t ast_idx;
@@ -1471,6 +1517,7 @@ struct dp_ast_entry {
 	void *cookie;
 	TAILQ_ENTRY(dp_ast_entry) ase_list_elem;
 	TAILQ_ENTRY(dp_ast_entry) hash_list_elem;
+	qdf_rcu_head_t rcu_head;
 };
 
 /**
@@ -1482,6 +1529,8 @@ struct dp_ast_entry {
  * @pdev_id: pdev ID
  * @vdev_id: vdev ID
  * @hash_list_elem: node in soc MEC hash list (mac address used as hash)
+ * @free_list_elem: node in the list of detached entries pending free
+ * @rcu_head: head to defer the free until hash lookups are done with it
  */
 struct dp_mec_entry {
 	union dp_align_mac_addr mac_addr;
@@ -1490,6 +1539,8 @@ struct dp_mec_entry {
 	uint8_t vdev_id;
 
 	TAILQ_ENTRY(dp_mec_entry) hash_list_elem;
+	TAILQ_ENTRY(dp_mec_entry) free_list_elem;
+	qdf_rcu_head_t rcu_head;
 };
 
 /* SOC level htt stats */
@@ -5002,6 +5053,9 @@ struct dp_peer {
 	/* entry to inactive_list*/
 	TAILQ_ENTRY(dp_peer) inactive_list_elem;
 
+	/* defers the free until lockless hash lookups are done with it */
+	qdf_rcu_head_t rcu_head;
+
 	qdf_atomic_t mod_refs[DP_MOD_ID_MAX];
 
 	uint8_t peer_state;
@@ -33,6 +33,12 @@
 
 #define QDF_CACHE_LINE_SZ __qdf_cache_line_sz
 
+/*
+ * qdf_cacheline_aligned - place a structure or variable on its own cache
+ * line, to keep data written from different CPUs from false sharing
+ */
+#define qdf_cacheline_aligned __qdf_cacheline_aligned
+
 /**
  * qdf_align() - align to the given size.
  * @a: input that needs to be aligned.
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: qdf_rcu.h
+ *
+ * Read-copy-update primitives, plus helpers to use them on the BSD style
+ * tail queues (queue.h) the datapath hash tables are built from.
+ *
+ * Readers walk a list with qdf_tailq_foreach_rcu() inside a
+ * qdf_rcu_read_lock()/qdf_rcu_read_unlock() section and never block.
+ * Writers still serialize against each other with their own lock, link and
+ * unlink nodes with qdf_tailq_insert_tail_rcu()/qdf_tailq_remove_rcu(), and
+ * must not free an unlinked node before a grace period has elapsed, either
+ * through qdf_call_rcu() or after qdf_synchronize_rcu().
+ *
+ * An object found inside the read section is only guaranteed to be valid
+ * until qdf_rcu_read_unlock(); to use it beyond that, the reader has to take
+ * a reference with an increment-not-zero style try-get.
+ */
+
+#ifndef __QDF_RCU_H
+#define __QDF_RCU_H
+
+#include "i_qdf_rcu.h"
+
+typedef __qdf_rcu_head_t qdf_rcu_head_t;
+typedef __qdf_rcu_callback_t qdf_rcu_callback_t;
+
+/**
+ * qdf_rcu_read_lock() - enter an RCU read side critical section
+ *
+ * Return: None
+ */
+#define qdf_rcu_read_lock() __qdf_rcu_read_lock()
+
+/**
+ * qdf_rcu_read_unlock() - leave an RCU read side critical section
+ *
+ * Return: None
+ */
+#define qdf_rcu_read_unlock() __qdf_rcu_read_unlock()
+
+/**
+ * qdf_synchronize_rcu() - wait for all pre-existing RCU readers to finish
+ *
+ * May sleep, must not be called from atomic context.
+ *
+ * Return: None
+ */
+#define qdf_synchronize_rcu() __qdf_synchronize_rcu()
+
+/**
+ * qdf_rcu_barrier() - wait for all queued qdf_call_rcu() callbacks to run
+ *
+ * Used on teardown paths so deferred frees have completed before the
+ * owning module or context goes away. May sleep.
+ *
+ * Return: None
+ */
+#define qdf_rcu_barrier() __qdf_rcu_barrier()
+
+/**
+ * qdf_rcu_dereference() - fetch an RCU protected pointer in a read section
+ * @ptr: pointer to fetch
+ *
+ * Return: value of @ptr
+ */
+#define qdf_rcu_dereference(ptr) __qdf_rcu_dereference(ptr)
+
+/**
+ * qdf_rcu_assign_pointer() - publish a pointer to RCU readers
+ * @ptr: pointer to assign to
+ * @val: new value, whose initialization is ordered before the publication
+ *
+ * Return: None
+ */
+#define qdf_rcu_assign_pointer(ptr, val) __qdf_rcu_assign_pointer(ptr, val)
+
+/**
+ * qdf_call_rcu() - run @func once all current RCU readers are done
+ * @head: rcu head embedded in the object to be reclaimed
+ * @func: callback, typically freeing the object containing @head
+ *
+ * Safe to call from any context, @func runs in softirq context.
+ *
+ * Return: None
+ */
+static inline void qdf_call_rcu(qdf_rcu_head_t *head, qdf_rcu_callback_t func)
+{
+	__qdf_call_rcu(head, func);
+}
+
+/**
+ * qdf_tailq_foreach_rcu() - iterate a TAILQ inside an RCU read section
+ * @var: loop cursor
+ * @head: TAILQ head
+ * @field: name of the TAILQ_ENTRY in the element
+ */
+#define qdf_tailq_foreach_rcu(var, head, field) \
+	for ((var) = qdf_rcu_dereference((head)->tqh_first); \
+	     (var); \
+	     (var) = qdf_rcu_dereference((var)->field.tqe_next))
+
+/**
+ * qdf_tailq_insert_tail_rcu() - append an element, visible to RCU readers
+ * @head: TAILQ head
+ * @elm: element to append, fully initialized
+ * @field: name of the TAILQ_ENTRY in the element
+ *
+ * Caller must hold the lock serializing writers of @head.
+ */
+#define qdf_tailq_insert_tail_rcu(head, elm, field) do { \
+	(elm)->field.tqe_next = NULL; \
+	(elm)->field.tqe_prev = (head)->tqh_last; \
+	qdf_rcu_assign_pointer(*(head)->tqh_last, (elm)); \
+	(head)->tqh_last = &(elm)->field.tqe_next; \
+} while (0)
+
+/**
+ * qdf_tailq_remove_rcu() - unlink an element that RCU readers may be on
+ * @head: TAILQ head
+ * @elm: element to unlink
+ * @field: name of the TAILQ_ENTRY in the element
+ *
+ * Unlike TAILQ_REMOVE(), the forward link of @elm is left intact so that a
+ * reader currently on @elm continues on to the rest of the list. @elm must
+ * not be freed before a grace period has elapsed. Linking it again through
+ * @field within that period is memory safe, but a reader still on @elm may
+ * then stop short of the end of the list it was walking. Caller must hold
+ * the lock serializing writers of @head.
+ */
+#define qdf_tailq_remove_rcu(head, elm, field) do { \
+	if ((elm)->field.tqe_next) \
+		(elm)->field.tqe_next->field.tqe_prev = \
+			(elm)->field.tqe_prev; \
+	else \
+		(head)->tqh_last = (elm)->field.tqe_prev; \
+	qdf_rcu_assign_pointer(*(elm)->field.tqe_prev, \
+			       (elm)->field.tqe_next); \
+} while (0)
+
+#endif /* __QDF_RCU_H */
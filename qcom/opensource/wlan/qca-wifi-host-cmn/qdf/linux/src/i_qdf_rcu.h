@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: i_qdf_rcu.h
+ * Linux-specific definitions for QDF read-copy-update APIs
+ */
+
+#ifndef __I_QDF_RCU_H
+#define __I_QDF_RCU_H
+
+#include <linux/rcupdate.h>
+
+typedef struct rcu_head __qdf_rcu_head_t;
+typedef void (*__qdf_rcu_callback_t)(__qdf_rcu_head_t *head);
+
+#define __qdf_rcu_read_lock() rcu_read_lock()
+#define __qdf_rcu_read_unlock() rcu_read_unlock()
+#define __qdf_synchronize_rcu() synchronize_rcu()
+#define __qdf_rcu_barrier() rcu_barrier()
+
+/*
+ * The datapath lists protected through these APIs are plain pointers and are
+ * not annotated with __rcu, hence the _raw flavour of the dereference.
+ */
+#define __qdf_rcu_dereference(ptr) rcu_dereference_raw(ptr)
+#define __qdf_rcu_assign_pointer(ptr, val) rcu_assign_pointer(ptr, val)
+
+static inline void __qdf_call_rcu(__qdf_rcu_head_t *head,
+				  __qdf_rcu_callback_t func)
+{
+	call_rcu(head, func);
+}
+
+#endif /* __I_QDF_RCU_H */
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2024 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "qdf_atomic.h"
+#include "qdf_lock.h"
+#include "qdf_mem.h"
+#include "qdf_rcu.h"
+#include "qdf_rcu_test.h"
+#include "qdf_threads.h"
+#include "qdf_time.h"
+#include "qdf_trace.h"
+#include "qdf_util.h"
+#include "queue.h"
+
+#define qdf_rcu_test_node_count 8
+
+/* sized like a loaded datapath peer hash: 4 entries per bin */
+#define qdf_rcu_test_bin_count 64
+#define qdf_rcu_test_key_count 256
+
+#define qdf_rcu_test_max_readers 4
+#define qdf_rcu_test_batch 1024
+#define qdf_rcu_test_churn 64
+#define qdf_rcu_test_run_ms 200
+
+#define qdf_rcu_test_live 0x1ea5ed
+#define qdf_rcu_test_dead 0xdeadbeef
+
+struct qdf_rcu_test_item {
+	uint32_t key;
+	uint32_t magic;
+	TAILQ_ENTRY(qdf_rcu_test_item) elem;
+	qdf_rcu_head_t rcu_head;
+};
+
+TAILQ_HEAD(qdf_rcu_test_list, qdf_rcu_test_item);
+
+static qdf_atomic_t qdf_rcu_test_freed;
+
+static void qdf_rcu_test_free_cb(qdf_rcu_head_t *head)
+{
+	struct qdf_rcu_test_item *item =
+		qdf_container_of(head, struct qdf_rcu_test_item, rcu_head);
+
+	item->magic = qdf_rcu_test_dead;
+	qdf_mem_free(item);
+	qdf_atomic_inc(&qdf_rcu_test_freed);
+}
+
+static uint32_t qdf_rcu_test_count(struct qdf_rcu_test_list *list)
+{
+	struct qdf_rcu_test_item *item;
+	uint32_t count = 0;
+
+	qdf_rcu_read_lock();
+	qdf_tailq_foreach_rcu(item, list, elem)
+		count++;
+	qdf_rcu_read_unlock();
+
+	return count;
+}
+
+static uint32_t qdf_rcu_test_insert_remove(void)
+{
+	struct qdf_rcu_test_list list;
+	struct qdf_rcu_test_item items[qdf_rcu_test_node_count];
+	struct qdf_rcu_test_item extra;
+	struct qdf_rcu_test_item *item;
+	uint32_t last = qdf_rcu_test_node_count - 1;
+	uint32_t i;
+
+	TAILQ_INIT(&list);
+
+	/* an empty list should not be iterated */
+	QDF_BUG(!qdf_rcu_test_count(&list));
+
+	/* items inserted at the tail should be visited in insertion order */
+	for (i = 0; i < qdf_rcu_test_node_count; i++) {
+		items[i].key = i;
+		qdf_tailq_insert_tail_rcu(&list, &items[i], elem);
+	}
+
+	i = 0;
+	qdf_rcu_read_lock();
+	qdf_tailq_foreach_rcu(item, &list, elem)
+		QDF_BUG(item->key == i++);
+	qdf_rcu_read_unlock();
+	QDF_BUG(i == qdf_rcu_test_node_count);
+
+	/* a removed item should keep its forward link for readers on it */
+	qdf_tailq_remove_rcu(&list, &items[3], elem);
+	QDF_BUG(TAILQ_NEXT(&items[3], elem) == &items[4]);
+	QDF_BUG(TAILQ_NEXT(&items[2], elem) == &items[4]);
+	QDF_BUG(items[4].elem.tqe_prev == &TAILQ_NEXT(&items[2], elem));
+
+	/* the head and the tail should be removable as well */
+	qdf_tailq_remove_rcu(&list, &items[0], elem);
+	QDF_BUG(TAILQ_FIRST(&list) == &items[1]);
+	qdf_tailq_remove_rcu(&list, &items[last], elem);
+	QDF_BUG(qdf_rcu_test_count(&list) == qdf_rcu_test_node_count - 3);
+
+	/* ... leaving a tail that can be appended to */
+	extra.key = qdf_rcu_test_node_count;
+	qdf_tailq_insert_tail_rcu(&list, &extra, elem);
+	QDF_BUG(TAILQ_NEXT(&items[last - 1], elem) == &extra);
+	QDF_BUG(list.tqh_last == &TAILQ_NEXT(&extra, elem));
+
+	/* the writer side TAILQ API should agree with the RCU walk */
+	i = 0;
+	TAILQ_FOREACH(item, &list, elem)
+		i++;
+	QDF_BUG(i == qdf_rcu_test_count(&list));
+
+	return 0;
+}
+
+static uint32_t qdf_rcu_test_call_rcu(void)
+{
+	struct qdf_rcu_test_item *item;
+	uint32_t i;
+
+	qdf_atomic_set(&qdf_rcu_test_freed, 0);
+
+	for (i = 0; i < qdf_rcu_test_node_count; i++) {
+		item = qdf_mem_malloc(sizeof(*item));
+		if (!item)
+			break;
+
+		item->magic = qdf_rcu_test_live;
+		qdf_call_rcu(&item->rcu_head, qdf_rcu_test_free_cb);
+	}
+
+	/* every queued callback should have run once the barrier returns */
+	qdf_rcu_barrier();
+	QDF_BUG(qdf_atomic_read(&qdf_rcu_test_freed) == i);
+
+	return i == qdf_rcu_test_node_count ? 0 : 1;
+}
+
+/**
+ * struct qdf_rcu_test_table - hash table for the lookup benchmark
+ * @bins: hash buckets, keyed by qdf_rcu_test_item.key
+ * @lock: serializes writers, and readers as well when !@use_rcu
+ * @use_rcu: readers walk the buckets inside an RCU read section
+ * @misses: lookups that did not find a key, which is always present
+ */
+struct qdf_rcu_test_table {
+	struct qdf_rcu_test_list bins[qdf_rcu_test_bin_count];
+	qdf_spinlock_t lock;
+	bool use_rcu;
+	qdf_atomic_t misses;
+};
+
+/**
+ * struct qdf_rcu_test_reader - per thread state of a benchmark reader
+ * @table: table to look keys up in
+ * @seed: seed of the key sequence
+ * @lookups: number of lookups done
+ * @elapsed_ns: time taken by @lookups
+ */
+struct qdf_rcu_test_reader {
+	struct qdf_rcu_test_table *table;
+	uint32_t seed;
+	uint64_t lookups;
+	unsigned long long elapsed_ns;
+};
+
+static struct qdf_rcu_test_list *
+qdf_rcu_test_bin(struct qdf_rcu_test_table *table, uint32_t key)
+{
+	return &table->bins[key % qdf_rcu_test_bin_count];
+}
+
+static bool qdf_rcu_test_lookup(struct qdf_rcu_test_table *table,
+				uint32_t key)
+{
+	struct qdf_rcu_test_list *bin = qdf_rcu_test_bin(table, key);
+	struct qdf_rcu_test_item *item;
+	bool found = false;
+
+	if (!table->use_rcu) {
+		qdf_spin_lock_bh(&table->lock);
+		TAILQ_FOREACH(item, bin, elem) {
+			if (item->key == key) {
+				found = item->magic == qdf_rcu_test_live;
+				break;
+			}
+		}
+		qdf_spin_unlock_bh(&table->lock);
+
+		return found;
+	}
+
+	qdf_rcu_read_lock();
+	qdf_tailq_foreach_rcu(item, bin, elem) {
+		if (item->key == key) {
+			found = item->magic == qdf_rcu_test_live;
+			break;
+		}
+	}
+	qdf_rcu_read_unlock();
+
+	return found;
+}
+
+static QDF_STATUS qdf_rcu_test_replace(struct qdf_rcu_test_table *table,
+				       uint32_t key)
+{
+	struct qdf_rcu_test_list *bin = qdf_rcu_test_bin(table, key);
+	struct qdf_rcu_test_item *new_item;
+	struct qdf_rcu_test_item *old_item;
+
+	new_item = qdf_mem_malloc(sizeof(*new_item));
+	if (!new_item)
+		return QDF_STATUS_E_NOMEM;
+
+	new_item->key = key;
+	new_item->magic = qdf_rcu_test_live;
+
+	qdf_spin_lock_bh(&table->lock);
+	TAILQ_FOREACH(old_item, bin, elem) {
+		if (old_item->key == key)
+			break;
+	}
+	QDF_BUG(old_item);
+
+	/* publish the replacement first, so readers never miss the key */
+	qdf_tailq_insert_tail_rcu(bin, new_item, elem);
+	if (old_item)
+		qdf_tailq_remove_rcu(bin, old_item, elem);
+	qdf_spin_unlock_bh(&table->lock);
+
+	if (!old_item)
+		return QDF_STATUS_SUCCESS;
+
+	if (table->use_rcu) {
+		qdf_call_rcu(&old_item->rcu_head, qdf_rcu_test_free_cb);
+	} else {
+		old_item->magic = qdf_rcu_test_dead;
+		qdf_mem_free(old_item);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS qdf_rcu_test_reader_run(void *context)
+{
+	struct qdf_rcu_test_reader *reader = context;
+	unsigned long long start;
+	uint32_t key = reader->seed;
+	uint32_t i;
+
+	start = qdf_time_sched_clock();
+	while (!qdf_thread_should_stop()) {
+		for (i = 0; i < qdf_rcu_test_batch; i++) {
+			key = key * 1664525 + 1013904223;
+			if (!qdf_rcu_test_lookup(reader->table,
+						 key % qdf_rcu_test_key_count))
+				qdf_atomic_inc(&reader->table->misses);
+		}
+		reader->lookups += qdf_rcu_test_batch;
+		schedule();
+	}
+	reader->elapsed_ns = qdf_time_sched_clock() - start;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS qdf_rcu_test_writer_run(void *context)
+{
+	struct qdf_rcu_test_table *table = context;
+	uint32_t key = 0;
+	uint32_t i;
+	QDF_STATUS status;
+
+	while (!qdf_thread_should_stop()) {
+		for (i = 0; i < qdf_rcu_test_churn; i++) {
+			status = qdf_rcu_test_replace(table, key);
+			if (QDF_IS_STATUS_ERROR(status))
+				return status;
+
+			key = (key + 1) % qdf_rcu_test_key_count;
+		}
+		qdf_sleep_us(1);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS qdf_rcu_test_table_init(struct qdf_rcu_test_table *table,
+					  bool use_rcu)
+{
+	struct qdf_rcu_test_item *item;
+	uint32_t i;
+
+	for (i = 0; i < qdf_rcu_test_bin_count; i++)
+		TAILQ_INIT(&table->bins[i]);
+
+	qdf_spinlock_create(&table->lock);
+	table->use_rcu = use_rcu;
+	qdf_atomic_init(&table->misses);
+
+	for (i = 0; i < qdf_rcu_test_key_count; i++) {
+		item = qdf_mem_malloc(sizeof(*item));
+		if (!item)
+			return QDF_STATUS_E_NOMEM;
+
+		item->key = i;
+		item->magic = qdf_rcu_test_live;
+		TAILQ_INSERT_TAIL(qdf_rcu_test_bin(table, i), item, elem);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static void qdf_rcu_test_table_deinit(struct qdf_rcu_test_table *table)
+{
+	struct qdf_rcu_test_item *item, *next;
+	uint32_t i;
+
+	for (i = 0; i < qdf_rcu_test_bin_count; i++) {
+		TAILQ_FOREACH_SAFE(item, &table->bins[i], elem, next) {
+			TAILQ_REMOVE(&table->bins[i], item, elem);
+			qdf_mem_free(item);
+		}
+	}
+
+	qdf_spinlock_destroy(&table->lock);
+}
+
+static uint32_t qdf_rcu_test_bench_run(bool use_rcu, uint32_t num_readers,
+				       bool churn)
+{
+	struct qdf_rcu_test_reader readers[qdf_rcu_test_max_readers] = { 0 };
+	qdf_thread_t *threads[qdf_rcu_test_max_readers];
+	qdf_thread_t *writer = NULL;
+	struct qdf_rcu_test_table *table;
+	uint64_t lookups = 0;
+	uint64_t rate = 0;
+	uint32_t elapsed_us;
+	uint32_t errors = 0;
+	uint32_t started;
+	uint32_t i;
+	int misses;
+
+	table = qdf_mem_malloc(sizeof(*table));
+	if (!table)
+		return 1;
+
+	if (QDF_IS_STATUS_ERROR(qdf_rcu_test_table_init(table, use_rcu))) {
+		errors++;
+		goto deinit;
+	}
+
+	for (started = 0; started < num_readers; started++) {
+		readers[started].table = table;
+		readers[started].seed = started + 1;
+		threads[started] = qdf_thread_run(qdf_rcu_test_reader_run,
+						  &readers[started]);
+		if (!threads[started]) {
+			errors++;
+			break;
+		}
+	}
+
+	if (churn) {
+		writer = qdf_thread_run(qdf_rcu_test_writer_run, table);
+		if (!writer)
+			errors++;
+	}
+
+	qdf_sleep(qdf_rcu_test_run_ms);
+
+	if (writer && QDF_IS_STATUS_ERROR(qdf_thread_join(writer)))
+		errors++;
+
+	for (i = 0; i < started; i++) {
+		qdf_thread_join(threads[i]);
+
+		elapsed_us = qdf_do_div(readers[i].elapsed_ns, 1000);
+		if (!elapsed_us)
+			continue;
+
+		lookups += readers[i].lookups;
+		rate += qdf_do_div(readers[i].lookups * 1000000, elapsed_us);
+	}
+
+	qdf_nofl_info("qdf rcu bench: %-8s x%u readers%s: %llu lookups/s (%llu lookups)",
+		      use_rcu ? "rcu" : "spinlock", num_readers,
+		      churn ? " + writer" : "",
+		      (unsigned long long)rate, (unsigned long long)lookups);
+
+	misses = qdf_atomic_read(&table->misses);
+	if (misses) {
+		qdf_nofl_alert("FAIL: %s lookups missed %d present keys",
+			       use_rcu ? "rcu" : "spinlock", misses);
+		errors++;
+	}
+
+deinit:
+	qdf_rcu_test_table_deinit(table);
+	qdf_mem_free(table);
+
+	/* the replaced entries are freed through call_rcu */
+	qdf_rcu_barrier();
+
+	return errors;
+}
+
+static uint32_t qdf_rcu_test_bench(void)
+{
+	uint32_t errors = 0;
+	uint32_t readers;
+
+	for (readers = 1; readers <= qdf_rcu_test_max_readers; readers <<= 1) {
+		errors += qdf_rcu_test_bench_run(false, readers, false);
+		errors += qdf_rcu_test_bench_run(true, readers, false);
+		errors += qdf_rcu_test_bench_run(false, readers, true);
+		errors += qdf_rcu_test_bench_run(true, readers, true);
+	}
+
+	return errors;
+}
+
+uint32_t qdf_rcu_unit_test(void)
+{
+	uint32_t errors = 0;
+
+	errors += qdf_rcu_test_insert_remove();
+	errors += qdf_rcu_test_call_rcu();
+	errors += qdf_rcu_test_bench();
+
+	return errors;
+}
@@ -607,6 +607,7 @@ struct dp_rx_fst {
  * @sap_tx_block_mask: SAP TX block mask
  * @gro_disallowed: GRO disallowed flag
  * @gro_flushed: GRO flushed flag
+ * @gro_lock: Lock serializing the GRO/FISA disallow updates of the rx contexts
  * @fisa_disallowed: Flag to indicate fisa aggregation not to be done for a
  *		     particular rx_context
  * @fisa_force_flushed: Flag to indicate FISA flow has been flushed for a
@@ -668,7 +669,8 @@ struct wlan_dp_intf {
 	uint32_t sap_tx_block_mask;
 
 	qdf_atomic_t gro_disallowed;
-	uint8_t gro_flushed[DP_MAX_RX_THREADS];
+	qdf_atomic_t gro_flushed[DP_MAX_RX_THREADS];
+	qdf_spinlock_t gro_lock;
 
 #ifdef WLAN_SUPPORT_RX_FISA
 	/*
@@ -868,7 +870,7 @@ struct wlan_dp_psoc_context {
 
 	struct {
 		qdf_atomic_t rx_aggregation;
-		uint8_t gro_force_flush[DP_MAX_RX_THREADS];
+		qdf_atomic_t gro_force_flush[DP_MAX_RX_THREADS];
 		bool tc_based_dyn_gro;
 		uint32_t tc_ingress_prio;
 	}
@@ -63,6 +63,9 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
  * @rx_nbufq_loop_yield: rx loop yield counter
+ * @flows_migrated_in: flow buckets steered to the thread by rebalancing
+ * @flows_migrated_out: flow buckets steered away from the thread by
+ *			rebalancing
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -79,8 +82,75 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
 	unsigned int rx_nbufq_loop_yield;
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+	unsigned int flows_migrated_in;
+	unsigned int flows_migrated_out;
+#endif
+};
+
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+/* Number of flow buckets per REO ring, must be a power of 2 */
+#define DP_RX_TM_FLOW_BUCKETS 64
+/* Pending packets spread between rx threads that triggers rebalancing */
+#define DP_RX_TM_IMBALANCE_THRESH 256
+/* Maximum number of flow buckets migrated per GRO flush indication */
+#define DP_RX_TM_MAX_FLOW_MIGRATE 4
+
+/**
+ * struct dp_rx_tm_flow_bucket - rx thread steering entry for a set of flows
+ * @thread_id: rx thread the flows of the bucket are steered to
+ * @pkts: packets steered through the bucket, halved at every GRO flush
+ *	  indication of the ring
+ * @last_enq: enqueue sequence number, within the ring and @thread_id, of the
+ *	      last packet of the bucket
+ */
+struct dp_rx_tm_flow_bucket {
+	uint8_t thread_id;
+	uint32_t pkts;
+	uint32_t last_enq;
+};
+
+/**
+ * struct dp_rx_tm_flow_table - rx thread steering table of a REO ring
+ * @lock: lock serializing enqueue and rebalancing for the ring
+ * @bucket: flow buckets, indexed by a hash of the RX flow id
+ * @enq_cnt: packets of the ring enqueued to each rx thread so far
+ * @flush_pending: bitmap of rx threads which got packets of the ring since
+ *		   its last GRO flush indication
+ */
+struct dp_rx_tm_flow_table {
+	qdf_spinlock_t lock;
+	struct dp_rx_tm_flow_bucket bucket[DP_RX_TM_FLOW_BUCKETS];
+	qdf_atomic_t enq_cnt[DP_MAX_RX_THREADS];
+	unsigned long flush_pending;
 };
 
+/**
+ * struct dp_rx_thread_flow_ctx - rx thread side state of RX flow steering
+ * @pending: packets enqueued to the thread and not yet dequeued or flushed
+ * @deq_cnt: packets of each REO ring dequeued by the thread, only accessed
+ *	     from the thread itself
+ * @flushed_cnt: @deq_cnt as of the last full GRO flush of the thread, all
+ *		 packets below it have left the thread and its GRO context
+ * @skip_cnt: packets of each REO ring removed by vdev flushes and not yet
+ *	      added to @deq_cnt, protected by the nbuf queue lock
+ * @skip_at: @deq_cnt of each REO ring at which the packets kept in the
+ *	     queue by the last vdev flush have all been dequeued, protected
+ *	     by the nbuf queue lock
+ * @skip_pending: some @skip_cnt is not zero
+ * @gro_enabled: packets are delivered through the thread napi
+ */
+struct dp_rx_thread_flow_ctx {
+	qdf_atomic_t pending;
+	uint32_t deq_cnt[DP_RX_TM_MAX_REO_RINGS];
+	qdf_atomic_t flushed_cnt[DP_RX_TM_MAX_REO_RINGS];
+	uint32_t skip_cnt[DP_RX_TM_MAX_REO_RINGS];
+	uint32_t skip_at[DP_RX_TM_MAX_REO_RINGS];
+	bool skip_pending;
+	bool gro_enabled;
+};
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
 /**
  * enum dp_rx_refill_thread_state - enum to keep track of rx refill thread state
  * @DP_RX_REFILL_THREAD_INVALID: initial invalid state
@@ -117,6 +187,7 @@ enum dp_rx_refill_thread_state {
  * @napi: napi to deliver packet to stack via GRO
  * @wait_q: wait queue to conditionally wait on events for DP Rx thread
  * @netdev: dummy netdev to initialize the napi structure with
+ * @flow: RX flow steering state of the thread
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -135,6 +206,9 @@ struct dp_rx_thread {
 	qdf_napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	qdf_dummy_netdev_t netdev;
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+	struct dp_rx_thread_flow_ctx flow;
+#endif
 };
 
 /**
@@ -185,6 +259,9 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @flow_table: per REO ring flow to rx thread steering tables
+ * @rebalances: number of GRO flush indications which migrated flows
+ * @max_imbalance: largest pending packets spread seen between rx threads
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -192,6 +269,11 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+	struct dp_rx_tm_flow_table *flow_table;
+	uint32_t rebalances;
+	uint32_t max_imbalance;
+#endif
 };
 
 /**
@@ -361,6 +443,10 @@ dp_rx_thread_get_txrx_handle(struct dp_rx_tm_handle_cmn *rx_tm_handle_cmn)
  * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread
  *             infrastructure
  *
+ * With RX flow steering the packets of a ring are spread over several
+ * threads, so the NAPI of the calling rx thread is returned when called
+ * from one.
+ *
  * Return: NULL on failure, else pointer to NAPI corresponding to rx_ctx_id
  */
 qdf_napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
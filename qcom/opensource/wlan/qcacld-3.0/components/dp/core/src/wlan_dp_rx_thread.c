@@ -176,6 +176,49 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 		rx_thread->stats.dropped_enq_fail);
 }
 
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+/**
+ * dp_rx_tm_dump_load_stats() - display load imbalance between rx threads
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * Return: None
+ */
+static void dp_rx_tm_dump_load_stats(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	char pending_string[200];
+	uint32_t off = 0;
+	int32_t pending, max_pending = 0, min_pending = 0;
+	int i;
+
+	qdf_mem_zero(pending_string, sizeof(pending_string));
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (!rx_tm_hdl->rx_thread[i])
+			continue;
+		pending = qdf_atomic_read(&rx_tm_hdl->rx_thread[i]->flow.pending);
+		if (!i || pending > max_pending)
+			max_pending = pending;
+		if (!i || pending < min_pending)
+			min_pending = pending;
+		if (off >= sizeof(pending_string))
+			continue;
+		off += qdf_scnprintf(&pending_string[off],
+				     sizeof(pending_string) - off,
+				     "thread[%d]:%d(in:%u out:%u) ", i, pending,
+				     rx_tm_hdl->rx_thread[i]->stats.flows_migrated_in,
+				     rx_tm_hdl->rx_thread[i]->stats.flows_migrated_out);
+	}
+
+	dp_info("rx thread load - pending:(%s) imbalance:%d max_imbalance:%u rebalances:%u",
+		pending_string, max_pending - min_pending,
+		rx_tm_hdl->max_imbalance, rx_tm_hdl->rebalances);
+}
+#else
+static inline void dp_rx_tm_dump_load_stats(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
 QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
 {
 	int i;
@@ -185,6 +228,8 @@ QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
 			continue;
 		dp_rx_tm_thread_dump_stats(rx_tm_hdl->rx_thread[i]);
 	}
+	dp_rx_tm_dump_load_stats(rx_tm_hdl);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -265,6 +310,232 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
 }
 #endif
 
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+/**
+ * dp_rx_thread_flow_init() - initialize RX flow steering state of a thread
+ * @rx_thread: rx_thread being initialized
+ *
+ * Return: None
+ */
+static void dp_rx_thread_flow_init(struct dp_rx_thread *rx_thread)
+{
+	int i;
+
+	qdf_atomic_init(&rx_thread->flow.pending);
+	for (i = 0; i < DP_RX_TM_MAX_REO_RINGS; i++) {
+		rx_thread->flow.deq_cnt[i] = 0;
+		qdf_atomic_init(&rx_thread->flow.flushed_cnt[i]);
+		rx_thread->flow.skip_cnt[i] = 0;
+		rx_thread->flow.skip_at[i] = 0;
+	}
+	rx_thread->flow.skip_pending = false;
+	rx_thread->flow.gro_enabled =
+		cdp_cfg_get(dp_rx_tm_get_soc_handle(rx_thread->rtm_handle_cmn),
+			    cfg_dp_gro_enable);
+}
+
+/**
+ * dp_rx_thread_flow_enqueued() - account packets enqueued to a thread
+ * @rx_thread: rx_thread the packets were enqueued to
+ * @num_pkts: number of packets
+ *
+ * Return: None
+ */
+static inline void dp_rx_thread_flow_enqueued(struct dp_rx_thread *rx_thread,
+					      uint32_t num_pkts)
+{
+	qdf_atomic_add(num_pkts, &rx_thread->flow.pending);
+}
+
+/**
+ * dp_rx_thread_flow_dequeued() - account packets dequeued by a thread
+ * @rx_thread: rx_thread which dequeued the packets
+ * @reo_ring_num: REO ring the packets were received on
+ * @num_pkts: number of packets
+ *
+ * Return: None
+ */
+static inline void dp_rx_thread_flow_dequeued(struct dp_rx_thread *rx_thread,
+					      uint8_t reo_ring_num,
+					      uint32_t num_pkts)
+{
+	qdf_atomic_sub(num_pkts, &rx_thread->flow.pending);
+	if (qdf_likely(reo_ring_num < DP_RX_TM_MAX_REO_RINGS))
+		rx_thread->flow.deq_cnt[reo_ring_num] += num_pkts;
+}
+
+/**
+ * dp_rx_thread_flow_flushed() - account packets removed by a vdev flush
+ * @rx_thread: rx_thread the packets were removed from
+ * @num_pkts: number of packets
+ *
+ * Their dequeue count is accounted by dp_rx_thread_flow_skip().
+ *
+ * Return: None
+ */
+static inline void dp_rx_thread_flow_flushed(struct dp_rx_thread *rx_thread,
+					     uint32_t num_pkts)
+{
+	qdf_atomic_sub(num_pkts, &rx_thread->flow.pending);
+}
+
+/**
+ * dp_rx_thread_flow_skip() - account packets removed by a vdev flush
+ * @rx_thread: rx_thread the packets were removed from
+ * @reo_ring_num: REO ring the packets were received on
+ * @num_pkts: number of packets
+ *
+ * The removed packets are never dequeued, and packets of the ring kept in
+ * the queue may be ahead of them. They are added to the dequeue count once
+ * the thread has dequeued every packet of the ring enqueued so far, except
+ * the removed ones.
+ *
+ * Caller holds the lock of the ring flow table, so every packet of the
+ * ring in the queue is counted in its enqueue count, and the queue lock.
+ *
+ * Return: None
+ */
+static void dp_rx_thread_flow_skip(struct dp_rx_thread *rx_thread,
+				   uint8_t reo_ring_num, uint32_t num_pkts)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread_flow_ctx *flow = &rx_thread->flow;
+
+	flow->skip_cnt[reo_ring_num] += num_pkts;
+	flow->skip_at[reo_ring_num] =
+		qdf_atomic_read(&rx_tm_hdl->flow_table[reo_ring_num].
+				enq_cnt[rx_thread->id]) -
+		flow->skip_cnt[reo_ring_num];
+	flow->skip_pending = true;
+}
+
+/**
+ * dp_rx_thread_flow_unskip() - add packets removed by vdev flushes to the
+ *				dequeue counts
+ * @rx_thread: rx_thread about to publish its dequeue counts
+ *
+ * Return: None
+ */
+static void dp_rx_thread_flow_unskip(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_thread_flow_ctx *flow = &rx_thread->flow;
+	bool skip_pending = false;
+	int i;
+
+	if (qdf_likely(!flow->skip_pending))
+		return;
+
+	qdf_local_bh_disable();
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	for (i = 0; i < DP_RX_TM_MAX_REO_RINGS; i++) {
+		if (!flow->skip_cnt[i])
+			continue;
+		if ((int32_t)(flow->deq_cnt[i] - flow->skip_at[i]) >= 0) {
+			flow->deq_cnt[i] += flow->skip_cnt[i];
+			flow->skip_cnt[i] = 0;
+		} else {
+			skip_pending = true;
+		}
+	}
+	flow->skip_pending = skip_pending;
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+	qdf_local_bh_enable();
+}
+
+/**
+ * dp_rx_thread_flow_sync() - resync dequeue counts of an idle thread
+ * @rx_thread: rx_thread whose nbuf queue was found empty
+ *
+ * Drops at enqueue never advance the enqueue counts and vdev flushes are
+ * accounted by dp_rx_thread_flow_skip(). This catches up with anything else
+ * which left the queue without being dequeued: once the queue is empty,
+ * every packet enqueued so far is gone, so the dequeue counts catch up with
+ * the enqueue counts of the rings. An enqueue count is only advanced after
+ * its packets are in the queue, hence reading it under the queue lock
+ * cannot count packets still to be queued.
+ *
+ * Return: None
+ */
+static void dp_rx_thread_flow_sync(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	int i;
+
+	qdf_local_bh_disable();
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	if (!qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue)) {
+		for (i = 0; i < DP_RX_TM_MAX_REO_RINGS; i++) {
+			rx_thread->flow.deq_cnt[i] = qdf_atomic_read(
+				&rx_tm_hdl->flow_table[i].enq_cnt[rx_thread->id]);
+			rx_thread->flow.skip_cnt[i] = 0;
+		}
+		rx_thread->flow.skip_pending = false;
+	}
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+	qdf_local_bh_enable();
+}
+
+/**
+ * dp_rx_thread_flow_gro_flushed() - publish packets which left a thread
+ * @rx_thread: rx_thread which finished a round of processing
+ * @gro_flush_code: GRO flush done by the thread in this round
+ *
+ * Only a full GRO flush pushes the packets held by the thread napi to the
+ * stack, a flow can be moved to another thread once all its packets are
+ * below the published count.
+ *
+ * Return: None
+ */
+static void
+dp_rx_thread_flow_gro_flushed(struct dp_rx_thread *rx_thread,
+			      enum dp_rx_gro_flush_code gro_flush_code)
+{
+	int i;
+
+	if (rx_thread->flow.gro_enabled &&
+	    gro_flush_code != DP_RX_GRO_NORMAL_FLUSH)
+		return;
+
+	dp_rx_thread_flow_unskip(rx_thread);
+
+	for (i = 0; i < DP_RX_TM_MAX_REO_RINGS; i++)
+		qdf_atomic_set(&rx_thread->flow.flushed_cnt[i],
+			       rx_thread->flow.deq_cnt[i]);
+}
+#else
+static inline void dp_rx_thread_flow_init(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_thread_flow_enqueued(struct dp_rx_thread *rx_thread,
+					      uint32_t num_pkts)
+{
+}
+
+static inline void dp_rx_thread_flow_dequeued(struct dp_rx_thread *rx_thread,
+					      uint8_t reo_ring_num,
+					      uint32_t num_pkts)
+{
+}
+
+static inline void dp_rx_thread_flow_flushed(struct dp_rx_thread *rx_thread,
+					     uint32_t num_pkts)
+{
+}
+
+static inline void dp_rx_thread_flow_sync(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void
+dp_rx_thread_flow_gro_flushed(struct dp_rx_thread *rx_thread,
+			      enum dp_rx_gro_flush_code gro_flush_code)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
 /**
  * dp_rx_tm_thread_enqueue() - enqueue nbuf list into rx_thread
  * @rx_thread: rx_thread in which the nbuf needs to be queued
@@ -276,8 +547,8 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
  * nbuf is queued into the thread nbuf queue. The reverse is
  * done at the time of dequeue.
  *
- * Returns: QDF_STATUS_SUCCESS on success or qdf error code on
- * failure
+ * Returns: QDF_STATUS_SUCCESS on success, QDF_STATUS_E_RESOURCES if the
+ * packets were dropped or qdf error code on failure
  */
 static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 					  qdf_nbuf_t nbuf_list)
@@ -290,6 +561,7 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 	uint8_t reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
 	qdf_wait_queue_head_t *wait_q_ptr;
 	uint8_t allow_dropping;
+	QDF_STATUS status = QDF_STATUS_SUCCESS;
 
 	tm_handle_cmn = rx_thread->rtm_handle_cmn;
 
@@ -316,10 +588,12 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 		qdf_nbuf_list_free(nbuf_list);
 		rx_thread->stats.dropped_enq_fail += num_elements_in_nbuf;
 		nbuf_queued = 0;
+		status = QDF_STATUS_E_RESOURCES;
 		goto enq_done;
 	}
 
 	dp_rx_tm_walk_skb_list(nbuf_list);
+	dp_rx_thread_flow_enqueued(rx_thread, num_elements_in_nbuf);
 
 	head_ptr = nbuf_list;
 
@@ -372,7 +646,7 @@ enq_done:
 	qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
 	qdf_wake_up_interruptible(wait_q_ptr);
 
-	return QDF_STATUS_SUCCESS;
+	return status;
 }
 
 /**
@@ -478,6 +752,7 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	ol_txrx_soc_handle soc;
 	uint32_t num_list_elements = 0;
 	uint32_t iterates = 0;
+	uint8_t reo_ring_num;
 
 	struct dp_txrx_handle_cmn *txrx_handle_cmn;
 
@@ -498,6 +773,9 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	while (nbuf_list) {
 		num_list_elements =
 			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+		reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
+		dp_rx_thread_flow_dequeued(rx_thread, reo_ring_num,
+					   num_list_elements);
 		/* count aggregated RX frame into stats */
 		num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
 		rx_thread->stats.nbuf_dequeued += num_list_elements;
@@ -525,6 +803,9 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 		nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	}
 
+	if (!nbuf_list)
+		dp_rx_thread_flow_sync(rx_thread);
+
 	dp_debug("exit: qlen  %u",
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
 
@@ -614,6 +895,7 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 			dp_rx_thread_gro_flush(rx_thread, gro_flush_code);
 			qdf_atomic_set(&rx_thread->gro_flush_ind, 0);
 		}
+		dp_rx_thread_flow_gro_flushed(rx_thread, gro_flush_code);
 
 		if (qdf_atomic_test_and_clear_bit(RX_VDEV_DEL_EVENT,
 						  &rx_thread->event_flag)) {
@@ -846,6 +1128,7 @@ static QDF_STATUS dp_rx_tm_thread_init(struct dp_rx_thread *rx_thread,
 	qdf_event_create(&rx_thread->vdev_del_event);
 	qdf_atomic_init(&rx_thread->gro_flush_ind);
 	qdf_init_waitqueue_head(&rx_thread->wait_q);
+	dp_rx_thread_flow_init(rx_thread);
 	qdf_scnprintf(thread_name, sizeof(thread_name), "dp_rx_thread_%u", id);
 	dp_info("%s %u", thread_name, id);
 
@@ -948,6 +1231,74 @@ QDF_STATUS dp_rx_refill_thread_deinit(struct dp_rx_refill_thread *refill_thread)
 	return QDF_STATUS_SUCCESS;
 }
 
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+/**
+ * dp_rx_tm_flow_table_init() - allocate and initialize RX flow steering
+ * tables
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * The flow buckets of each ring start out spread round robin over the rx
+ * threads, beginning with the thread the ring used to be mapped to.
+ *
+ * Return: QDF_STATUS_SUCCESS on success, QDF_STATUS_E_NOMEM otherwise
+ */
+static QDF_STATUS dp_rx_tm_flow_table_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	struct dp_rx_tm_flow_table *table;
+	int ring, i;
+
+	rx_tm_hdl->flow_table =
+		qdf_mem_malloc(DP_RX_TM_MAX_REO_RINGS *
+			       sizeof(struct dp_rx_tm_flow_table));
+	if (!rx_tm_hdl->flow_table)
+		return QDF_STATUS_E_NOMEM;
+
+	for (ring = 0; ring < DP_RX_TM_MAX_REO_RINGS; ring++) {
+		table = &rx_tm_hdl->flow_table[ring];
+		qdf_spinlock_create(&table->lock);
+		for (i = 0; i < DP_RX_TM_FLOW_BUCKETS; i++)
+			table->bucket[i].thread_id =
+				(ring + i) % rx_tm_hdl->num_dp_rx_threads;
+		for (i = 0; i < DP_MAX_RX_THREADS; i++)
+			qdf_atomic_init(&table->enq_cnt[i]);
+	}
+	rx_tm_hdl->rebalances = 0;
+	rx_tm_hdl->max_imbalance = 0;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * dp_rx_tm_flow_table_deinit() - free RX flow steering tables
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * Return: None
+ */
+static void dp_rx_tm_flow_table_deinit(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	int ring;
+
+	if (!rx_tm_hdl->flow_table)
+		return;
+
+	for (ring = 0; ring < DP_RX_TM_MAX_REO_RINGS; ring++)
+		qdf_spinlock_destroy(&rx_tm_hdl->flow_table[ring].lock);
+
+	qdf_mem_free(rx_tm_hdl->flow_table);
+	rx_tm_hdl->flow_table = NULL;
+}
+#else
+static inline QDF_STATUS
+dp_rx_tm_flow_table_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline void dp_rx_tm_flow_table_deinit(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
 QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 			 uint8_t num_dp_rx_threads)
 {
@@ -974,6 +1325,10 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 		goto ret;
 	}
 
+	qdf_status = dp_rx_tm_flow_table_init(rx_tm_hdl);
+	if (!QDF_IS_STATUS_SUCCESS(qdf_status))
+		goto ret;
+
 	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
 		rx_tm_hdl->rx_thread[i] =
 			(struct dp_rx_thread *)
@@ -1100,29 +1455,77 @@ suspend_fail:
 	return qdf_status;
 }
 
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
 /**
- * dp_rx_thread_flush_by_vdev_id() - flush rx packets by vdev_id in
+ * dp_rx_thread_unlink_by_vdev_id() - take rx packets of a vdev_id out of
  * a particular rx thread queue
  * @rx_thread: rx_thread pointer of the queue from which packets are
- * to be flushed out
- * @vdev_id: vdev id for which packets are to be flushed
- * @wait_timeout: wait time value for rx thread to complete flush
+ * to be taken out
+ * @vdev_id: vdev id for which packets are to be taken out
  *
- * The function will flush the RX packets by vdev_id in a particular
- * RX thead queue. And will notify and wait the TX thread to flush the
- * packets in the NAPI RX GRO hash list
+ * The queue is walked once per REO ring under the lock of the ring flow
+ * table, so that the packets taken out are accounted in the dequeue count
+ * of their ring.
  *
- * Return: Success/Failure
+ * Return: list of the packets taken out, linked through the queue
  */
-static inline
-QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
-					 uint8_t vdev_id, int wait_timeout)
+static qdf_nbuf_t dp_rx_thread_unlink_by_vdev_id(struct dp_rx_thread *rx_thread,
+						 uint8_t vdev_id)
 {
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_tm_flow_table *table;
 	qdf_nbuf_t nbuf_list, tmp_nbuf_list;
-	uint32_t num_list_elements = 0;
-	QDF_STATUS qdf_status = QDF_STATUS_SUCCESS;
+	qdf_nbuf_t nbuf_list_head = NULL;
+	uint64_t lock_time, unlock_time;
+	uint32_t num_pkts;
+	int i;
+
+	for (i = 0; i < DP_RX_TM_MAX_REO_RINGS; i++) {
+		table = &rx_tm_hdl->flow_table[i];
+		num_pkts = 0;
+
+		qdf_spin_lock_bh(&table->lock);
+		qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+		lock_time = qdf_get_log_timestamp();
+		QDF_NBUF_QUEUE_WALK_SAFE(&rx_thread->nbuf_queue, nbuf_list,
+					 tmp_nbuf_list) {
+			if (QDF_NBUF_CB_RX_VDEV_ID(nbuf_list) == vdev_id &&
+			    QDF_NBUF_CB_RX_CTX_ID(nbuf_list) == i) {
+				qdf_nbuf_unlink_no_lock(nbuf_list,
+							&rx_thread->nbuf_queue);
+				num_pkts +=
+				QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+				DP_RX_HEAD_APPEND(nbuf_list_head, nbuf_list);
+			}
+		}
+		if (num_pkts)
+			dp_rx_thread_flow_skip(rx_thread, i, num_pkts);
+		qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+		qdf_spin_unlock_bh(&table->lock);
+		unlock_time = qdf_get_log_timestamp();
+		dp_info("ring %d lock held time: %llu us", i,
+			qdf_log_timestamp_to_usecs(unlock_time - lock_time));
+	}
+
+	return nbuf_list_head;
+}
+#else
+/**
+ * dp_rx_thread_unlink_by_vdev_id() - take rx packets of a vdev_id out of
+ * a particular rx thread queue
+ * @rx_thread: rx_thread pointer of the queue from which packets are
+ * to be taken out
+ * @vdev_id: vdev id for which packets are to be taken out
+ *
+ * Return: list of the packets taken out, linked through the queue
+ */
+static qdf_nbuf_t dp_rx_thread_unlink_by_vdev_id(struct dp_rx_thread *rx_thread,
+						 uint8_t vdev_id)
+{
+	qdf_nbuf_t nbuf_list, tmp_nbuf_list;
+	qdf_nbuf_t nbuf_list_head = NULL;
 	uint64_t lock_time, unlock_time;
-	qdf_nbuf_t nbuf_list_head = NULL, nbuf_list_next;
 
 	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
 	lock_time = qdf_get_log_timestamp();
@@ -1139,6 +1542,34 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 	dp_info("Lock held time: %llu us",
 		qdf_log_timestamp_to_usecs(unlock_time - lock_time));
 
+	return nbuf_list_head;
+}
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
+/**
+ * dp_rx_thread_flush_by_vdev_id() - flush rx packets by vdev_id in
+ * a particular rx thread queue
+ * @rx_thread: rx_thread pointer of the queue from which packets are
+ * to be flushed out
+ * @vdev_id: vdev id for which packets are to be flushed
+ * @wait_timeout: wait time value for rx thread to complete flush
+ *
+ * The function will flush the RX packets by vdev_id in a particular
+ * RX thead queue. And will notify and wait the TX thread to flush the
+ * packets in the NAPI RX GRO hash list
+ *
+ * Return: Success/Failure
+ */
+static inline
+QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
+					 uint8_t vdev_id, int wait_timeout)
+{
+	uint32_t num_list_elements = 0;
+	QDF_STATUS qdf_status = QDF_STATUS_SUCCESS;
+	qdf_nbuf_t nbuf_list_head, nbuf_list_next;
+
+	nbuf_list_head = dp_rx_thread_unlink_by_vdev_id(rx_thread, vdev_id);
+
 	while (nbuf_list_head) {
 		nbuf_list_next = qdf_nbuf_queue_next(nbuf_list_head);
 		qdf_nbuf_set_next(nbuf_list_head, NULL);
@@ -1146,6 +1577,7 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 		num_list_elements =
 			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list_head);
 		rx_thread->stats.rx_flushed += num_list_elements;
+		dp_rx_thread_flow_flushed(rx_thread, num_list_elements);
 		qdf_nbuf_list_free(nbuf_list_head);
 		nbuf_list_head = nbuf_list_next;
 	}
@@ -1356,6 +1788,8 @@ QDF_STATUS dp_rx_tm_deinit(struct dp_rx_tm_handle *rx_tm_hdl)
 		qdf_mem_free(rx_tm_hdl->rx_thread[i]);
 	}
 
+	dp_rx_tm_flow_table_deinit(rx_tm_hdl);
+
 	/* free the array of RX thread pointers*/
 	qdf_mem_free(rx_tm_hdl->rx_thread);
 	rx_tm_hdl->rx_thread = NULL;
@@ -1388,14 +1822,298 @@ static uint8_t dp_rx_tm_select_thread(struct dp_rx_tm_handle *rx_tm_hdl,
 	return selected_rx_thread;
 }
 
+#ifdef WLAN_DP_RX_THREAD_FLOW_STEERING
+/**
+ * dp_rx_tm_flow_steering_enabled() - check if RX flow steering applies
+ * @reo_ring_num: REO ring the packets were received on
+ *
+ * Return: true if packets of the ring are steered by flow
+ */
+static inline bool dp_rx_tm_flow_steering_enabled(int reo_ring_num)
+{
+	return reo_ring_num >= 0 && reo_ring_num < DP_RX_TM_MAX_REO_RINGS;
+}
+
+/**
+ * dp_rx_tm_flow_bucket() - get the flow bucket of a packet
+ * @table: flow steering table of the ring the packet was received on
+ * @nbuf: received packet
+ *
+ * Return: flow bucket the packet hashes to
+ */
+static inline struct dp_rx_tm_flow_bucket *
+dp_rx_tm_flow_bucket(struct dp_rx_tm_flow_table *table, qdf_nbuf_t nbuf)
+{
+	uint32_t flow_id = QDF_NBUF_CB_RX_FLOW_ID(nbuf);
+
+	flow_id ^= flow_id >> 16;
+	flow_id ^= flow_id >> 8;
+
+	return &table->bucket[flow_id & (DP_RX_TM_FLOW_BUCKETS - 1)];
+}
+
+/**
+ * dp_rx_tm_flow_enqueue() - steer a nbuf list to rx threads by flow
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @nbuf_list: list of packets received on one REO ring
+ *
+ * The list is split into one sub list per rx thread following the flow
+ * buckets of the packets, keeping the order of the packets of a flow.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_flow_enqueue(struct dp_rx_tm_handle *rx_tm_hdl,
+				  qdf_nbuf_t nbuf_list)
+{
+	qdf_nbuf_t head[DP_MAX_RX_THREADS] = { NULL };
+	qdf_nbuf_t tail[DP_MAX_RX_THREADS] = { NULL };
+	uint32_t num_pkts[DP_MAX_RX_THREADS] = { 0 };
+	uint8_t reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
+	struct dp_rx_tm_flow_table *table;
+	struct dp_rx_tm_flow_bucket *bucket;
+	qdf_nbuf_t nbuf, next;
+	uint8_t id;
+
+	table = &rx_tm_hdl->flow_table[reo_ring_num];
+
+	qdf_spin_lock_bh(&table->lock);
+	for (nbuf = nbuf_list; nbuf; nbuf = next) {
+		next = qdf_nbuf_next(nbuf);
+		bucket = dp_rx_tm_flow_bucket(table, nbuf);
+		id = bucket->thread_id;
+
+		if (!head[id])
+			head[id] = nbuf;
+		else
+			qdf_nbuf_set_next(tail[id], nbuf);
+		tail[id] = nbuf;
+		num_pkts[id]++;
+
+		bucket->pkts++;
+		bucket->last_enq = qdf_atomic_read(&table->enq_cnt[id]) +
+				   num_pkts[id];
+	}
+
+	for (id = 0; id < rx_tm_hdl->num_dp_rx_threads; id++) {
+		if (!head[id])
+			continue;
+
+		qdf_nbuf_set_next(tail[id], NULL);
+		QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(head[id]) = num_pkts[id];
+		/*
+		 * Dropped packets never get a sequence number, as if they were
+		 * dequeued right away. The last_enq of their buckets is then
+		 * reached by the next packets of the thread, which only delays
+		 * a migration.
+		 */
+		if (dp_rx_tm_thread_enqueue(rx_tm_hdl->rx_thread[id],
+					    head[id]) != QDF_STATUS_SUCCESS)
+			continue;
+
+		/* make the packets visible in the queue before the count */
+		qdf_mb();
+		qdf_atomic_add(num_pkts[id], &table->enq_cnt[id]);
+		qdf_set_bit(id, &table->flush_pending);
+	}
+	qdf_spin_unlock_bh(&table->lock);
+}
+
+/**
+ * dp_rx_tm_flow_migrate() - move a cold flow bucket off an rx thread
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @table: flow steering table of the ring
+ * @reo_ring_num: REO ring of @table
+ * @from: overloaded rx thread
+ * @to: least loaded rx thread
+ *
+ * Only buckets whose packets have all been delivered and GRO flushed by
+ * @from are eligible, so that the flows stay in order across the move.
+ * Among them the bucket with the least recent traffic is moved.
+ *
+ * Return: true if a bucket was moved
+ */
+static bool dp_rx_tm_flow_migrate(struct dp_rx_tm_handle *rx_tm_hdl,
+				  struct dp_rx_tm_flow_table *table,
+				  uint8_t reo_ring_num, uint8_t from, uint8_t to)
+{
+	struct dp_rx_tm_flow_bucket *bucket, *victim = NULL;
+	uint32_t flushed;
+	int i;
+
+	flushed = qdf_atomic_read(
+		&rx_tm_hdl->rx_thread[from]->flow.flushed_cnt[reo_ring_num]);
+
+	for (i = 0; i < DP_RX_TM_FLOW_BUCKETS; i++) {
+		bucket = &table->bucket[i];
+		if (bucket->thread_id != from || !bucket->pkts)
+			continue;
+		if ((int32_t)(bucket->last_enq - flushed) > 0)
+			continue;
+		if (!victim || bucket->pkts < victim->pkts)
+			victim = bucket;
+	}
+
+	if (!victim)
+		return false;
+
+	victim->thread_id = to;
+	victim->last_enq = qdf_atomic_read(&table->enq_cnt[to]);
+	rx_tm_hdl->rx_thread[from]->stats.flows_migrated_out++;
+	rx_tm_hdl->rx_thread[to]->stats.flows_migrated_in++;
+
+	return true;
+}
+
+/**
+ * dp_rx_tm_flow_rebalance() - rebalance the flows of a ring at GRO flush
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @reo_ring_num: REO ring getting the GRO flush indication
+ *
+ * Caller holds the lock of the ring flow table.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_flow_rebalance(struct dp_rx_tm_handle *rx_tm_hdl,
+				    uint8_t reo_ring_num)
+{
+	struct dp_rx_tm_flow_table *table = &rx_tm_hdl->flow_table[reo_ring_num];
+	int32_t pending, max_pending = 0, min_pending = 0;
+	uint8_t hot = 0, cold = 0;
+	uint32_t spread;
+	bool migrated = false;
+	int i;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		pending = qdf_atomic_read(&rx_tm_hdl->rx_thread[i]->flow.pending);
+		if (!i || pending > max_pending) {
+			max_pending = pending;
+			hot = i;
+		}
+		if (!i || pending < min_pending) {
+			min_pending = pending;
+			cold = i;
+		}
+	}
+
+	spread = max_pending - min_pending;
+	if (spread > rx_tm_hdl->max_imbalance)
+		rx_tm_hdl->max_imbalance = spread;
+
+	if (spread > DP_RX_TM_IMBALANCE_THRESH) {
+		for (i = 0; i < DP_RX_TM_MAX_FLOW_MIGRATE; i++) {
+			if (!dp_rx_tm_flow_migrate(rx_tm_hdl, table,
+						   reo_ring_num, hot, cold))
+				break;
+			migrated = true;
+		}
+		if (migrated) {
+			rx_tm_hdl->rebalances++;
+			dp_debug("ring %u: moved %d flows from thread %u to %u, spread %u",
+				 reo_ring_num, i, hot, cold, spread);
+		}
+	}
+
+	for (i = 0; i < DP_RX_TM_FLOW_BUCKETS; i++)
+		table->bucket[i].pkts >>= 1;
+}
+
+/**
+ * dp_rx_tm_flow_gro_flush_ind() - post GRO flush to threads used by a ring
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @reo_ring_num: REO ring for which GRO flush needs to be done
+ * @flush_code: flush code to differentiate low TPUT flush
+ *
+ * The flush is posted to every rx thread which got packets of the ring
+ * since its last indication, and full flushes are the points at which
+ * the flows of the ring get rebalanced.
+ *
+ * Return: None
+ */
+static void
+dp_rx_tm_flow_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl,
+			    uint8_t reo_ring_num,
+			    enum dp_rx_gro_flush_code flush_code)
+{
+	struct dp_rx_tm_flow_table *table = &rx_tm_hdl->flow_table[reo_ring_num];
+	unsigned long flush_pending;
+	int i;
+
+	qdf_spin_lock_bh(&table->lock);
+	flush_pending = table->flush_pending;
+	table->flush_pending = 0;
+	if (flush_code == DP_RX_GRO_NORMAL_FLUSH)
+		dp_rx_tm_flow_rebalance(rx_tm_hdl, reo_ring_num);
+	qdf_spin_unlock_bh(&table->lock);
+
+	if (!flush_pending)
+		flush_pending = BIT(dp_rx_tm_select_thread(rx_tm_hdl,
+							   reo_ring_num));
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (qdf_test_bit(i, &flush_pending))
+			dp_rx_tm_thread_gro_flush_ind(rx_tm_hdl->rx_thread[i],
+						      flush_code);
+	}
+}
+
+/**
+ * dp_rx_tm_get_current_thread() - get the rx thread of the calling context
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * Return: rx thread running the caller, NULL if not called from one
+ */
+static struct dp_rx_thread *
+dp_rx_tm_get_current_thread(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	qdf_thread_t *task = qdf_get_current_task();
+	int i;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (rx_tm_hdl->rx_thread[i] &&
+		    rx_tm_hdl->rx_thread[i]->task == task)
+			return rx_tm_hdl->rx_thread[i];
+	}
+
+	return NULL;
+}
+
+#else
+static inline bool dp_rx_tm_flow_steering_enabled(int reo_ring_num)
+{
+	return false;
+}
+
+static inline void dp_rx_tm_flow_enqueue(struct dp_rx_tm_handle *rx_tm_hdl,
+					 qdf_nbuf_t nbuf_list)
+{
+}
+
+static inline void
+dp_rx_tm_flow_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl,
+			    uint8_t reo_ring_num,
+			    enum dp_rx_gro_flush_code flush_code)
+{
+}
+
+static inline struct dp_rx_thread *
+dp_rx_tm_get_current_thread(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	return NULL;
+}
+#endif /* WLAN_DP_RX_THREAD_FLOW_STEERING */
+
 QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 				qdf_nbuf_t nbuf_list)
 {
 	uint8_t selected_thread_id;
+	uint8_t reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
+
+	if (dp_rx_tm_flow_steering_enabled(reo_ring_num)) {
+		dp_rx_tm_flow_enqueue(rx_tm_hdl, nbuf_list);
+		return QDF_STATUS_SUCCESS;
+	}
 
-	selected_thread_id =
-		dp_rx_tm_select_thread(rx_tm_hdl,
-				       QDF_NBUF_CB_RX_CTX_ID(nbuf_list));
+	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, reo_ring_num);
 	dp_rx_tm_thread_enqueue(rx_tm_hdl->rx_thread[selected_thread_id],
 				nbuf_list);
 	return QDF_STATUS_SUCCESS;
@@ -1407,6 +2125,11 @@ dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
 {
 	uint8_t selected_thread_id;
 
+	if (dp_rx_tm_flow_steering_enabled(rx_ctx_id)) {
+		dp_rx_tm_flow_gro_flush_ind(rx_tm_hdl, rx_ctx_id, flush_code);
+		return QDF_STATUS_SUCCESS;
+	}
+
 	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
 	dp_rx_tm_thread_gro_flush_ind(rx_tm_hdl->rx_thread[selected_thread_id],
 				      flush_code);
@@ -1417,8 +2140,13 @@ dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
 qdf_napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 					   uint8_t rx_ctx_id)
 {
+	struct dp_rx_thread *rx_thread;
 	uint8_t selected_thread_id;
 
+	rx_thread = dp_rx_tm_get_current_thread(rx_tm_hdl);
+	if (rx_thread)
+		return &rx_thread->napi;
+
 	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
 
 	return &rx_tm_hdl->rx_thread[selected_thread_id]->napi;
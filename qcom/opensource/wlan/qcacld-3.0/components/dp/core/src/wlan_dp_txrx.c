@@ -994,9 +994,10 @@ static QDF_STATUS dp_gro_rx_bh_disable(struct wlan_dp_intf *dp_intf,
 			dp_intf->dp_stats.tx_rx_stats.
 					rx_gro_low_tput_flush++;
 		if (!rx_aggregation)
-			dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id] = 1;
+			qdf_atomic_set(&dp_ctx->dp_agg_param.
+				       gro_force_flush[rx_ctx_id], 1);
 		if (gro_disallowed)
-			dp_intf->gro_flushed[rx_ctx_id] = 1;
+			qdf_atomic_set(&dp_intf->gro_flushed[rx_ctx_id], 1);
 	} else {
 		status = dp_ctx->dp_ops.dp_rx_napi_gro_receive(napi_to_use,
 							      nbuf);
@@ -1428,6 +1429,42 @@ void wlan_dp_set_fisa_disallowed_for_intf(ol_txrx_soc_handle soc,
 #endif
 
 #ifdef WLAN_FEATURE_DYNAMIC_RX_AGGREGATION
+/**
+ * wlan_dp_rx_gro_disallow_update() - apply a GRO disallow change to FISA
+ * @soc: DP soc handle
+ * @dp_intf: DP interface handle
+ * @rx_ctx_id: rx context id
+ *
+ * Packets of an rx context may be delivered by several rx threads at once,
+ * which may each have seen a different gro_disallowed value. The flags are
+ * updated under the lock from a fresh read, so that the last update always
+ * matches the current setting.
+ *
+ * Return: None
+ */
+static void wlan_dp_rx_gro_disallow_update(ol_txrx_soc_handle soc,
+					   struct wlan_dp_intf *dp_intf,
+					   uint8_t rx_ctx_id)
+{
+	int32_t gro_disallowed;
+
+	qdf_spin_lock_bh(&dp_intf->gro_lock);
+	gro_disallowed = qdf_atomic_read(&dp_intf->gro_disallowed);
+	if (gro_disallowed == 0 &&
+	    qdf_atomic_read(&dp_intf->gro_flushed[rx_ctx_id]) != 0) {
+		if (qdf_likely(soc))
+			wlan_dp_set_fisa_disallowed_for_intf(soc, dp_intf,
+							     rx_ctx_id, 0);
+		qdf_atomic_set(&dp_intf->gro_flushed[rx_ctx_id], 0);
+	} else if (gro_disallowed &&
+		   qdf_atomic_read(&dp_intf->gro_flushed[rx_ctx_id]) == 0) {
+		if (qdf_likely(soc))
+			wlan_dp_set_fisa_disallowed_for_intf(soc, dp_intf,
+							     rx_ctx_id, 1);
+	}
+	qdf_spin_unlock_bh(&dp_intf->gro_lock);
+}
+
 QDF_STATUS wlan_dp_rx_deliver_to_stack(struct wlan_dp_intf *dp_intf,
 				       qdf_nbuf_t nbuf)
 {
@@ -1439,28 +1476,22 @@ QDF_STATUS wlan_dp_rx_deliver_to_stack(struct wlan_dp_intf *dp_intf,
 	uint8_t rx_ctx_id = QDF_NBUF_CB_RX_CTX_ID(nbuf);
 	ol_txrx_soc_handle soc = cds_get_context(QDF_MODULE_ID_SOC);
 	int32_t gro_disallowed;
+	int gro_flushed;
 
 	if (QDF_NBUF_CB_RX_TCP_PROTO(nbuf) &&
 	    !QDF_NBUF_CB_RX_PEER_CACHED_FRM(nbuf))
 		nbuf_receive_offload_ok = true;
 
 	gro_disallowed = qdf_atomic_read(&dp_intf->gro_disallowed);
-	if (gro_disallowed == 0 &&
-	    dp_intf->gro_flushed[rx_ctx_id] != 0) {
-		if (qdf_likely(soc))
-			wlan_dp_set_fisa_disallowed_for_intf(soc, dp_intf,
-							     rx_ctx_id, 0);
-		dp_intf->gro_flushed[rx_ctx_id] = 0;
-	} else if (gro_disallowed &&
-		   dp_intf->gro_flushed[rx_ctx_id] == 0) {
-		if (qdf_likely(soc))
-			wlan_dp_set_fisa_disallowed_for_intf(soc, dp_intf,
-							     rx_ctx_id, 1);
-	}
+	gro_flushed = qdf_atomic_read(&dp_intf->gro_flushed[rx_ctx_id]);
+	if ((gro_disallowed == 0 && gro_flushed != 0) ||
+	    (gro_disallowed && gro_flushed == 0))
+		wlan_dp_rx_gro_disallow_update(soc, dp_intf, rx_ctx_id);
 
 	if (nbuf_receive_offload_ok && dp_ctx->receive_offload_cb &&
-	    !dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id] &&
-	    !dp_intf->gro_flushed[rx_ctx_id] &&
+	    !qdf_atomic_read(&dp_ctx->dp_agg_param.
+			     gro_force_flush[rx_ctx_id]) &&
+	    !qdf_atomic_read(&dp_intf->gro_flushed[rx_ctx_id]) &&
 	    !dp_intf->runtime_disable_rx_thread) {
 		status = dp_ctx->receive_offload_cb(dp_intf, nbuf);
 
@@ -1481,8 +1512,9 @@ QDF_STATUS wlan_dp_rx_deliver_to_stack(struct wlan_dp_intf *dp_intf,
 	 * to be reset to 0 to allow GRO.
 	 */
 	if (qdf_atomic_read(&dp_ctx->dp_agg_param.rx_aggregation) &&
-	    dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id])
-		dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id] = 0;
+	    qdf_atomic_read(&dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id]))
+		qdf_atomic_set(&dp_ctx->dp_agg_param.gro_force_flush[rx_ctx_id],
+			       0);
 
 	dp_intf->dp_stats.tx_rx_stats.rx_non_aggregated++;
 
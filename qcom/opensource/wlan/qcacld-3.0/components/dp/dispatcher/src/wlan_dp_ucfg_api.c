@@ -240,6 +240,7 @@ ucfg_dp_create_intf(struct wlan_objmgr_psoc *psoc,
 	dp_mic_init_work(dp_intf);
 	qdf_atomic_init(&dp_ctx->num_latency_critical_clients);
 	qdf_atomic_init(&dp_intf->gro_disallowed);
+	qdf_spinlock_create(&dp_intf->gro_lock);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -272,6 +273,7 @@ ucfg_dp_destroy_intf(struct wlan_objmgr_psoc *psoc,
 
 	qdf_spinlock_destroy(&dp_intf->dp_link_list_lock);
 	qdf_list_destroy(&dp_intf->dp_link_list);
+	qdf_spinlock_destroy(&dp_intf->gro_lock);
 
 	qdf_spin_lock_bh(&dp_ctx->intf_list_lock);
 	qdf_list_remove_node(&dp_ctx->intf_list, &dp_intf->node);
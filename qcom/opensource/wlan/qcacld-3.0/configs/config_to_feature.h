@@ -97,6 +97,10 @@
 #define WLAN_PTR_HASH_TEST (1)
 #endif
 
+#ifdef CONFIG_QDF_TEST
+#define WLAN_RCU_TEST (1)
+#endif
+
 #ifdef CONFIG_QDF_TEST
 #define WLAN_SLIST_TEST (1)
 #endif
@@ -463,6 +467,10 @@
 #define FEATURE_WLAN_DP_RX_THREADS (1)
 #endif
 
+#ifdef CONFIG_WLAN_DP_RX_THREAD_FLOW_STEERING
+#define WLAN_DP_RX_THREAD_FLOW_STEERING (1)
+#endif
+
 #ifdef CONFIG_WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT
 #define WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT (1)
 #endif
@@ -1678,6 +1686,10 @@
 #define QCA_AC_BASED_FLOW_CONTROL (1)
 #endif
 
+#ifdef CONFIG_DP_TX_DESC_CPU_CACHE
+#define DP_TX_DESC_CPU_CACHE (1)
+#endif
+
 #ifdef CONFIG_FEATURE_NO_DBS_INTRABAND_MCC_SUPPORT
 #define FEATURE_NO_DBS_INTRABAND_MCC_SUPPORT (1)
 #endif
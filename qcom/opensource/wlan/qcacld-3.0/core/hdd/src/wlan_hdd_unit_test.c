@@ -27,6 +27,7 @@
 #include "qdf_hashtable_test.h"
 #include "qdf_periodic_work_test.h"
 #include "qdf_ptr_hash_test.h"
+#include "qdf_rcu_test.h"
 #include "qdf_slist_test.h"
 #include "qdf_talloc_test.h"
 #include "qdf_str.h"
@@ -50,6 +51,7 @@ struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "qdf_periodic_work",
 	  .callback = qdf_periodic_work_unit_test },
 	{ .name = "qdf_ptr_hash", .callback = qdf_ptr_hash_unit_test },
+	{ .name = "qdf_rcu", .callback = qdf_rcu_unit_test },
 	{ .name = "qdf_slist", .callback = qdf_slist_unit_test },
 	{ .name = "qdf_talloc", .callback = qdf_talloc_unit_test },
 	{ .name = "qdf_tracker", .callback = qdf_tracker_unit_test },